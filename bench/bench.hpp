@@ -0,0 +1,841 @@
+//
+// MIT License
+//
+// Copyright (c) 2024 Stellacore Corporation
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+
+#ifndef OriNet_bench_INCL_
+#define OriNet_bench_INCL_
+
+/*! \file
+\brief Self-contained timing harness for OriNet benchmark programs.
+
+Each benchmark program is a single translation unit that includes this
+header. Programs are linked with OriNet::AllocHook so that allocations
+are counted (via OriNet/alloc.hpp).
+
+A bench::Suite collects timing results (median over repetitions) for
+named operations at various problem sizes and reports them as JSON
+for tracking across releases.
+
+*/
+
+
+#include "hwCounters.hpp"
+
+#include "OriNet/OriNet"
+#include "OriNet/alloc.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/resource.h>
+#include <unistd.h>
+#endif
+
+
+namespace bench
+{
+	//! Prevent compiler from optimizing away computation of value
+	template <typename Type>
+	inline
+	void
+	keep
+		( Type const & value
+		)
+	{
+#if defined(__GNUC__) || defined(__clang__)
+		asm volatile("" : : "r"(&value) : "memory");
+#else
+		static void const * volatile sPtr{ nullptr };
+		sPtr = &value;
+#endif
+	}
+
+	//! Timing statistics for one (name, size) benchmark case
+	struct Result
+	{
+		//! Operation (e.g. "Values/insert")
+		std::string theName{};
+
+		//! Problem size (e.g. number of items in container)
+		std::size_t theSize{ 0u };
+
+		//! Number of operations timed in each repetition
+		std::size_t theNumOps{ 0u };
+
+		//! Number of (timed) repetitions
+		std::size_t theNumReps{ 0u };
+
+		//! Median (over repetitions) time per operation [ns]
+		double theNsPerOp{ 0. };
+
+		//! Minimum (over repetitions) time per operation [ns]
+		double theNsPerOpMin{ 0. };
+
+		//! Average (over all repetitions) allocations per operation
+		double theAllocsPerOp{ 0. };
+
+		//! Additional (named) values, e.g. accuracy or parameters
+		std::vector<std::pair<std::string, double> > theMetrics{};
+
+	}; // Result
+
+	//! Collection of benchmark results (with JSON reporting)
+	class Suite
+	{
+		std::string theName{};
+		std::size_t theNumReps{ 5u };
+		std::vector<Result> theResults{};
+
+		//! Hardware counters (opened on first use)
+		std::unique_ptr<HwCounters> thePtHwCounters{};
+
+		//! Name with JSON special characters escaped
+		inline
+		static
+		std::string
+		jsonString  // Suite::
+			( std::string const & name
+			)
+		{
+			std::string str{ "\"" };
+			for (char const & ch : name)
+			{
+				if (('"' == ch) || ('\\' == ch))
+				{
+					str.push_back('\\');
+				}
+				str.push_back(ch);
+			}
+			str.push_back('"');
+			return str;
+		}
+
+		//! Value as JSON number (or null if not finite)
+		inline
+		static
+		std::string
+		jsonNumber  // Suite::
+			( double const & value
+			)
+		{
+			std::ostringstream oss;
+			if (std::isfinite(value))
+			{
+				oss << std::setprecision(6) << value;
+			}
+			else
+			{
+				oss << "null";
+			}
+			return oss.str();
+		}
+
+	public:
+
+		//! Suite for which each case is timed numReps times
+		inline
+		explicit
+		Suite  // Suite::
+			( std::string const & name
+			, std::size_t const & numReps = 5u
+			)
+			: theName{ name }
+			, theNumReps{ std::max(numReps, std::size_t{ 1u }) }
+		{ }
+
+		/*! \brief Time runFunc(state, numOps) for state from setupFunc().
+		 *
+		 * The setupFunc() is called once (untimed). Each repetition
+		 * calls runFunc() (timed, with allocations counted) followed
+		 * by resetFunc(state, numOps) (untimed) which should restore
+		 * state to that prior to runFunc() (if runFunc() modifies it).
+		 */
+		template <typename SetupFunc, typename RunFunc, typename ResetFunc>
+		inline
+		Result const &
+		measure  // Suite::
+			( std::string const & name
+			, std::size_t const & size
+			, std::size_t const & numOps
+			, SetupFunc const & setupFunc
+			, RunFunc const & runFunc
+			, ResetFunc const & resetFunc
+			)
+		{
+			auto state{ setupFunc() };
+
+			std::vector<double> nsPerOps;
+			nsPerOps.reserve(theNumReps);
+			std::size_t numAllocs{ 0u };
+			HwCounters::Counts hwSums{};
+			double const dOps{ double(std::max(numOps, std::size_t{ 1u })) };
+			HwCounters & hwCounters = this->hwCounters();
+			for (std::size_t nRep{0u} ; nRep < theNumReps ; ++nRep)
+			{
+				using Clock = std::chrono::steady_clock;
+				orinet::alloc::Counts const allocBeg
+					{ orinet::alloc::processCounts() };
+				hwCounters.start();
+				Clock::time_point const timeBeg{ Clock::now() };
+
+				runFunc(state, numOps);
+
+				Clock::time_point const timeEnd{ Clock::now() };
+				HwCounters::Counts const hwCounts{ hwCounters.stop() };
+				numAllocs += orinet::alloc::processCounts()
+					.since(allocBeg).theNumAllocs;
+				for (std::size_t nn{0u} ; nn < hwSums.size() ; ++nn)
+				{
+					hwSums[nn] += hwCounts[nn];
+				}
+
+				double const ns
+					{ std::chrono::duration<double, std::nano>
+						(timeEnd - timeBeg).count()
+					};
+				nsPerOps.emplace_back(ns / dOps);
+
+				resetFunc(state, numOps);
+			}
+
+			std::sort(nsPerOps.begin(), nsPerOps.end());
+			theResults.emplace_back
+				( Result
+					{ .theName = name
+					, .theSize = size
+					, .theNumOps = numOps
+					, .theNumReps = theNumReps
+					, .theNsPerOp = nsPerOps[nsPerOps.size() / 2u]
+					, .theNsPerOpMin = nsPerOps.front()
+					, .theAllocsPerOp
+						= double(numAllocs) / (dOps * double(theNumReps))
+					}
+				);
+			annotateCounters(hwSums, dOps * double(theNumReps));
+			return theResults.back();
+		}
+
+		//! As measure() above for runFunc that does not modify state
+		template <typename SetupFunc, typename RunFunc>
+		inline
+		Result const &
+		measure  // Suite::
+			( std::string const & name
+			, std::size_t const & size
+			, std::size_t const & numOps
+			, SetupFunc const & setupFunc
+			, RunFunc const & runFunc
+			)
+		{
+			return measure
+				( name, size, numOps, setupFunc, runFunc
+				, [] (auto &, std::size_t const &) { }
+				);
+		}
+
+		/*! \brief Attach named value to most recent measure() result.
+		 *
+		 * E.g. for reporting accuracy along with speed, or for
+		 * reporting parameters (other than size) of the benchmark case.
+		 */
+		inline
+		void
+		annotate  // Suite::
+			( std::string const & key
+			, double const & value
+			)
+		{
+			if (! theResults.empty())
+			{
+				theResults.back().theMetrics.emplace_back(key, value);
+			}
+		}
+
+		/*! \brief Annotate last result with hardware counts per operation.
+		 *
+		 * Values are added for each counter that is available (i.e.
+		 * is not NaN), along with instructions per cycle ("ipc") if
+		 * both of those counters are available.
+		 */
+		inline
+		void
+		annotateCounters  // Suite::
+			( HwCounters::Counts const & hwCounts
+			, double const & numOps
+			)
+		{
+			for (std::size_t nn{0u} ; nn < hwCounts.size() ; ++nn)
+			{
+				if (std::isfinite(hwCounts[nn]))
+				{
+					HwCounters::Event const event
+						{ static_cast<HwCounters::Event>(nn) };
+					annotate
+						( HwCounters::nameFor(event) + "_per_op"
+						, hwCounts[nn] / numOps
+						);
+				}
+			}
+			double const & cycles = hwCounts[HwCounters::Cycles];
+			double const & instructions = hwCounts[HwCounters::Instructions];
+			if (std::isfinite(cycles) && std::isfinite(instructions)
+				&& (0. < cycles))
+			{
+				annotate("ipc", instructions / cycles);
+			}
+		}
+
+		/*! \brief Hardware counters (opened on first call).
+		 *
+		 * A note is put to std::cerr (once) if counters are not
+		 * available, in which case results have no counter values.
+		 */
+		inline
+		HwCounters &
+		hwCounters  // Suite::
+			()
+		{
+			if (! thePtHwCounters)
+			{
+				thePtHwCounters = std::make_unique<HwCounters>();
+				if (! thePtHwCounters->isAvailable())
+				{
+					std::cerr << "NOTE: " << theName
+						<< ": hardware counters not used ("
+						<< thePtHwCounters->note() << ")\n";
+				}
+			}
+			return *thePtHwCounters;
+		}
+
+		//! Add result determined externally (e.g. from a long run)
+		inline
+		Result const &
+		record  // Suite::
+			( Result const & result
+			)
+		{
+			theResults.emplace_back(result);
+			return theResults.back();
+		}
+
+		//! Results from all measure() calls (in order of calls)
+		inline
+		std::vector<Result> const &
+		results  // Suite::
+			() const
+		{
+			return theResults;
+		}
+
+		//! Put results to stream (as JSON)
+		inline
+		void
+		writeJson  // Suite::
+			( std::ostream & ostrm
+			) const
+		{
+			ostrm << "{\n"
+				<< "  \"suite\": " << jsonString(theName) << ",\n"
+				<< "  \"version\": "
+					<< jsonString(orinet::projectVersion()) << ",\n"
+				<< "  \"source\": "
+					<< jsonString(orinet::sourceIdentity()) << ",\n"
+				<< "  \"results\": [\n";
+			ostrm << std::setprecision(6);
+			for (std::size_t nn{0u} ; nn < theResults.size() ; ++nn)
+			{
+				Result const & result = theResults[nn];
+				ostrm
+					<< "    {"
+					<< " \"name\": " << jsonString(result.theName)
+					<< ", \"size\": " << result.theSize
+					<< ", \"ops\": " << result.theNumOps
+					<< ", \"reps\": " << result.theNumReps
+					<< ", \"ns_per_op\": " << result.theNsPerOp
+					<< ", \"ns_per_op_min\": " << result.theNsPerOpMin
+					<< ", \"allocs_per_op\": " << result.theAllocsPerOp;
+				for (std::pair<std::string, double> const & metric
+					: result.theMetrics)
+				{
+					ostrm << ", " << jsonString(metric.first)
+						<< ": " << jsonNumber(metric.second);
+				}
+				ostrm
+					<< " }"
+					<< (((nn + 1u) < theResults.size()) ? "," : "")
+					<< '\n';
+			}
+			ostrm << "  ]\n" << "}\n";
+		}
+
+		/*! \brief Save JSON to path (or to std::cout if path is empty)
+		 *
+		 * Returns false (with message to std::cerr) on failure.
+		 */
+		inline
+		bool
+		saveJson  // Suite::
+			( std::string const & path
+			) const
+		{
+			bool okay{ false };
+			if (path.empty())
+			{
+				writeJson(std::cout);
+				okay = std::cout.good();
+			}
+			else
+			{
+				std::ofstream ofs(path);
+				writeJson(ofs);
+				okay = ofs.good();
+			}
+			if (! okay)
+			{
+				std::cerr << "ERROR: unable to write results to '"
+					<< path << "'\n";
+			}
+			return okay;
+		}
+
+	}; // Suite
+
+	/*! \brief Reader for JSON produced by Suite::writeJson().
+	 *
+	 * Handles general JSON syntax (so that hand edited files are okay)
+	 * but only interprets the "suite" name and the "results" entries.
+	 */
+	class JsonReader
+	{
+		std::string theText{};
+		std::size_t thePos{ 0u };
+		bool theOkay{ true };
+
+		//! Advance past white space
+		inline
+		void
+		skipSpace  // JsonReader::
+			()
+		{
+			while ((thePos < theText.size())
+				&& std::isspace(static_cast<unsigned char>(theText[thePos])))
+			{
+				++thePos;
+			}
+		}
+
+		//! True (and advance past it) if next (non-space) char is expChar
+		inline
+		bool
+		consume  // JsonReader::
+			( char const & expChar
+			)
+		{
+			skipSpace();
+			bool const isNext
+				{ (thePos < theText.size()) && (expChar == theText[thePos]) };
+			if (isNext)
+			{
+				++thePos;
+			}
+			return isNext;
+		}
+
+		//! As consume() but note error if expChar is not next
+		inline
+		void
+		expect  // JsonReader::
+			( char const & expChar
+			)
+		{
+			if (! consume(expChar))
+			{
+				theOkay = false;
+			}
+		}
+
+		//! Next (quoted) string value (with simple escapes decoded)
+		inline
+		std::string
+		readString  // JsonReader::
+			()
+		{
+			std::string str;
+			expect('"');
+			while (theOkay && (thePos < theText.size())
+				&& ('"' != theText[thePos]))
+			{
+				char chr{ theText[thePos++] };
+				if (('\\' == chr) && (thePos < theText.size()))
+				{
+					chr = theText[thePos++];
+					if ('n' == chr) { chr = '\n'; }
+					else
+					if ('t' == chr) { chr = '\t'; }
+					else
+					if ('u' == chr)
+					{
+						// (non-ascii) code points not needed here
+						thePos = std::min(thePos + 4u, theText.size());
+						chr = '?';
+					}
+				}
+				str.push_back(chr);
+			}
+			expect('"');
+			return str;
+		}
+
+		//! Next number (or NaN for null, 1/0 for true/false)
+		inline
+		double
+		readNumber  // JsonReader::
+			()
+		{
+			double value{ std::numeric_limits<double>::quiet_NaN() };
+			skipSpace();
+			std::size_t const beg{ thePos };
+			while (thePos < theText.size())
+			{
+				char const & chr = theText[thePos];
+				bool const isPart
+					{ std::isalnum(static_cast<unsigned char>(chr))
+					|| ('-' == chr) || ('+' == chr) || ('.' == chr)
+					};
+				if (! isPart)
+				{
+					break;
+				}
+				++thePos;
+			}
+			std::string const token{ theText.substr(beg, thePos - beg) };
+			if ("true" == token) { value = 1.; }
+			else
+			if ("false" == token) { value = 0.; }
+			else
+			if (! ("null" == token))
+			{
+				std::istringstream iss(token);
+				iss >> value;
+				theOkay = theOkay && (! iss.fail());
+			}
+			return value;
+		}
+
+		//! Advance past next value (of any type)
+		inline
+		void
+		skipValue  // JsonReader::
+			()
+		{
+			skipSpace();
+			if (! (thePos < theText.size()))
+			{
+				theOkay = false;
+			}
+			else
+			if ('"' == theText[thePos])
+			{
+				readString();
+			}
+			else
+			if (consume('{'))
+			{
+				while (theOkay && (! consume('}')))
+				{
+					readString();
+					expect(':');
+					skipValue();
+					consume(',');
+				}
+			}
+			else
+			if (consume('['))
+			{
+				while (theOkay && (! consume(']')))
+				{
+					skipValue();
+					consume(',');
+				}
+			}
+			else
+			{
+				readNumber();
+			}
+		}
+
+		//! Next object as a Result
+		inline
+		Result
+		readResult  // JsonReader::
+			()
+		{
+			Result result{};
+			expect('{');
+			while (theOkay && (! consume('}')))
+			{
+				std::string const key{ readString() };
+				expect(':');
+				skipSpace();
+				if ("name" == key)
+				{
+					result.theName = readString();
+				}
+				else
+				if ((thePos < theText.size()) && ('"' == theText[thePos]))
+				{
+					skipValue(); // other (non-numeric) values
+				}
+				else
+				{
+					double const value{ readNumber() };
+					if ("size" == key)
+					{
+						result.theSize = static_cast<std::size_t>(value);
+					}
+					else
+					if ("ops" == key)
+					{
+						result.theNumOps = static_cast<std::size_t>(value);
+					}
+					else
+					if ("reps" == key)
+					{
+						result.theNumReps = static_cast<std::size_t>(value);
+					}
+					else
+					if ("ns_per_op" == key)
+					{
+						result.theNsPerOp = value;
+					}
+					else
+					if ("ns_per_op_min" == key)
+					{
+						result.theNsPerOpMin = value;
+					}
+					else
+					if ("allocs_per_op" == key)
+					{
+						result.theAllocsPerOp = value;
+					}
+					else
+					{
+						result.theMetrics.emplace_back(key, value);
+					}
+				}
+				consume(',');
+			}
+			return result;
+		}
+
+	public:
+
+		/*! \brief Suite name and results from JSON text in stream.
+		 *
+		 * Returns false (with message to std::cerr) on syntax error.
+		 */
+		inline
+		static
+		bool
+		read  // JsonReader::
+			( std::istream & istrm
+			, std::string * const & ptSuiteName
+			, std::vector<Result> * const & ptResults
+			)
+		{
+			JsonReader reader;
+			std::ostringstream oss;
+			oss << istrm.rdbuf();
+			reader.theText = oss.str();
+
+			reader.expect('{');
+			while (reader.theOkay && (! reader.consume('}')))
+			{
+				std::string const key{ reader.readString() };
+				reader.expect(':');
+				if ("suite" == key)
+				{
+					*ptSuiteName = reader.readString();
+				}
+				else
+				if ("results" == key)
+				{
+					reader.expect('[');
+					while (reader.theOkay && (! reader.consume(']')))
+					{
+						ptResults->emplace_back(reader.readResult());
+						reader.consume(',');
+					}
+				}
+				else
+				{
+					reader.skipValue();
+				}
+				reader.consume(',');
+			}
+			if (! reader.theOkay)
+			{
+				std::cerr << "ERROR: JSON syntax error near offset "
+					<< reader.thePos << '\n';
+			}
+			return reader.theOkay;
+		}
+
+	}; // JsonReader
+
+	//! Results from JSON file (e.g. from Suite::saveJson()), false on error
+	inline
+	bool
+	loadJson
+		( std::string const & path
+		, std::string * const & ptSuiteName
+		, std::vector<Result> * const & ptResults
+		)
+	{
+		bool okay{ false };
+		std::ifstream ifs(path);
+		if (ifs.is_open())
+		{
+			okay = JsonReader::read(ifs, ptSuiteName, ptResults);
+		}
+		else
+		{
+			std::cerr << "ERROR: unable to open '" << path << "'\n";
+		}
+		return okay;
+	}
+
+	//! Peak resident set size of process (or null if not available)
+	inline
+	double
+	peakRssMB
+		()
+	{
+		double rssMB{ std::numeric_limits<double>::quiet_NaN() };
+#if defined(__unix__) || defined(__APPLE__)
+		struct rusage usage{};
+		if (0 == getrusage(RUSAGE_SELF, &usage))
+		{
+#	if defined(__APPLE__)
+			double const bytesPerUnit{ 1. }; // ru_maxrss in bytes
+#	else
+			double const bytesPerUnit{ 1024. }; // ru_maxrss in kilobytes
+#	endif
+			rssMB = (double(usage.ru_maxrss) * bytesPerUnit) / (1024.*1024.);
+		}
+#endif
+		return rssMB;
+	}
+
+	//! Current resident set size of process (or null if not available)
+	inline
+	double
+	currentRssMB
+		()
+	{
+		double rssMB{ std::numeric_limits<double>::quiet_NaN() };
+#if defined(__linux__)
+		// second field is number of resident pages
+		std::ifstream ifs("/proc/self/statm");
+		std::size_t numVirt{ 0u };
+		std::size_t numRes{ 0u };
+		if (ifs >> numVirt >> numRes)
+		{
+			double const pageSize{ double(sysconf(_SC_PAGESIZE)) };
+			rssMB = (double(numRes) * pageSize) / (1024.*1024.);
+		}
+#endif
+		return rssMB;
+	}
+
+	/*! \brief Problem sizes: powers of ten from 1 through maxSize.
+	 *
+	 * Bench programs use command line: [outfile.json [maxSize]]
+	 */
+	inline
+	std::vector<std::size_t>
+	sizesUpTo
+		( std::size_t const & maxSize
+		)
+	{
+		std::vector<std::size_t> sizes;
+		for (std::size_t size{1u} ; ! (maxSize < size) ; size *= 10u)
+		{
+			sizes.emplace_back(size);
+		}
+		return sizes;
+	}
+
+	//! Output path from (optional) command line arg (else empty)
+	inline
+	std::string
+	outPathFrom
+		( int const & argc
+		, char const * const * const & argv
+		)
+	{
+		std::string path{};
+		if (1 < argc)
+		{
+			path = argv[1];
+		}
+		return path;
+	}
+
+	//! Maximum size from (optional) command line arg (else defMax)
+	inline
+	std::size_t
+	maxSizeFrom
+		( int const & argc
+		, char const * const * const & argv
+		, std::size_t const & defMax
+		)
+	{
+		std::size_t maxSize{ defMax };
+		if (2 < argc)
+		{
+			std::istringstream iss(argv[2]);
+			iss >> maxSize;
+		}
+		return maxSize;
+	}
+
+} // [bench]
+
+
+#endif // OriNet_bench_INCL_
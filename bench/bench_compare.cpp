@@ -0,0 +1,349 @@
+//
+// MIT License
+//
+// Copyright (c) 2024 Stellacore Corporation
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+
+/*! \file
+\brief Compare benchmark results against a (checked-in) baseline.
+
+Results from one or more runs of a benchmark program are combined
+(median over runs of the per-run median ns_per_op, minimum over runs
+of ns_per_op_min) and compared with a baseline for the same program.
+An entry is reported as a regression only if both its combined median
+and its minimum time exceed the baseline values by more than the
+tolerance fraction (and by at least minNs), or if its allocations per
+operation increase by more than the tolerance. Requiring both the
+typical and the best time to be slower avoids reporting noise from
+occasional slow repetitions.
+
+Usage:
+\arg bench_compare [--tolerance frac] [--min-ns ns] baseline.json
+	run.json [run.json ...]
+\arg bench_compare --merge outfile.json run.json [run.json ...]
+
+Exit status is 0 if there are no regressions, 1 for regressions and
+2 for a missing (or unreadable) baseline or for other errors.
+
+*/
+
+
+#include "bench.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+
+namespace
+{
+	//! Identify an entry by name and problem size
+	using EntryKey = std::pair<std::string, std::size_t>;
+
+	//! Median of values (which are reordered)
+	inline
+	double
+	medianOf
+		( std::vector<double> values
+		)
+	{
+		double median{ std::numeric_limits<double>::quiet_NaN() };
+		if (! values.empty())
+		{
+			std::size_t const half{ values.size() / 2u };
+			std::sort(values.begin(), values.end());
+			median = values[half];
+			if (0u == (values.size() % 2u))
+			{
+				median = .5 * (values[half - 1u] + values[half]);
+			}
+		}
+		return median;
+	}
+
+	/*! \brief Combine results from several runs (of same program).
+	 *
+	 * Entries are in order of first run. Entries missing from some
+	 * runs are combined from the runs in which they are present.
+	 */
+	inline
+	std::vector<bench::Result>
+	mergedResults
+		( std::vector<std::vector<bench::Result> > const & runs
+		)
+	{
+		std::vector<bench::Result> merged;
+		std::map<EntryKey, std::size_t> ndxForKey;
+		std::vector<std::vector<double> > nsPerOps;
+		std::vector<std::vector<double> > allocsPerOps;
+		for (std::vector<bench::Result> const & run : runs)
+		{
+			for (bench::Result const & result : run)
+			{
+				EntryKey const key{ result.theName, result.theSize };
+				std::map<EntryKey, std::size_t>::const_iterator const itFind
+					{ ndxForKey.find(key) };
+				if (ndxForKey.cend() == itFind)
+				{
+					ndxForKey.emplace(key, merged.size());
+					merged.emplace_back(result);
+					nsPerOps.emplace_back(1u, result.theNsPerOp);
+					allocsPerOps.emplace_back(1u, result.theAllocsPerOp);
+				}
+				else
+				{
+					std::size_t const & ndx = itFind->second;
+					bench::Result & into = merged[ndx];
+					into.theNumReps += result.theNumReps;
+					into.theNsPerOpMin = std::min
+						(into.theNsPerOpMin, result.theNsPerOpMin);
+					nsPerOps[ndx].emplace_back(result.theNsPerOp);
+					allocsPerOps[ndx].emplace_back(result.theAllocsPerOp);
+				}
+			}
+		}
+		for (std::size_t ndx{0u} ; ndx < merged.size() ; ++ndx)
+		{
+			merged[ndx].theNsPerOp = medianOf(nsPerOps[ndx]);
+			merged[ndx].theAllocsPerOp = medianOf(allocsPerOps[ndx]);
+		}
+		return merged;
+	}
+
+	//! Criteria for reporting a regression
+	struct Tolerance
+	{
+		//! Allowed fractional increase (e.g. .30 for 30%)
+		double theFrac{ .30 };
+
+		//! Time differences less than this are not significant [ns/op]
+		double theMinNs{ 2. };
+
+	}; // Tolerance
+
+	//! Percent change from base to curr
+	inline
+	std::string
+	changeString
+		( double const & base
+		, double const & curr
+		)
+	{
+		std::ostringstream oss;
+		oss << std::fixed << std::setprecision(1) << std::showpos;
+		if (0. < base)
+		{
+			oss << (100. * (curr - base) / base) << '%';
+		}
+		else
+		{
+			oss << "n/a";
+		}
+		return oss.str();
+	}
+
+	/*! \brief Report comparison of each entry, return number of regressions
+	 *
+	 * Entries in currs that are not in the baseline (and vice versa)
+	 * are reported, but are not considered regressions.
+	 */
+	inline
+	std::size_t
+	numRegressions
+		( std::string const & suiteName
+		, std::vector<bench::Result> const & bases
+		, std::vector<bench::Result> const & currs
+		, Tolerance const & tol
+		, std::ostream & ostrm
+		)
+	{
+		std::size_t numBad{ 0u };
+		std::map<EntryKey, bench::Result const *> baseForKey;
+		for (bench::Result const & base : bases)
+		{
+			baseForKey[EntryKey{ base.theName, base.theSize }] = &base;
+		}
+
+		ostrm << std::setprecision(6);
+		for (bench::Result const & curr : currs)
+		{
+			EntryKey const key{ curr.theName, curr.theSize };
+			std::string const entryName
+				{ suiteName + ": " + curr.theName
+				+ " [size " + std::to_string(curr.theSize) + "]"
+				};
+			std::map<EntryKey, bench::Result const *>::iterator const itBase
+				{ baseForKey.find(key) };
+			if (baseForKey.end() == itBase)
+			{
+				ostrm << "NEW        " << entryName << '\n';
+				continue;
+			}
+			bench::Result const & base = *(itBase->second);
+			baseForKey.erase(itBase);
+
+			double const timeLimit{ (1. + tol.theFrac) * base.theNsPerOp };
+			double const timeMinLimit
+				{ (1. + tol.theFrac) * base.theNsPerOpMin };
+			bool const isSlower
+				{  (timeLimit < curr.theNsPerOp)
+				&& (timeMinLimit < curr.theNsPerOpMin)
+				&& (tol.theMinNs < (curr.theNsPerOp - base.theNsPerOp))
+				};
+			double const allocLimit
+				{ (1. + tol.theFrac) * base.theAllocsPerOp + .5 };
+			bool const isAllocier{ allocLimit < curr.theAllocsPerOp };
+
+			ostrm << ((isSlower || isAllocier) ? "REGRESSION " : "ok         ")
+				<< entryName
+				<< " ns_per_op: " << base.theNsPerOp
+				<< " -> " << curr.theNsPerOp
+				<< " (" << changeString(base.theNsPerOp, curr.theNsPerOp) << ')'
+				<< " min: " << base.theNsPerOpMin
+				<< " -> " << curr.theNsPerOpMin;
+			if (isAllocier || (! (base.theAllocsPerOp == curr.theAllocsPerOp)))
+			{
+				ostrm << " allocs_per_op: " << base.theAllocsPerOp
+					<< " -> " << curr.theAllocsPerOp;
+			}
+			ostrm << '\n';
+
+			if (isSlower || isAllocier)
+			{
+				++numBad;
+			}
+		}
+		for (std::map<EntryKey, bench::Result const *>::value_type
+			const & baseItem : baseForKey)
+		{
+			ostrm << "MISSING    " << suiteName << ": "
+				<< baseItem.first.first
+				<< " [size " << baseItem.first.second << "]\n";
+		}
+		return numBad;
+	}
+
+} // [anon]
+
+
+//! Compare (or merge) benchmark results. Ref file comment for usage.
+int
+main
+	( int argc
+	, char * argv[]
+	)
+{
+	std::vector<std::string> args(argv + 1, argv + argc);
+
+	bool doMerge{ false };
+	Tolerance tol{};
+	std::size_t nArg{ 0u };
+	for ( ; (nArg < args.size())
+		&& (! args[nArg].empty()) && ('-' == args[nArg].front())
+		; ++nArg)
+	{
+		std::string const & opt = args[nArg];
+		if ("--merge" == opt)
+		{
+			doMerge = true;
+		}
+		else
+		if (("--tolerance" == opt) && ((nArg + 1u) < args.size()))
+		{
+			tol.theFrac = std::atof(args[++nArg].c_str());
+		}
+		else
+		if (("--min-ns" == opt) && ((nArg + 1u) < args.size()))
+		{
+			tol.theMinNs = std::atof(args[++nArg].c_str());
+		}
+		else
+		{
+			std::cerr << "ERROR: unknown option '" << opt << "'\n";
+			return 2;
+		}
+	}
+	if (! ((nArg + 2u) <= args.size()))
+	{
+		std::cerr << '\n'
+			<< "Usage: bench_compare [--tolerance frac] [--min-ns ns]"
+				" baseline.json run.json [run.json ...]\n"
+			<< "   or: bench_compare --merge outfile.json"
+				" run.json [run.json ...]\n"
+			<< '\n';
+		return 2;
+	}
+	std::string const & firstPath = args[nArg];
+
+	// load (and combine) results from all runs
+	std::string suiteName{};
+	std::vector<std::vector<bench::Result> > runs;
+	for (std::size_t nRun{nArg + 1u} ; nRun < args.size() ; ++nRun)
+	{
+		std::vector<bench::Result> run;
+		if (! bench::loadJson(args[nRun], &suiteName, &run))
+		{
+			return 2;
+		}
+		runs.emplace_back(run);
+	}
+	std::vector<bench::Result> const currs{ mergedResults(runs) };
+
+	int status{ 2 };
+	if (doMerge)
+	{
+		bench::Suite suite(suiteName);
+		for (bench::Result const & curr : currs)
+		{
+			suite.record(curr);
+		}
+		status = (suite.saveJson(firstPath) ? 0 : 2);
+	}
+	else
+	{
+		std::string baseName{};
+		std::vector<bench::Result> bases;
+		if (! bench::loadJson(firstPath, &baseName, &bases))
+		{
+			// message recognized by ctest (tests are skipped)
+			std::cout << "No baseline results in '" << firstPath << "'"
+				<< " (create with target 'bench_baseline')\n";
+			return 2;
+		}
+
+		std::size_t const numBad
+			{ numRegressions(suiteName, bases, currs, tol, std::cout) };
+		std::cout << suiteName << ": " << currs.size() << " entries from "
+			<< runs.size() << " run(s), " << numBad << " regression(s)"
+			<< " (tolerance " << (100. * tol.theFrac) << "%)\n";
+		status = ((0u == numBad) ? 0 : 1);
+	}
+	return status;
+}
@@ -0,0 +1,409 @@
+//
+// MIT License
+//
+// Copyright (c) 2024 Stellacore Corporation
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+
+/*! \file
+\brief Scaling benchmark for network::Geometry build, MST and propagation
+
+Networks (of sizes from 10^3 through 10^6 stations) are simulated with
+sim::NetworkSim. For networks with EdgeOri edges and with EdgeRobust
+edges (the latter up to 10^5 stations), the individual processing
+phases are timed separately:
+\arg Geometry::insertEdge() (per edge)
+\arg Geometry::spanningEdgeBases()
+\arg Geometry::networkTree()
+\arg Geometry::propagateTransforms()
+\arg Geometry::propagateTransformsByLevel()
+\arg Geometry::renumbered() and propagateTransforms() for networks
+renumbered in breadth first, reverse Cuthill-McKee and space filling
+curve (of propagated positions) orders
+
+The process peak resident set size (high water mark - i.e. including
+all previous cases) is reported with each result.
+
+Usage: bench_network [outfile.json [maxSize]]
+
+*/
+
+
+#include "bench.hpp"
+
+#include "OriNet/compare.hpp"
+#include "OriNet/network.hpp"
+#include "OriNet/robust.hpp"
+#include "OriNet/simNetwork.hpp"
+
+#include <Engabra>
+#include <Rigibra>
+
+#include <algorithm>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+
+namespace
+{
+	//! Default largest number of stations
+	constexpr std::size_t sMaxSize{ 1000u * 1000u };
+
+	/*! \brief Largest number of stations for EdgeRobust networks.
+	 *
+	 * Each EdgeRobust holds all of its observations (in trackers)
+	 * and requires roughly 1-2 kB, so that the largest networks
+	 * would require several GB of memory.
+	 */
+	constexpr std::size_t sMaxRobustSize{ 100u * 1000u };
+
+	//! Number of observations simulated for each edge
+	constexpr std::size_t sNumMea{ 5u };
+
+	//! Edge for observations (either EdgeOri or EdgeRobust)
+	inline
+	std::shared_ptr<orinet::network::EdgeBase>
+	edgeFor
+		( orinet::sim::NdxPair const & ndxPair
+		, std::vector<rigibra::Transform> const & obsXforms
+		, bool const & useRobust
+		)
+	{
+		using namespace orinet::network;
+		std::shared_ptr<EdgeBase> ptEdge{};
+		EdgeDir const edgeDir{ ndxPair.first, ndxPair.second };
+		if (useRobust)
+		{
+			std::shared_ptr<EdgeRobust> const ptRobust
+				{ std::make_shared<EdgeRobust>
+					(edgeDir, obsXforms.front(), obsXforms.size())
+				};
+			for (std::size_t nn{1u} ; nn < obsXforms.size() ; ++nn)
+			{
+				ptRobust->accumulateXform(obsXforms[nn]);
+			}
+			ptRobust->reestimate();
+			ptEdge = ptRobust;
+		}
+		else
+		{
+			// robust fit with (median) residual magnitude as fit error
+			rigibra::Transform const fitXform
+				{ orinet::robust::transformViaEffect
+					(obsXforms.cbegin(), obsXforms.cend())
+				};
+			std::vector<double> resids;
+			resids.reserve(obsXforms.size());
+			for (rigibra::Transform const & obsXform : obsXforms)
+			{
+				using orinet::compare::maxMagResultDifference;
+				resids.emplace_back
+					(maxMagResultDifference(obsXform, fitXform, false));
+			}
+			double const fitErr{ orinet::robust::medianOf(resids) };
+			ptEdge = std::make_shared<EdgeOri>(edgeDir, fitXform, fitErr);
+		}
+		return ptEdge;
+	}
+
+	//! Edges (with observations from netSim) in order of generation
+	inline
+	std::vector<std::shared_ptr<orinet::network::EdgeBase> >
+	simulatedEdges
+		( orinet::sim::NetworkSim const & netSim
+		, bool const & useRobust
+		)
+	{
+		std::vector<std::shared_ptr<orinet::network::EdgeBase> > ptEdges;
+		orinet::random::NoiseModel const noise
+			{ .theLocSigma = 1./100.
+			, .theAngSigma = 1./1000.
+			, .theProbErr = .10
+			};
+
+		// observations for each edge are generated consecutively
+		orinet::sim::NdxPair currPair{ 0u, 0u };
+		std::vector<rigibra::Transform> obsXforms;
+		obsXforms.reserve(sNumMea);
+		netSim.forEachObservation
+			( noise
+			, [&] (orinet::sim::NdxPair const & ndxPair
+				, rigibra::Transform const & xIntoWrtFrom)
+			{
+				if ((! (ndxPair == currPair)) && (! obsXforms.empty()))
+				{
+					ptEdges.emplace_back
+						(edgeFor(currPair, obsXforms, useRobust));
+					obsXforms.clear();
+				}
+				currPair = ndxPair;
+				obsXforms.emplace_back(xIntoWrtFrom);
+			}
+			);
+		if (! obsXforms.empty())
+		{
+			ptEdges.emplace_back(edgeFor(currPair, obsXforms, useRobust));
+		}
+		return ptEdges;
+	}
+
+	//! Network containing all edges
+	inline
+	orinet::network::Geometry
+	networkFor
+		( std::vector<std::shared_ptr<orinet::network::EdgeBase> >
+			const & ptEdges
+		)
+	{
+		orinet::network::Geometry netGeo;
+		for (std::shared_ptr<orinet::network::EdgeBase> const & ptEdge
+			: ptEdges)
+		{
+			netGeo.insertEdge(ptEdge);
+		}
+		return netGeo;
+	}
+
+	//! Time the processing phases for network simulated by netSim
+	inline
+	void
+	benchNetwork
+		( bench::Suite * const & ptSuite
+		, std::string const & name
+		, orinet::sim::NetworkSim const & netSim
+		, bool const & useRobust
+		)
+	{
+		using namespace orinet::network;
+		std::size_t const size{ netSim.sizeStations() };
+		std::vector<std::shared_ptr<EdgeBase> > const ptEdges
+			{ simulatedEdges(netSim, useRobust) };
+		std::string const prefix{ name + (useRobust ? "/Robust" : "/Ori") };
+
+		// insertion of edges (into initially empty network)
+		ptSuite->measure
+			( prefix + "/insertEdge", size, ptEdges.size()
+			, [] () { return Geometry{}; }
+			, [&ptEdges] (Geometry & netGeo, std::size_t const &)
+				{
+					for (std::shared_ptr<EdgeBase> const & ptEdge : ptEdges)
+					{
+						netGeo.insertEdge(ptEdge);
+					}
+				}
+			, [] (Geometry & netGeo, std::size_t const &)
+				{
+					netGeo = Geometry{};
+				}
+			);
+		ptSuite->annotate("edges", double(ptEdges.size()));
+		ptSuite->annotate("peak_rss_mb", bench::peakRssMB());
+
+		Geometry const netGeo{ networkFor(ptEdges) };
+
+		// minimum spanning tree
+		ptSuite->measure
+			( prefix + "/spanningEdgeBases", size, 1u
+			, [] () { return std::vector<EdgeId>{}; }
+			, [&netGeo] (std::vector<EdgeId> & eIds, std::size_t const &)
+				{
+					eIds = netGeo.spanningEdgeBases();
+				}
+			);
+		ptSuite->annotate("peak_rss_mb", bench::peakRssMB());
+
+		// network of spanning tree edges
+		std::vector<EdgeId> const eIds{ netGeo.spanningEdgeBases() };
+		ptSuite->measure
+			( prefix + "/networkTree", size, 1u
+			, [] () { return Geometry{}; }
+			, [&] (Geometry & treeGeo, std::size_t const &)
+				{
+					treeGeo = netGeo.networkTree(eIds);
+				}
+			, [] (Geometry & treeGeo, std::size_t const &)
+				{
+					treeGeo = Geometry{};
+				}
+			);
+		ptSuite->annotate("peak_rss_mb", bench::peakRssMB());
+
+		// propagation of station orientations through tree
+		Geometry const treeGeo{ netGeo.networkTree(eIds) };
+		StaKey const staKey0{ 0u };
+		rigibra::Transform const xform0{ netSim.stationXform(staKey0) };
+		using StaXforms = std::map<StaKey, rigibra::Transform>;
+		ptSuite->measure
+			( prefix + "/propagateTransforms", size, 1u
+			, [] () { return StaXforms{}; }
+			, [&] (StaXforms & staXforms, std::size_t const &)
+				{
+					staXforms = treeGeo.propagateTransforms(staKey0, xform0);
+				}
+			, [] (StaXforms & staXforms, std::size_t const &)
+				{
+					staXforms.clear();
+				}
+			);
+		ptSuite->annotate("peak_rss_mb", bench::peakRssMB());
+
+		// accuracy of propagated station orientations
+		StaXforms const gotXforms
+			{ treeGeo.propagateTransforms(staKey0, xform0) };
+		double errMax{ 0. };
+		for (StaXforms::value_type const & gotXform : gotXforms)
+		{
+			using orinet::compare::maxMagResultDifference;
+			errMax = std::max
+				( errMax
+				, maxMagResultDifference
+					( gotXform.second
+					, netSim.stationXform(gotXform.first)
+					, false
+					)
+				);
+		}
+		ptSuite->annotate("stations", double(gotXforms.size()));
+		ptSuite->annotate("err_max", errMax);
+
+		// propagation by levels (batch composition)
+		ptSuite->measure
+			( prefix + "/propagateTransformsByLevel", size, 1u
+			, [] () { return StaXforms{}; }
+			, [&] (StaXforms & staXforms, std::size_t const &)
+				{
+					staXforms = treeGeo
+						.propagateTransformsByLevel(staKey0, xform0);
+				}
+			, [] (StaXforms & staXforms, std::size_t const &)
+				{
+					staXforms.clear();
+				}
+			);
+		ptSuite->annotate("peak_rss_mb", bench::peakRssMB());
+
+		// renumbering (vertex storage in breadth first order)
+		ptSuite->measure
+			( prefix + "/renumbered", size, 1u
+			, [] () { return Geometry{}; }
+			, [&] (Geometry & renumGeo, std::size_t const &)
+				{
+					renumGeo = treeGeo
+						.renumbered(treeGeo.breadthFirstOrder(staKey0));
+				}
+			, [] (Geometry & renumGeo, std::size_t const &)
+				{
+					renumGeo = Geometry{};
+				}
+			);
+		ptSuite->annotate("peak_rss_mb", bench::peakRssMB());
+
+		// propagation through renumbered trees (compare with the
+		// propagateTransforms entry - e.g. llc_misses_per_op)
+		std::vector<std::pair<std::string, std::vector<StaKey> > > const
+			namedOrders
+			{ { "BreadthFirst", treeGeo.breadthFirstOrder(staKey0) }
+			, { "CuthillMcKee", treeGeo.cuthillMcKeeOrder() }
+			, { "SpaceFilling", spaceFillingOrder(gotXforms) }
+			};
+		for (std::pair<std::string, std::vector<StaKey> > const & namedOrder
+			: namedOrders)
+		{
+			Geometry const renumGeo{ treeGeo.renumbered(namedOrder.second) };
+			ptSuite->measure
+				( prefix + "/propagateTransforms/" + namedOrder.first, size, 1u
+				, [] () { return StaXforms{}; }
+				, [&] (StaXforms & staXforms, std::size_t const &)
+					{
+						staXforms = renumGeo
+							.propagateTransforms(staKey0, xform0);
+					}
+				, [] (StaXforms & staXforms, std::size_t const &)
+					{
+						staXforms.clear();
+					}
+				);
+			ptSuite->annotate("peak_rss_mb", bench::peakRssMB());
+		}
+	}
+
+} // [anon]
+
+
+//! Run network scaling benchmarks and report results as JSON.
+int
+main
+	( int argc
+	, char * argv[]
+	)
+{
+	std::string const outPath{ bench::outPathFrom(argc, argv) };
+	std::vector<std::size_t> const sizes
+		{ bench::sizesUpTo(bench::maxSizeFrom(argc, argv, sMaxSize)) };
+
+	constexpr std::size_t numReps{ 3u };
+	bench::Suite suite("bench_network", numReps);
+
+	for (std::size_t const & size : sizes)
+	{
+		// smaller networks are not of interest for scaling
+		if (size < 1000u)
+		{
+			continue;
+		}
+
+		using orinet::sim::NetworkSpec;
+		NetworkSpec const specChain
+			{ .theTopology = NetworkSpec::Chain
+			, .theNumStas = size
+			, .theNumBack = 3u
+			, .theNumMea = sNumMea
+			, .theSeed = 1000u
+			};
+		NetworkSpec const specGeometric
+			{ .theTopology = NetworkSpec::RandomGeometric
+			, .theNumStas = size
+			, .theRadius = 1.5
+			, .theNumMea = sNumMea
+			, .theSeed = 2000u
+			};
+
+		using orinet::sim::NetworkSim;
+		NetworkSim const simChain(specChain);
+		NetworkSim const simGeometric(specGeometric);
+		for (bool const useRobust : { false, true })
+		{
+			// (memory for) robust edges limits size
+			if (useRobust && (sMaxRobustSize < size))
+			{
+				continue;
+			}
+			benchNetwork(&suite, "Chain", simChain, useRobust);
+			benchNetwork(&suite, "RandomGeometric", simGeometric, useRobust);
+		}
+	}
+
+	return (suite.saveJson(outPath) ? 0 : 1);
+}
@@ -0,0 +1,448 @@
+//
+// MIT License
+//
+// Copyright (c) 2024 Stellacore Corporation
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+
+/*! \file
+\brief Benchmarks for robust estimators, alignment and comparison kernels
+
+Robust estimators are timed (and their accuracy evaluated) over a range
+of input sizes and of contamination (blunder) rates. Accuracy is
+reported along with speed so that optimizations which degrade
+robustness are evident in the same results.
+
+Usage: bench_robust [outfile.json [maxSize]]
+
+*/
+
+
+#include "bench.hpp"
+
+#include "OriNet/align.hpp"
+#include "OriNet/compare.hpp"
+#include "OriNet/random.hpp"
+#include "OriNet/robust.hpp"
+#include "OriNet/robustScreen.hpp"
+
+#include <Engabra>
+#include <Rigibra>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <iostream>
+#include <string>
+#include <vector>
+
+
+namespace
+{
+	//! Default largest number of transforms per robust estimate
+	constexpr std::size_t sMaxSize{ 100u * 1000u };
+
+	//! Number of operations for (single item) kernel benchmarks
+	constexpr std::size_t sNumKernelOps{ 16u * 1024u };
+
+	//! Fractions of blunders among observations
+	constexpr std::array<double, 4u> sContaminations{ 0., .10, .25, .40 };
+
+	//! Measurement noise (1-sigma) for location and angle components
+	constexpr double sSigmaLoc{ 1./100. };
+	constexpr double sSigmaAng{ 1./1000. };
+
+	//! Screening tolerance (relative to sigma_mag) for transformViaScreening
+	constexpr double sScreenSigmas{ 10. };
+
+	//! Range of simulated (expected) transform values
+	constexpr std::pair<double, double> sLocMinMax{ -10., 10. };
+	constexpr std::pair<double, double> sAngMinMax
+		{ -engabra::g3::pi, engabra::g3::pi };
+
+	//! Observations of one (expected) transform
+	struct Trial
+	{
+		rigibra::Transform theExpXform{};
+		std::vector<rigibra::Transform> theXforms{};
+
+	}; // Trial
+
+	//! Trials with numBlunder of the size transforms
+	inline
+	std::vector<Trial>
+	trialsFor
+		( orinet::random::Context ctx
+		, std::size_t const & numTrials
+		, std::size_t const & size
+		, std::size_t const & numBlunder
+		)
+	{
+		std::vector<Trial> trials;
+		trials.reserve(numTrials);
+		for (std::size_t nn{0u} ; nn < numTrials ; ++nn)
+		{
+			using namespace orinet::random;
+			rigibra::Transform const expXform
+				{ uniformTransform(ctx, sLocMinMax, sAngMinMax) };
+			trials.emplace_back
+				( Trial
+					{ .theExpXform = expXform
+					, .theXforms = noisyTransforms
+						( ctx, expXform, size - numBlunder, numBlunder
+						, sSigmaLoc, sSigmaAng
+						, sLocMinMax, sAngMinMax
+						)
+					}
+				);
+		}
+		return trials;
+	}
+
+	//! Number of trials (bounding effort for large sizes)
+	inline
+	std::size_t
+	numTrialsFor
+		( std::size_t const & size
+		)
+	{
+		constexpr std::size_t maxTrials{ 256u };
+		constexpr std::size_t minTrials{ 4u };
+		constexpr std::size_t effort{ 256u * 1024u };
+		return std::clamp(effort / size, minTrials, maxTrials);
+	}
+
+	//! Attach median and max of (absolute) errs to most recent result
+	inline
+	void
+	annotateErrors
+		( bench::Suite * const & ptSuite
+		, std::vector<double> errs
+		)
+	{
+		double errMed{ engabra::g3::null<double>() };
+		double errMax{ engabra::g3::null<double>() };
+		if (! errs.empty())
+		{
+			std::sort(errs.begin(), errs.end());
+			errMed = errs[errs.size() / 2u];
+			errMax = errs.back();
+		}
+		ptSuite->annotate("err_median", errMed);
+		ptSuite->annotate("err_max", errMax);
+		ptSuite->annotate
+			( "sigma_mag"
+			, orinet::random::sigmaMagForSigmaLocAng(sSigmaLoc, sSigmaAng)
+			);
+	}
+
+	//! Transform estimator benchmark (and accuracy) for each trial
+	template <typename EstFunc>
+	inline
+	void
+	benchEstimator
+		( bench::Suite * const & ptSuite
+		, std::string const & name
+		, std::vector<Trial> const & trials
+		, std::size_t const & size
+		, double const & contam
+		, EstFunc const & estFunc
+		)
+	{
+		using rigibra::Transform;
+		bench::Result const & result = ptSuite->measure
+			( name, size, trials.size()
+			, [] () { return 0; }
+			, [&] (int &, std::size_t const &)
+				{
+					for (Trial const & trial : trials)
+					{
+						bench::keep(estFunc(trial.theXforms));
+					}
+				}
+			);
+		double const nsPerItem{ result.theNsPerOp / double(size) };
+
+		std::vector<double> errs;
+		errs.reserve(trials.size());
+		for (Trial const & trial : trials)
+		{
+			Transform const got{ estFunc(trial.theXforms) };
+			using orinet::compare::maxMagResultDifference;
+			errs.emplace_back
+				(maxMagResultDifference(got, trial.theExpXform, false));
+		}
+
+		ptSuite->annotate("contamination", contam);
+		ptSuite->annotate("ns_per_item", nsPerItem);
+		annotateErrors(ptSuite, errs);
+	}
+
+	//! Benchmark robust::medianOf() (on offset component of trials)
+	inline
+	void
+	benchMedianOf
+		( bench::Suite * const & ptSuite
+		, std::vector<Trial> const & trials
+		, std::size_t const & size
+		, double const & contam
+		)
+	{
+		// values from (first) offset component of each transform
+		std::vector<std::vector<double> > valueSets;
+		valueSets.reserve(trials.size());
+		for (Trial const & trial : trials)
+		{
+			std::vector<double> values;
+			values.reserve(trial.theXforms.size());
+			for (rigibra::Transform const & xform : trial.theXforms)
+			{
+				values.emplace_back(xform.theLoc[0]);
+			}
+			valueSets.emplace_back(values);
+		}
+
+		// medianOf() reorders values, so time it on a copy
+		std::vector<double> work;
+		work.reserve(size);
+		bench::Result const & result = ptSuite->measure
+			( "robust::medianOf", size, trials.size()
+			, [] () { return 0; }
+			, [&] (int &, std::size_t const &)
+				{
+					for (std::vector<double> const & values : valueSets)
+					{
+						work.assign(values.cbegin(), values.cend());
+						bench::keep(orinet::robust::medianOf(work));
+					}
+				}
+			);
+		double const nsPerItem{ result.theNsPerOp / double(size) };
+
+		std::vector<double> errs;
+		errs.reserve(trials.size());
+		for (std::size_t nn{0u} ; nn < trials.size() ; ++nn)
+		{
+			work.assign(valueSets[nn].cbegin(), valueSets[nn].cend());
+			double const got{ orinet::robust::medianOf(work) };
+			double const exp{ trials[nn].theExpXform.theLoc[0] };
+			errs.emplace_back(std::abs(got - exp));
+		}
+
+		ptSuite->annotate("contamination", contam);
+		ptSuite->annotate("ns_per_item", nsPerItem);
+		annotateErrors(ptSuite, errs);
+	}
+
+	//! Benchmark align::attitudeFromDirPairs() (from noisy attitudes)
+	inline
+	void
+	benchAlign
+		( bench::Suite * const & ptSuite
+		, Trial const & trial
+		)
+	{
+		using namespace engabra::g3;
+		using namespace orinet::align;
+		DirPair const refDirPair{ e1, e2 };
+		std::vector<DirPair> bodDirPairs;
+		bodDirPairs.reserve(trial.theXforms.size());
+		for (rigibra::Transform const & xform : trial.theXforms)
+		{
+			bodDirPairs.emplace_back(xform.theAtt(e1), xform.theAtt(e2));
+		}
+
+		ptSuite->measure
+			( "align::attitudeFromDirPairs", 1u, bodDirPairs.size()
+			, [] () { return 0; }
+			, [&] (int &, std::size_t const &)
+				{
+					for (DirPair const & bodDirPair : bodDirPairs)
+					{
+						bench::keep
+							(attitudeFromDirPairs(refDirPair, bodDirPair));
+					}
+				}
+			);
+
+		// accuracy relative to expected attitude (at common origin)
+		using rigibra::Transform;
+		Vector const origin{ zero<Vector>() };
+		Transform const expXform{ origin, trial.theExpXform.theAtt };
+		std::vector<double> errs;
+		errs.reserve(bodDirPairs.size());
+		for (DirPair const & bodDirPair : bodDirPairs)
+		{
+			Transform const got
+				{ origin, attitudeFromDirPairs(refDirPair, bodDirPair) };
+			using orinet::compare::maxMagResultDifference;
+			errs.emplace_back(maxMagResultDifference(got, expXform, false));
+		}
+		annotateErrors(ptSuite, errs);
+	}
+
+	//! Benchmark compare::maxMagResultDifference() (noisy vs expected)
+	inline
+	void
+	benchCompare
+		( bench::Suite * const & ptSuite
+		, Trial const & trial
+		)
+	{
+		using orinet::compare::maxMagResultDifference;
+		ptSuite->measure
+			( "compare::maxMagResultDifference", 1u, trial.theXforms.size()
+			, [] () { return 0; }
+			, [&] (int &, std::size_t const &)
+				{
+					for (rigibra::Transform const & xform : trial.theXforms)
+					{
+						bench::keep(maxMagResultDifference
+							(xform, trial.theExpXform, false));
+					}
+				}
+			);
+
+		// differences (should be consistent with noise model)
+		std::vector<double> diffs;
+		diffs.reserve(trial.theXforms.size());
+		for (rigibra::Transform const & xform : trial.theXforms)
+		{
+			diffs.emplace_back
+				(maxMagResultDifference(xform, trial.theExpXform, false));
+		}
+		annotateErrors(ptSuite, diffs);
+	}
+
+	//! Benchmark compare::maxMagResultDifferences() (bulk) for Real type
+	template <typename Real>
+	inline
+	void
+	benchCompareBulk
+		( bench::Suite * const & ptSuite
+		, std::string const & name
+		, Trial const & trial
+		)
+	{
+		orinet::robust::EffectArrays<Real> effects;
+		effects.assign(trial.theXforms.cbegin(), trial.theXforms.cend());
+		std::vector<Real> mags;
+		mags.reserve(effects.size());
+		ptSuite->measure
+			( name, 1u, effects.size()
+			, [] () { return 0; }
+			, [&] (int &, std::size_t const &)
+				{
+					orinet::compare::maxMagResultDifferences
+						(&mags, effects, trial.theExpXform, false);
+					bench::keep(mags.front());
+				}
+			);
+
+		std::vector<double> diffs(mags.cbegin(), mags.cend());
+		annotateErrors(ptSuite, diffs);
+	}
+
+} // [anon]
+
+
+//! Run robust/align/compare benchmarks and report results as JSON.
+int
+main
+	( int argc
+	, char * argv[]
+	)
+{
+	std::string const outPath{ bench::outPathFrom(argc, argv) };
+	std::vector<std::size_t> const sizes
+		{ bench::sizesUpTo(bench::maxSizeFrom(argc, argv, sMaxSize)) };
+
+	orinet::random::Context const ctx(20240917u);
+	bench::Suite suite("bench_robust");
+
+	std::uint64_t caseId{ 0u };
+	for (std::size_t const & size : sizes)
+	{
+		// robust estimates from fewer items are not meaningful here
+		if (size < 10u)
+		{
+			continue;
+		}
+		for (double const & contam : sContaminations)
+		{
+			std::size_t const numBlunder
+				{ static_cast<std::size_t>(std::round(contam * double(size))) };
+			std::vector<Trial> const trials
+				{ trialsFor
+					(ctx.stream(caseId++), numTrialsFor(size), size, numBlunder)
+				};
+
+			benchMedianOf(&suite, trials, size, contam);
+
+			using rigibra::Transform;
+			benchEstimator
+				( &suite, "robust::transformViaParameters"
+				, trials, size, contam
+				, [] (std::vector<Transform> const & xforms)
+					{
+						return orinet::robust::transformViaParameters
+							(xforms.cbegin(), xforms.cend());
+					}
+				);
+			benchEstimator
+				( &suite, "robust::transformViaEffect"
+				, trials, size, contam
+				, [] (std::vector<Transform> const & xforms)
+					{
+						return orinet::robust::transformViaEffect
+							(xforms.cbegin(), xforms.cend());
+					}
+				);
+			double const maxMagTol
+				{ sScreenSigmas * orinet::random::sigmaMagForSigmaLocAng
+					(sSigmaLoc, sSigmaAng)
+				};
+			benchEstimator
+				( &suite, "robust::transformViaScreening"
+				, trials, size, contam
+				, [&maxMagTol] (std::vector<Transform> const & xforms)
+					{
+						return orinet::robust::transformViaScreening
+							(xforms.cbegin(), xforms.cend(), maxMagTol);
+					}
+				);
+		}
+	}
+
+	// single item kernels (measurement noise only)
+	std::vector<Trial> const kernelTrials
+		{ trialsFor(ctx.stream(caseId++), 1u, sNumKernelOps, 0u) };
+	benchAlign(&suite, kernelTrials.front());
+	benchCompare(&suite, kernelTrials.front());
+	benchCompareBulk<double>
+		(&suite, "compare::maxMagResultDifferences<double>"
+		, kernelTrials.front());
+	benchCompareBulk<float>
+		(&suite, "compare::maxMagResultDifferences<float>"
+		, kernelTrials.front());
+
+	return (suite.saveJson(outPath) ? 0 : 1);
+}
@@ -0,0 +1,595 @@
+//
+// MIT License
+//
+// Copyright (c) 2024 Stellacore Corporation
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+
+/*! \file
+\brief End-to-end throughput benchmark for incremental (SLAM-like) updates
+
+The scenario of test/test_slam.cpp (a camera moving on a circular
+trajectory observing a subset of object features in each frame) is
+run for a range of configurations. Each configuration varies one
+parameter from a base case:
+\arg total number of object features
+\arg number of features observed per frame
+\arg frame rate (for a fixed simulated duration)
+\arg observation blunder rate (NoiseModel::theProbErr)
+\arg observation noise (scale of NoiseModel sigma values)
+\arg observation registration (pairwise or star, for several of the
+above)
+
+Each frame performs all of the incremental update phases (with the
+same perf::Phase decomposition as test_slam):
+\arg ObsAccumulate: pairwise feature edges via accumulateEdgeXform()
+(or, for star cases, one edge from a per-frame camera station to each
+observed feature via insertStarObservations())
+\arg EdgeReestimate: EdgeRobust::reestimate() for edges in frame
+\arg SpanningUpdate: networkTree(spanningEdgeBases())
+\arg Propagation: propagateTransforms() from a reference feature
+
+For each configuration, the report includes frames per second, frame
+latency percentiles (p50, p90, p99, p999, max), phase latency
+percentiles, allocations per frame, hardware counters per frame (if
+available), the process resident set size sampled at each quarter of
+the run (with growth per frame) and the propagated feature orientation
+error (relative to simulated truth).
+
+Usage: bench_slam [outfile.json [maxSize]]
+
+where maxSize limits the (largest) total number of features.
+
+*/
+
+
+#include "bench.hpp"
+
+#include "OriNet/alloc.hpp"
+#include "OriNet/compare.hpp"
+#include "OriNet/network.hpp"
+#include "OriNet/perf.hpp"
+#include "OriNet/random.hpp"
+#include "OriNet/simScene.hpp"
+
+#include <Engabra>
+#include <Rigibra>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+
+namespace
+{
+	//! Default largest number of (total) features
+	constexpr std::size_t sMaxSize{ 1000u };
+
+	/*! \brief Initial tracker capacity for each EdgeRobust.
+	 *
+	 * Trackers grow beyond this (as observations accumulate) which
+	 * is part of the memory growth reported by this benchmark.
+	 */
+	constexpr std::size_t sReserveSize{ 64u };
+
+	//! Number of trajectory loops simulated for each configuration
+	constexpr double sNumLoops{ 1.5 };
+
+	//! Parameters for one benchmark configuration
+	struct SlamCase
+	{
+		//! Total number of object space features
+		std::size_t theNumFea{ 100u };
+
+		//! Number of features observed in each frame
+		std::size_t theFeaPerFrame{ 7u };
+
+		//! Frames per (simulated) second
+		double theFrameRate{ 30. };
+
+		//! Probability of blunder in each observation
+		double theProbErr{ .20 };
+
+		//! Scale factor applied to (base) observation noise sigmas
+		double theNoiseScale{ 1. };
+
+		/*! \brief If true, register each frame as a star.
+		 *
+		 * The frame is a new (hub) station with an edge to each
+		 * observed feature - linear in features per frame - instead
+		 * of an edge between each pair of observed features.
+		 */
+		bool theUseStar{ false };
+
+		//! Name of result (encoding the parameter values)
+		inline
+		std::string
+		name  // SlamCase::
+			() const
+		{
+			std::ostringstream oss;
+			oss << "Slam"
+				<< "/numFea:" << theNumFea
+				<< "/perFrame:" << theFeaPerFrame
+				<< "/hz:" << theFrameRate
+				<< "/blunder:" << theProbErr
+				<< "/noise:" << theNoiseScale
+				<< "/star:" << theUseStar
+				;
+			return oss.str();
+		}
+
+	}; // SlamCase
+
+	//! Configurations with one parameter at a time varied from base
+	inline
+	std::vector<SlamCase>
+	slamCases
+		( std::size_t const & maxNumFea
+		)
+	{
+		SlamCase const base{};
+		std::vector<SlamCase> cases{ base };
+
+		for (std::size_t const numFea : { 20u, 400u, 1000u })
+		{
+			SlamCase aCase{ base };
+			aCase.theNumFea = numFea;
+			cases.emplace_back(aCase);
+		}
+		for (std::size_t const feaPerFrame : { 4u, 15u })
+		{
+			SlamCase aCase{ base };
+			aCase.theFeaPerFrame = feaPerFrame;
+			cases.emplace_back(aCase);
+		}
+		for (double const & frameRate : { 15., 60. })
+		{
+			SlamCase aCase{ base };
+			aCase.theFrameRate = frameRate;
+			cases.emplace_back(aCase);
+		}
+		for (double const & probErr : { 0., .40 })
+		{
+			SlamCase aCase{ base };
+			aCase.theProbErr = probErr;
+			cases.emplace_back(aCase);
+		}
+		for (double const & noiseScale : { .25, 4. })
+		{
+			SlamCase aCase{ base };
+			aCase.theNoiseScale = noiseScale;
+			cases.emplace_back(aCase);
+		}
+
+		// star registration for base and for features per frame cases
+		for (std::size_t const feaPerFrame : { 4u, 7u, 15u })
+		{
+			SlamCase aCase{ base };
+			aCase.theFeaPerFrame = feaPerFrame;
+			aCase.theUseStar = true;
+			cases.emplace_back(aCase);
+		}
+
+		cases.erase
+			( std::remove_if
+				( cases.begin(), cases.end()
+				, [&maxNumFea] (SlamCase const & aCase)
+					{ return (maxNumFea < aCase.theNumFea); }
+				)
+			, cases.end()
+			);
+		return cases;
+	}
+
+	//! Nanoseconds elapsed since t0
+	inline
+	std::uint64_t
+	nanosSince
+		( std::chrono::steady_clock::time_point const & t0
+		)
+	{
+		std::chrono::steady_clock::duration const elapsed
+			{ std::chrono::steady_clock::now() - t0 };
+		return static_cast<std::uint64_t>
+			(std::chrono::duration_cast<std::chrono::nanoseconds>
+				(elapsed).count());
+	}
+
+	//! Accumulate noisy pairwise feature edges for observations in frame
+	inline
+	void
+	accumulateFrame
+		( orinet::network::Geometry * const & ptNetGeo
+		, orinet::sim::FrameBatch const & batch
+		, orinet::sim::Frame const & frame
+		, orinet::random::NoiseModel const & feaNoise
+		, orinet::random::Context & ctx
+		)
+	{
+		using namespace rigibra;
+		using Iter = std::vector<orinet::sim::Observation>::const_iterator;
+		for (Iter it1{batch.begin(frame)} ; batch.end(frame) != it1 ; ++it1)
+		{
+			Transform const & xCamWrtFea1 = it1->theXformCamWrtFea;
+			for (Iter it2{it1 + 1} ; batch.end(frame) != it2 ; ++it2)
+			{
+				Transform const & xCamWrtFea2 = it2->theXformCamWrtFea;
+				Transform const x2w1Ideal
+					{ inverse(xCamWrtFea2) * xCamWrtFea1 };
+				using orinet::random::noisyTransform;
+				ptNetGeo->accumulateEdgeXform
+					( orinet::network::EdgeDir
+						{ it1->theFeaKey, it2->theFeaKey }
+					, noisyTransform(ctx, x2w1Ideal, feaNoise)
+					, sReserveSize
+					);
+			}
+		}
+	}
+
+	//! Insert noisy observations of frame as a star from station hubKey
+	inline
+	void
+	accumulateFrameStar
+		( orinet::network::Geometry * const & ptNetGeo
+		, orinet::sim::FrameBatch const & batch
+		, orinet::sim::Frame const & frame
+		, orinet::network::StaKey const & hubKey
+		, orinet::random::NoiseModel const & feaNoise
+		, orinet::random::Context & ctx
+		, std::vector<std::pair<orinet::network::StaKey, rigibra::Transform> >
+			* const & ptXCamWrtFeas
+		)
+	{
+		using Iter = std::vector<orinet::sim::Observation>::const_iterator;
+		ptXCamWrtFeas->clear();
+		for (Iter it{batch.begin(frame)} ; batch.end(frame) != it ; ++it)
+		{
+			using orinet::random::noisyTransform;
+			ptXCamWrtFeas->emplace_back
+				( it->theFeaKey
+				, noisyTransform(ctx, it->theXformCamWrtFea, feaNoise)
+				);
+		}
+		ptNetGeo->insertStarObservations(hubKey, *ptXCamWrtFeas, sReserveSize);
+	}
+
+	//! Refresh robust estimates for all star edges observed in frame
+	inline
+	void
+	reestimateFrameStar
+		( orinet::network::Geometry const & netGeo
+		, orinet::sim::FrameBatch const & batch
+		, orinet::sim::Frame const & frame
+		, orinet::network::StaKey const & hubKey
+		)
+	{
+		using namespace orinet::network;
+		using Iter = std::vector<orinet::sim::Observation>::const_iterator;
+		for (Iter it{batch.begin(frame)} ; batch.end(frame) != it ; ++it)
+		{
+			std::shared_ptr<EdgeRobust> const ptEdgeRobust
+				{ std::dynamic_pointer_cast<EdgeRobust>
+					(netGeo.edge(EdgeDir{ it->theFeaKey, hubKey }))
+				};
+			if (ptEdgeRobust)
+			{
+				ptEdgeRobust->reestimate();
+			}
+		}
+	}
+
+	//! Refresh robust estimates for all edges observed in frame
+	inline
+	void
+	reestimateFrame
+		( orinet::network::Geometry const & netGeo
+		, orinet::sim::FrameBatch const & batch
+		, orinet::sim::Frame const & frame
+		)
+	{
+		using namespace orinet::network;
+		using Iter = std::vector<orinet::sim::Observation>::const_iterator;
+		for (Iter it1{batch.begin(frame)} ; batch.end(frame) != it1 ; ++it1)
+		{
+			for (Iter it2{it1 + 1} ; batch.end(frame) != it2 ; ++it2)
+			{
+				std::shared_ptr<EdgeRobust> const ptEdgeRobust
+					{ std::dynamic_pointer_cast<EdgeRobust>
+						(netGeo.edge(EdgeDir{ it1->theFeaKey, it2->theFeaKey }))
+					};
+				if (ptEdgeRobust)
+				{
+					ptEdgeRobust->reestimate();
+				}
+			}
+		}
+	}
+
+	//! Maximum (hexad magnitude) error of propagated feature orientations
+	inline
+	double
+	maxErrorFor
+		( std::map<orinet::network::StaKey, rigibra::Transform>
+			const & gotXforms
+		, orinet::sim::Scene const & scene
+		)
+	{
+		double errMax{ 0. };
+		for (std::map<orinet::network::StaKey, rigibra::Transform>
+			::value_type const & gotXform : gotXforms)
+		{
+			std::size_t const feaNdx{ gotXform.first - orinet::sim::sFeaKey0 };
+			if (! (feaNdx < scene.sizeFeatures()))
+			{
+				continue; // (star hub) station that is not a feature
+			}
+			using orinet::compare::maxMagResultDifference;
+			errMax = std::max
+				( errMax
+				, maxMagResultDifference
+					(gotXform.second, scene.featureXform(feaNdx), false)
+				);
+		}
+		return errMax;
+	}
+
+	//! Run one configuration and record its result into suite
+	inline
+	void
+	benchSlam
+		( bench::Suite * const & ptSuite
+		, SlamCase const & slamCase
+		, std::uint32_t const & seed
+		)
+	{
+		using namespace rigibra;
+		using orinet::perf::Phase;
+		using orinet::perf::ScopedTimer;
+
+		orinet::random::Context ctx(seed);
+
+		// scene with single camera (as in test_slam)
+		namespace sim = orinet::sim;
+		sim::Scene scene(sim::expFeaXforms(ctx, slamCase.theNumFea));
+		std::shared_ptr<sim::TrajectoryCircle const> const ptTraj
+			{ std::make_shared<sim::TrajectoryCircle const>() };
+		scene.addCamera(sim::sCamKey0, ptTraj);
+
+		orinet::random::NoiseModel const camNoise{};
+		orinet::random::NoiseModel const feaNoise
+			{ .theLocSigma = slamCase.theNoiseScale * 5./100.
+			, .theAngSigma = slamCase.theNoiseScale * 2./1000.
+			, .theProbErr = slamCase.theProbErr
+			, .theLocMinMax = { -.5, .5 }
+			, .theAngMinMax = { -.5, .5 }
+			};
+
+		double const tauDelta{ 1. / slamCase.theFrameRate };
+		double const tauOneLoop{ ptTraj->period() };
+		std::size_t const numFrames
+			{ static_cast<std::size_t>
+				((sNumLoops * tauOneLoop) / tauDelta)
+			};
+
+		sim::FrameBatch batch;
+		batch.reserve(1u, slamCase.theFeaPerFrame, slamCase.theNumFea);
+
+		orinet::perf::Latencies latencies;
+		orinet::perf::Histogram frameNanos;
+		std::uint64_t sumNanos{ 0u };
+		std::uint64_t sumAllocs{ 0u };
+		bench::HwCounters & hwCounters = ptSuite->hwCounters();
+		bench::HwCounters::Counts hwSums{};
+		std::vector<double> rssMBs;
+		double errMaxSteady{ 0. };
+		double errMaxFinal{ 0. };
+
+		orinet::network::Geometry netGeo;
+		orinet::network::StaKey feaKey0{};
+		Transform xform0{};
+
+		// star hub (frame) stations are numbered after all features
+		orinet::network::StaKey const hubKey0
+			{ sim::sFeaKey0 + slamCase.theNumFea };
+		std::vector<std::pair<orinet::network::StaKey, Transform> >
+			xCamWrtFeas;
+		xCamWrtFeas.reserve(slamCase.theFeaPerFrame);
+		for (std::size_t nFrame{0u} ; nFrame < numFrames ; ++nFrame)
+		{
+			double const tau{ double(nFrame + 1u) * tauDelta };
+			scene.fillFrames
+				( ctx, tau, tauDelta, 1u, slamCase.theFeaPerFrame
+				, camNoise, &batch
+				);
+			sim::Frame const & frame = batch.theFrames.front();
+			if (0u == nFrame)
+			{
+				// first feature in first frame is propagation reference
+				feaKey0 = batch.begin(frame)->theFeaKey;
+				xform0 = scene.featureXform(feaKey0 - sim::sFeaKey0);
+			}
+
+			orinet::alloc::Scope const allocScope{};
+			hwCounters.start();
+			std::chrono::steady_clock::time_point const t0
+				{ std::chrono::steady_clock::now() };
+
+			orinet::network::StaKey const hubKey{ hubKey0 + nFrame };
+			{
+				ScopedTimer const timer(&latencies, Phase::ObsAccumulate);
+				if (slamCase.theUseStar)
+				{
+					accumulateFrameStar
+						( &netGeo, batch, frame, hubKey, feaNoise, ctx
+						, &xCamWrtFeas
+						);
+				}
+				else
+				{
+					accumulateFrame(&netGeo, batch, frame, feaNoise, ctx);
+				}
+			}
+			{
+				ScopedTimer const timer(&latencies, Phase::EdgeReestimate);
+				if (slamCase.theUseStar)
+				{
+					reestimateFrameStar(netGeo, batch, frame, hubKey);
+				}
+				else
+				{
+					reestimateFrame(netGeo, batch, frame);
+				}
+			}
+			orinet::network::Geometry treeGeo;
+			{
+				ScopedTimer const timer(&latencies, Phase::SpanningUpdate);
+				treeGeo = netGeo.networkTree(netGeo.spanningEdgeBases());
+			}
+			std::map<orinet::network::StaKey, Transform> gotXforms;
+			{
+				ScopedTimer const timer(&latencies, Phase::Propagation);
+				gotXforms = treeGeo.propagateTransforms(feaKey0, xform0);
+			}
+
+			std::uint64_t const nanos{ nanosSince(t0) };
+			bench::HwCounters::Counts const hwCounts{ hwCounters.stop() };
+			for (std::size_t nn{0u} ; nn < hwSums.size() ; ++nn)
+			{
+				hwSums[nn] += hwCounts[nn];
+			}
+			std::uint64_t const numAllocs{ allocScope.numAllocs() };
+			frameNanos.record(nanos);
+			latencies.recordAllocations(numAllocs);
+			sumNanos += nanos;
+			sumAllocs += numAllocs;
+
+			// accuracy (only after network has seen one trajectory loop)
+			errMaxFinal = maxErrorFor(gotXforms, scene);
+			if (tauOneLoop < tau)
+			{
+				errMaxSteady = std::max(errMaxSteady, errMaxFinal);
+			}
+
+			// memory use at end of each quarter of the run
+			std::size_t const quarterEnd
+				{ ((rssMBs.size() + 1u) * numFrames) / 4u };
+			if ((nFrame + 1u) == quarterEnd)
+			{
+				rssMBs.emplace_back(bench::currentRssMB());
+			}
+		}
+
+		double const frameCount{ double(frameNanos.count()) };
+		bench::Result const result
+			{ .theName = slamCase.name()
+			, .theSize = slamCase.theNumFea
+			, .theNumOps = numFrames
+			, .theNumReps = 1u
+			, .theNsPerOp = double(frameNanos.percentile(.500))
+			, .theNsPerOpMin = double(frameNanos.min())
+			, .theAllocsPerOp = double(sumAllocs) / frameCount
+			};
+		ptSuite->record(result);
+
+		// configuration
+		ptSuite->annotate("num_fea", double(slamCase.theNumFea));
+		ptSuite->annotate("fea_per_frame", double(slamCase.theFeaPerFrame));
+		ptSuite->annotate("frame_rate", slamCase.theFrameRate);
+		ptSuite->annotate("blunder_rate", slamCase.theProbErr);
+		ptSuite->annotate("noise_scale", slamCase.theNoiseScale);
+		ptSuite->annotate("star", (slamCase.theUseStar ? 1. : 0.));
+
+		// throughput and latency
+		ptSuite->annotate("fps", (1.e9 * frameCount) / double(sumNanos));
+		ptSuite->annotate("frame_p50_ns", double(frameNanos.percentile(.500)));
+		ptSuite->annotate("frame_p90_ns", double(frameNanos.percentile(.900)));
+		ptSuite->annotate("frame_p99_ns", double(frameNanos.percentile(.990)));
+		ptSuite->annotate
+			("frame_p999_ns", double(frameNanos.percentile(.999)));
+		ptSuite->annotate("frame_max_ns", double(frameNanos.max()));
+		for (std::size_t nn{0u} ; nn < orinet::perf::sNumPhases ; ++nn)
+		{
+			Phase const phase{ static_cast<Phase>(nn) };
+			std::string const name{ orinet::perf::nameFor(phase) };
+			orinet::perf::Histogram const & hist = latencies.phaseNanos(phase);
+			ptSuite->annotate(name + "_p50_ns", double(hist.percentile(.500)));
+			ptSuite->annotate(name + "_p99_ns", double(hist.percentile(.990)));
+		}
+		ptSuite->annotate
+			("allocs_p99", double(latencies.frameAllocs().percentile(.990)));
+		ptSuite->annotateCounters(hwSums, frameCount); // per frame
+
+		// memory growth over time
+		for (std::size_t nn{0u} ; nn < rssMBs.size() ; ++nn)
+		{
+			std::string const key
+				{ "rss_mb_q" + std::to_string(nn + 1u) };
+			ptSuite->annotate(key, rssMBs[nn]);
+		}
+		if (1u < rssMBs.size())
+		{
+			// growth from end of first quarter to end of run
+			double const numGrowFrames{ .75 * double(numFrames) };
+			ptSuite->annotate
+				( "rss_growth_kb_per_frame"
+				, (1024. * (rssMBs.back() - rssMBs.front())) / numGrowFrames
+				);
+		}
+		ptSuite->annotate("peak_rss_mb", bench::peakRssMB());
+		ptSuite->annotate("edges", double(netGeo.sizeEdges()));
+		ptSuite->annotate("stations", double(netGeo.sizeVerts()));
+
+		// accuracy
+		ptSuite->annotate("err_max_steady", errMaxSteady);
+		ptSuite->annotate("err_max_final", errMaxFinal);
+	}
+
+} // [anon]
+
+
+//! Run SLAM throughput benchmarks and report results as JSON.
+int
+main
+	( int argc
+	, char * argv[]
+	)
+{
+	std::string const outPath{ bench::outPathFrom(argc, argv) };
+	std::size_t const maxNumFea{ bench::maxSizeFrom(argc, argv, sMaxSize) };
+
+	bench::Suite suite("bench_slam");
+
+	std::uint32_t seed{ 1000u };
+	for (SlamCase const & slamCase : slamCases(maxNumFea))
+	{
+		benchSlam(&suite, slamCase, seed++);
+	}
+
+	return (suite.saveJson(outPath) ? 0 : 1);
+}
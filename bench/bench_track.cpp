@@ -0,0 +1,353 @@
+//
+// MIT License
+//
+// Copyright (c) 2024 Stellacore Corporation
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+
+/*! \file
+\brief Micro-benchmarks for stat::track trackers (insert, median, ...)
+
+Reports cost per operation (and allocations per operation) as a
+function of the number of items held in the tracker.
+
+Usage: bench_track [outfile.json [maxSize]]
+
+*/
+
+
+#include "bench.hpp"
+
+#include "OriNet/random.hpp"
+#include "OriNet/stat.hpp"
+
+#include <Engabra>
+#include <Rigibra>
+
+#include <algorithm>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+
+namespace
+{
+	//! Default largest tracker size
+	constexpr std::size_t sMaxSize{ 1000u * 1000u };
+
+	//! Number of operations for (O(1)) query benchmarks
+	constexpr std::size_t sNumQueryOps{ 16u * 1024u };
+
+	//! Number of insert operations (bounding effort for large sizes)
+	inline
+	std::size_t
+	numInsertOpsFor
+		( std::size_t const & size
+		)
+	{
+		constexpr std::size_t maxOps{ 1024u };
+		constexpr std::size_t minOps{ 8u };
+		constexpr std::size_t effort{ 1024u * 1024u };
+		return std::clamp(effort / size, minOps, maxOps);
+	}
+
+	/*! \brief Items for which all tracked components increase with tau.
+	 *
+	 * Trackers keep sorted component arrays. Inserting items in
+	 * increasing (component) order appends each one, such that large
+	 * trackers can be filled in linear time (i.e. benchmark setup is
+	 * not quadratic). Random items along the ramp (itemAt(rand)) are
+	 * then inserted at random (interior) positions as in actual use.
+	 */
+	struct Ramp
+	{
+		rigibra::PhysAngle theAng0{};
+		rigibra::PhysAngle theAngDelta{};
+
+		//! True if all components of (cur - prev) are positive
+		inline
+		static
+		bool
+		isIncreasing
+			( engabra::g3::Vector const & prev
+			, engabra::g3::Vector const & curr
+			)
+		{
+			return ( (prev[0] < curr[0])
+				&& (prev[1] < curr[1])
+				&& (prev[2] < curr[2])
+				);
+		}
+
+		//! Search for attitude path along which {e1,e2} images increase
+		inline
+		static
+		Ramp
+		create
+			()
+		{
+			using namespace engabra::g3;
+			orinet::random::Context ctx(12345u);
+			std::uniform_real_distribution<double> dist(-1., 1.);
+			for (;;)
+			{
+				Ramp const ramp
+					{ rigibra::PhysAngle
+						{ pi * BiVector
+							{ dist(ctx.generator())
+							, dist(ctx.generator())
+							, dist(ctx.generator())
+							}
+						}
+					, rigibra::PhysAngle
+						{ .25 * BiVector
+							{ dist(ctx.generator())
+							, dist(ctx.generator())
+							, dist(ctx.generator())
+							}
+						}
+					};
+				constexpr std::size_t numCheck{ 256u };
+				bool okay{ true };
+				rigibra::Attitude prevAtt{ ramp.attitudeAt(0.) };
+				for (std::size_t nn{1u} ; okay && (! (numCheck < nn)) ; ++nn)
+				{
+					double const tau{ double(nn) / double(numCheck) };
+					rigibra::Attitude const currAtt{ ramp.attitudeAt(tau) };
+					okay = ( isIncreasing(prevAtt(e1), currAtt(e1))
+						&& isIncreasing(prevAtt(e2), currAtt(e2))
+						);
+					prevAtt = currAtt;
+				}
+				if (okay)
+				{
+					return ramp;
+				}
+			}
+		}
+
+		//! Value at tau in [0,1]
+		inline
+		double
+		valueAt
+			( double const & tau
+			) const
+		{
+			return tau;
+		}
+
+		//! Vector at tau in [0,1]
+		inline
+		engabra::g3::Vector
+		vectorAt
+			( double const & tau
+			) const
+		{
+			return engabra::g3::Vector{ tau, 2.*tau, 3.*tau };
+		}
+
+		//! Attitude at tau in [0,1]
+		inline
+		rigibra::Attitude
+		attitudeAt
+			( double const & tau
+			) const
+		{
+			return rigibra::Attitude
+				(rigibra::PhysAngle{ theAng0.theBiv + tau*theAngDelta.theBiv });
+		}
+
+		//! Transform at tau in [0,1]
+		inline
+		rigibra::Transform
+		transformAt
+			( double const & tau
+			) const
+		{
+			return rigibra::Transform{ vectorAt(tau), attitudeAt(tau) };
+		}
+
+	}; // Ramp
+
+	//! Tracker filled with size ramp items (and room for numMore)
+	template <typename Tracker, typename ItemFunc>
+	inline
+	Tracker
+	filledTracker
+		( std::size_t const & size
+		, std::size_t const & numMore
+		, ItemFunc const & itemAt
+		)
+	{
+		Tracker tracker(size + numMore);
+		for (std::size_t nn{0u} ; nn < size ; ++nn)
+		{
+			tracker.insert(itemAt(double(nn) / double(size)));
+		}
+		return tracker;
+	}
+
+	//! Items at (pseudo)random places along ramp
+	template <typename ItemFunc>
+	inline
+	auto
+	randomItems
+		( std::size_t const & numItems
+		, ItemFunc const & itemAt
+		)
+	{
+		orinet::random::Context ctx(54321u);
+		std::uniform_real_distribution<double> dist(0., 1.);
+		std::vector<decltype(itemAt(0.))> items;
+		items.reserve(numItems);
+		for (std::size_t nn{0u} ; nn < numItems ; ++nn)
+		{
+			items.emplace_back(itemAt(dist(ctx.generator())));
+		}
+		return items;
+	}
+
+	//! Benchmark insert() and median() for Tracker at each size
+	template <typename Tracker, typename ItemFunc>
+	inline
+	void
+	benchTracker
+		( bench::Suite * const & ptSuite
+		, std::string const & name
+		, std::vector<std::size_t> const & sizes
+		, ItemFunc const & itemAt
+		)
+	{
+		for (std::size_t const & size : sizes)
+		{
+			std::size_t const numIns{ numInsertOpsFor(size) };
+			auto const items{ randomItems(numIns, itemAt) };
+
+			// insert into tracker holding size items (then remove them)
+			ptSuite->measure
+				( name + "/insert", size, numIns
+				, [&] ()
+					{ return filledTracker<Tracker>(size, numIns, itemAt); }
+				, [&] (Tracker & tracker, std::size_t const & numOps)
+					{
+						for (std::size_t nn{0u} ; nn < numOps ; ++nn)
+						{
+							tracker.insert(items[nn]);
+						}
+					}
+				, [&] (Tracker & tracker, std::size_t const & numOps)
+					{
+						for (std::size_t nn{0u} ; nn < numOps ; ++nn)
+						{
+							tracker.erase(items[nn]);
+						}
+					}
+				);
+
+			// median of tracker holding size items
+			ptSuite->measure
+				( name + "/median", size, sNumQueryOps
+				, [&] ()
+					{ return filledTracker<Tracker>(size, 0u, itemAt); }
+				, [] (Tracker & tracker, std::size_t const & numOps)
+					{
+						for (std::size_t nn{0u} ; nn < numOps ; ++nn)
+						{
+							bench::keep(tracker.median());
+						}
+					}
+				);
+		}
+	}
+
+	//! Benchmark Transforms::medianErrorEstimate() at each size
+	inline
+	void
+	benchMedianError
+		( bench::Suite * const & ptSuite
+		, std::vector<std::size_t> const & sizes
+		, Ramp const & ramp
+		)
+	{
+		using orinet::stat::track::Transforms;
+		auto const itemAt
+			{ [&ramp] (double const & tau) { return ramp.transformAt(tau); } };
+		for (std::size_t const & size : sizes)
+		{
+			ptSuite->measure
+				( "Transforms/medianErrorEstimate", size, sNumQueryOps
+				, [&] ()
+					{ return filledTracker<Transforms>(size, 0u, itemAt); }
+				, [] (Transforms & tracker, std::size_t const & numOps)
+					{
+						constexpr bool useNorm{ false };
+						for (std::size_t nn{0u} ; nn < numOps ; ++nn)
+						{
+							bench::keep(tracker.medianErrorEstimate(useNorm));
+						}
+					}
+				);
+		}
+	}
+
+} // [anon]
+
+
+/*! \brief Run tracker micro-benchmarks and report results as JSON.
+ *
+ * Note that medianErrorEstimate() is only provided by the
+ * stat::track::Transforms tracker.
+ */
+int
+main
+	( int argc
+	, char * argv[]
+	)
+{
+	std::string const outPath{ bench::outPathFrom(argc, argv) };
+	std::vector<std::size_t> const sizes
+		{ bench::sizesUpTo(bench::maxSizeFrom(argc, argv, sMaxSize)) };
+
+	Ramp const ramp{ Ramp::create() };
+	bench::Suite suite("bench_track");
+
+	using namespace orinet::stat::track;
+	benchTracker<Values>
+		( &suite, "Values", sizes
+		, [&ramp] (double const & tau) { return ramp.valueAt(tau); }
+		);
+	benchTracker<Vectors>
+		( &suite, "Vectors", sizes
+		, [&ramp] (double const & tau) { return ramp.vectorAt(tau); }
+		);
+	benchTracker<Attitudes>
+		( &suite, "Attitudes", sizes
+		, [&ramp] (double const & tau) { return ramp.attitudeAt(tau); }
+		);
+	benchTracker<Transforms>
+		( &suite, "Transforms", sizes
+		, [&ramp] (double const & tau) { return ramp.transformAt(tau); }
+		);
+	benchMedianError(&suite, sizes, ramp);
+
+	return (suite.saveJson(outPath) ? 0 : 1);
+}
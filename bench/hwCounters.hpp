@@ -0,0 +1,332 @@
+//
+// MIT License
+//
+// Copyright (c) 2024 Stellacore Corporation
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+
+#ifndef OriNet_bench_hwCounters_INCL_
+#define OriNet_bench_hwCounters_INCL_
+
+/*! \file
+\brief Hardware performance counters (Linux perf_event_open) for benchmarks.
+
+Counters (cycles, instructions, last level cache misses and branch
+misses) indicate whether an operation is compute or memory bound.
+Each counter is opened independently for the calling thread (user
+space only) so that the counters which are supported are used even
+if others are not. Counters are inherited by threads that the calling
+thread starts after opening them (e.g. by parallel::forEachRange())
+and the counts of those threads are included once they have been
+joined. If perf_event_open is not available (non-Linux,
+containers, perf_event_paranoid restrictions, virtual machines, ...)
+then isAvailable() is false and all values are NaN.
+
+Collection is disabled if environment variable OriNet_BENCH_HW_COUNTERS
+is set to "0".
+
+*/
+
+
+#include <array>
+#include <cerrno>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <sstream>
+#include <string>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+
+namespace bench
+{
+	//! Hardware performance counters for the calling thread (and children).
+	class HwCounters
+	{
+	public:
+
+		//! Events that are counted
+		enum Event
+			{ Cycles = 0
+			, Instructions
+			, LlcMisses
+			, BranchMisses
+			};
+
+		//! Number of Event enum values
+		static constexpr std::size_t sNumEvents{ 4u };
+
+		//! Counts for each Event (NaN for unavailable counters)
+		using Counts = std::array<double, sNumEvents>;
+
+	private:
+
+		//! File descriptors for each event counter (-1 if unavailable)
+		std::array<int, sNumEvents> theFds{ -1, -1, -1, -1 };
+
+		//! Reason (if any) that counters are not available
+		std::string theNote{};
+
+		//! Times (enabled, running) for each counter at start()
+		std::array<std::array<std::uint64_t, 2u>, sNumEvents> theStartTimes{};
+
+	public:
+
+		//! Name for event (e.g. for use as key prefix)
+		inline
+		static
+		std::string
+		nameFor
+			( Event const & event
+			)
+		{
+			static std::array<std::string, sNumEvents> const names
+				{ "cycles"
+				, "instructions"
+				, "llc_misses"
+				, "branch_misses"
+				};
+			return names[static_cast<std::size_t>(event)];
+		}
+
+		//! Counts with all values set to NaN
+		inline
+		static
+		Counts
+		nullCounts
+			()
+		{
+			Counts counts;
+			counts.fill(std::numeric_limits<double>::quiet_NaN());
+			return counts;
+		}
+
+		//! Open counters (if supported and not disabled by environment)
+		inline
+		explicit
+		HwCounters
+			()
+		{
+			char const * const envValue
+				{ std::getenv("OriNet_BENCH_HW_COUNTERS") };
+			if (envValue && (std::string("0") == envValue))
+			{
+				theNote = "disabled by OriNet_BENCH_HW_COUNTERS=0";
+			}
+			else
+			{
+				open();
+			}
+		}
+
+		//! Close counters
+		inline
+		~HwCounters
+			()
+		{
+#if defined(__linux__)
+			for (int const & fd : theFds)
+			{
+				if (! (fd < 0))
+				{
+					close(fd);
+				}
+			}
+#endif
+		}
+
+		// not copyable (owns file descriptors)
+		HwCounters(HwCounters const &) = delete;
+		HwCounters & operator=(HwCounters const &) = delete;
+
+		//! True if any of the counters are available
+		inline
+		bool
+		isAvailable  // HwCounters::
+			() const
+		{
+			bool any{ false };
+			for (int const & fd : theFds)
+			{
+				any = any || (! (fd < 0));
+			}
+			return any;
+		}
+
+		//! Reason that counters are not available (empty if they are)
+		inline
+		std::string const &
+		note  // HwCounters::
+			() const
+		{
+			return theNote;
+		}
+
+		/*! \brief Reset and start counting
+		 *
+		 * The reset clears only the count. The times enabled and
+		 * running accumulate from when the counter was opened and
+		 * are therefore noted here for use by stop().
+		 */
+		inline
+		void
+		start  // HwCounters::
+			()
+		{
+#if defined(__linux__)
+			for (std::size_t nn{0u} ; nn < sNumEvents ; ++nn)
+			{
+				int const & fd = theFds[nn];
+				if (! (fd < 0))
+				{
+					ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+					std::array<std::uint64_t, 3u> data{ 0u, 0u, 0u };
+					if (readData(fd, &data))
+					{
+						theStartTimes[nn] = { data[1], data[2] };
+					}
+					ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+				}
+			}
+#endif
+		}
+
+		/*! \brief Stop counting and return counts since start().
+		 *
+		 * Counts are scaled for time that counter was multiplexed
+		 * (i.e. not running while enabled) during the interval since
+		 * start().
+		 */
+		inline
+		Counts
+		stop  // HwCounters::
+			()
+		{
+			Counts counts{ nullCounts() };
+#if defined(__linux__)
+			for (int const & fd : theFds)
+			{
+				if (! (fd < 0))
+				{
+					ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+				}
+			}
+			for (std::size_t nn{0u} ; nn < sNumEvents ; ++nn)
+			{
+				if (theFds[nn] < 0)
+				{
+					continue;
+				}
+				std::array<std::uint64_t, 3u> data{ 0u, 0u, 0u };
+				if (readData(theFds[nn], &data))
+				{
+					std::uint64_t const timeEnabled
+						{ data[1] - theStartTimes[nn][0] };
+					std::uint64_t const timeRunning
+						{ data[2] - theStartTimes[nn][1] };
+					if (0u < timeRunning)
+					{
+						counts[nn] = double(data[0])
+							* (double(timeEnabled) / double(timeRunning));
+					}
+				}
+			}
+#endif
+			return counts;
+		}
+
+	private:
+
+#if defined(__linux__)
+		//! Read (value, time enabled, time running) for counter fd
+		inline
+		static
+		bool
+		readData  // HwCounters::
+			( int const & fd
+			, std::array<std::uint64_t, 3u> * const & ptData
+			)
+		{
+			ssize_t const numRead
+				{ read(fd, ptData->data(), sizeof(*ptData)) };
+			return (sizeof(*ptData) == std::size_t(numRead));
+		}
+#endif
+
+		//! Open each event counter (those not supported remain closed)
+		inline
+		void
+		open  // HwCounters::
+			()
+		{
+#if defined(__linux__)
+			static std::array<std::uint64_t, sNumEvents> const configs
+				{ PERF_COUNT_HW_CPU_CYCLES
+				, PERF_COUNT_HW_INSTRUCTIONS
+				, PERF_COUNT_HW_CACHE_MISSES
+				, PERF_COUNT_HW_BRANCH_MISSES
+				};
+			int errNum{ 0 };
+			for (std::size_t nn{0u} ; nn < sNumEvents ; ++nn)
+			{
+				perf_event_attr attr{};
+				attr.size = sizeof(attr);
+				attr.type = PERF_TYPE_HARDWARE;
+				attr.config = configs[nn];
+				attr.disabled = 1;
+				attr.exclude_kernel = 1; // allowed with perf_event_paranoid 2
+				attr.exclude_hv = 1;
+				// include threads started later (not with PERF_FORMAT_GROUP)
+				attr.inherit = 1;
+				attr.read_format
+					= PERF_FORMAT_TOTAL_TIME_ENABLED
+					| PERF_FORMAT_TOTAL_TIME_RUNNING;
+				long const fd
+					{ syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0) };
+				if (fd < 0)
+				{
+					errNum = errno;
+				}
+				theFds[nn] = static_cast<int>(fd);
+			}
+			if (! isAvailable())
+			{
+				theNote = std::string("perf_event_open: ")
+					+ std::strerror(errNum);
+			}
+#else
+			theNote = "perf_event_open requires Linux";
+#endif
+		}
+
+	}; // HwCounters
+
+} // [bench]
+
+
+#endif // OriNet_bench_hwCounters_INCL_
@@ -0,0 +1,79 @@
+#
+# MIT License
+#
+# Copyright (c) 2024 Stellacore Corporation
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documentation files (the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to whom the Software is
+# furnished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included in
+# all copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+# SOFTWARE.
+#
+
+#
+# Run a benchmark program several times and then either compare the
+# (combined) results with a baseline (MODE=check) or save them as the
+# baseline (MODE=baseline). Used as a script ('cmake -P') with values:
+#
+#	MODE - 'check' or 'baseline'
+#	BENCH_PROG - benchmark program to run
+#	COMPARE_PROG - bench_compare program
+#	MAX_SIZE - maxSize argument for BENCH_PROG
+#	NUM_RUNS - number of times to run BENCH_PROG
+#	TOLERANCE - allowed fractional slow down (for MODE=check)
+#	BASELINE - baseline JSON file path
+#	WORK_DIR - directory for results from each run
+#
+
+file(MAKE_DIRECTORY ${WORK_DIR})
+
+set(RunFiles)
+foreach(RunNum RANGE 1 ${NUM_RUNS})
+
+	set(RunFile ${WORK_DIR}/run${RunNum}.json)
+	execute_process(
+		COMMAND ${BENCH_PROG} ${RunFile} ${MAX_SIZE}
+		RESULT_VARIABLE RunStatus
+		)
+	if(NOT RunStatus EQUAL 0)
+		message(FATAL_ERROR "Failure running ${BENCH_PROG} (${RunStatus})")
+	endif()
+	list(APPEND RunFiles ${RunFile})
+
+endforeach(RunNum RANGE 1 ${NUM_RUNS})
+
+if(MODE STREQUAL "baseline")
+
+	execute_process(
+		COMMAND ${COMPARE_PROG} --merge ${BASELINE} ${RunFiles}
+		RESULT_VARIABLE CompareStatus
+		)
+	if(NOT CompareStatus EQUAL 0)
+		message(FATAL_ERROR "Failure saving baseline ${BASELINE}")
+	endif()
+	message("Saved baseline: ${BASELINE}")
+
+else()
+
+	execute_process(
+		COMMAND
+			${COMPARE_PROG} --tolerance ${TOLERANCE} ${BASELINE} ${RunFiles}
+		RESULT_VARIABLE CompareStatus
+		)
+	if(NOT CompareStatus EQUAL 0)
+		message(FATAL_ERROR "Performance check failed: ${BENCH_PROG}")
+	endif()
+
+endif()
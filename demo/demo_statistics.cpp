@@ -29,7 +29,9 @@
 
 
 #include "OriNet/compare.hpp"
+#include "OriNet/monteCarlo.hpp"
 #include "OriNet/random.hpp"
+#include "OriNet/stat.hpp"
 
 #include <Engabra>
 #include <Rigibra>
@@ -67,6 +69,24 @@ namespace
 		return samps;
 	}
 
+	//! Statistics accumulated for each sigma{Loc,Ang} grid cell
+	struct CellStats
+	{
+		orinet::stat::Summary theMaxMag{};
+		orinet::stat::Summary theAveMag{};
+
+		//! Incorporate statistics from another (e.g. replicate) instance
+		inline
+		void
+		merge
+			( CellStats const & other
+			)
+		{
+			theMaxMag.merge(other.theMaxMag);
+			theAveMag.merge(other.theAveMag);
+		}
+	};
+
 }
 
 
@@ -99,11 +119,16 @@ main
 
 	For each combination of sigma{Loc,Ang} values, a collection of
 	rigibra::Transform objects from orinet::random::noisyTransforms()
-	are used to compute statistics.
+	are used to compute statistics. The combinations (and multiple
+	base transforms for each) are evaluated in parallel with
+	orinet::mc::cellResults().
 
-	Reported statistics include:
+	Reported statistics (mean, deviation, max for each cell) include:
 	 * orinet::compare::maxMagResultDifference()
 	 * orinet::compare::aveMagResultDifference()
+
+	The outfile is written in the (binary) orinet::mc::Columns format
+	with one row per sigma{Loc,Ang} combination.
 	)";
 	// [DoxyExample01]
 
@@ -116,13 +141,6 @@ main
 			;
 		return 1;
 	}
-	std::ofstream ofs(argv[1]);
-	ofs
-		<< '#' << "sigmaLoc"
-		<< ' ' << "sigmaAng"
-		<< ' ' << "maxMag"
-		<< ' ' << "aveMag"
-		<< '\n';
 
 	constexpr std::size_t numBaseXforms{ 32u };
 	constexpr std::size_t numMea{ 9u };
@@ -137,32 +155,29 @@ main
 	std::pair<double, double> const locMinMax{ -10., 10. };
 	std::pair<double, double> const angMinMax{ -pi, pi };
 
-	// generate statistics releative to multiple base transforms
-	for (std::size_t numBase{0u} ; numBase < numBaseXforms ; ++numBase)
-	{
-		// compute base transform
-		rigibra::Transform const xformBase
-			{ orinet::random::uniformTransform(locMinMax, angMinMax) };
-
-		for (double const & sigmaLoc : sigmaLocs)
-		{
-			for (double const & sigmaAng : sigmaAngs)
+	// statistics relative to one base transform for one grid cell
+	std::size_t const numCells{ sigmaLocs.size() * sigmaAngs.size() };
+	auto const taskFunc
+		{ [&] ( CellStats * const ptStats
+			, std::size_t const cellNdx
+			, std::size_t const // numBase
+			, orinet::random::Context & ctx
+			)
 			{
+				double const & sigmaLoc = sigmaLocs[cellNdx / sigmaAngs.size()];
+				double const & sigmaAng = sigmaAngs[cellNdx % sigmaAngs.size()];
+
+				// compute base transform
+				rigibra::Transform const xformBase
+					{ orinet::random::uniformTransform
+						(ctx, locMinMax, angMinMax)
+					};
+
 				std::vector<rigibra::Transform> const xformSamps
 					{ orinet::random::noisyTransforms
-						(xformBase, numMea, numErr, sigmaLoc, sigmaAng)
+						(ctx, xformBase, numMea, numErr, sigmaLoc, sigmaAng)
 					};
 
-				/*
-				std::cout << "\n\n";
-				std::cout << "xformBase: " << xformBase << '\n';
-				std::cout << '\n';
-				for (rigibra::Transform const & xformSamp : xformSamps)
-				{
-					std::cout << "xformSamp: " << xformSamp << '\n';
-				}
-				*/
-
 				for (rigibra::Transform const & xformSamp : xformSamps)
 				{
 					double const maxMag
@@ -177,18 +192,46 @@ main
 							)
 						};
 
-					using namespace engabra::g3::io;
-					ofs
-						<< ' ' << fixed(sigmaLoc)
-						<< ' ' << fixed(sigmaAng)
-						<< ' ' << fixed(maxMag)
-						<< ' ' << fixed(aveMag)
-						<< '\n';
+					ptStats->theMaxMag.add(maxMag);
+					ptStats->theAveMag.add(aveMag);
 				}
-				ofs << "\n\n";
-
 			}
-		}
+		};
+
+	// generate statistics relative to multiple base transforms
+	orinet::random::Context const ctx{};
+	std::vector<CellStats> const cellStats
+		{ orinet::mc::cellResults<CellStats>
+			(numCells, numBaseXforms, taskFunc, ctx)
+		};
+
+	// assemble results into columns
+	std::vector<std::string> const names
+		{ "sigmaLoc", "sigmaAng", "count"
+		, "maxMagMean", "maxMagDev", "maxMagMax"
+		, "aveMagMean", "aveMagDev", "aveMagMax"
+		};
+	std::vector<std::vector<double> > values
+		(names.size(), std::vector<double>(numCells));
+	for (std::size_t cellNdx{0u} ; cellNdx < numCells ; ++cellNdx)
+	{
+		CellStats const & stats = cellStats[cellNdx];
+		values[0][cellNdx] = sigmaLocs[cellNdx / sigmaAngs.size()];
+		values[1][cellNdx] = sigmaAngs[cellNdx % sigmaAngs.size()];
+		values[2][cellNdx] = static_cast<double>(stats.theMaxMag.count());
+		values[3][cellNdx] = stats.theMaxMag.mean();
+		values[4][cellNdx] = stats.theMaxMag.deviation();
+		values[5][cellNdx] = stats.theMaxMag.max();
+		values[6][cellNdx] = stats.theAveMag.mean();
+		values[7][cellNdx] = stats.theAveMag.deviation();
+		values[8][cellNdx] = stats.theAveMag.max();
+	}
+	orinet::mc::Columns cols;
+	for (std::size_t nCol{0u} ; nCol < names.size() ; ++nCol)
+	{
+		cols.addColumn(names[nCol], values[nCol]);
 	}
-}
 
+	std::ofstream ofs(argv[1], std::ios::binary);
+	return (cols.write(ofs) ? 0 : 1);
+}
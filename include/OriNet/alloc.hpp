@@ -0,0 +1,223 @@
+//
+// MIT License
+//
+// Copyright (c) 2024 Stellacore Corporation
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+
+#ifndef OriNet_alloc_INCL_
+#define OriNet_alloc_INCL_
+
+/*! \file
+\brief Opt-in counting of (global) memory allocations.
+
+Counters are incremented by replacements of the global operator
+new/delete functions that are provided by the separate support library,
+OriNet::AllocHook (src/allocHook.cpp). Programs (e.g. tests and
+benchmarks) that link with that library can measure the allocations
+made by a section of code (e.g. to assert that a hot path does not
+allocate in steady state). Programs that do not link with it use the
+standard allocation functions and all counts remain zero (which can
+be detected with isTracking()).
+
+Example:
+\snippet test_alloc.cpp DoxyExample01
+
+*/
+
+
+#include <atomic>
+#include <cstddef>
+#include <sstream>
+#include <string>
+
+
+namespace orinet
+{
+
+/*! \brief Allocation counting (requires linking with OriNet::AllocHook).
+ */
+namespace alloc
+{
+	//! Allocation activity (e.g. since start or within a Scope)
+	struct Counts
+	{
+		//! Number of calls to (any form of) operator new
+		std::size_t theNumAllocs{ 0u };
+
+		//! Number of calls to operator delete (for non-null pointers)
+		std::size_t theNumFrees{ 0u };
+
+		//! Total number of bytes requested from operator new
+		std::size_t theNumBytes{ 0u };
+
+		//! Activity between (earlier) beg and this instance
+		inline
+		Counts
+		since  // Counts::
+			( Counts const & beg
+			) const
+		{
+			return Counts
+				{ .theNumAllocs = theNumAllocs - beg.theNumAllocs
+				, .theNumFrees = theNumFrees - beg.theNumFrees
+				, .theNumBytes = theNumBytes - beg.theNumBytes
+				};
+		}
+
+		//! Descriptive information about this instance
+		inline
+		std::string
+		infoString  // Counts::
+			( std::string const & title = {}
+			) const
+		{
+			std::ostringstream oss;
+			if (! title.empty())
+			{
+				oss << title << ' ';
+			}
+			oss << "allocs: " << theNumAllocs
+				<< ' ' << "frees: " << theNumFrees
+				<< ' ' << "bytes: " << theNumBytes
+				;
+			return oss.str();
+		}
+
+	}; // Counts
+
+	//! Counters updated by OriNet::AllocHook (for internal use)
+	namespace detail
+	{
+		//! Set true (at static init) by OriNet::AllocHook
+		inline std::atomic<bool> sIsTracking{ false };
+
+		//! Counts for all threads
+		inline std::atomic<std::size_t> sNumAllocs{ 0u };
+		inline std::atomic<std::size_t> sNumFrees{ 0u };
+		inline std::atomic<std::size_t> sNumBytes{ 0u };
+
+		//! Counts for the current thread
+		inline thread_local std::size_t tNumAllocs{ 0u };
+		inline thread_local std::size_t tNumFrees{ 0u };
+		inline thread_local std::size_t tNumBytes{ 0u };
+
+		//! Update counters (called by replacement operator new)
+		inline
+		void
+		noteAlloc
+			( std::size_t const & size
+			) noexcept
+		{
+			sNumAllocs.fetch_add(1u, std::memory_order_relaxed);
+			sNumBytes.fetch_add(size, std::memory_order_relaxed);
+			++tNumAllocs;
+			tNumBytes += size;
+		}
+
+		//! Update counters (called by replacement operator delete)
+		inline
+		void
+		noteFree
+			() noexcept
+		{
+			sNumFrees.fetch_add(1u, std::memory_order_relaxed);
+			++tNumFrees;
+		}
+
+	} // [detail]
+
+	//! True if allocation counting hooks are linked into program
+	inline
+	bool
+	isTracking
+		()
+	{
+		return detail::sIsTracking.load();
+	}
+
+	//! Allocation activity (all threads) since program start
+	inline
+	Counts
+	processCounts
+		()
+	{
+		return Counts
+			{ .theNumAllocs = detail::sNumAllocs.load()
+			, .theNumFrees = detail::sNumFrees.load()
+			, .theNumBytes = detail::sNumBytes.load()
+			};
+	}
+
+	//! Allocation activity (by calling thread) since thread start
+	inline
+	Counts
+	threadCounts
+		()
+	{
+		return Counts
+			{ .theNumAllocs = detail::tNumAllocs
+			, .theNumFrees = detail::tNumFrees
+			, .theNumBytes = detail::tNumBytes
+			};
+	}
+
+	/*! \brief Allocation activity of calling thread during instance lifetime.
+	 *
+	 * Only allocations made by the thread that constructs the instance
+	 * are counted (so that other, concurrent, activity does not affect
+	 * a measurement). Use processCounts() for activity of all threads.
+	 *
+	 * Example:
+	 * \snippet test_alloc.cpp DoxyExample01
+	 */
+	class Scope
+	{
+		Counts const theBeg{ threadCounts() };
+
+	public:
+
+		//! Allocation activity since construction.
+		inline
+		Counts
+		counts  // Scope::
+			() const
+		{
+			return threadCounts().since(theBeg);
+		}
+
+		//! Number of allocations since construction.
+		inline
+		std::size_t
+		numAllocs  // Scope::
+			() const
+		{
+			return counts().theNumAllocs;
+		}
+
+	}; // Scope
+
+} // [alloc]
+
+} // [orinet]
+
+
+#endif // OriNet_alloc_INCL_
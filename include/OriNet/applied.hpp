@@ -0,0 +1,705 @@
+//
+// MIT License
+//
+// Copyright (c) 2024 Stellacore Corporation
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+
+#ifndef OriNet_applied_INCL_
+#define OriNet_applied_INCL_
+
+/*! \file
+\brief Transformation in "applied form" (3x3 rotation matrix plus offset).
+
+Each application of a rigibra::Attitude to a vector (i.e. att(vec))
+evaluates a spinor sandwich product. When the same attitude is applied
+to several vectors, it is less effort to form the rotation matrix once
+(from the rotated basis vectors) and then apply that to each vector.
+
+An applied::Xform has the same interpretation as rigibra::Transform
+(i.e. xform(vec) = att(vec - loc)) and is converted to and from that
+type. It is intended as a (local) cache within computation loops and
+not as a replacement for rigibra::Transform in interfaces.
+
+For many transformations, XformArrays stores the same values in
+structure-of-arrays layout and the batch kernels (composeEach(),
+inverseEach() and composeInverseEach()) operate on spans of these
+with simple loops that compilers can vectorize.
+
+Example:
+\snippet test_applied.cpp DoxyExample01
+
+*/
+
+
+#include "align.hpp"
+
+#include <Engabra>
+#include <Rigibra>
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <limits>
+#include <span>
+#include <vector>
+
+
+namespace orinet
+{
+
+/*! \brief Transformations in matrix form for repeated application.
+ */
+namespace applied
+{
+
+	//! Rotation matrix elements: [row][col]
+	using Rotation = std::array<std::array<double, 3u>, 3u>;
+
+	/*! \brief Rotation matrix plus offset: xform(vec) = rot*(vec - loc)
+	 *
+	 * Matrix columns are the (attitude) rotated basis vectors
+	 * {e1, e2, e3}. The offset has the same meaning as the
+	 * rigibra::Transform::theLoc member.
+	 */
+	struct Xform
+	{
+		//! Rotation matrix elements: theRot[row][col]
+		Rotation theRot
+			{{ { std::numeric_limits<double>::quiet_NaN(), 0., 0. }
+			 , { 0., std::numeric_limits<double>::quiet_NaN(), 0. }
+			 , { 0., 0., std::numeric_limits<double>::quiet_NaN() }
+			}};
+
+		//! Offset - same as rigibra::Transform::theLoc
+		engabra::g3::Vector theLoc{ engabra::g3::null<engabra::g3::Vector>() };
+
+		//! Default (null) instance
+		Xform
+			() = default;
+
+		//! Value ctor - matrix from attitude (2 sandwich products total)
+		inline
+		explicit
+		Xform  // Xform::
+			( rigibra::Transform const & xform
+			)
+			: theLoc{ xform.theLoc }
+		{
+			using namespace engabra::g3;
+			Vector const col0{ xform.theAtt(e1) };
+			Vector const col1{ xform.theAtt(e2) };
+			// (orthonormal) third column is cross product of first two
+			Vector const col2
+				{ col0[1]*col1[2] - col0[2]*col1[1]
+				, col0[2]*col1[0] - col0[0]*col1[2]
+				, col0[0]*col1[1] - col0[1]*col1[0]
+				};
+			for (std::size_t row{0u} ; row < 3u ; ++row)
+			{
+				theRot[row] = { col0[row], col1[row], col2[row] };
+			}
+		}
+
+		//! Rotated vector - same as (attitude) att(vec)
+		inline
+		engabra::g3::Vector
+		rotated  // Xform::
+			( engabra::g3::Vector const & vec
+			) const
+		{
+			Rotation const & rr = theRot;
+			return engabra::g3::Vector
+				{ rr[0][0]*vec[0] + rr[0][1]*vec[1] + rr[0][2]*vec[2]
+				, rr[1][0]*vec[0] + rr[1][1]*vec[1] + rr[1][2]*vec[2]
+				, rr[2][0]*vec[0] + rr[2][1]*vec[1] + rr[2][2]*vec[2]
+				};
+		}
+
+		//! Inversely rotated vector - same as inverse(att)(vec)
+		inline
+		engabra::g3::Vector
+		rotatedInverse  // Xform::
+			( engabra::g3::Vector const & vec
+			) const
+		{
+			Rotation const & rr = theRot;
+			return engabra::g3::Vector
+				{ rr[0][0]*vec[0] + rr[1][0]*vec[1] + rr[2][0]*vec[2]
+				, rr[0][1]*vec[0] + rr[1][1]*vec[1] + rr[2][1]*vec[2]
+				, rr[0][2]*vec[0] + rr[1][2]*vec[1] + rr[2][2]*vec[2]
+				};
+		}
+
+		//! Rotated basis vector (matrix column) - same as att(e_{ndx+1})
+		inline
+		engabra::g3::Vector
+		rotatedBasis  // Xform::
+			( std::size_t const & ndx
+			) const
+		{
+			return engabra::g3::Vector
+				{ theRot[0][ndx], theRot[1][ndx], theRot[2][ndx] };
+		}
+
+		//! Transformed vector - same as rigibra::Transform::operator()
+		inline
+		engabra::g3::Vector
+		operator()  // Xform::
+			( engabra::g3::Vector const & vec
+			) const
+		{
+			return rotated(vec - theLoc);
+		}
+
+		/*! \brief Equivalent rigibra::Transform.
+		 *
+		 * The attitude is reconstructed from the first two matrix
+		 * columns (by align::attitudeFromDirPairs()). This involves
+		 * more effort than the other operations here and is intended
+		 * for use once at the end of a computation sequence.
+		 */
+		inline
+		rigibra::Transform
+		transform  // Xform::
+			() const
+		{
+			using namespace engabra::g3;
+			static align::DirPair const refDirPair{ e1, e2 };
+			align::DirPair const bodDirPair
+				{ rotatedBasis(0u), rotatedBasis(1u) };
+			return rigibra::Transform
+				{ theLoc, align::attitudeFromDirPairs(refDirPair, bodDirPair) };
+		}
+
+	}; // Xform
+
+
+	//! True if all values of xform are valid
+	inline
+	bool
+	isValid
+		( Xform const & xform
+		)
+	{
+		bool okay{ engabra::g3::isValid(xform.theLoc) };
+		for (std::array<double, 3u> const & row : xform.theRot)
+		{
+			for (double const & elem : row)
+			{
+				okay = okay && engabra::g3::isValid(elem);
+			}
+		}
+		return okay;
+	}
+
+	//! Inverse transform - same as rigibra::inverse(Transform)
+	inline
+	Xform
+	inverse
+		( Xform const & xform
+		)
+	{
+		Xform inv;
+		for (std::size_t row{0u} ; row < 3u ; ++row)
+		{
+			for (std::size_t col{0u} ; col < 3u ; ++col)
+			{
+				inv.theRot[row][col] = xform.theRot[col][row];
+			}
+		}
+		inv.theLoc = -xform.rotated(xform.theLoc);
+		return inv;
+	}
+
+	/*! \brief Composition xCwA = xCwB * xBwA (as for rigibra::Transform)
+	 *
+	 * I.e. xCwA(vec) = xCwB(xBwA(vec)).
+	 */
+	inline
+	Xform
+	operator*
+		( Xform const & xCwB
+		, Xform const & xBwA
+		)
+	{
+		Xform xCwA;
+		for (std::size_t row{0u} ; row < 3u ; ++row)
+		{
+			for (std::size_t col{0u} ; col < 3u ; ++col)
+			{
+				xCwA.theRot[row][col]
+					= xCwB.theRot[row][0] * xBwA.theRot[0][col]
+					+ xCwB.theRot[row][1] * xBwA.theRot[1][col]
+					+ xCwB.theRot[row][2] * xBwA.theRot[2][col]
+					;
+			}
+		}
+		xCwA.theLoc = xBwA.theLoc + xBwA.rotatedInverse(xCwB.theLoc);
+		return xCwA;
+	}
+
+	//! Number of elements processed together in batch kernel loops
+	constexpr std::size_t sBatchLanes{ 64u };
+
+	/*! \brief Span views into structure-of-arrays applied form storage.
+	 *
+	 * The Value type is (double const) for input and (double) for
+	 * output of the batch kernels. Element ndx has rotation matrix
+	 * element [row][col] at theRots[3*row + col][ndx] and offset
+	 * component [kk] at theLocs[kk][ndx].
+	 */
+	template <typename Value>
+	struct XformSpans
+	{
+		//! Rotation matrix elements: theRots[3*row + col][element]
+		std::array<std::span<Value>, 9u> theRots{};
+
+		//! Offset components: theLocs[component][element]
+		std::array<std::span<Value>, 3u> theLocs{};
+
+		//! Number of elements
+		inline
+		std::size_t
+		size  // XformSpans::
+			() const
+		{
+			return theLocs[0].size();
+		}
+
+		//! View of elements [beg, beg+count)
+		inline
+		XformSpans
+		subspan  // XformSpans::
+			( std::size_t const & beg
+			, std::size_t const & count
+			) const
+		{
+			XformSpans sub;
+			for (std::size_t kk{0u} ; kk < 9u ; ++kk)
+			{
+				sub.theRots[kk] = theRots[kk].subspan(beg, count);
+			}
+			for (std::size_t kk{0u} ; kk < 3u ; ++kk)
+			{
+				sub.theLocs[kk] = theLocs[kk].subspan(beg, count);
+			}
+			return sub;
+		}
+
+	}; // XformSpans
+
+	//! Input (read only) views for batch kernels
+	using XformInSpans = XformSpans<double const>;
+
+	//! Output views for batch kernels
+	using XformOutSpans = XformSpans<double>;
+
+
+	//! Structure-of-arrays storage of applied form transformations.
+	struct XformArrays
+	{
+		//! Rotation matrix elements: theRots[3*row + col][element]
+		std::array<std::vector<double>, 9u> theRots{};
+
+		//! Offset components: theLocs[component][element]
+		std::array<std::vector<double>, 3u> theLocs{};
+
+		//! Construct with storage for numElem transforms
+		inline
+		explicit
+		XformArrays  // XformArrays::
+			( std::size_t const & numElem = 0u
+			)
+		{
+			resize(numElem);
+		}
+
+		//! Set number of elements
+		inline
+		void
+		resize  // XformArrays::
+			( std::size_t const & numElem
+			)
+		{
+			for (std::vector<double> & rots : theRots)
+			{
+				rots.resize(numElem);
+			}
+			for (std::vector<double> & locs : theLocs)
+			{
+				locs.resize(numElem);
+			}
+		}
+
+		//! Number of elements
+		inline
+		std::size_t
+		size  // XformArrays::
+			() const
+		{
+			return theLocs[0].size();
+		}
+
+		//! Views for use as batch kernel input
+		inline
+		XformInSpans
+		inSpans  // XformArrays::
+			() const
+		{
+			XformInSpans views;
+			for (std::size_t kk{0u} ; kk < 9u ; ++kk)
+			{
+				views.theRots[kk] = theRots[kk];
+			}
+			for (std::size_t kk{0u} ; kk < 3u ; ++kk)
+			{
+				views.theLocs[kk] = theLocs[kk];
+			}
+			return views;
+		}
+
+		//! Views for use as batch kernel output
+		inline
+		XformOutSpans
+		outSpans  // XformArrays::
+			()
+		{
+			XformOutSpans views;
+			for (std::size_t kk{0u} ; kk < 9u ; ++kk)
+			{
+				views.theRots[kk] = theRots[kk];
+			}
+			for (std::size_t kk{0u} ; kk < 3u ; ++kk)
+			{
+				views.theLocs[kk] = theLocs[kk];
+			}
+			return views;
+		}
+
+		//! Applied form for element ndx
+		inline
+		Xform
+		xform  // XformArrays::
+			( std::size_t const & ndx
+			) const
+		{
+			Xform app;
+			for (std::size_t row{0u} ; row < 3u ; ++row)
+			{
+				for (std::size_t col{0u} ; col < 3u ; ++col)
+				{
+					app.theRot[row][col] = theRots[3u*row + col][ndx];
+				}
+			}
+			app.theLoc = engabra::g3::Vector
+				{ theLocs[0][ndx], theLocs[1][ndx], theLocs[2][ndx] };
+			return app;
+		}
+
+		//! Set element ndx from applied form
+		inline
+		void
+		setXform  // XformArrays::
+			( std::size_t const & ndx
+			, Xform const & app
+			)
+		{
+			for (std::size_t row{0u} ; row < 3u ; ++row)
+			{
+				for (std::size_t col{0u} ; col < 3u ; ++col)
+				{
+					theRots[3u*row + col][ndx] = app.theRot[row][col];
+				}
+			}
+			for (std::size_t kk{0u} ; kk < 3u ; ++kk)
+			{
+				theLocs[kk][ndx] = app.theLoc[kk];
+			}
+		}
+
+		//! Transformation for element ndx (ref Xform::transform())
+		inline
+		rigibra::Transform
+		transform  // XformArrays::
+			( std::size_t const & ndx
+			) const
+		{
+			return xform(ndx).transform();
+		}
+
+		//! Set element ndx from (rigibra) transformation
+		inline
+		void
+		setTransform  // XformArrays::
+			( std::size_t const & ndx
+			, rigibra::Transform const & xform
+			)
+		{
+			setXform(ndx, Xform(xform));
+		}
+
+	}; // XformArrays
+
+
+	//! Copy outs[nn] = srcs[ndxs[nn]] (e.g. to make kernel input contiguous)
+	inline
+	void
+	gatherEach
+		( XformOutSpans const & outs
+		, XformInSpans const & srcs
+		, std::span<std::size_t const> const & ndxs
+		)
+	{
+		for (std::size_t kk{0u} ; kk < 9u ; ++kk)
+		{
+			double const * const src = srcs.theRots[kk].data();
+			double * const out = outs.theRots[kk].data();
+			for (std::size_t nn{0u} ; nn < ndxs.size() ; ++nn)
+			{
+				out[nn] = src[ndxs[nn]];
+			}
+		}
+		for (std::size_t kk{0u} ; kk < 3u ; ++kk)
+		{
+			double const * const src = srcs.theLocs[kk].data();
+			double * const out = outs.theLocs[kk].data();
+			for (std::size_t nn{0u} ; nn < ndxs.size() ; ++nn)
+			{
+				out[nn] = src[ndxs[nn]];
+			}
+		}
+	}
+
+	//! Lane values for a group of (batch kernel) elements
+	struct LaneXforms
+	{
+		//! Rotation elements: theRots[3*row + col][lane]
+		std::array<std::array<double, sBatchLanes>, 9u> theRots;
+
+		//! Offset components: theLocs[component][lane]
+		std::array<std::array<double, sBatchLanes>, 3u> theLocs;
+
+		//! Copy lanes [0, numLanes) into outs elements [beg, beg+numLanes)
+		inline
+		void
+		storeInto  // LaneXforms::
+			( XformOutSpans const & outs
+			, std::size_t const & beg
+			, std::size_t const & numLanes
+			) const
+		{
+			for (std::size_t kk{0u} ; kk < 9u ; ++kk)
+			{
+				std::copy_n(theRots[kk].cbegin(), numLanes
+					, outs.theRots[kk].begin() + beg);
+			}
+			for (std::size_t kk{0u} ; kk < 3u ; ++kk)
+			{
+				std::copy_n(theLocs[kk].cbegin(), numLanes
+					, outs.theLocs[kk].begin() + beg);
+			}
+		}
+
+	}; // LaneXforms
+
+	/*! \brief Batch composition: outs[nn] = as[nn] * bs[nn]
+	 *
+	 * Composition is as for operator*(Xform, Xform). All spans must
+	 * have the same size. Output may overlap either input. Inner
+	 * loops operate on groups of sBatchLanes elements with simple
+	 * arithmetic (intended for compiler auto-vectorization).
+	 */
+	inline
+	void
+	composeEach
+		( XformOutSpans const & outs
+		, XformInSpans const & as
+		, XformInSpans const & bs
+		)
+	{
+		LaneXforms lanes;
+		std::size_t const numElem{ outs.size() };
+		for (std::size_t grp{0u} ; grp < numElem ; grp += sBatchLanes)
+		{
+			std::size_t const num{ std::min(sBatchLanes, numElem - grp) };
+			for (std::size_t row{0u} ; row < 3u ; ++row)
+			{
+				double const * const a0 = as.theRots[3u*row + 0u].data() + grp;
+				double const * const a1 = as.theRots[3u*row + 1u].data() + grp;
+				double const * const a2 = as.theRots[3u*row + 2u].data() + grp;
+				for (std::size_t col{0u} ; col < 3u ; ++col)
+				{
+					double const * const b0 = bs.theRots[col].data() + grp;
+					double const * const b1 = bs.theRots[3u + col].data() + grp;
+					double const * const b2 = bs.theRots[6u + col].data() + grp;
+					double * const rr = lanes.theRots[3u*row + col].data();
+					for (std::size_t lane{0u} ; lane < num ; ++lane)
+					{
+						rr[lane] = a0[lane] * b0[lane]
+							+ a1[lane] * b1[lane]
+							+ a2[lane] * b2[lane];
+					}
+				}
+			}
+			// loc = bLoc + inverse(bRot)(aLoc)
+			double const * const ta0 = as.theLocs[0].data() + grp;
+			double const * const ta1 = as.theLocs[1].data() + grp;
+			double const * const ta2 = as.theLocs[2].data() + grp;
+			for (std::size_t col{0u} ; col < 3u ; ++col)
+			{
+				double const * const b0 = bs.theRots[col].data() + grp;
+				double const * const b1 = bs.theRots[3u + col].data() + grp;
+				double const * const b2 = bs.theRots[6u + col].data() + grp;
+				double const * const tb = bs.theLocs[col].data() + grp;
+				double * const tt = lanes.theLocs[col].data();
+				for (std::size_t lane{0u} ; lane < num ; ++lane)
+				{
+					tt[lane] = tb[lane]
+						+ b0[lane] * ta0[lane]
+						+ b1[lane] * ta1[lane]
+						+ b2[lane] * ta2[lane];
+				}
+			}
+			lanes.storeInto(outs, grp, num);
+		}
+	}
+
+	/*! \brief Batch inversion: outs[nn] = inverse(as[nn])
+	 *
+	 * Inversion is as for inverse(Xform). Output may overlap input.
+	 */
+	inline
+	void
+	inverseEach
+		( XformOutSpans const & outs
+		, XformInSpans const & as
+		)
+	{
+		LaneXforms lanes;
+		std::size_t const numElem{ outs.size() };
+		for (std::size_t grp{0u} ; grp < numElem ; grp += sBatchLanes)
+		{
+			std::size_t const num{ std::min(sBatchLanes, numElem - grp) };
+			for (std::size_t row{0u} ; row < 3u ; ++row)
+			{
+				for (std::size_t col{0u} ; col < 3u ; ++col)
+				{
+					std::copy_n(as.theRots[3u*col + row].begin() + grp, num
+						, lanes.theRots[3u*row + col].begin());
+				}
+			}
+			// loc = -rot(loc)
+			double const * const t0 = as.theLocs[0].data() + grp;
+			double const * const t1 = as.theLocs[1].data() + grp;
+			double const * const t2 = as.theLocs[2].data() + grp;
+			for (std::size_t row{0u} ; row < 3u ; ++row)
+			{
+				double const * const r0 = as.theRots[3u*row + 0u].data() + grp;
+				double const * const r1 = as.theRots[3u*row + 1u].data() + grp;
+				double const * const r2 = as.theRots[3u*row + 2u].data() + grp;
+				double * const tt = lanes.theLocs[row].data();
+				for (std::size_t lane{0u} ; lane < num ; ++lane)
+				{
+					tt[lane] = -(r0[lane] * t0[lane]
+						+ r1[lane] * t1[lane]
+						+ r2[lane] * t2[lane]);
+				}
+			}
+			lanes.storeInto(outs, grp, num);
+		}
+	}
+
+	/*! \brief Batch relative transform: outs[nn] = as[nn] * inverse(bs[nn])
+	 *
+	 * Same as composeEach() with inverseEach() of bs - but in one
+	 * pass. E.g. relative orientation of station 'a' with respect to
+	 * station 'b' from both of their orientations with respect to
+	 * a common reference frame. Output may overlap either input.
+	 */
+	inline
+	void
+	composeInverseEach
+		( XformOutSpans const & outs
+		, XformInSpans const & as
+		, XformInSpans const & bs
+		)
+	{
+		LaneXforms lanes;
+		std::size_t const numElem{ outs.size() };
+		for (std::size_t grp{0u} ; grp < numElem ; grp += sBatchLanes)
+		{
+			std::size_t const num{ std::min(sBatchLanes, numElem - grp) };
+			// rot = aRot * transpose(bRot)
+			for (std::size_t row{0u} ; row < 3u ; ++row)
+			{
+				double const * const a0 = as.theRots[3u*row + 0u].data() + grp;
+				double const * const a1 = as.theRots[3u*row + 1u].data() + grp;
+				double const * const a2 = as.theRots[3u*row + 2u].data() + grp;
+				for (std::size_t col{0u} ; col < 3u ; ++col)
+				{
+					std::size_t const bb{ 3u*col };
+					double const * const b0 = bs.theRots[bb].data() + grp;
+					double const * const b1 = bs.theRots[bb + 1u].data() + grp;
+					double const * const b2 = bs.theRots[bb + 2u].data() + grp;
+					double * const rr = lanes.theRots[3u*row + col].data();
+					for (std::size_t lane{0u} ; lane < num ; ++lane)
+					{
+						rr[lane] = a0[lane] * b0[lane]
+							+ a1[lane] * b1[lane]
+							+ a2[lane] * b2[lane];
+					}
+				}
+			}
+			// loc = bRot(aLoc - bLoc)
+			std::array<std::array<double, sBatchLanes>, 3u> dts;
+			for (std::size_t kk{0u} ; kk < 3u ; ++kk)
+			{
+				double const * const ta = as.theLocs[kk].data() + grp;
+				double const * const tb = bs.theLocs[kk].data() + grp;
+				for (std::size_t lane{0u} ; lane < num ; ++lane)
+				{
+					dts[kk][lane] = ta[lane] - tb[lane];
+				}
+			}
+			for (std::size_t row{0u} ; row < 3u ; ++row)
+			{
+				double const * const b0 = bs.theRots[3u*row + 0u].data() + grp;
+				double const * const b1 = bs.theRots[3u*row + 1u].data() + grp;
+				double const * const b2 = bs.theRots[3u*row + 2u].data() + grp;
+				double * const tt = lanes.theLocs[row].data();
+				for (std::size_t lane{0u} ; lane < num ; ++lane)
+				{
+					tt[lane] = b0[lane] * dts[0][lane]
+						+ b1[lane] * dts[1][lane]
+						+ b2[lane] * dts[2][lane];
+				}
+			}
+			lanes.storeInto(outs, grp, num);
+		}
+	}
+
+} // [applied]
+
+} // [orinet]
+
+
+#endif // OriNet_applied_INCL_
@@ -0,0 +1,756 @@
+//
+// MIT License
+//
+// Copyright (c) 2024 Stellacore Corporation
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+
+#ifndef OriNet_checkpoint_INCL_
+#define OriNet_checkpoint_INCL_
+
+/*! \file
+\brief Incremental (crash safe) checkpoint and restore of network Geometry.
+
+A checkpoint::Writer saves network::Geometry state (stations and edges
+including EdgeRobust tracker contents) into numbered files in a
+checkpoint directory:
+\arg saveFull() - every station and edge
+\arg saveIncremental() - only stations and edges changed since the
+previous save (ref network::Geometry::takeChanges()). Change noting
+is enabled on the network by the first save (which is then a full one)
+
+The (changed part of the) network is encoded into memory on the calling
+thread such that the checkpoint content is a consistent snapshot. The
+file is written by a background thread while the caller continues to
+modify the network (e.g. ingest more observations). Each file is
+written to a temporary name, synced and then renamed such that an
+interruption never leaves a partial checkpoint file. After a full
+checkpoint is complete, the older checkpoint files are removed.
+
+The function checkpoint::restore() rebuilds a network from the most
+recent full checkpoint and the (valid) incremental ones after it.
+
+Files are in native byte order (and Transform memory layout) and are
+intended for restarting on the same platform.
+
+Example:
+\snippet test_checkpoint.cpp DoxyExample01
+
+*/
+
+
+#include "checksum.hpp"
+#include "networkGeometry.hpp"
+#include "trace.hpp"
+
+#include <Engabra>
+#include <Rigibra>
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#	include <fcntl.h>
+#	include <unistd.h>
+#	define OriNet_checkpoint_FSYNC
+#endif
+
+
+namespace orinet
+{
+
+/*! \brief Checkpoint (and restore) network state.
+ */
+namespace checkpoint
+{
+	//! Identification for start of file
+	constexpr std::array<char, 8u> sFileMagic
+		{ 'O', 'r', 'i', 'N', 'e', 't', 'C', '1' };
+
+	//! File format version
+	constexpr std::uint32_t sVersion{ 1u };
+
+	//! Transforms are saved as memory images (exact values)
+	static_assert(std::is_trivially_copyable_v<rigibra::Transform>);
+
+	//! Types of edges that are saved
+	enum EdgeType : std::uint32_t
+		{ Unknown = 0u
+		, Ori = 1u
+		, Robust = 2u
+		};
+
+	//! Start of every checkpoint file
+	struct FileHeader
+	{
+		std::array<char, 8u> theMagic{ sFileMagic };
+		std::uint32_t theVersion{ sVersion };
+		std::uint32_t theXformSize{ sizeof(rigibra::Transform) };
+		std::uint64_t theSequence{ 0u };
+		std::uint32_t theIsFull{ 0u };
+		std::uint32_t theReserved{ 0u };
+		std::uint64_t theNumStas{ 0u };
+		std::uint64_t theNumEdges{ 0u };
+
+		//! True if consistent with this implementation
+		inline
+		bool
+		isValid  // FileHeader::
+			() const
+		{
+			return
+				(  (sFileMagic == theMagic)
+				&& (sVersion == theVersion)
+				&& (sizeof(rigibra::Transform) == theXformSize)
+				);
+		}
+
+	}; // FileHeader
+
+	static_assert(48u == sizeof(FileHeader));
+
+	//! Write binary (memory image) of value to stream
+	template <typename Type>
+	inline
+	void
+	put
+		( std::ostream & ostrm
+		, Type const & value
+		)
+	{
+		static_assert(std::is_trivially_copyable_v<Type>);
+		ostrm.write(reinterpret_cast<char const *>(&value), sizeof(Type));
+	}
+
+	//! Read value written by put() - returns stream status
+	template <typename Type>
+	inline
+	bool
+	get
+		( std::istream & istrm
+		, Type & value
+		)
+	{
+		static_assert(std::is_trivially_copyable_v<Type>);
+		istrm.read(reinterpret_cast<char *>(&value), sizeof(Type));
+		return istrm.good();
+	}
+
+	/*! \brief Save edge to stream (false if edge type is not supported).
+	 *
+	 * EdgeOri and EdgeRobust (including tracker, time stamped
+	 * observations and forgetting policy) are supported.
+	 */
+	inline
+	bool
+	putEdge
+		( std::ostream & ostrm
+		, network::EdgeBase const & edge
+		)
+	{
+		using network::EdgeOri;
+		using network::EdgeRobust;
+		bool okay{ true };
+		std::uint64_t const fromKey{ edge.fromKey() };
+		std::uint64_t const intoKey{ edge.intoKey() };
+		if (EdgeRobust const * const ptRobust
+			= dynamic_cast<EdgeRobust const *>(&edge))
+		{
+			put(ostrm, EdgeType::Robust);
+			put(ostrm, fromKey);
+			put(ostrm, intoKey);
+			stat::track::Forgetting const & forgetting
+				= ptRobust->theForgetting;
+			put(ostrm, forgetting.theDecayTime);
+			put(ostrm, forgetting.theMinWeight);
+			put(ostrm, std::uint64_t{ forgetting.theMaxSize });
+			ptRobust->theXformTracker.writeTo(ostrm);
+			put(ostrm, std::uint64_t{ ptRobust->theTimedXforms.size() });
+			for (std::pair<double, rigibra::Transform> const & timedXform
+				: ptRobust->theTimedXforms)
+			{
+				put(ostrm, timedXform.first);
+				put(ostrm, timedXform.second);
+			}
+		}
+		else
+		if (EdgeOri const * const ptOri = dynamic_cast<EdgeOri const *>(&edge))
+		{
+			put(ostrm, EdgeType::Ori);
+			put(ostrm, fromKey);
+			put(ostrm, intoKey);
+			put(ostrm, ptOri->theXform);
+			put(ostrm, ptOri->theFitErr);
+		}
+		else
+		{
+			okay = false;
+		}
+		return okay;
+	}
+
+	//! Edge restored from stream (null if stream data are not valid)
+	inline
+	std::shared_ptr<network::EdgeBase>
+	getEdge
+		( std::istream & istrm
+		)
+	{
+		using network::EdgeDir;
+		std::shared_ptr<network::EdgeBase> ptEdge{ nullptr };
+		EdgeType edgeType{ EdgeType::Unknown };
+		std::uint64_t fromKey{ 0u };
+		std::uint64_t intoKey{ 0u };
+		get(istrm, edgeType);
+		get(istrm, fromKey);
+		get(istrm, intoKey);
+		EdgeDir const edgeDir{ fromKey, intoKey };
+		if (EdgeType::Robust == edgeType)
+		{
+			stat::track::Forgetting forgetting{};
+			std::uint64_t maxSize{ 0u };
+			get(istrm, forgetting.theDecayTime);
+			get(istrm, forgetting.theMinWeight);
+			get(istrm, maxSize);
+			forgetting.theMaxSize = static_cast<std::size_t>(maxSize);
+
+			std::shared_ptr<network::EdgeRobust> const ptRobust
+				{ std::make_shared<network::EdgeRobust>(edgeDir, 0u) };
+			ptRobust->theForgetting = forgetting;
+			bool okay{ ptRobust->theXformTracker.readFrom(istrm) };
+			std::uint64_t numTimed{ 0u };
+			okay = okay && get(istrm, numTimed);
+			for (std::uint64_t nn{0u} ; okay && (nn < numTimed) ; ++nn)
+			{
+				std::pair<double, rigibra::Transform> timedXform{};
+				okay = get(istrm, timedXform.first)
+					&& get(istrm, timedXform.second);
+				ptRobust->theTimedXforms.emplace_back(timedXform);
+			}
+			if (okay)
+			{
+				ptEdge = ptRobust;
+			}
+		}
+		else
+		if (EdgeType::Ori == edgeType)
+		{
+			rigibra::Transform xform{};
+			double fitErr{ engabra::g3::null<double>() };
+			get(istrm, xform);
+			if (get(istrm, fitErr))
+			{
+				ptEdge = std::make_shared<network::EdgeOri>
+					(edgeDir, xform, fitErr);
+			}
+		}
+		return ptEdge;
+	}
+
+	/*! \brief Encoded checkpoint file content for changes in geo.
+	 *
+	 * The result includes a header, the station keys (in vertex
+	 * order), the edges and a trailing checksum.
+	 */
+	inline
+	std::string
+	encodedChanges
+		( network::Geometry const & geo
+		, network::ChangeSet const & changes
+		, std::uint64_t const & sequence
+		, bool const & isFull
+		)
+	{
+		OriNet_TRACE_SPAN("checkpoint::encodedChanges");
+
+		std::ostringstream body(std::ios::out | std::ios::binary);
+		for (network::StaKey const & staKey : changes.theStaKeys)
+		{
+			put(body, std::uint64_t{ staKey });
+		}
+		std::uint64_t numEdges{ 0u };
+		for (std::pair<network::StaKey, network::StaKey> const & edgeKey
+			: changes.theEdgeKeys)
+		{
+			network::EdgeDir const edgeDir{ edgeKey.first, edgeKey.second };
+			std::shared_ptr<network::EdgeBase> const ptEdge
+				{ geo.edge(edgeDir) };
+			if (ptEdge && putEdge(body, *ptEdge))
+			{
+				++numEdges;
+			}
+			else
+			{
+				std::cerr << "checkpoint: skipping unsupported edge:"
+					<< ' ' << edgeDir << '\n';
+			}
+		}
+
+		FileHeader header{};
+		header.theSequence = sequence;
+		header.theIsFull = isFull ? 1u : 0u;
+		header.theNumStas = changes.theStaKeys.size();
+		header.theNumEdges = numEdges;
+
+		std::string bytes(sizeof(FileHeader), '\0');
+		std::memcpy(bytes.data(), &header, sizeof(FileHeader));
+		bytes.append(body.str());
+		std::uint64_t const sum
+			{ checksum::checksumOf
+				( reinterpret_cast<unsigned char const *>(bytes.data())
+				, bytes.size()
+				)
+			};
+		bytes.append(reinterpret_cast<char const *>(&sum), sizeof(sum));
+		return bytes;
+	}
+
+	//! Contents of one checkpoint file
+	struct Content
+	{
+		FileHeader theHeader{};
+		std::vector<network::StaKey> theStaKeys{};
+		std::vector<std::shared_ptr<network::EdgeBase> > theEdges{};
+	};
+
+	/*! \brief Decode checkpoint file data (produced by encodedChanges()).
+	 *
+	 * Returns false if the data are incomplete or inconsistent (e.g.
+	 * wrong format or checksum mismatch).
+	 */
+	inline
+	bool
+	decodeContent
+		( std::string const & bytes
+		, Content * const & ptContent
+		)
+	{
+		bool okay{ false };
+		std::size_t const minSize{ sizeof(FileHeader) + sizeof(std::uint64_t) };
+		if (ptContent && (minSize <= bytes.size()))
+		{
+			std::size_t const dataSize{ bytes.size() - sizeof(std::uint64_t) };
+			std::uint64_t expSum{ 0u };
+			std::memcpy(&expSum, bytes.data() + dataSize, sizeof(expSum));
+			std::uint64_t const gotSum
+				{ checksum::checksumOf
+					( reinterpret_cast<unsigned char const *>(bytes.data())
+					, dataSize
+					)
+				};
+			FileHeader & header = ptContent->theHeader;
+			std::memcpy(&header, bytes.data(), sizeof(FileHeader));
+			okay = (expSum == gotSum) && header.isValid();
+			if (okay)
+			{
+				std::size_t const bodySize{ dataSize - sizeof(FileHeader) };
+				std::istringstream istrm
+					( bytes.substr(sizeof(FileHeader), bodySize)
+					, std::ios::in | std::ios::binary
+					);
+				ptContent->theStaKeys.clear();
+				ptContent->theEdges.clear();
+				for (std::uint64_t nn{0u} ; okay && (nn < header.theNumStas)
+					; ++nn)
+				{
+					std::uint64_t staKey{ 0u };
+					okay = get(istrm, staKey);
+					ptContent->theStaKeys.emplace_back(staKey);
+				}
+				for (std::uint64_t nn{0u} ; okay && (nn < header.theNumEdges)
+					; ++nn)
+				{
+					std::shared_ptr<network::EdgeBase> const ptEdge
+						{ getEdge(istrm) };
+					okay = (nullptr != ptEdge);
+					ptContent->theEdges.emplace_back(ptEdge);
+				}
+			}
+		}
+		return okay;
+	}
+
+	//! Name of checkpoint file for sequence number
+	inline
+	std::filesystem::path
+	pathFor
+		( std::filesystem::path const & dir
+		, std::uint64_t const & sequence
+		)
+	{
+		char name[32];
+		std::snprintf
+			( name, sizeof(name), "checkpoint_%012llu.onc"
+			, static_cast<unsigned long long>(sequence)
+			);
+		return (dir / name);
+	}
+
+	//! Checkpoint files (by sequence number) in directory
+	inline
+	std::map<std::uint64_t, std::filesystem::path>
+	checkpointPaths
+		( std::filesystem::path const & dir
+		)
+	{
+		std::map<std::uint64_t, std::filesystem::path> paths;
+		std::error_code ec{};
+		for (std::filesystem::directory_entry const & entry
+			: std::filesystem::directory_iterator(dir, ec))
+		{
+			std::string const stem{ entry.path().stem().string() };
+			unsigned long long sequence{ 0u };
+			int numChars{ 0 };
+			int const numGot
+				{ std::sscanf
+					(stem.c_str(), "checkpoint_%llu%n", &sequence, &numChars)
+				};
+			if (  (".onc" == entry.path().extension())
+			   && (1 == numGot)
+			   && (stem.size() == static_cast<std::size_t>(numChars))
+			   )
+			{
+				paths[sequence] = entry.path();
+			}
+		}
+		return paths;
+	}
+
+	//! Write bytes to path such that path is either complete or absent
+	inline
+	bool
+	writeAtomically
+		( std::filesystem::path const & path
+		, std::string const & bytes
+		)
+	{
+		OriNet_TRACE_SPAN("checkpoint::writeAtomically");
+
+		std::filesystem::path tmpPath{ path };
+		tmpPath += ".tmp";
+		bool okay{ false };
+		{
+			std::ofstream ofs(tmpPath, std::ios::binary | std::ios::trunc);
+			ofs.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+			ofs.flush();
+			okay = ofs.good();
+		}
+#		if defined(OriNet_checkpoint_FSYNC)
+		if (okay)
+		{
+			int const fd{ ::open(tmpPath.c_str(), O_RDONLY) };
+			okay = (! (fd < 0)) && (0 == ::fsync(fd));
+			if (! (fd < 0))
+			{
+				::close(fd);
+			}
+		}
+#		endif
+		std::error_code ec{};
+		if (okay)
+		{
+			std::filesystem::rename(tmpPath, path, ec);
+			okay = (! ec);
+		}
+#		if defined(OriNet_checkpoint_FSYNC)
+		if (okay)
+		{
+			// the rename (directory entry) must also reach the disk
+			std::filesystem::path dirPath{ path.parent_path() };
+			if (dirPath.empty())
+			{
+				dirPath = ".";
+			}
+			int const fd{ ::open(dirPath.c_str(), O_RDONLY | O_DIRECTORY) };
+			okay = (! (fd < 0)) && (0 == ::fsync(fd));
+			if (! (fd < 0))
+			{
+				::close(fd);
+			}
+		}
+#		endif
+		if (! okay)
+		{
+			std::filesystem::remove(tmpPath, ec);
+		}
+		return okay;
+	}
+
+
+	/*! \brief Save (full and incremental) network checkpoints to directory.
+	 *
+	 * At most one file write is in progress at a time. A save call
+	 * waits for completion of the previous write (if any) before
+	 * starting its own. If a write fails, the next save is a full
+	 * one (since the changes in the failed one are otherwise lost).
+	 */
+	class Writer
+	{
+		std::filesystem::path theDir{};
+		std::uint64_t theNextSeq{ 1u };
+		bool theNeedFull{ true };
+		std::thread theThread{};
+		bool theWriteOkay{ true };
+
+		//! Encode changes (now) and write file (in background)
+		inline
+		std::size_t
+		start  // Writer::
+			( network::Geometry & geo
+			, bool const & wantFull
+			)
+		{
+			bool const isOkay{ wait() };
+			// without noted changes, only a full save is complete
+			bool const wasTracked{ geo.tracksChanges() };
+			geo.trackChanges(true);
+			bool const isFull
+				{ wantFull || theNeedFull || (! isOkay) || (! wasTracked) };
+			network::ChangeSet changes{ geo.takeChanges() };
+			if (isFull)
+			{
+				changes = geo.allContents();
+			}
+			std::uint64_t const sequence{ theNextSeq++ };
+			std::string bytes
+				{ encodedChanges(geo, changes, sequence, isFull) };
+			theNeedFull = false;
+
+			std::filesystem::path const dir{ theDir };
+			theThread = std::thread
+				( [this, dir, sequence, isFull, bytes = std::move(bytes)] ()
+				{
+					std::filesystem::path const path{ pathFor(dir, sequence) };
+					theWriteOkay = writeAtomically(path, bytes);
+					if (! theWriteOkay)
+					{
+						std::cerr << "checkpoint::Writer: failed to write "
+							<< path << '\n';
+					}
+					else
+					if (isFull)
+					{
+						// older checkpoints are no longer needed
+						for (std::pair<std::uint64_t const
+							, std::filesystem::path> const & seqPath
+							: checkpointPaths(dir))
+						{
+							if (seqPath.first < sequence)
+							{
+								std::error_code ec{};
+								std::filesystem::remove(seqPath.second, ec);
+							}
+						}
+					}
+				}
+				);
+			return changes.theEdgeKeys.size();
+		}
+
+	public:
+
+		/*! \brief Writer for checkpoint files in directory dir.
+		 *
+		 * The directory is created if needed. Numbering continues after
+		 * any checkpoint files already in dir (e.g. after restore()).
+		 * The first save is a full one unless dir already contains a
+		 * full checkpoint.
+		 */
+		inline
+		explicit
+		Writer  // Writer::
+			( std::filesystem::path const & dir
+			)
+			: theDir{ dir }
+		{
+			std::error_code ec{};
+			std::filesystem::create_directories(theDir, ec);
+			for (std::pair<std::uint64_t const, std::filesystem::path>
+				const & seqPath : checkpointPaths(theDir))
+			{
+				theNextSeq = std::max(theNextSeq, seqPath.first + 1u);
+				std::ifstream ifs(seqPath.second, std::ios::binary);
+				FileHeader header{};
+				if (get(ifs, header) && header.isValid() && header.theIsFull)
+				{
+					theNeedFull = false;
+				}
+			}
+		}
+
+		//! Wait for completion of background write
+		inline
+		~Writer  // Writer::
+			()
+		{
+			wait();
+		}
+
+		Writer(Writer const &) = delete;
+		Writer & operator=(Writer const &) = delete;
+
+		/*! \brief Save stations and edges changed since the previous save.
+		 *
+		 * The changes are encoded before return (after which geo may
+		 * be modified) and written to file in the background.
+		 *
+		 * Returns the number of edges in the checkpoint.
+		 */
+		inline
+		std::size_t
+		saveIncremental  // Writer::
+			( network::Geometry & geo
+			)
+		{
+			return start(geo, false);
+		}
+
+		//! Save all stations and edges (as saveIncremental()).
+		inline
+		std::size_t
+		saveFull  // Writer::
+			( network::Geometry & geo
+			)
+		{
+			return start(geo, true);
+		}
+
+		//! Wait for background write (if any), true if it was successful
+		inline
+		bool
+		wait  // Writer::
+			()
+		{
+			if (theThread.joinable())
+			{
+				theThread.join();
+			}
+			return theWriteOkay;
+		}
+
+	}; // Writer
+
+
+	/*! \brief Rebuild network from checkpoint files in directory.
+	 *
+	 * The most recent valid full checkpoint and (in sequence) each
+	 * following incremental checkpoint are applied. An incremental
+	 * checkpoint that is not valid ends the restoration (since
+	 * following ones could depend on its content).
+	 *
+	 * Stations are added in their original (vertex) order, then edges
+	 * (in station key order) with the most recently saved content of
+	 * each. The network, geo, should be empty on input. On return,
+	 * geo has no noted changes and notes further ones (ref
+	 * network::Geometry::trackChanges()).
+	 *
+	 * Returns the number of checkpoint files applied (zero if there is
+	 * no valid full checkpoint).
+	 */
+	inline
+	std::size_t
+	restore
+		( std::filesystem::path const & dir
+		, network::Geometry & geo
+		)
+	{
+		OriNet_TRACE_SPAN("checkpoint::restore");
+
+		using EdgeKey = std::pair<network::StaKey, network::StaKey>;
+		using SeqPaths = std::map<std::uint64_t, std::filesystem::path>;
+		SeqPaths const paths{ checkpointPaths(dir) };
+
+		// decode files (newest first) back to a full checkpoint
+		std::vector<Content> contents;
+		for (SeqPaths::const_reverse_iterator
+			iter{paths.crbegin()} ; paths.crend() != iter ; ++iter)
+		{
+			std::ifstream ifs(iter->second, std::ios::binary);
+			std::ostringstream oss(std::ios::out | std::ios::binary);
+			oss << ifs.rdbuf();
+			Content content{};
+			if (decodeContent(oss.str(), &content))
+			{
+				bool const isFull{ 0u != content.theHeader.theIsFull };
+				contents.emplace_back(std::move(content));
+				if (isFull)
+				{
+					break;
+				}
+			}
+			else
+			{
+				// newer ones (after a bad one) can not be used
+				std::cerr << "checkpoint::restore: invalid file "
+					<< iter->second << '\n';
+				contents.clear();
+			}
+		}
+
+		std::size_t numApplied{ 0u };
+		if ((! contents.empty()) && contents.back().theHeader.theIsFull)
+		{
+			// apply in sequence: stations directly, edges latest content
+			std::map<EdgeKey, std::shared_ptr<network::EdgeBase> > edges;
+			for (std::vector<Content>::const_reverse_iterator
+				iter{contents.crbegin()} ; contents.crend() != iter ; ++iter)
+			{
+				geo.insertStations(iter->theStaKeys);
+				for (std::shared_ptr<network::EdgeBase> const & ptEdge
+					: iter->theEdges)
+				{
+					edges[network::ChangeSet::edgeKeyFor(ptEdge->edgeDir())]
+						= ptEdge;
+				}
+				++numApplied;
+			}
+			for (std::pair<EdgeKey const, std::shared_ptr<network::EdgeBase> >
+				const & edge : edges)
+			{
+				geo.insertEdge(edge.second);
+			}
+			// note changes from here on (e.g. for checkpoint::Writer)
+			geo.trackChanges(true);
+			(void)geo.takeChanges();
+		}
+		return numApplied;
+	}
+
+} // [checkpoint]
+
+} // [orinet]
+
+
+#endif // OriNet_checkpoint_INCL_
@@ -0,0 +1,72 @@
+//
+// MIT License
+//
+// Copyright (c) 2024 Stellacore Corporation
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+
+#ifndef OriNet_checksum_INCL_
+#define OriNet_checksum_INCL_
+
+/*! \file
+\brief Checksum of byte data (e.g. for integrity checks of saved files).
+
+*/
+
+
+#include <cstddef>
+#include <cstdint>
+
+
+namespace orinet
+{
+
+/*! \brief Checksum (integrity check) utilities.
+ */
+namespace checksum
+{
+	//! Initial value for checksumOf() (64-bit FNV-1a offset basis)
+	constexpr std::uint64_t sChecksumSeed{ 14695981039346656037u };
+
+	//! Checksum (64-bit FNV-1a) of bytes, continuing from hash value
+	inline
+	std::uint64_t
+	checksumOf
+		( unsigned char const * const & bytes
+		, std::size_t const & numBytes
+		, std::uint64_t const & hash = sChecksumSeed
+		)
+	{
+		constexpr std::uint64_t prime{ 1099511628211u };
+		std::uint64_t sum{ hash };
+		for (std::size_t nn{0u} ; nn < numBytes ; ++nn)
+		{
+			sum = (sum ^ std::uint64_t{ bytes[nn] }) * prime;
+		}
+		return sum;
+	}
+
+} // [checksum]
+
+} // [orinet]
+
+
+#endif // OriNet_checksum_INCL_
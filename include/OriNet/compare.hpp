@@ -27,12 +27,14 @@
 #define OriNet_compare_INCL_
 
 
+#include "applied.hpp"
 #include "robust.hpp" // for medianOf() - probably should factor out
 
 #include <Rigibra>
 
 #include <algorithm>
 #include <array>
+#include <cmath>
 #include <limits>
 #include <vector>
 
@@ -51,6 +53,26 @@ namespace orinet
 namespace compare
 {
 
+	/*! \brief Differences: all basis vectors rotated by each applied form.
+	 *
+	 * Same as triadDeltaVectors(att1, att2) (below) for attitudes
+	 * associated with each applied form (i.e. the differences in the
+	 * rotation matrix columns).
+	 */
+	inline
+	std::array<engabra::g3::Vector, 3u>
+	triadDeltaVectors
+		( applied::Xform const & app1
+		, applied::Xform const & app2
+		)
+	{
+		return std::array<engabra::g3::Vector, 3u>
+			{ (app2.rotatedBasis(0u) - app1.rotatedBasis(0u))
+			, (app2.rotatedBasis(1u) - app1.rotatedBasis(1u))
+			, (app2.rotatedBasis(2u) - app1.rotatedBasis(2u))
+			};
+	}
+
 	/*! \brief Differences: all basis vectors transformed by each attitude.
 	 *
 	 * Each of the basis vectors {e1, e2, e3} are transformed by each
@@ -67,22 +89,13 @@ namespace compare
 		std::array<Vector, 3u> diffs;
 		if (rigibra::isValid(att1) && rigibra::isValid(att2))
 		{
-			// transform attitude changes for each of the +/- each basis vector
-			Vector const into_e1_1{ att1(e1) };
-			Vector const into_e1_2{ att2(e1) };
-
-			Vector const into_e2_1{ att1(e2) };
-			Vector const into_e2_2{ att2(e2) };
-
-			Vector const into_e3_1{ att1(e3) };
-			Vector const into_e3_2{ att2(e3) };
+			// rotation matrices (columns are the rotated basis vectors)
+			Vector const origin{ zero<Vector>() };
+			applied::Xform const app1(rigibra::Transform{ origin, att1 });
+			applied::Xform const app2(rigibra::Transform{ origin, att2 });
 
 			// return all three differences
-			diffs = std::array<Vector, 3u>
-				{ (into_e1_2 - into_e1_1)
-				, (into_e2_2 - into_e2_1)
-				, (into_e3_2 - into_e3_1)
-				};
+			diffs = triadDeltaVectors(app1, app2);
 		}
 		return diffs;
 	}
@@ -162,14 +175,18 @@ namespace compare
 				rho = std::max(1., aveMag);
 			}
 
+			// applied forms - each attitude is used four times below
+			applied::Xform const app1(xfm1);
+			applied::Xform const app2(xfm2);
+
 			// apply rotation to the translation components of transformations
-			Vector const into_t_1{ xfm1.theAtt(xfm1.theLoc) };
-			Vector const into_t_2{ xfm2.theAtt(xfm2.theLoc) };
+			Vector const into_t_1{ app1.rotated(xfm1.theLoc) };
+			Vector const into_t_2{ app2.rotated(xfm2.theLoc) };
 			Vector const delta_trans{ (into_t_1 - into_t_2) };
 
 			// transform attitude changes for each of the +/- each basis vector
 			std::array<Vector, 3u> const deltas
-				{ triadDeltaVectors(xfm1.theAtt, xfm2.theAtt) };
+				{ triadDeltaVectors(app1, app2) };
 			Vector const delta_e1{ rho * deltas[0] };
 			Vector const delta_e2{ rho * deltas[1] };
 			Vector const delta_e3{ rho * deltas[2] };
@@ -274,6 +291,145 @@ namespace compare
 	}
 
 
+	/*! \brief Bulk version of maxMagResultDifference() (each element vs ref)
+	 *
+	 * For each element of effects, the value placed in (*ptMags)
+	 * is (in the precision of Real) the same as
+	 * maxMagResultDifference(xform, refXform, useNormalizedCompare).
+	 *
+	 * The max over the hexad (+/- e_k) is evaluated from
+	 * \arg (dt +/- rho*dk)^2 = dt^2 + rho^2*dk^2 +/- 2*rho*(dt.dk)
+	 *
+	 * where dt is the difference of rotated offsets and the dk are
+	 * differences of rotated basis vectors (Ref theory/compare.lyx).
+	 * The inner loop involves only Real arithmetic over contiguous
+	 * arrays (suitable for compiler auto-vectorization).
+	 */
+	template <typename Real>
+	inline
+	void
+	maxMagResultDifferences
+		( std::vector<Real> * const & ptMags
+		, robust::EffectArrays<Real> const & effects
+		, rigibra::Transform const & refXform
+		, bool const & useNormalizedCompare
+		)
+	{
+		std::size_t const numElem{ effects.size() };
+		ptMags->assign(numElem, std::numeric_limits<Real>::quiet_NaN());
+		if (isValid(refXform))
+		{
+			// reference values (computed in double, used in Real)
+			using namespace engabra::g3;
+			applied::Xform const refApp(refXform);
+			Vector const refRotLoc{ refApp.rotated(refXform.theLoc) };
+			std::array<Vector, 3u> const refDirs
+				{ refApp.rotatedBasis(0u)
+				, refApp.rotatedBasis(1u)
+				, refApp.rotatedBasis(2u)
+				};
+			Real const rt0{ static_cast<Real>(refRotLoc[0]) };
+			Real const rt1{ static_cast<Real>(refRotLoc[1]) };
+			Real const rt2{ static_cast<Real>(refRotLoc[2]) };
+			std::array<std::array<Real, 3u>, 3u> rd;
+			for (std::size_t kk{0u} ; kk < 3u ; ++kk)
+			{
+				for (std::size_t jj{0u} ; jj < 3u ; ++jj)
+				{
+					rd[kk][jj] = static_cast<Real>(refDirs[kk][jj]);
+				}
+			}
+			Real const one{ 1.f };
+			Real const two{ 2.f };
+
+			Real const * const t0s = effects.theLocs[0].data();
+			Real const * const t1s = effects.theLocs[1].data();
+			Real const * const t2s = effects.theLocs[2].data();
+			Real const * const a0s = effects.theDirE1s[0].data();
+			Real const * const a1s = effects.theDirE1s[1].data();
+			Real const * const a2s = effects.theDirE1s[2].data();
+			Real const * const b0s = effects.theDirE2s[0].data();
+			Real const * const b1s = effects.theDirE2s[1].data();
+			Real const * const b2s = effects.theDirE2s[2].data();
+			Real * const mags = ptMags->data();
+
+			// translation normalizing scale factors (rho) into mags
+			std::fill_n(mags, numElem, one);
+			if (useNormalizedCompare)
+			{
+				Real const half{ .5f };
+				Real const refMag
+					{ static_cast<Real>(magnitude(refXform.theLoc)) };
+				for (std::size_t ndx{0u} ; ndx < numElem ; ++ndx)
+				{
+					Real const t0{ t0s[ndx] };
+					Real const t1{ t1s[ndx] };
+					Real const t2{ t2s[ndx] };
+					Real const mag{ std::sqrt(t0*t0 + t1*t1 + t2*t2) };
+					mags[ndx] = std::max(one, half * (mag + refMag));
+				}
+			}
+
+			// squared max hexad differences (no sqrt() in this main loop
+			// so that it vectorizes even without -fno-math-errno)
+			for (std::size_t ndx{0u} ; ndx < numElem ; ++ndx)
+			{
+				Real const t0{ t0s[ndx] };
+				Real const t1{ t1s[ndx] };
+				Real const t2{ t2s[ndx] };
+				Real const a0{ a0s[ndx] };
+				Real const a1{ a1s[ndx] };
+				Real const a2{ a2s[ndx] };
+				Real const b0{ b0s[ndx] };
+				Real const b1{ b1s[ndx] };
+				Real const b2{ b2s[ndx] };
+
+				// rotated e3 direction (dual of e1^e2 rotated)
+				Real const c0{ a1*b2 - a2*b1 };
+				Real const c1{ a2*b0 - a0*b2 };
+				Real const c2{ a0*b1 - a1*b0 };
+
+				// rotated offset difference
+				Real const dt0{ (t0*a0 + t1*b0 + t2*c0) - rt0 };
+				Real const dt1{ (t0*a1 + t1*b1 + t2*c1) - rt1 };
+				Real const dt2{ (t0*a2 + t1*b2 + t2*c2) - rt2 };
+				Real const dtSq{ dt0*dt0 + dt1*dt1 + dt2*dt2 };
+
+				Real const rho{ mags[ndx] };
+
+				// rotated basis direction differences
+				Real const d00{ rd[0][0] - a0 };
+				Real const d01{ rd[0][1] - a1 };
+				Real const d02{ rd[0][2] - a2 };
+				Real const d10{ rd[1][0] - b0 };
+				Real const d11{ rd[1][1] - b1 };
+				Real const d12{ rd[1][2] - b2 };
+				Real const d20{ rd[2][0] - c0 };
+				Real const d21{ rd[2][1] - c1 };
+				Real const d22{ rd[2][2] - c2 };
+
+				Real const sq0
+					{ rho*rho * (d00*d00 + d01*d01 + d02*d02)
+					+ two*rho * std::abs(dt0*d00 + dt1*d01 + dt2*d02)
+					};
+				Real const sq1
+					{ rho*rho * (d10*d10 + d11*d11 + d12*d12)
+					+ two*rho * std::abs(dt0*d10 + dt1*d11 + dt2*d12)
+					};
+				Real const sq2
+					{ rho*rho * (d20*d20 + d21*d21 + d22*d22)
+					+ two*rho * std::abs(dt0*d20 + dt1*d21 + dt2*d22)
+					};
+				mags[ndx] = dtSq + std::max(sq0, std::max(sq1, sq2));
+			}
+			for (std::size_t ndx{0u} ; ndx < numElem ; ++ndx)
+			{
+				mags[ndx] = std::sqrt(mags[ndx]);
+			}
+		}
+	}
+
+
 	/*! \brief True if both attitudes produce similar effect on basis vectors.
 	 *
 	 * Example:
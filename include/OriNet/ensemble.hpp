@@ -0,0 +1,286 @@
+//
+// MIT License
+//
+// Copyright (c) 2024 Stellacore Corporation
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+
+#ifndef OriNet_ensemble_INCL_
+#define OriNet_ensemble_INCL_
+
+/*! \file
+\brief Bootstrap ensemble estimation of station uncertainty.
+
+The station transforms of a network are computed by the chain of
+network::Geometry::spanningEdgeBases(), network::Geometry::networkTree()
+and network::Geometry::propagateTransforms(). The uncertainty of the
+results is estimated by repeating the chain for an ensemble of
+replicate networks in which each EdgeRobust edge is replaced by an
+estimate from its resampled observations (ref
+network::EdgeRobust::resampledInstance()). Other edges are used as is.
+
+The original network is only read. Its stations and edge instances are
+collected once (by a Replicator) and shared by all replicates, which
+are run in parallel each with an independent random::Context stream.
+The spread of the replicate results for each station is reported as
+compare::differenceStats() relative to the original network result.
+
+Example:
+\snippet test_ensemble.cpp DoxyExample01
+
+*/
+
+
+#include "compare.hpp"
+#include "networkGeometry.hpp"
+#include "parallel.hpp"
+#include "random.hpp"
+#include "trace.hpp"
+
+#include <Engabra>
+#include <Rigibra>
+
+#include <map>
+#include <memory>
+#include <vector>
+
+
+namespace orinet
+{
+
+/*! \brief Bootstrap ensemble estimation of network uncertainty.
+ */
+namespace ensemble
+{
+	//! Station transforms from propagation through spanning tree of geo.
+	inline
+	std::map<network::StaKey, rigibra::Transform>
+	treeTransforms
+		( network::Geometry const & geo
+		, network::StaKey const & staKey0
+		, rigibra::Transform const & staXform0
+		)
+	{
+		network::Geometry const treeGeo
+			{ geo.networkTree(geo.spanningEdgeBases()) };
+		return treeGeo.propagateTransforms(staKey0, staXform0);
+	}
+
+	/*! \brief Generator of replicate networks (from resampled observations).
+	 *
+	 * The station keys and edge instances of the original network are
+	 * collected at construction and are shared (read only) by all of
+	 * the replicates. The original network edges should therefore not
+	 * be modified while the instance is in use.
+	 */
+	class Replicator
+	{
+		//! Station keys in original vertex order
+		std::vector<network::StaKey> theStaKeys{};
+
+		//! Edge instances (shared with the original network)
+		std::vector<std::shared_ptr<network::EdgeBase> > theEdges{};
+
+		//! Robust form of theEdges[ndx] (or null if other edge type)
+		std::vector<network::EdgeRobust const *> thePtRobusts{};
+
+	public:
+
+		//! Collect stations and edges from geo.
+		inline
+		explicit
+		Replicator  // Replicator::
+			( network::Geometry const & geo
+			)
+		{
+			network::ChangeSet const contents{ geo.allContents() };
+			theStaKeys = contents.theStaKeys;
+			theEdges.reserve(contents.theEdgeKeys.size());
+			thePtRobusts.reserve(contents.theEdgeKeys.size());
+			for (std::pair<network::StaKey, network::StaKey> const & edgeKey
+				: contents.theEdgeKeys)
+			{
+				network::EdgeDir const edgeDir{ edgeKey.first, edgeKey.second };
+				std::shared_ptr<network::EdgeBase> const ptEdge
+					{ geo.edge(edgeDir) };
+				theEdges.emplace_back(ptEdge);
+				thePtRobusts.emplace_back
+					(dynamic_cast<network::EdgeRobust const *>(ptEdge.get()));
+			}
+		}
+
+		//! Number of edges with observations that are resampled
+		inline
+		std::size_t
+		numRobustEdges  // Replicator::
+			() const
+		{
+			std::size_t count{ 0u };
+			for (network::EdgeRobust const * const & ptRobust : thePtRobusts)
+			{
+				if (ptRobust)
+				{
+					++count;
+				}
+			}
+			return count;
+		}
+
+		/*! \brief Network with each robust edge from resampled observations.
+		 *
+		 * The stations are in the original vertex order and each
+		 * EdgeRobust edge is replaced by its resampledInstance() (drawn
+		 * in edge key order from ctx). Other edges are the same (shared)
+		 * instances as in the original. The result depends only on the
+		 * state of ctx such that it may be called concurrently with a
+		 * different ctx for each call.
+		 */
+		inline
+		network::Geometry
+		replicate  // Replicator::
+			( random::Context & ctx
+			) const
+		{
+			network::Geometry repGeo;
+			repGeo.insertStations(theStaKeys);
+			for (std::size_t ndx{0u} ; ndx < theEdges.size() ; ++ndx)
+			{
+				network::EdgeRobust const * const & ptRobust
+					= thePtRobusts[ndx];
+				if (ptRobust)
+				{
+					repGeo.insertEdge
+						(ptRobust->resampledInstance(ctx.generator()));
+				}
+				else
+				{
+					repGeo.insertEdge(theEdges[ndx]);
+				}
+			}
+			return repGeo;
+		}
+
+	}; // Replicator
+
+	//! Station uncertainty estimated from a bootstrap ensemble
+	struct Spread
+	{
+		//! Station transforms from the original network
+		std::map<network::StaKey, rigibra::Transform> theRefXforms{};
+
+		//! Differences of replicate station transforms from theRefXforms
+		std::map<network::StaKey, compare::Stats> theStaStats{};
+
+		//! Number of replicates in the ensemble
+		std::size_t theNumReps{ 0u };
+
+	}; // Spread
+
+	/*! \brief Per station spread of a bootstrap ensemble of numReps networks.
+	 *
+	 * The reference station transforms are computed by treeTransforms()
+	 * for geo (the original, not resampled, observations). Each of the
+	 * numReps replicates is a Replicator::replicate() network (with the
+	 * random context ctx.stream(repNdx)) for which treeTransforms() is
+	 * also computed. The replicates are scheduled dynamically on (up
+	 * to) parallel::threadCount(numThreads) threads and the results
+	 * are the same regardless of the number of threads.
+	 *
+	 * For each reference station, the result contains the statistics
+	 * (compare::differenceStats()) of the replicate transforms (those
+	 * in which the station is reached) relative to the reference.
+	 *
+	 * If ptRepXforms is not null, it is filled with the station
+	 * transforms for each replicate (in order of repNdx).
+	 *
+	 * Example:
+	 * \snippet test_ensemble.cpp DoxyExample01
+	 */
+	inline
+	Spread
+	stationSpread
+		( network::Geometry const & geo
+		, network::StaKey const & staKey0
+		, rigibra::Transform const & staXform0
+		, std::size_t const & numReps
+		, random::Context const & ctx
+		, std::size_t const & numThreads = 0u
+		, std::vector<std::map<network::StaKey, rigibra::Transform> >
+			* const & ptRepXforms = nullptr
+		)
+	{
+		OriNet_TRACE_SPAN_ARG("ensemble::stationSpread", numReps);
+
+		Spread spread{};
+		spread.theNumReps = numReps;
+
+		// reference also updates any cached edge estimates (before
+		// the edges are shared by concurrent replicates)
+		spread.theRefXforms = treeTransforms(geo, staKey0, staXform0);
+
+		Replicator const replicator(geo);
+		std::vector<std::map<network::StaKey, rigibra::Transform> >
+			repXforms(numReps);
+		parallel::forEachIndex
+			( numReps
+			, [&] (std::size_t const repNdx)
+			{
+				random::Context repCtx{ ctx.stream(repNdx) };
+				network::Geometry const repGeo
+					{ replicator.replicate(repCtx) };
+				repXforms[repNdx] = treeTransforms(repGeo, staKey0, staXform0);
+			}
+			, numThreads
+			);
+
+		std::vector<rigibra::Transform> staXforms;
+		staXforms.reserve(numReps);
+		for (std::pair<network::StaKey const, rigibra::Transform> const & ref
+			: spread.theRefXforms)
+		{
+			staXforms.clear();
+			for (std::map<network::StaKey, rigibra::Transform> const & xforms
+				: repXforms)
+			{
+				std::map<network::StaKey, rigibra::Transform>::const_iterator
+					const itFind{ xforms.find(ref.first) };
+				if (xforms.cend() != itFind)
+				{
+					staXforms.emplace_back(itFind->second);
+				}
+			}
+			spread.theStaStats[ref.first] = compare::differenceStats
+				(staXforms.cbegin(), staXforms.cend(), ref.second);
+		}
+
+		if (ptRepXforms)
+		{
+			*ptRepXforms = std::move(repXforms);
+		}
+		return spread;
+	}
+
+} // [ensemble]
+
+} // [orinet]
+
+
+#endif // OriNet_ensemble_INCL_
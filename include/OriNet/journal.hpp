@@ -0,0 +1,900 @@
+//
+// MIT License
+//
+// Copyright (c) 2024 Stellacore Corporation
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+
+#ifndef OriNet_journal_INCL_
+#define OriNet_journal_INCL_
+
+/*! \file
+\brief Append-only binary journal of edge observations (with replay).
+
+Each observation that is fed into a network (e.g. via
+network::Geometry::accumulateEdgeXform() or EdgeRobust::accumulateXform())
+may also be appended to a journal file by a journal::Writer. The
+network can later be rebuilt from the journal by journal::replay()
+(e.g. to restart a long running service) without re-running the
+upstream processing that produced the observations.
+
+File layout (native byte order):
+\arg FileHeader - identification and record/index sizes
+\arg Repeated chunks of theRecsPerIndex fixed size Record instances
+each followed by an IndexBlock (record count, time range and checksum)
+\arg A final (partial) chunk of records without an IndexBlock
+
+Replay memory maps the file, checks and decodes the chunks in
+parallel, groups the observations by edge and loads each edge with
+bulk tracker insertion (EdgeRobust::accumulateXforms() and
+EdgeRobust::accumulateTimedXforms()).
+
+Example:
+\snippet test_journal.cpp DoxyExample01
+
+*/
+
+
+#include "checksum.hpp"
+#include "networkGeometry.hpp"
+#include "parallel.hpp"
+#include "trace.hpp"
+
+#include <Engabra>
+#include <Rigibra>
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#	include <fcntl.h>
+#	include <sys/mman.h>
+#	include <sys/stat.h>
+#	include <unistd.h>
+#	define OriNet_journal_MMAP
+#endif
+
+
+namespace orinet
+{
+
+/*! \brief Binary journal (record and replay) of edge observations.
+ */
+namespace journal
+{
+	//! Identification for start of file
+	constexpr std::array<char, 8u> sFileMagic
+		{ 'O', 'r', 'i', 'N', 'e', 't', 'J', '1' };
+
+	//! File format version
+	constexpr std::uint32_t sVersion{ 1u };
+
+	//! Identification for start of each index block
+	constexpr std::uint64_t sIndexTag{ 0x58496a4e69724fu }; // "OriNjIX"
+
+	//! Default number of records in each (indexed) chunk
+	constexpr std::size_t sRecsPerIndex{ 4096u };
+
+	// checksum of records (ref checksum.hpp)
+	using checksum::sChecksumSeed;
+	using checksum::checksumOf;
+
+	//! One observation: xform (into wrt from) at time tau (NaN if untimed)
+	struct Record
+	{
+		//! EdgeDir::theFromKey
+		std::uint64_t theFromKey;
+
+		//! EdgeDir::theIntoKey
+		std::uint64_t theIntoKey;
+
+		//! Time of observation (NaN for observations without time)
+		double theTau;
+
+		//! Transform offset (theLoc) components
+		std::array<double, 3u> theLoc;
+
+		//! Transform attitude (physical angle bivector) components
+		std::array<double, 3u> theAngle;
+
+		//! Record for observation
+		inline
+		static
+		Record
+		from  // Record::
+			( network::EdgeDir const & edgeDir
+			, rigibra::Transform const & xIntoWrtFrom
+			, double const & tau = engabra::g3::null<double>()
+			)
+		{
+			engabra::g3::Vector const & loc = xIntoWrtFrom.theLoc;
+			engabra::g3::BiVector const angle
+				{ xIntoWrtFrom.theAtt.physAngle().theBiv };
+			return Record
+				{ .theFromKey = edgeDir.fromKey()
+				, .theIntoKey = edgeDir.intoKey()
+				, .theTau = tau
+				, .theLoc = { loc[0], loc[1], loc[2] }
+				, .theAngle = { angle[0], angle[1], angle[2] }
+				};
+		}
+
+		//! True if the observation has a time (i.e. theTau is valid)
+		inline
+		bool
+		isTimed  // Record::
+			() const
+		{
+			return engabra::g3::isValid(theTau);
+		}
+
+		//! Station keys in ascending order (same for either direction)
+		inline
+		std::pair<network::StaKey, network::StaKey>
+		staKeyPair  // Record::
+			() const
+		{
+			return
+				{ std::min(theFromKey, theIntoKey)
+				, std::max(theFromKey, theIntoKey)
+				};
+		}
+
+		//! Edge direction for which xform() applies
+		inline
+		network::EdgeDir
+		edgeDir  // Record::
+			() const
+		{
+			return network::EdgeDir{ theFromKey, theIntoKey };
+		}
+
+		//! Observed transform (into wrt from)
+		inline
+		rigibra::Transform
+		xform  // Record::
+			() const
+		{
+			using namespace engabra::g3;
+			BiVector const angle{ theAngle[0], theAngle[1], theAngle[2] };
+			return rigibra::Transform
+				{ Vector{ theLoc[0], theLoc[1], theLoc[2] }
+				, rigibra::Attitude(rigibra::PhysAngle{ angle })
+				};
+		}
+
+	}; // Record
+
+	static_assert(72u == sizeof(Record));
+	static_assert(std::is_trivially_copyable_v<Record>);
+
+	//! Start of every journal file
+	struct FileHeader
+	{
+		std::array<char, 8u> theMagic{ sFileMagic };
+		std::uint32_t theVersion{ sVersion };
+		std::uint32_t theRecordSize{ sizeof(Record) };
+		std::uint32_t theIndexSize{ 64u };
+		std::uint32_t theRecsPerIndex{ sRecsPerIndex };
+		std::uint64_t theReserved{ 0u };
+
+		//! True if consistent with this implementation
+		inline
+		bool
+		isValid  // FileHeader::
+			() const
+		{
+			return
+				(  (sFileMagic == theMagic)
+				&& (sVersion == theVersion)
+				&& (sizeof(Record) == theRecordSize)
+				&& (64u == theIndexSize)
+				&& (0u < theRecsPerIndex)
+				);
+		}
+
+	}; // FileHeader
+
+	static_assert(32u == sizeof(FileHeader));
+
+	//! Summary of the chunk of records that precedes it in the file
+	struct IndexBlock
+	{
+		std::uint64_t theTag{ sIndexTag };
+		std::uint64_t theChunkNdx{ 0u };
+		std::uint64_t theNumRecords{ 0u };
+		double theTauMin{ engabra::g3::null<double>() };
+		double theTauMax{ engabra::g3::null<double>() };
+		std::uint64_t theChecksum{ sChecksumSeed };
+		std::array<std::uint64_t, 2u> theReserved{};
+
+	}; // IndexBlock
+
+	static_assert(64u == sizeof(IndexBlock));
+
+	/*! \brief Positions of chunks within a journal file.
+	 *
+	 * The full chunks (each with an index block) are followed by
+	 * numTail records. Trailing bytes that do not form a complete
+	 * record (e.g. from an interrupted write) are not included.
+	 */
+	struct Layout
+	{
+		std::size_t theRecsPerIndex{ sRecsPerIndex };
+		std::size_t theNumChunks{ 0u };
+		std::size_t theNumTail{ 0u };
+
+		//! Layout for a file of fileSize bytes (with header)
+		inline
+		explicit
+		Layout  // Layout::
+			( FileHeader const & header
+			, std::size_t const & fileSize
+			)
+			: theRecsPerIndex{ header.theRecsPerIndex }
+		{
+			if (sizeof(FileHeader) < fileSize)
+			{
+				std::size_t const dataSize{ fileSize - sizeof(FileHeader) };
+				theNumChunks = dataSize / chunkSize();
+				std::size_t const tailSize
+					{ dataSize - theNumChunks * chunkSize() };
+				theNumTail = std::min
+					(theRecsPerIndex, tailSize / sizeof(Record));
+			}
+		}
+
+		//! Bytes for one chunk of records and its index block
+		inline
+		std::size_t
+		chunkSize  // Layout::
+			() const
+		{
+			return (theRecsPerIndex * sizeof(Record) + sizeof(IndexBlock));
+		}
+
+		//! File offset to first record of chunk (tail if numChunks)
+		inline
+		std::size_t
+		chunkBeg  // Layout::
+			( std::size_t const & chunkNdx
+			) const
+		{
+			return (sizeof(FileHeader) + chunkNdx * chunkSize());
+		}
+
+		//! File offset to index block for chunk
+		inline
+		std::size_t
+		indexBeg  // Layout::
+			( std::size_t const & chunkNdx
+			) const
+		{
+			return (chunkBeg(chunkNdx) + theRecsPerIndex * sizeof(Record));
+		}
+
+		//! Number of complete records
+		inline
+		std::size_t
+		numRecords  // Layout::
+			() const
+		{
+			return (theNumChunks * theRecsPerIndex + theNumTail);
+		}
+
+		//! Size of file containing only the complete records (and indices)
+		inline
+		std::size_t
+		validSize  // Layout::
+			() const
+		{
+			return (chunkBeg(theNumChunks) + theNumTail * sizeof(Record));
+		}
+
+	}; // Layout
+
+
+	/*! \brief Append observation records to a journal file.
+	 *
+	 * If the file exists, records are appended to it (after discarding
+	 * any incomplete trailing record). Otherwise a new file is created.
+	 * Records are buffered by the output stream - use flush() to
+	 * ensure they are in the file (e.g. at a commit point).
+	 */
+	class Writer
+	{
+		std::ofstream theStream{};
+		std::size_t theRecsPerIndex{ sRecsPerIndex };
+		std::size_t theNumRecords{ 0u };
+		IndexBlock theChunk{};
+
+		//! Accumulate record into current chunk index information
+		inline
+		void
+		include  // Writer::
+			( Record const & record
+			)
+		{
+			unsigned char const * const bytes
+				{ reinterpret_cast<unsigned char const *>(&record) };
+			theChunk.theChecksum
+				= checksumOf(bytes, sizeof(Record), theChunk.theChecksum);
+			++theChunk.theNumRecords;
+			if (record.isTimed())
+			{
+				if (! engabra::g3::isValid(theChunk.theTauMin))
+				{
+					theChunk.theTauMin = record.theTau;
+					theChunk.theTauMax = record.theTau;
+				}
+				double const & tau = record.theTau;
+				theChunk.theTauMin = std::min(theChunk.theTauMin, tau);
+				theChunk.theTauMax = std::max(theChunk.theTauMax, tau);
+			}
+		}
+
+		//! Write index block if chunk is complete and start next one
+		inline
+		void
+		completeChunk  // Writer::
+			()
+		{
+			if (theRecsPerIndex == theChunk.theNumRecords)
+			{
+				theStream.write
+					( reinterpret_cast<char const *>(&theChunk)
+					, sizeof(IndexBlock)
+					);
+				std::uint64_t const nextNdx{ theChunk.theChunkNdx + 1u };
+				theChunk = IndexBlock{};
+				theChunk.theChunkNdx = nextNdx;
+			}
+		}
+
+		//! Setup to continue existing file (false if not a journal)
+		inline
+		bool
+		resume  // Writer::
+			( std::filesystem::path const & path
+			)
+		{
+			bool okay{ false };
+			std::ifstream ifs(path, std::ios::binary);
+			FileHeader header{};
+			ifs.read(reinterpret_cast<char *>(&header), sizeof(FileHeader));
+			std::size_t const fileSize{ std::filesystem::file_size(path) };
+			if (ifs.good() && header.isValid())
+			{
+				Layout const layout(header, fileSize);
+				theRecsPerIndex = layout.theRecsPerIndex;
+				theNumRecords = layout.numRecords();
+				theChunk.theChunkNdx = layout.theNumChunks;
+
+				// restore index information for (partial) tail chunk
+				ifs.seekg(layout.chunkBeg(layout.theNumChunks));
+				for (std::size_t nn{0u} ; nn < layout.theNumTail ; ++nn)
+				{
+					Record record{};
+					ifs.read(reinterpret_cast<char *>(&record), sizeof(Record));
+					include(record);
+				}
+				okay = ifs.good();
+				ifs.close();
+
+				// drop incomplete record (or index) from interrupted write
+				if (okay && (layout.validSize() < fileSize))
+				{
+					std::filesystem::resize_file(path, layout.validSize());
+				}
+			}
+			return okay;
+		}
+
+	public:
+
+		//! Open path for appending (new files use recsPerIndex)
+		inline
+		explicit
+		Writer  // Writer::
+			( std::filesystem::path const & path
+			, std::size_t const & recsPerIndex = sRecsPerIndex
+			)
+			: theRecsPerIndex{ std::max(recsPerIndex, std::size_t{ 1u }) }
+		{
+			std::error_code ec{};
+			bool const haveFile
+				{ std::filesystem::exists(path, ec)
+				&& (sizeof(FileHeader) <= std::filesystem::file_size(path, ec))
+				};
+			if (haveFile)
+			{
+				if (resume(path))
+				{
+					theStream.open
+						(path, std::ios::binary | std::ios::app);
+					completeChunk(); // if interrupted before index block
+				}
+				else
+				{
+					std::cerr << "journal::Writer: not a valid journal file:"
+						<< ' ' << path << '\n';
+				}
+			}
+			else
+			{
+				theStream.open
+					(path, std::ios::binary | std::ios::trunc);
+				FileHeader header{};
+				header.theRecsPerIndex
+					= static_cast<std::uint32_t>(theRecsPerIndex);
+				theStream.write
+					( reinterpret_cast<char const *>(&header)
+					, sizeof(FileHeader)
+					);
+			}
+		}
+
+		//! True if file is open and no write errors have occurred
+		inline
+		bool
+		isValid  // Writer::
+			() const
+		{
+			return (theStream.is_open() && theStream.good());
+		}
+
+		//! Total number of records in file (including previous ones)
+		inline
+		std::size_t
+		size  // Writer::
+			() const
+		{
+			return theNumRecords;
+		}
+
+		//! Append observation (tau is NaN for untimed observations)
+		inline
+		void
+		append  // Writer::
+			( network::EdgeDir const & edgeDir
+			, rigibra::Transform const & xIntoWrtFrom
+			, double const & tau = engabra::g3::null<double>()
+			)
+		{
+			Record const record{ Record::from(edgeDir, xIntoWrtFrom, tau) };
+			theStream.write
+				(reinterpret_cast<char const *>(&record), sizeof(Record));
+			include(record);
+			++theNumRecords;
+			completeChunk();
+		}
+
+		//! Ensure that all appended records are written to the file
+		inline
+		void
+		flush  // Writer::
+			()
+		{
+			theStream.flush();
+		}
+
+	}; // Writer
+
+
+	//! Read only (memory mapped if available) view of file contents
+	class MappedFile
+	{
+		unsigned char const * theData{ nullptr };
+		std::size_t theSize{ 0u };
+		std::vector<unsigned char> theCopy{};
+		void * theMap{ nullptr };
+
+	public:
+
+		//! Map (or if not possible, read) content of path
+		inline
+		explicit
+		MappedFile  // MappedFile::
+			( std::filesystem::path const & path
+			)
+		{
+			std::error_code ec{};
+			std::size_t const fileSize{ std::filesystem::file_size(path, ec) };
+			if ((! ec) && (0u < fileSize))
+			{
+#				if defined(OriNet_journal_MMAP)
+				int const fd{ ::open(path.c_str(), O_RDONLY) };
+				if (! (fd < 0))
+				{
+					void * const ptMap
+						{ ::mmap
+							(nullptr, fileSize, PROT_READ, MAP_PRIVATE, fd, 0)
+						};
+					if (MAP_FAILED != ptMap)
+					{
+						theMap = ptMap;
+						theData = static_cast<unsigned char const *>(ptMap);
+						theSize = fileSize;
+					}
+					::close(fd);
+				}
+#				endif
+				if (! theData)
+				{
+					// read into memory
+					theCopy.resize(fileSize);
+					std::ifstream ifs(path, std::ios::binary);
+					ifs.read
+						(reinterpret_cast<char *>(theCopy.data()), fileSize);
+					if (ifs.good())
+					{
+						theData = theCopy.data();
+						theSize = fileSize;
+					}
+				}
+			}
+		}
+
+		//! Release mapping
+		inline
+		~MappedFile  // MappedFile::
+			()
+		{
+#			if defined(OriNet_journal_MMAP)
+			if (theMap)
+			{
+				::munmap(theMap, theSize);
+			}
+#			endif
+		}
+
+		MappedFile(MappedFile const &) = delete;
+		MappedFile & operator=(MappedFile const &) = delete;
+
+		//! Start of file contents (null if not available)
+		inline
+		unsigned char const *
+		data  // MappedFile::
+			() const
+		{
+			return theData;
+		}
+
+		//! Number of bytes available at data()
+		inline
+		std::size_t
+		size  // MappedFile::
+			() const
+		{
+			return theSize;
+		}
+
+	}; // MappedFile
+
+
+	/*! \brief All (valid) records from journal file in order.
+	 *
+	 * Chunks are copied and checked (against their index block) in
+	 * parallel with up to parallel::threadCount(numThreads) threads.
+	 * Records of chunks that fail the check are omitted (and counted
+	 * in *ptNumBadChunks if provided).
+	 */
+	inline
+	std::vector<Record>
+	readRecords
+		( std::filesystem::path const & path
+		, std::size_t const & numThreads = 0u
+		, std::size_t * const & ptNumBadChunks = nullptr
+		)
+	{
+		OriNet_TRACE_SPAN("journal::readRecords");
+
+		std::vector<Record> records;
+		std::size_t numBad{ 0u };
+
+		MappedFile const mapped(path);
+		FileHeader header{};
+		if (sizeof(FileHeader) <= mapped.size())
+		{
+			std::memcpy(&header, mapped.data(), sizeof(FileHeader));
+		}
+		if (header.isValid())
+		{
+			Layout const layout(header, mapped.size());
+			std::size_t const recsPerIndex{ layout.theRecsPerIndex };
+			records.resize(layout.numRecords());
+
+			// copy and check full chunks
+			std::vector<char> chunkOkays(layout.theNumChunks, 0);
+			parallel::forEachRange
+				( layout.theNumChunks
+				, [&] (std::size_t const beg, std::size_t const end)
+				{
+					for (std::size_t ndx{beg} ; ndx < end ; ++ndx)
+					{
+						unsigned char const * const recBytes
+							{ mapped.data() + layout.chunkBeg(ndx) };
+						std::size_t const recSize
+							{ recsPerIndex * sizeof(Record) };
+						std::memcpy
+							( records.data() + ndx * recsPerIndex
+							, recBytes
+							, recSize
+							);
+						IndexBlock index{};
+						std::memcpy
+							( &index
+							, mapped.data() + layout.indexBeg(ndx)
+							, sizeof(IndexBlock)
+							);
+						chunkOkays[ndx]
+							=  (sIndexTag == index.theTag)
+							&& (ndx == index.theChunkNdx)
+							&& (recsPerIndex == index.theNumRecords)
+							&& (index.theChecksum
+								== checksumOf(recBytes, recSize));
+					}
+				}
+				, numThreads
+				, 1u
+				);
+
+			// tail records (not yet covered by an index block)
+			std::memcpy
+				( records.data() + layout.theNumChunks * recsPerIndex
+				, mapped.data() + layout.chunkBeg(layout.theNumChunks)
+				, layout.theNumTail * sizeof(Record)
+				);
+
+			// omit records from bad chunks
+			numBad = static_cast<std::size_t>
+				(std::count(chunkOkays.cbegin(), chunkOkays.cend(), 0));
+			if (0u < numBad)
+			{
+				std::cerr << "journal::readRecords: skipping " << numBad
+					<< " chunks with invalid index/checksum in " << path
+					<< '\n';
+				std::size_t numKeep{ 0u };
+				for (std::size_t ndx{0u} ; ndx < records.size() ; ++ndx)
+				{
+					std::size_t const chunkNdx{ ndx / recsPerIndex };
+					if ((! (chunkNdx < chunkOkays.size()))
+						|| chunkOkays[chunkNdx])
+					{
+						records[numKeep++] = records[ndx];
+					}
+				}
+				records.resize(numKeep);
+			}
+		}
+		else
+		{
+			std::cerr << "journal::readRecords: not a valid journal file:"
+				<< ' ' << path << '\n';
+		}
+
+		if (ptNumBadChunks)
+		{
+			*ptNumBadChunks = numBad;
+		}
+		return records;
+	}
+
+	/*! \brief Rebuild network by applying all journal observations to geo.
+	 *
+	 * Observations are grouped by station pair (in either direction)
+	 * and applied to the EdgeRobust instance for that pair. Existing
+	 * EdgeRobust edges in geo are accumulated into. Otherwise, a new
+	 * edge is created (with tracker capacity reserveSize and with the
+	 * forgetting policy) in the direction of the first observation.
+	 * Observations made in the opposite direction are inverted.
+	 *
+	 * The edges are loaded concurrently (with bulk tracker insertion)
+	 * with up to parallel::threadCount(numThreads) threads and new
+	 * edges are inserted into geo afterward (in station key order).
+	 * Modified existing edges are noted with geo.markChanged().
+	 *
+	 * The result is the same as for a sequence of accumulateXform()
+	 * calls (the timed version for records with valid tau).
+	 *
+	 * Returns the number of observations applied.
+	 */
+	inline
+	std::size_t
+	replay
+		( std::filesystem::path const & path
+		, network::Geometry & geo
+		, std::size_t const & reserveSize
+		, stat::track::Forgetting const & forgetting = {}
+		, std::size_t const & numThreads = 0u
+		)
+	{
+		OriNet_TRACE_SPAN("journal::replay");
+
+		using network::EdgeBase;
+		using network::EdgeDir;
+		using network::EdgeRobust;
+		using network::StaKey;
+
+		std::vector<Record> const records{ readRecords(path, numThreads) };
+
+		// partition record indices by station pair (in file order)
+		using KeyPair = std::pair<StaKey, StaKey>;
+		std::size_t const numBuckets{ 4u * parallel::threadCount(numThreads) };
+		std::vector<std::vector<std::size_t> > bucketNdxs(numBuckets);
+		for (std::size_t ndx{0u} ; ndx < records.size() ; ++ndx)
+		{
+			KeyPair const keyPair{ records[ndx].staKeyPair() };
+			std::size_t const bucket
+				{ (keyPair.first * 31u + keyPair.second) % numBuckets };
+			bucketNdxs[bucket].emplace_back(ndx);
+		}
+
+		// load edges for each bucket concurrently
+		using NewEdge = std::pair<KeyPair, std::shared_ptr<EdgeBase> >;
+		std::vector<std::vector<NewEdge> > bucketNewEdges(numBuckets);
+		std::vector<std::vector<EdgeDir> > bucketOldDirs(numBuckets);
+		std::vector<std::size_t> bucketNumApplied(numBuckets, 0u);
+		parallel::forEachIndex
+			( numBuckets
+			, [&] (std::size_t const & bucket)
+			{
+				std::map<KeyPair, std::vector<std::size_t> > pairNdxs;
+				for (std::size_t const & ndx : bucketNdxs[bucket])
+				{
+					pairNdxs[records[ndx].staKeyPair()].emplace_back(ndx);
+				}
+
+				std::vector<rigibra::Transform> xforms;
+				std::vector<std::pair<double, rigibra::Transform> > timedXforms;
+				for (std::pair<KeyPair const, std::vector<std::size_t> >
+					const & pairNdx : pairNdxs)
+				{
+					std::vector<std::size_t> const & ndxs = pairNdx.second;
+
+					// edge to load - existing one or new (first record)
+					std::shared_ptr<EdgeRobust> ptEdge{ nullptr };
+					std::size_t ndxBeg{ 0u };
+					Record const & rec0 = records[ndxs.front()];
+					std::shared_ptr<EdgeBase> const ptHave
+						{ geo.edge(rec0.edgeDir()) };
+					if (ptHave)
+					{
+						ptEdge = std::dynamic_pointer_cast<EdgeRobust>(ptHave);
+						if (ptEdge)
+						{
+							bucketOldDirs[bucket].emplace_back
+								(ptEdge->edgeDir());
+						}
+						else
+						{
+							std::cerr << "journal::replay:"
+								<< " existing edge is not EdgeRobust type"
+								<< " edgeDir: " << rec0.edgeDir()
+								<< '\n';
+						}
+					}
+					else
+					{
+						if (rec0.isTimed())
+						{
+							ptEdge = std::make_shared<EdgeRobust>
+								( rec0.edgeDir(), rec0.xform(), rec0.theTau
+								, reserveSize, forgetting
+								);
+						}
+						else
+						{
+							ptEdge = std::make_shared<EdgeRobust>
+								(rec0.edgeDir(), rec0.xform(), reserveSize);
+							ptEdge->theForgetting = forgetting;
+						}
+						bucketNewEdges[bucket].emplace_back
+							(pairNdx.first, ptEdge);
+						ndxBeg = 1u;
+					}
+
+					if (ptEdge)
+					{
+						// observations expressed in edge direction
+						EdgeDir const & useDir = ptEdge->edgeDir();
+						xforms.clear();
+						timedXforms.clear();
+						for (std::size_t nn{ndxBeg} ; nn < ndxs.size() ; ++nn)
+						{
+							Record const & record = records[ndxs[nn]];
+							rigibra::Transform xform{ record.xform() };
+							EdgeDir::DirCompare const dirComp
+								{ useDir.compareTo(record.edgeDir()) };
+							if (EdgeDir::Reverse == dirComp)
+							{
+								xform = rigibra::inverse(xform);
+							}
+							if (record.isTimed())
+							{
+								timedXforms.emplace_back(record.theTau, xform);
+							}
+							else
+							{
+								xforms.emplace_back(xform);
+							}
+						}
+						ptEdge->accumulateXforms
+							(xforms.cbegin(), xforms.cend());
+						ptEdge->accumulateTimedXforms
+							(timedXforms.cbegin(), timedXforms.cend());
+						bucketNumApplied[bucket] += ndxs.size();
+					}
+				}
+			}
+			, numThreads
+			);
+
+		// insert new edges into network (in deterministic order)
+		std::vector<NewEdge> newEdges;
+		for (std::vector<NewEdge> & bucketEdges : bucketNewEdges)
+		{
+			newEdges.insert
+				(newEdges.end(), bucketEdges.cbegin(), bucketEdges.cend());
+		}
+		std::sort
+			( newEdges.begin(), newEdges.end()
+			, [] (NewEdge const & edgeA, NewEdge const & edgeB)
+				{ return (edgeA.first < edgeB.first); }
+			);
+		for (NewEdge const & newEdge : newEdges)
+		{
+			geo.insertEdge(newEdge.second);
+		}
+
+		// note modification of existing edges (e.g. for checkpoints)
+		for (std::vector<EdgeDir> const & oldDirs : bucketOldDirs)
+		{
+			for (EdgeDir const & oldDir : oldDirs)
+			{
+				geo.markChanged(oldDir);
+			}
+		}
+
+		std::size_t numApplied{ 0u };
+		for (std::size_t const & bucketNum : bucketNumApplied)
+		{
+			numApplied += bucketNum;
+		}
+		return numApplied;
+	}
+
+} // [journal]
+
+} // [orinet]
+
+
+#endif // OriNet_journal_INCL_
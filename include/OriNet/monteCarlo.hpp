@@ -0,0 +1,332 @@
+//
+// MIT License
+//
+// Copyright (c) 2024 Stellacore Corporation
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+
+#ifndef OriNet_monteCarlo_INCL_
+#define OriNet_monteCarlo_INCL_
+
+/*! \file
+\brief Multi-threaded Monte-Carlo study evaluation and columnar output.
+
+A study is a collection of cells (e.g. the nodes of a parameter grid)
+each of which is evaluated with a number of (independent) replicates.
+Each replicate is a task that is run on a pool of threads. Replicate
+results (e.g. stat::Summary) are merged per cell.
+
+Example:
+\snippet test_monteCarlo.cpp DoxyExample01
+
+*/
+
+
+#include "parallel.hpp"
+#include "random.hpp"
+
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+
+namespace orinet
+{
+
+/*! \brief Monte-Carlo study evaluation
+ */
+namespace mc
+{
+
+	/*! \brief Results per cell from tasks run for each (cell, replicate).
+	 *
+	 * The taskFunc is called as:
+	 * \code
+	 * taskFunc(Accum * ptAccum, cellNdx, repNdx, random::Context & ctx)
+	 * \endcode
+	 * once for each combination of cellNdx in [0, numCells) and repNdx
+	 * in [0, numReps). The tasks are scheduled dynamically on a pool of
+	 * (up to) numThreads threads (zero for hardware concurrency).
+	 *
+	 * Each task has its own (default constructed) Accum instance and
+	 * the random context ctx.stream(cellNdx*numReps + repNdx). The
+	 * replicate results are merged - in order of repNdx - into the
+	 * result for each cell via Accum::merge(). Results are therefore
+	 * the same regardless of number of threads or task scheduling.
+	 */
+	template <typename Accum, typename TaskFunc>
+	inline
+	std::vector<Accum>
+	cellResults
+		( std::size_t const & numCells
+		, std::size_t const & numReps
+		, TaskFunc const & taskFunc
+		, random::Context const & ctx
+		, std::size_t const & numThreads = 0u
+		)
+	{
+		std::size_t const numTasks{ numCells * numReps };
+		std::vector<Accum> taskAccums(numTasks);
+		parallel::forEachIndex
+			( numTasks
+			, [&] (std::size_t const taskNdx)
+			{
+				std::size_t const cellNdx{ taskNdx / numReps };
+				std::size_t const repNdx{ taskNdx % numReps };
+				random::Context taskCtx{ ctx.stream(taskNdx) };
+				taskFunc(&(taskAccums[taskNdx]), cellNdx, repNdx, taskCtx);
+			}
+			, numThreads
+			);
+
+		std::vector<Accum> cellAccums(numCells);
+		for (std::size_t cellNdx{0u} ; cellNdx < numCells ; ++cellNdx)
+		{
+			for (std::size_t repNdx{0u} ; repNdx < numReps ; ++repNdx)
+			{
+				cellAccums[cellNdx].merge
+					(taskAccums[cellNdx*numReps + repNdx]);
+			}
+		}
+		return cellAccums;
+	}
+
+
+	/*! \brief Named columns of (double) values - e.g. results per cell.
+	 *
+	 * Binary file layout (written by write(), read by read()):
+	 * \code
+	 * char[8]   : "OriNetMC"
+	 * uint64    : number of columns
+	 * uint64    : number of rows
+	 * per column: uint64 name size, followed by name characters
+	 * per column: (number of rows) double values
+	 * \endcode
+	 * Integers and doubles are stored in native byte order.
+	 */
+	struct Columns
+	{
+		std::vector<std::string> theNames{};
+		std::vector<std::vector<double> > theValues{};
+
+		//! Signature at start of binary data
+		static constexpr char sMagic[8u]{ 'O','r','i','N','e','t','M','C' };
+
+		//! Append a column (all columns should have the same size)
+		inline
+		void
+		addColumn  // Columns::
+			( std::string const & name
+			, std::vector<double> const & values
+			)
+		{
+			theNames.emplace_back(name);
+			theValues.emplace_back(values);
+		}
+
+		//! Number of rows (size of first column)
+		inline
+		std::size_t
+		numRows  // Columns::
+			() const
+		{
+			std::size_t num{ 0u };
+			if (! theValues.empty())
+			{
+				num = theValues.front().size();
+			}
+			return num;
+		}
+
+		//! True if all columns are named and of the same size
+		inline
+		bool
+		isValid  // Columns::
+			() const
+		{
+			bool okay{ theNames.size() == theValues.size() };
+			for (std::vector<double> const & values : theValues)
+			{
+				okay &= (values.size() == numRows());
+			}
+			return okay;
+		}
+
+		//! Put binary representation to stream (false on error).
+		inline
+		bool
+		write  // Columns::
+			( std::ostream & ostrm
+			) const
+		{
+			bool okay{ isValid() };
+			if (okay)
+			{
+				std::uint64_t const numCols{ theValues.size() };
+				std::uint64_t const numRowsOut{ numRows() };
+				ostrm.write(sMagic, sizeof(sMagic));
+				writeU64(ostrm, numCols);
+				writeU64(ostrm, numRowsOut);
+				for (std::string const & name : theNames)
+				{
+					writeU64(ostrm, name.size());
+					ostrm.write(name.data(), std::streamsize(name.size()));
+				}
+				for (std::vector<double> const & values : theValues)
+				{
+					ostrm.write
+						( reinterpret_cast<char const *>(values.data())
+						, std::streamsize(values.size() * sizeof(double))
+						);
+				}
+				okay = ostrm.good();
+			}
+			else
+			{
+				std::cerr << "Columns::write: invalid (inconsistent) columns\n";
+			}
+			return okay;
+		}
+
+		//! Instance from binary stream data (not isValid() on error).
+		inline
+		static
+		Columns
+		read  // Columns::
+			( std::istream & istrm
+			)
+		{
+			Columns cols;
+			char magic[8u]{};
+			istrm.read(magic, sizeof(magic));
+			bool okay
+				{ istrm.good()
+				&& (0 == std::memcmp(magic, sMagic, sizeof(sMagic)))
+				};
+			std::uint64_t const numCols{ okay ? readU64(istrm) : 0u };
+			std::uint64_t const numRowsIn{ okay ? readU64(istrm) : 0u };
+
+			// sizes from (possibly corrupt) data must fit in the stream
+			std::uint64_t const maxBytes{ remainingSize(istrm) };
+			okay = okay
+				&& istrm.good()
+				&& (numCols <= (maxBytes / sizeof(std::uint64_t)))
+				&& ((0u == numCols) || (numRowsIn
+					<= ((maxBytes / sizeof(double)) / numCols)));
+			for (std::uint64_t nCol{0u} ; okay && (nCol < numCols) ; ++nCol)
+			{
+				std::uint64_t const nameSize{ readU64(istrm) };
+				okay = istrm.good() && (nameSize <= remainingSize(istrm));
+				if (okay)
+				{
+					std::string name(nameSize, '\0');
+					istrm.read(name.data(), std::streamsize(name.size()));
+					cols.theNames.emplace_back(name);
+					okay = istrm.good();
+				}
+			}
+			for (std::uint64_t nCol{0u} ; okay && (nCol < numCols) ; ++nCol)
+			{
+				std::vector<double> values(numRowsIn);
+				istrm.read
+					( reinterpret_cast<char *>(values.data())
+					, std::streamsize(values.size() * sizeof(double))
+					);
+				cols.theValues.emplace_back(std::move(values));
+				okay = istrm.good();
+			}
+			if (! okay)
+			{
+				std::cerr << "Columns::read: invalid or incomplete data\n";
+				cols.theNames.emplace_back("<error>"); // make invalid
+			}
+			return cols;
+		}
+
+	private:
+
+		//! Limit on data size for streams of unknown length (bytes)
+		static constexpr std::uint64_t sMaxStreamSize{ 1ull << 34u };
+
+		/*! \brief Number of bytes remaining in istrm.
+		 *
+		 * For streams that do not support positioning (e.g. pipes), the
+		 * result is sMaxStreamSize (as a sanity limit on data sizes).
+		 */
+		inline
+		static
+		std::uint64_t
+		remainingSize  // Columns::
+			( std::istream & istrm
+			)
+		{
+			std::uint64_t size{ sMaxStreamSize };
+			std::istream::pos_type const posNow{ istrm.tellg() };
+			if (std::istream::pos_type(-1) != posNow)
+			{
+				istrm.seekg(0, std::ios::end);
+				std::istream::pos_type const posEnd{ istrm.tellg() };
+				istrm.seekg(posNow);
+				if ((std::istream::pos_type(-1) != posEnd) && istrm.good())
+				{
+					size = static_cast<std::uint64_t>(posEnd - posNow);
+				}
+			}
+			return size;
+		}
+
+		//! Put integer value to stream (native byte order)
+		inline
+		static
+		void
+		writeU64  // Columns::
+			( std::ostream & ostrm
+			, std::uint64_t const & value
+			)
+		{
+			ostrm.write
+				(reinterpret_cast<char const *>(&value), sizeof(value));
+		}
+
+		//! Get integer value from stream (native byte order)
+		inline
+		static
+		std::uint64_t
+		readU64  // Columns::
+			( std::istream & istrm
+			)
+		{
+			std::uint64_t value{ 0u };
+			istrm.read(reinterpret_cast<char *>(&value), sizeof(value));
+			return value;
+		}
+
+	}; // Columns
+
+
+} // [mc]
+
+} // [orinet]
+
+
+#endif // OriNet_monteCarlo_INCL_
@@ -37,14 +37,21 @@ Example:
 
 #include "networkVert.hpp"
 #include "stat.hpp"
+#include "trace.hpp"
 
 #include <Engabra>
 #include <graaflib/edge.h>
 #include <Rigibra>
 
+#include <atomic>
+#include <deque>
 #include <iostream>
+#include <mutex>
+#include <random>
 #include <sstream>
 #include <string>
+#include <utility>
+#include <vector>
 
 
 namespace orinet
@@ -464,6 +471,22 @@ namespace network
 	{
 		stat::track::Transforms theXformTracker;
 
+		//! Time stamped observations (oldest first) subject to forgetting
+		std::deque<std::pair<double, rigibra::Transform> > theTimedXforms{};
+
+		//! Policy for discarding stale time stamped observations
+		stat::track::Forgetting theForgetting{};
+
+		//! Estimates cached by reestimate() - valid until data change
+		mutable rigibra::Transform theEstXform
+			{ rigibra::null<rigibra::Transform>() };
+		mutable std::atomic<double> theEstWeight
+			{ engabra::g3::null<double>() };
+		mutable std::atomic<bool> theEstIsCurrent{ false };
+
+		//! Serializes (re)computation of the cached estimates
+		mutable std::mutex theEstMutex{};
+
 		//! Value ctor.
 		inline
 		explicit
@@ -478,6 +501,43 @@ namespace network
 			accumulateXform(xform);
 		}
 
+		/*! \brief Value ctor - for time stamped observations.
+		 *
+		 * The reserveSize need only be large enough to hold the
+		 * number of observations expected to be retained by the
+		 * forgetting policy.
+		 */
+		inline
+		explicit
+		EdgeRobust  // EdgeRobust::
+			( EdgeDir const & edgeDir
+			, rigibra::Transform const & xform
+			, double const & tau
+			, std::size_t const & reserveSize
+			, stat::track::Forgetting const & forgetting
+			)
+			: EdgeBase(edgeDir)
+			, theXformTracker(reserveSize)
+			, theForgetting{ forgetting }
+		{
+			accumulateXform(xform, tau);
+		}
+
+		/*! \brief Instance without observations (e.g. for restoring state).
+		 *
+		 * The instance is not valid until observations are accumulated
+		 * (or tracker contents are restored - e.g. by checkpoint).
+		 */
+		inline
+		explicit
+		EdgeRobust  // EdgeRobust::
+			( EdgeDir const & edgeDir
+			, std::size_t const & reserveSize
+			)
+			: EdgeBase(edgeDir)
+			, theXformTracker(reserveSize)
+		{ }
+
 		//! No-op dtor.
 		virtual
 		inline
@@ -504,29 +564,200 @@ namespace network
 			)
 		{
 			theXformTracker.insert(xform);
+			theEstIsCurrent = false;
 		}
 
-		//! Transformation (Hi-Ndx w.r.t. Lo-Ndx)
-		virtual
+		/*! \brief Insert observation made at time tau and forget stale ones.
+		 *
+		 * Observation times are expected to be non-decreasing. After
+		 * the insertion, older observations are discarded according to
+		 * theForgetting policy (via compact()).
+		 *
+		 * Observations inserted without a time stamp (by the other
+		 * accumulateXform() overload) are never discarded.
+		 */
 		inline
-		rigibra::Transform
-		xform  // EdgeRobust::
-			() const override
+		void
+		accumulateXform  // EdgeRobust::
+			( rigibra::Transform const & xform
+			, double const & tau
+			)
 		{
-			return theXformTracker.median();
+			theTimedXforms.emplace_back(tau, xform);
+			theXformTracker.insert(xform);
+			theEstIsCurrent = false;
+			compact(tau);
 		}
 
-		//! \brief Unity for now - assuming all medians() are similar quality
-		// TODO (transformation 50 percentile error) TODO
-		[[nodiscard]]
+		/*! \brief Insert many (untimed) observations at once.
+		 *
+		 * Same result as accumulateXform(xform) for each of the
+		 * rigibra::Transform values in [beg, end) but with a bulk
+		 * tracker load (ref stat::track::Transforms::insertMany()).
+		 */
+		template <typename FwdIter>
 		inline
-		virtual
+		void
+		accumulateXforms  // EdgeRobust::
+			( FwdIter const & beg
+			, FwdIter const & end
+			)
+		{
+			if (end != beg)
+			{
+				theXformTracker.insertMany(beg, end);
+				theEstIsCurrent = false;
+			}
+		}
+
+		/*! \brief Insert many time stamped observations at once.
+		 *
+		 * Same result as accumulateXform(xform, tau) for each of the
+		 * std::pair<double, rigibra::Transform> (tau, xform) values
+		 * in [beg, end) - which are expected to be in non-decreasing
+		 * time order. Observations that would be discarded by then
+		 * (ref compact()) are never inserted into the tracker and the
+		 * remaining ones are inserted with a bulk tracker load.
+		 *
+		 * Returns the number of observations discarded.
+		 */
+		template <typename FwdIter>
+		inline
+		std::size_t
+		accumulateTimedXforms  // EdgeRobust::
+			( FwdIter const & beg
+			, FwdIter const & end
+			)
+		{
+			std::size_t numDropped{ 0u };
+			if (end != beg)
+			{
+				std::size_t const numPrev{ theTimedXforms.size() };
+				theTimedXforms.insert(theTimedXforms.end(), beg, end);
+				std::size_t const numAll{ theTimedXforms.size() };
+
+				// count as compact() would at the most recent time
+				double const tauNow{ theTimedXforms.back().first };
+				while ((numDropped + 1u) < numAll)
+				{
+					double const age
+						{ tauNow - theTimedXforms[numDropped].first };
+					bool const tooMany
+						{ theForgetting.theMaxSize < (numAll - numDropped) };
+					if (! (tooMany || theForgetting.isStale(age)))
+					{
+						break;
+					}
+					++numDropped;
+				}
+
+				// only previous observations are in tracker already
+				for (std::size_t nn{0u} ; nn < numDropped ; ++nn)
+				{
+					if (nn < numPrev)
+					{
+						theXformTracker.erase(theTimedXforms.front().second);
+					}
+					theTimedXforms.pop_front();
+				}
+
+				// bulk load those new observations that are retained
+				std::size_t const numKeepPrev
+					{ (numDropped < numPrev) ? (numPrev - numDropped) : 0u };
+				std::vector<rigibra::Transform> newXforms;
+				newXforms.reserve(theTimedXforms.size() - numKeepPrev);
+				for (std::size_t nn{numKeepPrev} ; nn < theTimedXforms.size()
+					; ++nn)
+				{
+					newXforms.emplace_back(theTimedXforms[nn].second);
+				}
+				theXformTracker.insertMany
+					(newXforms.cbegin(), newXforms.cend());
+				theEstIsCurrent = false;
+			}
+			return numDropped;
+		}
+
+		/*! \brief Discard time stamped observations that are stale at tauNow.
+		 *
+		 * Observations are discarded (oldest first) if they are stale
+		 * according to theForgetting or if more than theMaxSize are
+		 * present. The most recent observation is always retained.
+		 *
+		 * Returns the number of observations discarded.
+		 */
+		inline
+		std::size_t
+		compact  // EdgeRobust::
+			( double const & tauNow
+			)
+		{
+			std::size_t numDropped{ 0u };
+			while (1u < theTimedXforms.size())
+			{
+				std::pair<double, rigibra::Transform> const & oldest
+					= theTimedXforms.front();
+				double const age{ tauNow - oldest.first };
+				bool const tooMany
+					{ theForgetting.theMaxSize < theTimedXforms.size() };
+				if (! (tooMany || theForgetting.isStale(age)))
+				{
+					break;
+				}
+				theXformTracker.erase(oldest.second);
+				theTimedXforms.pop_front();
+				theEstIsCurrent = false;
+				++numDropped;
+			}
+			return numDropped;
+		}
+
+		/*! \brief Update (cached) estimates from current observations.
+		 *
+		 * The robust estimates (median and median error) are relatively
+		 * expensive. They are computed here once per change of data,
+		 * after which xform() and get_weight() return cached values.
+		 * This is called on demand by xform() (and by Geometry
+		 * functions that use edge weights) but may be called
+		 * explicitly, e.g. to control when the work is done. Note that
+		 * get_weight() does not call this (ref get_weight()).
+		 *
+		 * The cache is refreshed under a lock such that const access
+		 * (xform(), get_weight()) is safe from concurrent threads (e.g.
+		 * several threads reading the same network). Functions that
+		 * modify the observations are not, i.e. they should not be
+		 * called concurrently with any other access.
+		 *
+		 * NOTE: Direct modification of theXformTracker bypasses this
+		 * mechanism - use accumulateXform() to add observations.
+		 */
+		inline
+		void
+		reestimate  // EdgeRobust::
+			() const
+		{
+			std::lock_guard<std::mutex> const lock(theEstMutex);
+			if (! theEstIsCurrent.load(std::memory_order_relaxed))
+			{
+				OriNet_TRACE_SPAN_ARG
+					("EdgeRobust::reestimate", theXformTracker.size());
+				theEstXform = theXformTracker.median();
+				theEstWeight.store
+					(weightFor(theXformTracker), std::memory_order_relaxed);
+				theEstIsCurrent.store(true, std::memory_order_release);
+			}
+		}
+
+		//! Edge weight for the median estimate from xformTracker
+		inline
+		static
 		double
-		get_weight // EdgeRobust::
-			() const noexcept override
+		weightFor  // EdgeRobust::
+			( stat::track::Transforms const & xformTracker
+			)
 		{
 			double weight{ engabra::g3::null<double>() };
-			std::size_t const numXforms{ theXformTracker.size() };
+			std::size_t const numXforms{ xformTracker.size() };
 			if (0u < numXforms) // 0u shouldn't be possible if edge exists
 			{
 				if (1u == numXforms)
@@ -539,12 +770,93 @@ namespace network
 				else
 				{
 					constexpr bool normComp{ false };
-					weight = theXformTracker.medianErrorEstimate(normComp);
+					weight = xformTracker.medianErrorEstimate(normComp);
 				}
 			}
 			return weight;
 		}
 
+		/*! \brief Edge with estimates from resampled observations.
+		 *
+		 * The observations are resampled with replacement and the
+		 * result is an EdgeOri with the median transform and weight
+		 * (as for reestimate()) of the resampled collection - e.g. for
+		 * one replicate of a bootstrap ensemble. This instance
+		 * (including its cached estimates) is not modified.
+		 *
+		 * If all observations are time stamped, whole observations
+		 * (from theTimedXforms) are drawn such that the location and
+		 * attitude components of each stay together. Otherwise, the
+		 * tracker holds only the (sorted) components and these are
+		 * resampled independently (ref
+		 * stat::track::Transforms::resampled()). This marginal
+		 * resampling ignores correlation between the components
+		 * and can combine values from different observations.
+		 */
+		template <typename Generator>
+		inline
+		std::shared_ptr<EdgeBase>
+		resampledInstance  // EdgeRobust::
+			( Generator & gen
+			) const
+		{
+			std::size_t const numObs{ theXformTracker.size() };
+			stat::track::Transforms xformSamps(0u);
+			if ((0u < numObs) && (theTimedXforms.size() == numObs))
+			{
+				// joint resampling of whole observations
+				std::uniform_int_distribution<std::size_t> dist
+					(0u, numObs - 1u);
+				std::vector<rigibra::Transform> xforms;
+				xforms.reserve(numObs);
+				for (std::size_t nn{0u} ; nn < numObs ; ++nn)
+				{
+					xforms.emplace_back(theTimedXforms[dist(gen)].second);
+				}
+				xformSamps = stat::track::Transforms(numObs);
+				xformSamps.insertMany(xforms.cbegin(), xforms.cend());
+			}
+			else
+			{
+				// marginal (per component) resampling
+				xformSamps = theXformTracker.resampled(gen);
+			}
+			return std::make_shared<EdgeOri>
+				(theEdgeDir, xformSamps.median(), weightFor(xformSamps));
+		}
+
+		//! Transformation (Hi-Ndx w.r.t. Lo-Ndx)
+		virtual
+		inline
+		rigibra::Transform
+		xform  // EdgeRobust::
+			() const override
+		{
+			if (! theEstIsCurrent.load(std::memory_order_acquire))
+			{
+				reestimate();
+			}
+			return theEstXform;
+		}
+
+		/*! \brief Median error of tracked transforms (or large if only one)
+		 *
+		 * This (noexcept graaf interface) only returns the weight
+		 * cached by the most recent reestimate() - it does not lock
+		 * or compute. After observations change, the value is stale
+		 * until reestimate() (or xform()) is called. Geometry functions
+		 * that use weights (e.g. Geometry::spanningEdgeBases()) do so.
+		 */
+		[[nodiscard]]
+		inline
+		virtual
+		double
+		get_weight // EdgeRobust::
+			() const noexcept override
+		{
+			return theEstWeight.load(std::memory_order_acquire);
+		}
+
 		//! An instance associated with edge in reverse direction.
 		virtual
 		inline
@@ -552,6 +864,7 @@ namespace network
 		reversedInstance  // EdgeRobust::
 			() const override
 		{
+			reestimate(); // before (unsequenced) xform() and get_weight()
 			return std::make_shared<EdgeOri>
 				( edgeDir().reverseEdgeDir()
 				, rigibra::inverse(xform())
@@ -567,6 +880,7 @@ namespace network
 			( std::string const & title = {}
 			) const override
 		{
+			reestimate(); // current weight for EdgeBase::infoString()
 			std::ostringstream oss;
 			oss << EdgeBase::infoString(title)
 				<< ' '
@@ -31,16 +31,20 @@
 
 */
 
+#include "applied.hpp"
 #include "networkEdge.hpp"
 
 #include <Engabra>
 #include <graaflib/graph.h>
 #include <Rigibra>
 
+#include <algorithm>
 #include <filesystem>
 #include <iostream>
+#include <limits>
 #include <map>
 #include <memory>
+#include <set>
 #include <string>
 #include <utility>
 #include <vector>
@@ -51,6 +55,160 @@ namespace orinet
 
 namespace network
 {
+	/*! \brief Per station path information from transform propagation.
+	 *
+	 * Arrays are all the same size with one entry per station in
+	 * the order that stations are reached by the propagation (i.e.
+	 * each parent station precedes its children). The first entry
+	 * is the starting station (with depth zero, zero cumulative
+	 * weight and with parent index sNullNdx).
+	 */
+	struct PathMetrics
+	{
+		//! Parent index value for the starting station.
+		static constexpr std::size_t sNullNdx
+			{ std::numeric_limits<std::size_t>::max() };
+
+		//! Station key for each entry.
+		std::vector<StaKey> theStaKeys{};
+
+		//! Index (into these arrays) of the station reached from.
+		std::vector<std::size_t> theParentNdxs{};
+
+		//! Number of edges (hops) from the starting station.
+		std::vector<std::size_t> theDepths{};
+
+		//! Sum of edge weights (get_weight()) along path from start.
+		std::vector<double> theCumWeights{};
+
+		//! Number of entries (stations)
+		inline
+		std::size_t
+		size  // PathMetrics::
+			() const
+		{
+			return theStaKeys.size();
+		}
+
+		//! Remove all entries and reserve space for numSta of them
+		inline
+		void
+		reset  // PathMetrics::
+			( std::size_t const & numSta
+			)
+		{
+			theStaKeys.clear();
+			theParentNdxs.clear();
+			theDepths.clear();
+			theCumWeights.clear();
+			theStaKeys.reserve(numSta);
+			theParentNdxs.reserve(numSta);
+			theDepths.reserve(numSta);
+			theCumWeights.reserve(numSta);
+		}
+
+		//! Add the starting station, returns its index (zero)
+		inline
+		std::size_t
+		appendStart  // PathMetrics::
+			( StaKey const & staKey
+			)
+		{
+			theStaKeys.emplace_back(staKey);
+			theParentNdxs.emplace_back(sNullNdx);
+			theDepths.emplace_back(0u);
+			theCumWeights.emplace_back(0.);
+			return (size() - 1u);
+		}
+
+		//! Add station reached from parentNdx (via edge of edgeWeight)
+		inline
+		std::size_t
+		appendChild  // PathMetrics::
+			( StaKey const & staKey
+			, std::size_t const & parentNdx
+			, double const & edgeWeight
+			)
+		{
+			theStaKeys.emplace_back(staKey);
+			theParentNdxs.emplace_back(parentNdx);
+			theDepths.emplace_back(theDepths[parentNdx] + 1u);
+			theCumWeights.emplace_back(theCumWeights[parentNdx] + edgeWeight);
+			return (size() - 1u);
+		}
+
+		//! Station key for parent of entry ndx (sNullKey for start)
+		inline
+		StaKey
+		parentKey  // PathMetrics::
+			( std::size_t const & ndx
+			) const
+		{
+			StaKey key{ sNullKey };
+			std::size_t const & parentNdx = theParentNdxs[ndx];
+			if (sNullNdx != parentNdx)
+			{
+				key = theStaKeys[parentNdx];
+			}
+			return key;
+		}
+
+	}; // PathMetrics
+
+
+	/*! \brief Stations and edges that have been added or modified.
+	 *
+	 * Station keys are in order of their addition to the network (i.e.
+	 * graph vertex order). Edges are identified by the station key pair
+	 * in increasing order (independent of edge direction).
+	 */
+	struct ChangeSet
+	{
+		//! Stations (added) in network vertex order.
+		std::vector<StaKey> theStaKeys{};
+
+		//! Edges (lo,hi station key pair) added or modified.
+		std::set<std::pair<StaKey, StaKey> > theEdgeKeys{};
+
+		//! Key pair (in increasing order) for edge in either direction
+		inline
+		static
+		std::pair<StaKey, StaKey>
+		edgeKeyFor  // ChangeSet::
+			( EdgeDir const & edgeDir
+			)
+		{
+			StaKey const fromKey{ edgeDir.fromKey() };
+			StaKey const intoKey{ edgeDir.intoKey() };
+			return { std::min(fromKey, intoKey), std::max(fromKey, intoKey) };
+		}
+
+		//! True if there are no stations or edges.
+		inline
+		bool
+		empty  // ChangeSet::
+			() const
+		{
+			return (theStaKeys.empty() && theEdgeKeys.empty());
+		}
+
+	}; // ChangeSet
+
+
+	/*! \brief Station keys in space filling curve order of their locations.
+	 *
+	 * Station locations (e.g. from Geometry::propagateTransforms())
+	 * are quantized within their bounding box and sorted by their
+	 * Morton (Z-order) code such that stations close to each other
+	 * are (mostly) close together in the result. E.g. for use with
+	 * Geometry::renumbered().
+	 */
+	std::vector<StaKey>
+	spaceFillingOrder
+		( std::map<StaKey, rigibra::Transform> const & staXforms
+		);
+
+
 	/*! \brief Representation of the geometry of a rigid body network.
 	 *
 	 * Uses a graph data structure to store StaFrame instances as nodes
@@ -96,6 +254,12 @@ namespace network
 		graaf::undirected_graph<StaFrame, std::shared_ptr<EdgeBase> >
 			theGraph{};
 
+		//! Stations and edges changed since most recent takeChanges()
+		ChangeSet theChanges{};
+
+		//! If true, changes are noted in #theChanges (ref trackChanges())
+		bool theTracksChanges{ false };
+
 		//! True if station is already a node in graph
 		bool
 		hasStaKey
@@ -108,6 +272,11 @@ namespace network
 			( StaKey const & staKey
 			);
 
+		//! Bring cached EdgeRobust estimates (e.g. weights) up to date
+		void
+		reestimateEdges
+			() const;
+
 		//! Graaf vertex ID value for station index
 		VertId
 		vertIdForStaKey
@@ -126,12 +295,36 @@ namespace network
 			( graaf::edge_id_t const & eId
 			) const;
 
+		/*! \brief Vertex ids in breadth first order over all components.
+		 *
+		 * Each (unvisited) vertex of startVIds in turn starts traversal
+		 * of its component. Neighbors are visited in order of increasing
+		 * (*ptDegrees)[vId] (if not null) and then of vertex id.
+		 */
+		std::vector<VertId>
+		traversalVertIds
+			( std::vector<VertId> const & startVIds
+			, std::vector<std::size_t> const * const & ptDegrees
+			) const;
+
 		//! Functor for graph traversal transform propagation
 		struct Propagator
 		{
 			Geometry const * const thePtGeo;
 			std::map<StaKey, rigibra::Transform> * const thePtStaXforms;
 
+			//! If not null, path information is appended for each edge
+			PathMetrics * const thePtMetrics{ nullptr };
+
+			//! Index into #thePtMetrics arrays by VertId (if used)
+			mutable std::vector<std::size_t> theMetricNdxs{};
+
+			//! Station (traversal from) for most recent edge
+			mutable StaKey thePrevFromKey{ sNullKey };
+
+			//! Applied form for thePrevFromKey (formed when reused)
+			mutable applied::Xform thePrevFromApplied{};
+
 			//! Update #thePtStaXforms content with each edge
 			void
 			operator()
@@ -142,6 +335,17 @@ namespace network
 
 	public:
 
+		/*! \brief Add stations (in order) that are not already in graph.
+		 *
+		 * Graph vertices are created in the order of staKeys (e.g. to
+		 * reproduce the vertex order of a saved or original network
+		 * before its edges are inserted).
+		 */
+		void
+		insertStations
+			( std::vector<StaKey> const & staKeys
+			);
+
 		/*! \brief Insert transformation edge into graph
 		 *
 		 * Example:
@@ -158,6 +362,62 @@ namespace network
 			( EdgeDir const & edgeDir
 			) const;
 
+		/*! \brief Accumulate an observation into a (robust) edge.
+		 *
+		 * If an edge already exists for edgeDir, the transform is
+		 * accumulated into it (which requires that edge to be of
+		 * EdgeRobust type). Otherwise, a new EdgeRobust instance
+		 * (with tracker capacity reserveSize) is inserted.
+		 *
+		 * The xIntoWrtFrom transform must be consistent with the
+		 * edgeDir interpretation (i.e. xInto = xIntoWrtFrom(xFrom)).
+		 */
+		void
+		accumulateEdgeXform
+			( EdgeDir const & edgeDir
+			, rigibra::Transform const & xIntoWrtFrom
+			, std::size_t const & reserveSize
+			);
+
+		/*! \brief Insert observations from one hub to each of several spokes.
+		 *
+		 * This is a "star" registration of observations such as a single
+		 * camera exposure (hub station) that observes several object
+		 * features (spoke stations). The hub is a first-class station
+		 * in the network (i.e. has a graph node like any other station).
+		 *
+		 * Each transform in xHubWrtSpokes is accumulated into a robust
+		 * edge between hubKey and the spoke key (by accumulateEdgeXform())
+		 * such that the effort is linear in the number of spokes. Direct
+		 * relationships between spoke stations are not created. If needed,
+		 * they may be derived on demand via xformViaHubs().
+		 *
+		 * Example:
+		 * \snippet test_slam.cpp DoxyExampleStar
+		 */
+		void
+		insertStarObservations
+			( StaKey const & hubKey
+			, std::vector<std::pair<StaKey, rigibra::Transform> >
+				const & xHubWrtSpokes
+			, std::size_t const & reserveSize
+			);
+
+		/*! \brief Relative orientation derived through common neighbor hubs.
+		 *
+		 * For each station (hub) that is directly connected to both of
+		 * the edgeDir stations, a candidate transform is computed by
+		 * composition of the two edge transforms (into w.r.t. hub and
+		 * hub w.r.t. from). The result is a robust estimate from all of
+		 * the candidates (by robust::transformViaEffect()).
+		 *
+		 * Returns null transform if there are no common neighbors.
+		 */
+		rigibra::Transform
+		xformViaHubs
+			( EdgeDir const & edgeDir
+			) const;
+
 		//! Edges forming a minimum path
 		std::vector<graaf::edge_id_t>
 		spanningEdgeBases
@@ -181,12 +441,60 @@ namespace network
 			( std::vector<graaf::edge_id_t> const eIds
 			) const;
 
+		/*! \brief Station keys in breadth first traversal order from staKey0.
+		 *
+		 * Stations not connected to staKey0 follow (each further
+		 * component traversed from its first station in vertex order).
+		 * Neighbors are visited in vertex order (deterministic result).
+		 */
+		std::vector<StaKey>
+		breadthFirstOrder
+			( StaKey const & staKey0
+			) const;
+
+		/*! \brief Station keys in reverse Cuthill-McKee order.
+		 *
+		 * Bandwidth reducing order: each component is traversed breadth
+		 * first from a station of minimum degree (number of neighbors)
+		 * with neighbors visited in order of increasing degree. The
+		 * overall sequence is then reversed.
+		 */
+		std::vector<StaKey>
+		cuthillMcKeeOrder
+			() const;
+
+		/*! \brief Network with the same content but with renumbered vertices.
+		 *
+		 * Graph vertices are created in the order of staKeyOrder (e.g.
+		 * from breadthFirstOrder(), cuthillMcKeeOrder() or
+		 * spaceFillingOrder()). Stations not in staKeyOrder follow in
+		 * current vertex order. Edges (the same shared instances) are
+		 * then inserted in order of their new vertex ids.
+		 *
+		 * Station keys (and all results expressed in them) are not
+		 * affected. However, the graph storage is allocated in the new
+		 * order such that traversals that follow it (e.g.
+		 * propagateTransforms() from the first station of a breadth
+		 * first order) access memory more nearly sequentially.
+		 *
+		 * Example:
+		 * \snippet test_network.cpp DoxyExampleRenumber
+		 */
+		Geometry
+		renumbered
+			( std::vector<StaKey> const & staKeyOrder
+			) const;
+
 		/*! \brief Transformations computed by propagation through network
 		 *
 		 * Note that later computed transformations overwrite earlier ones.
 		 * In general, this is method is probably most useful if run
 		 * on a network that represents a minimum spanning tree.
 		 *
+		 * If ptMetrics is not null, it is (re)filled during the same
+		 * traversal with the path information (parent, depth and
+		 * cumulative edge weight) for each station reached.
+		 *
 		 * Example:
 	 	 * \snippet test_network.cpp DoxyExamplePropagate
 		 */
@@ -194,8 +502,81 @@ namespace network
 		propagateTransforms
 			( StaKey const & staKey0
 			, rigibra::Transform const & staXform0
+			, PathMetrics * const & ptMetrics = nullptr
+			) const;
+
+		/*! \brief Transformations propagated breadth first, level by level
+		 *
+		 * Produces the same result as propagateTransforms() for a
+		 * network that is a tree (e.g. result of networkTree()). For
+		 * a network with cycles, each station is computed from the
+		 * first (breadth first) station from which it is reached.
+		 *
+		 * Stations at the same distance (in edges) from staKey0 are
+		 * computed together: the edge transforms are loaded (with up
+		 * to parallel::threadCount(numThreads) threads) into applied
+		 * form arrays and the station offsets (and rotation matrices
+		 * for the next level) are propagated with the batch kernel,
+		 * applied::composeEach(). Station attitudes are composed
+		 * directly (as spinors) at the same time as edge loading.
+		 *
+		 * If ptMetrics is not null, it is (re)filled with the path
+		 * information as for propagateTransforms().
+		 */
+		std::map<StaKey, rigibra::Transform>
+		propagateTransformsByLevel
+			( StaKey const & staKey0
+			, rigibra::Transform const & staXform0
+			, std::size_t const & numThreads = 0u
+			, PathMetrics * const & ptMetrics = nullptr
 			) const;
 
+		/*! \brief Start (or stop) noting changes for use by takeChanges().
+		 *
+		 * Noting is off by default such that networks that are never
+		 * checkpointed do not accumulate (and pay for) a record of
+		 * every station and edge. It is enabled by checkpoint::Writer
+		 * (and by checkpoint::restore()). Stopping discards the changes
+		 * noted so far.
+		 */
+		void
+		trackChanges
+			( bool const & enable
+			);
+
+		//! True if changes are being noted (ref trackChanges())
+		bool
+		tracksChanges
+			() const;
+
+		/*! \brief Note modification of edge made via the edge() instance.
+		 *
+		 * Changes made through Geometry functions are noted
+		 * automatically (if tracksChanges()). This is needed only if
+		 * the edge is modified directly (e.g. with
+		 * EdgeRobust::accumulateXform()) so that the change is included
+		 * in the next takeChanges() result.
+		 */
+		void
+		markChanged
+			( EdgeDir const & edgeDir
+			);
+
+		/*! \brief Stations and edges changed since previous takeChanges().
+		 *
+		 * The changes noted so far are returned and noting restarts
+		 * (e.g. for use by incremental checkpoint operations). The
+		 * result is empty unless trackChanges() has been enabled.
+		 */
+		ChangeSet
+		takeChanges
+			();
+
+		//! All stations and edges (as though all had changed)
+		ChangeSet
+		allContents
+			() const;
+
 		//! Number of vertices in graph
 		std::size_t
 		sizeVerts
@@ -0,0 +1,267 @@
+//
+// MIT License
+//
+// Copyright (c) 2024 Stellacore Corporation
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+
+#ifndef OriNet_parallel_INCL_
+#define OriNet_parallel_INCL_
+
+/*! \file
+\brief Functions for (simple) multi-threaded processing of index ranges.
+
+Example:
+\snippet test_randomBulk.cpp DoxyExample01
+
+*/
+
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <thread>
+#include <vector>
+
+
+namespace orinet
+{
+
+/*! \brief Utilities for multi-threaded computation.
+ */
+namespace parallel
+{
+
+	//! Number of threads to use: numThreads or (if zero) hardware count
+	inline
+	std::size_t
+	threadCount
+		( std::size_t const & numThreads = 0u
+		)
+	{
+		std::size_t count{ numThreads };
+		if (0u == count)
+		{
+			count = static_cast<std::size_t>
+				(std::thread::hardware_concurrency());
+		}
+		return std::max(count, std::size_t{ 1u });
+	}
+
+	/*! \brief Threads that are joined on destruction (e.g. when unwinding).
+	 *
+	 * Destroying a joinable std::thread calls std::terminate(). A
+	 * guard ensures all threads started so far are joined even if
+	 * the calling thread exits the scope by exception.
+	 */
+	struct JoinGuard
+	{
+		std::vector<std::thread> * const thePtThreads;
+
+		//! Join each (joinable) thread.
+		inline
+		~JoinGuard  // JoinGuard::
+			()
+		{
+			for (std::thread & thread : *thePtThreads)
+			{
+				if (thread.joinable())
+				{
+					thread.join();
+				}
+			}
+		}
+
+	}; // JoinGuard
+
+	//! Rethrow the first (non-null) exception from errors (if any)
+	inline
+	void
+	rethrowFirst
+		( std::vector<std::exception_ptr> const & errors
+		)
+	{
+		for (std::exception_ptr const & error : errors)
+		{
+			if (error)
+			{
+				std::rethrow_exception(error);
+			}
+		}
+	}
+
+	/*! \brief Call func(beg, end) for contiguous ranges over [0, numItems).
+	 *
+	 * The ranges are disjoint, together cover all items and are
+	 * processed concurrently with (up to) threadCount(numThreads)
+	 * threads - one of which is the calling thread. Fewer threads are
+	 * used if needed to have at least minPerRange items per range.
+	 *
+	 * The func must be safe to call concurrently for disjoint ranges.
+	 * For results that do not depend on the number of threads, the
+	 * values produced for each item should depend only on the item
+	 * index (not on range boundaries).
+	 *
+	 * If func throws (on any thread), all threads are joined and then
+	 * the exception from the first such range is rethrown here.
+	 */
+	template <typename Func>
+	inline
+	void
+	forEachRange
+		( std::size_t const & numItems
+		, Func const & func
+		, std::size_t const & numThreads = 0u
+		, std::size_t const & minPerRange = 1024u
+		)
+	{
+		std::size_t const perRange{ std::max(minPerRange, std::size_t{ 1u }) };
+		std::size_t const maxRanges
+			{ std::max(std::size_t{ 1u }, numItems / perRange) };
+		std::size_t const numRanges
+			{ std::min(threadCount(numThreads), maxRanges) };
+		if (numRanges < 2u)
+		{
+			if (0u < numItems)
+			{
+				func(std::size_t{ 0u }, numItems);
+			}
+		}
+		else
+		{
+			// exception (if any) from each range
+			std::vector<std::exception_ptr> errors(numRanges);
+			auto const task
+				{ [&func, &errors]
+					( std::size_t const nRange
+					, std::size_t const beg
+					, std::size_t const end
+					)
+				{
+					try
+					{
+						func(beg, end);
+					}
+					catch (...)
+					{
+						errors[nRange] = std::current_exception();
+					}
+				}
+				};
+			{
+				std::vector<std::thread> threads;
+				JoinGuard const joinGuard{ &threads };
+				threads.reserve(numRanges - 1u);
+				std::size_t const baseSize{ numItems / numRanges };
+				std::size_t const numExtra{ numItems % numRanges };
+				std::size_t beg{ 0u };
+				for (std::size_t nRange{0u} ; nRange < numRanges ; ++nRange)
+				{
+					std::size_t const size
+						{ baseSize + ((nRange < numExtra) ? 1u : 0u) };
+					std::size_t const end{ beg + size };
+					if ((nRange + 1u) < numRanges)
+					{
+						threads.emplace_back(task, nRange, beg, end);
+					}
+					else
+					{
+						task(nRange, beg, end); // last on calling thread
+					}
+					beg = end;
+				}
+			} // threads joined
+			rethrowFirst(errors);
+		}
+	}
+
+	/*! \brief Call func(ndx) for each ndx in [0, numItems) - dynamically.
+	 *
+	 * A pool of threadCount(numThreads) threads (including the calling
+	 * thread) repeatedly claim the next unprocessed index (from a shared
+	 * atomic counter). This balances the load for items that require
+	 * different amounts of effort. The order (and thread) in which the
+	 * items are processed varies from run to run.
+	 *
+	 * If func throws (on any thread), no further indices are claimed,
+	 * all threads are joined and then an exception (the first of the
+	 * calling thread then of the other threads) is rethrown here.
+	 */
+	template <typename Func>
+	inline
+	void
+	forEachIndex
+		( std::size_t const & numItems
+		, Func const & func
+		, std::size_t const & numThreads = 0u
+		)
+	{
+		std::size_t const numUse
+			{ std::max
+				( std::size_t{ 1u }
+				, std::min(threadCount(numThreads), numItems)
+				)
+			};
+		std::vector<std::exception_ptr> errors(numUse);
+		std::atomic<std::size_t> nextNdx{ 0u };
+		auto const worker
+			{ [&nextNdx, &numItems, &func, &errors]
+				( std::size_t const nThread
+				)
+				{
+					try
+					{
+						for (;;)
+						{
+							std::size_t const ndx{ nextNdx.fetch_add(1u) };
+							if (! (ndx < numItems))
+							{
+								break;
+							}
+							func(ndx);
+						}
+					}
+					catch (...)
+					{
+						errors[nThread] = std::current_exception();
+						nextNdx.store(numItems); // others stop claiming
+					}
+				}
+			};
+		{
+			std::vector<std::thread> threads;
+			JoinGuard const joinGuard{ &threads };
+			threads.reserve(numUse - 1u);
+			for (std::size_t nThread{1u} ; nThread < numUse ; ++nThread)
+			{
+				threads.emplace_back(worker, nThread);
+			}
+			worker(std::size_t{ 0u }); // calling thread
+		} // threads joined
+		rethrowFirst(errors);
+	}
+
+} // [parallel]
+
+} // [orinet]
+
+
+#endif // OriNet_parallel_INCL_
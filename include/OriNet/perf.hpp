@@ -0,0 +1,484 @@
+//
+// MIT License
+//
+// Copyright (c) 2024 Stellacore Corporation
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+
+#ifndef OriNet_perf_INCL_
+#define OriNet_perf_INCL_
+
+/*! \file
+\brief Classes for low overhead recording of latency statistics.
+
+Example:
+\snippet test_perf.cpp DoxyExample01
+
+*/
+
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <sstream>
+#include <string>
+
+
+namespace orinet
+{
+
+/*! \brief Performance instrumentation (e.g. latency histograms).
+ */
+namespace perf
+{
+
+	/*! \brief Log-linear (HDR style) histogram of non-negative integers.
+	 *
+	 * Values less than 2^sSubBits are counted exactly. Larger values
+	 * are counted in buckets for which the bucket width is (at most)
+	 * 2^(1-sSubBits) of the values in it (i.e. about 3 percent for
+	 * the sSubBits=6 used here). The full 64-bit range is covered
+	 * with a fixed number of buckets.
+	 *
+	 * All storage is allocated with the instance. Recording a value
+	 * involves only a few integer operations and no allocations.
+	 */
+	class Histogram
+	{
+	public:
+
+		//! Number of bits resolved exactly within each power of two
+		static constexpr std::size_t sSubBits{ 6u };
+
+		//! Number of buckets for small values (counted exactly)
+		static constexpr std::size_t sNumSub{ 1u << sSubBits };
+
+		//! Number of buckets per power of two for larger values
+		static constexpr std::size_t sNumHalf{ sNumSub / 2u };
+
+		//! Total number of buckets to cover full 64-bit range
+		static constexpr std::size_t sNumBuckets
+			{ sNumSub + (64u - sSubBits) * sNumHalf };
+
+	private:
+
+		std::array<std::uint64_t, sNumBuckets> theCounts{};
+		std::uint64_t theCount{ 0u };
+		std::uint64_t theMin{ std::numeric_limits<std::uint64_t>::max() };
+		std::uint64_t theMax{ 0u };
+		double theSum{ 0. };
+
+	public:
+
+		//! Bucket (index) in which value is counted.
+		inline
+		static
+		std::size_t
+		bucketIndex
+			( std::uint64_t const & value
+			)
+		{
+			std::size_t ndx{ static_cast<std::size_t>(value) };
+			if (! (value < sNumSub))
+			{
+				// position of most significant bit is (sSubBits-1) or more
+				std::size_t const msb
+					{ static_cast<std::size_t>(std::bit_width(value)) - 1u };
+				std::size_t const shift{ msb - (sSubBits - 1u) };
+				std::size_t const sub
+					{ static_cast<std::size_t>(value >> shift) };
+				ndx = sNumSub + (shift - 1u) * sNumHalf + (sub - sNumHalf);
+			}
+			return ndx;
+		}
+
+		//! Smallest value counted in bucket ndx.
+		inline
+		static
+		std::uint64_t
+		bucketLower
+			( std::size_t const & ndx
+			)
+		{
+			std::uint64_t lower{ ndx };
+			if (! (ndx < sNumSub))
+			{
+				std::size_t const rel{ ndx - sNumSub };
+				std::size_t const shift{ (rel / sNumHalf) + 1u };
+				std::uint64_t const sub{ (rel % sNumHalf) + sNumHalf };
+				lower = (sub << shift);
+			}
+			return lower;
+		}
+
+		//! Largest value counted in bucket ndx.
+		inline
+		static
+		std::uint64_t
+		bucketUpper
+			( std::size_t const & ndx
+			)
+		{
+			std::uint64_t upper{ ndx };
+			if (! (ndx < sNumSub))
+			{
+				std::size_t const rel{ ndx - sNumSub };
+				std::size_t const shift{ (rel / sNumHalf) + 1u };
+				std::uint64_t const width{ std::uint64_t{ 1u } << shift };
+				upper = bucketLower(ndx) + (width - 1u);
+			}
+			return upper;
+		}
+
+		//! Incorporate value into histogram.
+		inline
+		void
+		record
+			( std::uint64_t const & value
+			)
+		{
+			++theCounts[bucketIndex(value)];
+			++theCount;
+			theMin = std::min(theMin, value);
+			theMax = std::max(theMax, value);
+			theSum += static_cast<double>(value);
+		}
+
+		//! Incorporate all values from another histogram into this one.
+		inline
+		void
+		merge
+			( Histogram const & other
+			)
+		{
+			for (std::size_t nn{0u} ; nn < sNumBuckets ; ++nn)
+			{
+				theCounts[nn] += other.theCounts[nn];
+			}
+			theCount += other.theCount;
+			theMin = std::min(theMin, other.theMin);
+			theMax = std::max(theMax, other.theMax);
+			theSum += other.theSum;
+		}
+
+		//! Remove all recorded values.
+		inline
+		void
+		reset
+			()
+		{
+			*this = Histogram{};
+		}
+
+		//! Number of values recorded.
+		inline
+		std::uint64_t
+		count
+			() const
+		{
+			return theCount;
+		}
+
+		//! Smallest value recorded (zero if empty).
+		inline
+		std::uint64_t
+		min
+			() const
+		{
+			std::uint64_t value{ 0u };
+			if (0u < theCount)
+			{
+				value = theMin;
+			}
+			return value;
+		}
+
+		//! Largest value recorded (zero if empty).
+		inline
+		std::uint64_t
+		max
+			() const
+		{
+			return theMax;
+		}
+
+		//! Average of recorded values (null if empty).
+		inline
+		double
+		mean
+			() const
+		{
+			double ave{ std::numeric_limits<double>::quiet_NaN() };
+			if (0u < theCount)
+			{
+				ave = theSum / static_cast<double>(theCount);
+			}
+			return ave;
+		}
+
+		/*! \brief Value at or below which fraction of all values are.
+		 *
+		 * E.g. fraction=.5 is the median, fraction=.99 is the 99-th
+		 * percentile. The returned value is the largest value in the
+		 * bucket containing the requested rank (limited to the range
+		 * of values recorded). Returns zero if empty.
+		 */
+		inline
+		std::uint64_t
+		percentile
+			( double const & fraction
+			) const
+		{
+			std::uint64_t value{ 0u };
+			if (0u < theCount)
+			{
+				double const frac{ std::clamp(fraction, 0., 1.) };
+				std::uint64_t rank{ static_cast<std::uint64_t>
+					(std::ceil(frac * static_cast<double>(theCount))) };
+				rank = std::clamp(rank, std::uint64_t{ 1u }, theCount);
+				std::uint64_t sum{ 0u };
+				for (std::size_t nn{0u} ; nn < sNumBuckets ; ++nn)
+				{
+					sum += theCounts[nn];
+					if (! (sum < rank))
+					{
+						value = std::clamp(bucketUpper(nn), theMin, theMax);
+						break;
+					}
+				}
+			}
+			return value;
+		}
+
+	}; // Histogram
+
+
+	//! Phases of an incremental network update.
+	enum Phase
+	{
+		  ObsAccumulate  //!< Insert observations into edge trackers
+		, EdgeReestimate  //!< Update robust edge estimates
+		, SpanningUpdate  //!< Determine minimum spanning tree network
+		, Propagation  //!< Propagate station orientations through tree
+	};
+
+	//! Number of values in Phase enumeration
+	constexpr std::size_t sNumPhases{ 4u };
+
+	//! Name associated with each phase
+	inline
+	std::string
+	nameFor
+		( Phase const & phase
+		)
+	{
+		static std::array<std::string, sNumPhases> const names
+			{ "ObsAccumulate"
+			, "EdgeReestimate"
+			, "SpanningUpdate"
+			, "Propagation"
+			};
+		return names[static_cast<std::size_t>(phase)];
+	}
+
+
+	/*! \brief Latency statistics for phases of incremental updates.
+	 *
+	 * Phase latencies are recorded in nanoseconds. The number of
+	 * allocations per update (frame) can also be recorded, e.g. using
+	 * values from an allocation counting operator new.
+	 */
+	class Latencies
+	{
+		std::array<Histogram, sNumPhases> thePhaseNanos{};
+		Histogram theFrameAllocs{};
+
+	public:
+
+		//! Incorporate elapsed time (nanoseconds) for phase.
+		inline
+		void
+		recordPhase
+			( Phase const & phase
+			, std::uint64_t const & nanoseconds
+			)
+		{
+			thePhaseNanos[static_cast<std::size_t>(phase)].record(nanoseconds);
+		}
+
+		//! Incorporate number of allocations made during one update.
+		inline
+		void
+		recordAllocations
+			( std::uint64_t const & numAllocs
+			)
+		{
+			theFrameAllocs.record(numAllocs);
+		}
+
+		//! Histogram of latencies (nanoseconds) recorded for phase.
+		inline
+		Histogram const &
+		phaseNanos
+			( Phase const & phase
+			) const
+		{
+			return thePhaseNanos[static_cast<std::size_t>(phase)];
+		}
+
+		//! Histogram of allocation counts recorded per update.
+		inline
+		Histogram const &
+		frameAllocs
+			() const
+		{
+			return theFrameAllocs;
+		}
+
+		//! A copy of the current statistics.
+		inline
+		Latencies
+		snapshot
+			() const
+		{
+			return *this;
+		}
+
+		//! Remove all recorded values.
+		inline
+		void
+		reset
+			()
+		{
+			for (Histogram & hist : thePhaseNanos)
+			{
+				hist.reset();
+			}
+			theFrameAllocs.reset();
+		}
+
+		//! Descriptive information: count and p50/p99/p999 for each phase
+		inline
+		std::string
+		infoString
+			( std::string const & title = {}
+			) const
+		{
+			std::ostringstream oss;
+			if (! title.empty())
+			{
+				oss << title << '\n';
+			}
+			oss << "phase[ns]:          count        p50        p99       p999"
+				"        max";
+			for (std::size_t nn{0u} ; nn < sNumPhases ; ++nn)
+			{
+				Histogram const & hist = thePhaseNanos[nn];
+				std::string name{ nameFor(static_cast<Phase>(nn)) };
+				name.resize(16u, ' ');
+				oss << '\n' << name
+					<< ' ' << infoCounts(hist);
+			}
+			oss << '\n' << "allocs/frame    "
+				<< ' ' << infoCounts(theFrameAllocs);
+			return oss.str();
+		}
+
+	private:
+
+		//! Column formatted percentile values
+		inline
+		static
+		std::string
+		infoCounts
+			( Histogram const & hist
+			)
+		{
+			std::ostringstream oss;
+			oss.width(8); oss << hist.count();
+			oss << ' '; oss.width(10); oss << hist.percentile(.500);
+			oss << ' '; oss.width(10); oss << hist.percentile(.990);
+			oss << ' '; oss.width(10); oss << hist.percentile(.999);
+			oss << ' '; oss.width(10); oss << hist.max();
+			return oss.str();
+		}
+
+	}; // Latencies
+
+
+	/*! \brief Record elapsed lifetime of this instance as a phase latency.
+	 *
+	 * Nothing is recorded if constructed with a null ptLatencies.
+	 */
+	class ScopedTimer
+	{
+		Latencies * const thePtLatencies{ nullptr };
+		Phase const thePhase{};
+		std::chrono::steady_clock::time_point const theT0{};
+
+	public:
+
+		//! Start timing (if ptLatencies is not null).
+		inline
+		explicit
+		ScopedTimer
+			( Latencies * const & ptLatencies
+			, Phase const & phase
+			)
+			: thePtLatencies{ ptLatencies }
+			, thePhase{ phase }
+			, theT0{ std::chrono::steady_clock::now() }
+		{ }
+
+		//! Record elapsed time into phase histogram.
+		inline
+		~ScopedTimer
+			()
+		{
+			if (thePtLatencies)
+			{
+				std::chrono::steady_clock::duration const elapsed
+					{ std::chrono::steady_clock::now() - theT0 };
+				long long const nanos
+					{ std::chrono::duration_cast<std::chrono::nanoseconds>
+						(elapsed).count()
+					};
+				thePtLatencies->recordPhase
+					(thePhase, static_cast<std::uint64_t>(nanos));
+			}
+		}
+
+		ScopedTimer(ScopedTimer const &) = delete;
+		ScopedTimer & operator=(ScopedTimer const &) = delete;
+
+	}; // ScopedTimer
+
+
+} // [perf]
+
+} // [orinet]
+
+
+#endif // OriNet_perf_INCL_
@@ -32,13 +32,26 @@
 Example:
 \snippet test_robust.cpp DoxyExample02
 
+Functions are provided in two forms. The first form accepts an explicit
+random::Context argument that holds all generator state (e.g. one per
+thread via Context::stream()). The second (original) form, without a
+context argument, uses function-local static generators - these are
+convenient for single threaded use but are NOT thread safe.
+
+Example of context use:
+\snippet test_random.cpp DoxyExample01
+
 */
 
 
 #include <Engabra>
 #include <Rigibra>
 
+#include <algorithm>
+#include <array>
+#include <cstdint>
 #include <random>
+#include <unordered_set>
 #include <vector>
 
 
@@ -55,22 +68,146 @@ namespace random
 	// Range of rotation angles - plus/minus this limit
 //	constexpr double sLimAng{ engabra::g3::pi };
 
+	//! \brief Next value of SplitMix64 sequence (used for seed mixing)
+	inline
+	std::uint64_t
+	splitMix64
+		( std::uint64_t * const & ptState
+		)
+	{
+		std::uint64_t zz{ (*ptState += 0x9e3779b97f4a7c15u) };
+		zz = (zz ^ (zz >> 30u)) * 0xbf58476d1ce4e5b9u;
+		zz = (zz ^ (zz >> 27u)) * 0x94d049bb133111ebu;
+		return zz ^ (zz >> 31u);
+	}
+
+	/*! \brief Explicit (pseudo)random generation state.
+	 *
+	 * An instance owns its generator. Functions that accept a Context
+	 * draw values only from it, so that results are determined by the
+	 * seed and the sequence of calls made with the instance.
+	 *
+	 * Instances are not shared between threads. Instead, use stream()
+	 * to split off independent (deterministic) sub-streams, e.g. one
+	 * per thread or one per work item. The resulting values are then
+	 * independent of the number of threads and of their scheduling.
+	 *
+	 * Example:
+	 * \snippet test_random.cpp DoxyExample01
+	 */
+	class Context
+	{
+	public:
+
+		//! Generator type (same as used by context-free functions)
+		using Generator = std::mt19937;
+
+	private:
+
+		std::uint64_t theSeed{};
+		Generator theGen{};
+
+		//! Tag type for construction with full width seed mixing
+		struct Mixed{};
+
+		//! Generator seeded from all bits of seed (via std::seed_seq).
+		inline
+		explicit
+		Context  // Context::
+			( std::uint64_t const & seed
+			, Mixed const & // tag
+			)
+			: theSeed{ seed }
+			, theGen{}
+		{
+			std::uint64_t state{ seed };
+			std::array<std::uint32_t, 4u> words{};
+			for (std::size_t nn{0u} ; nn < words.size() ; nn += 2u)
+			{
+				std::uint64_t const mix{ splitMix64(&state) };
+				words[nn] = static_cast<std::uint32_t>(mix);
+				words[nn + 1u] = static_cast<std::uint32_t>(mix >> 32u);
+			}
+			std::seed_seq seq(words.cbegin(), words.cend());
+			theGen.seed(seq);
+		}
+
+	public:
+
+		//! Default seed value
+		static constexpr std::uint32_t sDefaultSeed{ 5489u };
+
+		/*! \brief Context with generator seeded as Generator(seed).
+		 *
+		 * I.e. produces the same sequence as a std::mt19937 constructed
+		 * with this seed.
+		 */
+		inline
+		explicit
+		Context  // Context::
+			( std::uint32_t const & seed = sDefaultSeed
+			)
+			: theSeed{ seed }
+			, theGen(seed)
+		{ }
+
+		//! Seed value from which this instance was created
+		inline
+		std::uint64_t
+		seed  // Context::
+			() const
+		{
+			return theSeed;
+		}
+
+		//! Generator to use with standard distributions
+		inline
+		Generator &
+		generator  // Context::
+			()
+		{
+			return theGen;
+		}
+
+		/*! \brief An independent context associated with streamId.
+		 *
+		 * The result depends only on seed() and on streamId (not on
+		 * the use of this instance). E.g. stream(nThread) or
+		 * stream(workItem) provides deterministic per-thread (or per
+		 * work item) generation. Streams may be split recursively.
+		 */
+		inline
+		Context
+		stream  // Context::
+			( std::uint64_t const & streamId
+			) const
+		{
+			std::uint64_t state{ theSeed };
+			std::uint64_t const base{ splitMix64(&state) };
+			state = base ^ streamId;
+			std::uint64_t const subSeed{ splitMix64(&state) };
+			return Context(subSeed, Mixed{});
+		}
+
+	}; // Context
+
+
 	//! \brief A random unitary direction vector
 	inline
 	engabra::g3::Vector
 	directionVector
-		()
+		( Context & ctx
+		)
 	{
 		using namespace engabra::g3;
 		Vector dir{ null<Vector>() };
 		for (;;)
 		{
-			static std::mt19937 gen(36742620u);
 			std::uniform_real_distribution<> dist(-1., 1.);
 			Vector const aVec
-				{ dist(gen)
-				, dist(gen)
-				, dist(gen)
+				{ dist(ctx.generator())
+				, dist(ctx.generator())
+				, dist(ctx.generator())
 				};
 			double const mag{ magnitude(aVec) };
 			if (! (1. < mag))
@@ -82,6 +219,47 @@ namespace random
 		return dir;
 	}
 
+	//! \brief A random unitary direction vector (NOT thread safe)
+	inline
+	engabra::g3::Vector
+	directionVector
+		()
+	{
+		static Context ctx(36742620u);
+		return directionVector(ctx);
+	}
+
+	/*! \brief Distinct indices sampled (without replacement) from [0, numAvail)
+	 *
+	 * Returns min(numPick, numAvail) indices in ascending order. Uses
+	 * Floyd's algorithm (with hashed membership tests) with expected
+	 * effort proportional to numPick (not to numAvail) plus sorting of
+	 * the result - e.g. for selecting a few items from a large range.
+	 */
+	inline
+	std::vector<std::size_t>
+	distinctIndices
+		( Context & ctx
+		, std::size_t const & numAvail
+		, std::size_t const & numPick
+		)
+	{
+		std::size_t const numUse{ std::min(numPick, numAvail) };
+		std::unordered_set<std::size_t> picked;
+		picked.reserve(numUse);
+		for (std::size_t top{numAvail - numUse} ; top < numAvail ; ++top)
+		{
+			std::uniform_int_distribution<std::size_t> dist(0u, top);
+			std::size_t const cand{ dist(ctx.generator()) };
+			if (! picked.insert(cand).second)
+			{
+				picked.insert(top); // cand already present (top is not)
+			}
+		}
+		std::vector<std::size_t> ndxs(picked.cbegin(), picked.cend());
+		std::sort(ndxs.begin(), ndxs.end());
+		return ndxs;
+	}
 
 	/*! \brief Estimate distribution of triad transform residual magnitudes.
 	 *
@@ -127,7 +305,8 @@ namespace random
 	inline
 	engabra::g3::Vector
 	perturbedLocation
-		( engabra::g3::Vector const & meanLoc
+		( Context & ctx
+		, engabra::g3::Vector const & meanLoc
 		, double const & sigmaLoc
 		)
 	{
@@ -135,24 +314,36 @@ namespace random
 		if (! (sigmaLoc < 0.))
 		{
 			// Configure pseudo-random number distribution generator
-			static std::mt19937 gen(82035133u);
 			std::normal_distribution<> distLocs(0., sigmaLoc);
 
 			// Use pseudo-random number generation to create transformation
 			loc = engabra::g3::Vector
-				{ meanLoc[0] + distLocs(gen)
-				, meanLoc[1] + distLocs(gen)
-				, meanLoc[2] + distLocs(gen)
+				{ meanLoc[0] + distLocs(ctx.generator())
+				, meanLoc[1] + distLocs(ctx.generator())
+				, meanLoc[2] + distLocs(ctx.generator())
 				};
 		}
 		return loc;
 	}
 
+	//! \brief Location from normally distributed components (NOT thread safe)
+	inline
+	engabra::g3::Vector
+	perturbedLocation
+		( engabra::g3::Vector const & meanLoc
+		, double const & sigmaLoc
+		)
+	{
+		static Context ctx(82035133u);
+		return perturbedLocation(ctx, meanLoc, sigmaLoc);
+	}
+
 	//! \brief Attitude from normally distributed Physical angle components
 	inline
 	rigibra::Attitude
 	perturbedAttitude
-		( rigibra::PhysAngle const & meanAng
+		( Context & ctx
+		, rigibra::PhysAngle const & meanAng
 		, double const & sigmaAng
 		)
 	{
@@ -160,21 +351,56 @@ namespace random
 		if (! (sigmaAng < 0.))
 		{
 			// Configure pseudo-random number distribution generator
-			static std::mt19937 gen(18448574u);
 			std::normal_distribution<> distAngs(0., sigmaAng);
 
 			// Use pseudo-random number generation to create transformation
 			att = rigibra::Attitude
 				{ rigibra::PhysAngle
-					{ meanAng.theBiv[0] + distAngs(gen)
-					, meanAng.theBiv[1] + distAngs(gen)
-					, meanAng.theBiv[2] + distAngs(gen)
+					{ meanAng.theBiv[0] + distAngs(ctx.generator())
+					, meanAng.theBiv[1] + distAngs(ctx.generator())
+					, meanAng.theBiv[2] + distAngs(ctx.generator())
 					}
 				};
 		}
 		return att;
 	}
 
+	//! \brief Attitude from normal Physical angle values (NOT thread safe)
+	inline
+	rigibra::Attitude
+	perturbedAttitude
+		( rigibra::PhysAngle const & meanAng
+		, double const & sigmaAng
+		)
+	{
+		static Context ctx(18448574u);
+		return perturbedAttitude(ctx, meanAng, sigmaAng);
+	}
+
+	//! \brief A transformation with uniformly distributed parameters values
+	inline
+	rigibra::Transform
+	perturbedTransform
+		( Context & ctx
+		, engabra::g3::Vector const & meanLoc
+		, rigibra::PhysAngle const & meanAng
+		, double const & sigmaLoc
+		, double const & sigmaAng
+		)
+	{
+		rigibra::Transform xform{ rigibra::null<rigibra::Transform>() };
+		if (! ((sigmaLoc < 0.) || (sigmaAng < 0.)) )
+		{
+			// Use pseudo-random number generation to create transformation
+			engabra::g3::Vector const loc
+				{ perturbedLocation(ctx, meanLoc, sigmaLoc) };
+			rigibra::Attitude const att
+				{ perturbedAttitude(ctx, meanAng, sigmaAng) };
+			xform = rigibra::Transform{ loc, att };
+		}
+		return xform;
+	}
+
 	//! \brief A transformation with uniformly distributed parameters values
 	inline
 	rigibra::Transform
@@ -197,6 +423,22 @@ namespace random
 		return xform;
 	}
 
+	//! \brief A transformation with uniformly distributed parameters values
+	inline
+	rigibra::Transform
+	perturbedTransform
+		( Context & ctx
+		, rigibra::Transform const & expXform
+		, double const & sigmaLoc
+		, double const & sigmaAng
+		)
+	{	
+		engabra::g3::Vector const expLoc = expXform.theLoc;
+		rigibra::PhysAngle const expAng{ expXform.theAtt.physAngle() };
+
+		return perturbedTransform(ctx, expLoc, expAng, sigmaLoc, sigmaAng);
+	}
+
 	//! \brief A transformation with uniformly distributed parameters values
 	inline
 	rigibra::Transform
@@ -216,7 +458,8 @@ namespace random
 	inline
 	engabra::g3::Vector
 	uniformLocation
-		( std::pair<double, double> const & locMinMax
+		( Context & ctx
+		, std::pair<double, double> const & locMinMax
 		)
 	{
 		using namespace engabra::g3;
@@ -226,20 +469,35 @@ namespace random
 		double const & locMax = locMinMax.second;
 
 		// Configure pseudo-random number distribution generator
-		static std::mt19937 gen(99981274u);
 		std::uniform_real_distribution<> distLocs(locMin, locMax);
 
 		// Use pseudo-random number generation to create transformation
-		loc = Vector{ distLocs(gen), distLocs(gen), distLocs(gen) };
+		loc = Vector
+			{ distLocs(ctx.generator())
+			, distLocs(ctx.generator())
+			, distLocs(ctx.generator())
+			};
 
 		return loc;
 	}
 
+	//! \brief A location with uniformly distributed values (NOT thread safe)
+	inline
+	engabra::g3::Vector
+	uniformLocation
+		( std::pair<double, double> const & locMinMax
+		)
+	{
+		static Context ctx(99981274u);
+		return uniformLocation(ctx, locMinMax);
+	}
+
 	//! \brief An attitude with uniformly distributed parameters values
 	inline
 	rigibra::Attitude
 	uniformAttitude
-		( std::pair<double, double> const & angMinMax
+		( Context & ctx
+		, std::pair<double, double> const & angMinMax
 		)
 	{
 		using namespace rigibra;
@@ -248,12 +506,15 @@ namespace random
 		double const & angMax = angMinMax.second;
 
 		// Configure pseudo-random number distribution generator
-		static std::mt19937 gen(48169386u);
 		std::uniform_real_distribution<> distAngs(angMin, angMax);
 
 		// keep angle size within principle range
 		using namespace engabra::g3;
-		BiVector angle{ distAngs(gen), distAngs(gen), distAngs(gen) };
+		BiVector angle
+			{ distAngs(ctx.generator())
+			, distAngs(ctx.generator())
+			, distAngs(ctx.generator())
+			};
 		double mag{ magnitude(angle) };
 		if (turnHalf < mag)
 		{
@@ -268,6 +529,32 @@ namespace random
 		return att;
 	}
 
+	//! \brief An attitude with uniformly distributed values (NOT thread safe)
+	inline
+	rigibra::Attitude
+	uniformAttitude
+		( std::pair<double, double> const & angMinMax
+		)
+	{
+		static Context ctx(48169386u);
+		return uniformAttitude(ctx, angMinMax);
+	}
+
+	//! \brief A transformation with uniformly distributed parameters values
+	inline
+	rigibra::Transform
+	uniformTransform
+		( Context & ctx
+		, std::pair<double, double> const & locMinMax
+		, std::pair<double, double> const & angMinMax
+			= { -engabra::g3::pi, engabra::g3::pi }
+		)
+	{
+		engabra::g3::Vector const loc{ uniformLocation(ctx, locMinMax) };
+		rigibra::Attitude const att{ uniformAttitude(ctx, angMinMax) };
+		return rigibra::Transform{ loc, att };
+	}
+
 	//! \brief A transformation with uniformly distributed parameters values
 	inline
 	rigibra::Transform
@@ -283,6 +570,27 @@ namespace random
 			};
 	}
 
+	//! \brief A transformation with uniformly distributed parameters values
+	inline
+	rigibra::Transform
+	blunderTransform
+		( Context & ctx
+		, rigibra::Transform const & expXform
+		, std::pair<double, double> const & locMinMax
+		, std::pair<double, double> const & angMinMax
+			= { -engabra::g3::pi, engabra::g3::pi }
+		)
+	{
+		using namespace rigibra;
+		Transform const & xExpWrtRef = expXform;
+		// error amount relative to expected transformation
+		Transform const xErrWrtExp
+			{ uniformTransform(ctx, locMinMax, angMinMax) };
+		// observed transform is error on top of expected
+		Transform const xObsWrtRef{ xErrWrtExp * xExpWrtRef };
+		return xObsWrtRef;
+	}
+
 	//! \brief A transformation with uniformly distributed parameters values
 	inline
 	rigibra::Transform
@@ -324,6 +632,41 @@ namespace random
 	}; // NoiseModel
 
 
+	/*! \brief Transformation that may be perturbed or blunderous
+	 *
+	 *
+	 */
+	inline
+	rigibra::Transform
+	noisyTransform
+		( Context & ctx
+		, rigibra::Transform const & expXform
+		, NoiseModel const & noise
+		)
+	{
+		rigibra::Transform xform;
+
+		engabra::g3::Vector const expLoc = expXform.theLoc;
+		rigibra::PhysAngle const expAng{ expXform.theAtt.physAngle() };
+
+		// determine if blunder or not
+		std::uniform_real_distribution<double> dist(0., 1.);
+		bool const blunder{ (dist(ctx.generator()) < noise.theProbErr) };
+
+		if (blunder)
+		{
+			xform = blunderTransform
+				(ctx, expXform, noise.theLocMinMax, noise.theAngMinMax);
+		}
+		else
+		{
+			xform = perturbedTransform
+				(ctx, expLoc, expAng, noise.theLocSigma, noise.theAngSigma);
+		}
+
+		return xform;
+	}
+
 	/*! \brief Transformation that may be perturbed or blunderous
 	 *
 	 *
@@ -341,9 +684,9 @@ namespace random
 		rigibra::PhysAngle const expAng{ expXform.theAtt.physAngle() };
 
 		// determine if blunder or not
-		static std::mt19937 gen(62525462u);
+		static Context ctx(62525462u);
 		std::uniform_real_distribution<double> dist(0., 1.);
-		bool const blunder{ (dist(gen) < noise.theProbErr) };
+		bool const blunder{ (dist(ctx.generator()) < noise.theProbErr) };
 
 		if (blunder)
 		{
@@ -378,6 +721,56 @@ namespace random
 	 */
 	inline
 	std::vector<rigibra::Transform>
+	noisyTransforms
+		( Context & ctx
+		, rigibra::Transform const & expXform
+		, std::size_t const & numMea
+		, std::size_t const & numErr
+		, double const & sigmaLoc
+		, double const & sigmaAng
+		, std::pair<double, double> const & locMinMax
+			= { -10., 10. }
+		, std::pair<double, double> const & angMinMax
+			= { -engabra::g3::pi, engabra::g3::pi }
+		)
+	{
+		std::vector<rigibra::Transform> xforms;
+		xforms.reserve(numMea + numErr);
+
+		using namespace rigibra;
+
+		engabra::g3::Vector const expLoc = expXform.theLoc;
+		PhysAngle const expAng{ expXform.theAtt.physAngle() };
+
+		// ... a number of typical measurements - with Gaussian noise
+		for (std::size_t nn{0u} ; nn < numMea ; ++nn)
+		{
+			Transform const meaXform
+				{ perturbedTransform
+					(ctx, expLoc, expAng, sigmaLoc, sigmaAng)
+				};
+			xforms.emplace_back(meaXform);
+		}
+
+		// ... a few 'blunderous' measurements - from uniform probability
+		for (std::size_t nn{0u} ; nn < numErr ; ++nn)
+		{
+			Transform const meaXform
+				{ blunderTransform(ctx, expXform, locMinMax, angMinMax) };
+			xforms.emplace_back(meaXform);
+		}
+
+		return xforms;
+	}
+
+	/*! \brief As noisyTransforms(ctx, ...) above (but NOT thread safe)
+	 *
+	 * Values are drawn from the (separate) generators of the context
+	 * free perturbedTransform() and blunderTransform() such that the
+	 * sequences are the same as for earlier versions of this function.
+	 */
+	inline
+	std::vector<rigibra::Transform>
 	noisyTransforms
 		( rigibra::Transform const & expXform
 		, std::size_t const & numMea
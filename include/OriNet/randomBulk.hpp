@@ -0,0 +1,694 @@
+//
+// MIT License
+//
+// Copyright (c) 2024 Stellacore Corporation
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+
+#ifndef OriNet_randomBulk_INCL_
+#define OriNet_randomBulk_INCL_
+
+/*! \file
+\brief Counter based (pseudo)random generation of transformations in bulk.
+
+The functions here generate large numbers of transformations into
+structure-of-arrays storage (TransformArrays). The values are produced
+with a counter based generator (Philox4x32-10) such that the value for
+each element depends only on the CounterSource (seed, stream) and on
+the element index. Results are therefore bitwise identical regardless
+of the number of threads used.
+
+Inner loops operate on fixed size groups of elements (sBulkLanes)
+using simple arithmetic loops intended for compiler auto-vectorization.
+
+Example:
+\snippet test_randomBulk.cpp DoxyExample01
+
+*/
+
+
+#include "parallel.hpp"
+#include "random.hpp"
+
+#include <Engabra>
+#include <Rigibra>
+
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+
+namespace orinet
+{
+
+namespace random
+{
+
+	/*! \brief Philox4x32-10 counter based generator.
+	 *
+	 * Reference: Salmon, Moraes, Dror, Shaw, "Parallel Random Numbers:
+	 * As Easy as 1, 2, 3", SC11 (2011).
+	 *
+	 * Each (counter, key) combination maps to four (pseudo)random
+	 * 32-bit values. There is no other state.
+	 */
+	struct Philox4x32
+	{
+		using Counter = std::array<std::uint32_t, 4u>;
+		using Key = std::array<std::uint32_t, 2u>;
+
+		static constexpr std::uint32_t sMul0{ 0xD2511F53u };
+		static constexpr std::uint32_t sMul1{ 0xCD9E8D57u };
+		static constexpr std::uint32_t sWeyl0{ 0x9E3779B9u };
+		static constexpr std::uint32_t sWeyl1{ 0xBB67AE85u };
+		static constexpr std::size_t sNumRounds{ 10u };
+
+		//! Random values associated with counter and key
+		inline
+		static
+		Counter
+		block  // Philox4x32::
+			( Counter ctr
+			, Key key
+			)
+		{
+			for (std::size_t nRound{0u} ; nRound < sNumRounds ; ++nRound)
+			{
+				std::uint64_t const prod0{ std::uint64_t{ sMul0 } * ctr[0] };
+				std::uint64_t const prod1{ std::uint64_t{ sMul1 } * ctr[2] };
+				ctr = Counter
+					{ static_cast<std::uint32_t>(prod1 >> 32u) ^ ctr[1] ^ key[0]
+					, static_cast<std::uint32_t>(prod1)
+					, static_cast<std::uint32_t>(prod0 >> 32u) ^ ctr[3] ^ key[1]
+					, static_cast<std::uint32_t>(prod0)
+					};
+				key[0] += sWeyl0;
+				key[1] += sWeyl1;
+			}
+			return ctr;
+		}
+
+	}; // Philox4x32
+
+
+	//! Identification of a (reproducible) sequence of counter based values
+	struct CounterSource
+	{
+		//! Seed value (determines Philox key)
+		std::uint64_t theSeed{ 0u };
+
+		//! Independent stream of values for same seed
+		std::uint32_t theStream{ 0u };
+
+		//! Counter value associated with first element of output
+		std::uint64_t theFirstIndex{ 0u };
+
+	}; // CounterSource
+
+
+	/*! \brief Structure-of-arrays storage of transformation parameters.
+	 *
+	 * Each transformation is represented by location vector components
+	 * and by physical angle bivector components (i.e. the values used
+	 * to construct rigibra::Transform{ loc, Attitude{ PhysAngle } }).
+	 */
+	struct TransformArrays
+	{
+		//! Location components: theLocs[component][element]
+		std::array<std::vector<double>, 3u> theLocs{};
+
+		//! Physical angle components: theAngs[component][element]
+		std::array<std::vector<double>, 3u> theAngs{};
+
+		//! Construct with storage for numElem transforms
+		inline
+		explicit
+		TransformArrays  // TransformArrays::
+			( std::size_t const & numElem = 0u
+			)
+		{
+			resize(numElem);
+		}
+
+		//! Set number of elements
+		inline
+		void
+		resize  // TransformArrays::
+			( std::size_t const & numElem
+			)
+		{
+			for (std::size_t kk{0u} ; kk < 3u ; ++kk)
+			{
+				theLocs[kk].resize(numElem);
+				theAngs[kk].resize(numElem);
+			}
+		}
+
+		//! Number of elements
+		inline
+		std::size_t
+		size  // TransformArrays::
+			() const
+		{
+			return theLocs[0].size();
+		}
+
+		//! Transformation for element ndx
+		inline
+		rigibra::Transform
+		transform  // TransformArrays::
+			( std::size_t const & ndx
+			) const
+		{
+			using namespace engabra::g3;
+			Vector const loc
+				{ theLocs[0][ndx], theLocs[1][ndx], theLocs[2][ndx] };
+			BiVector const ang
+				{ theAngs[0][ndx], theAngs[1][ndx], theAngs[2][ndx] };
+			return rigibra::Transform
+				{ loc, rigibra::Attitude{ rigibra::PhysAngle{ ang } } };
+		}
+
+		//! Set parameters of element ndx from xform
+		inline
+		void
+		setTransform  // TransformArrays::
+			( std::size_t const & ndx
+			, rigibra::Transform const & xform
+			)
+		{
+			rigibra::PhysAngle const physAng{ xform.theAtt.physAngle() };
+			for (std::size_t kk{0u} ; kk < 3u ; ++kk)
+			{
+				theLocs[kk][ndx] = xform.theLoc[kk];
+				theAngs[kk][ndx] = physAng.theBiv[kk];
+			}
+		}
+
+		//! All elements as (array-of-structure) transformations
+		inline
+		std::vector<rigibra::Transform>
+		transforms  // TransformArrays::
+			() const
+		{
+			std::vector<rigibra::Transform> xforms;
+			xforms.reserve(size());
+			for (std::size_t ndx{0u} ; ndx < size() ; ++ndx)
+			{
+				xforms.emplace_back(transform(ndx));
+			}
+			return xforms;
+		}
+
+	}; // TransformArrays
+
+
+	//! Number of elements processed together in bulk generation loops
+	constexpr std::size_t sBulkLanes{ 64u };
+
+	//! Per-lane values: [0,1,2] for location, [3,4,5] for angle
+	using LaneValues = std::array<std::array<double, sBulkLanes>, 6u>;
+
+	/*! \brief Uniform values in open interval (0,1) for a group of elements.
+	 *
+	 * Elements (beg + lane) for lane in [0, numLanes) with counter
+	 * {index, stream, blockNdx} where index is (theFirstIndex + beg +
+	 * lane). Each Philox block provides two 53-bit values, uOut0[lane]
+	 * and uOut1[lane].
+	 */
+	inline
+	void
+	philoxUniformLanes
+		( CounterSource const & source
+		, std::uint64_t const & beg
+		, std::size_t const & numLanes
+		, std::uint32_t const & blockNdx
+		, double * const & uOut0
+		, double * const & uOut1
+		)
+	{
+		std::array<std::uint32_t, sBulkLanes> c0;
+		std::array<std::uint32_t, sBulkLanes> c1;
+		std::array<std::uint32_t, sBulkLanes> c2;
+		std::array<std::uint32_t, sBulkLanes> c3;
+		for (std::size_t lane{0u} ; lane < numLanes ; ++lane)
+		{
+			std::uint64_t const index{ source.theFirstIndex + beg + lane };
+			c0[lane] = static_cast<std::uint32_t>(index);
+			c1[lane] = static_cast<std::uint32_t>(index >> 32u);
+			c2[lane] = source.theStream;
+			c3[lane] = blockNdx;
+		}
+
+		std::uint32_t key0{ static_cast<std::uint32_t>(source.theSeed) };
+		std::uint32_t key1{ static_cast<std::uint32_t>(source.theSeed >> 32u) };
+		for (std::size_t nRound{0u} ; nRound < Philox4x32::sNumRounds
+			; ++nRound)
+		{
+			for (std::size_t lane{0u} ; lane < numLanes ; ++lane)
+			{
+				std::uint64_t const prod0
+					{ std::uint64_t{ Philox4x32::sMul0 } * c0[lane] };
+				std::uint64_t const prod1
+					{ std::uint64_t{ Philox4x32::sMul1 } * c2[lane] };
+				std::uint32_t const hi0
+					{ static_cast<std::uint32_t>(prod0 >> 32u) };
+				std::uint32_t const hi1
+					{ static_cast<std::uint32_t>(prod1 >> 32u) };
+				std::uint32_t const n0{ hi1 ^ c1[lane] ^ key0 };
+				std::uint32_t const n2{ hi0 ^ c3[lane] ^ key1 };
+				c0[lane] = n0;
+				c1[lane] = static_cast<std::uint32_t>(prod1);
+				c2[lane] = n2;
+				c3[lane] = static_cast<std::uint32_t>(prod0);
+			}
+			key0 += Philox4x32::sWeyl0;
+			key1 += Philox4x32::sWeyl1;
+		}
+
+		// 53 bits per value, offset by half step to exclude 0 and 1
+		constexpr double scale{ 1. / 9007199254740992. }; // 2^-53
+		for (std::size_t lane{0u} ; lane < numLanes ; ++lane)
+		{
+			std::uint64_t const bits0
+				{ ((std::uint64_t{ c0[lane] } << 32u) | c1[lane]) >> 11u };
+			std::uint64_t const bits1
+				{ ((std::uint64_t{ c2[lane] } << 32u) | c3[lane]) >> 11u };
+			uOut0[lane] = (static_cast<double>(bits0) + .5) * scale;
+			uOut1[lane] = (static_cast<double>(bits1) + .5) * scale;
+		}
+	}
+
+	//! Uniform values for all six parameters (from Philox blocks 0,1,2)
+	inline
+	void
+	philoxUniformParms
+		( LaneValues * const & ptUni
+		, CounterSource const & source
+		, std::uint64_t const & beg
+		, std::size_t const & numLanes
+		)
+	{
+		LaneValues & uni = *ptUni;
+		for (std::uint32_t blockNdx{0u} ; blockNdx < 3u ; ++blockNdx)
+		{
+			philoxUniformLanes
+				( source, beg, numLanes, blockNdx
+				, uni[2u*blockNdx].data(), uni[2u*blockNdx + 1u].data()
+				);
+		}
+	}
+
+	//! Normally distributed parameters (Box-Muller) from uniform values
+	inline
+	void
+	perturbedLaneParms
+		( LaneValues * const & ptParms
+		, LaneValues const & uni
+		, std::size_t const & numLanes
+		, engabra::g3::Vector const & meanLoc
+		, rigibra::PhysAngle const & meanAng
+		, double const & sigmaLoc
+		, double const & sigmaAng
+		)
+	{
+		LaneValues & parms = *ptParms;
+		constexpr double twoPi{ 2. * engabra::g3::pi };
+		for (std::size_t kk{0u} ; kk < 6u ; kk += 2u)
+		{
+			double const * const u0 = uni[kk].data();
+			double const * const u1 = uni[kk + 1u].data();
+			double * const z0 = parms[kk].data();
+			double * const z1 = parms[kk + 1u].data();
+			for (std::size_t lane{0u} ; lane < numLanes ; ++lane)
+			{
+				double const rad{ std::sqrt(-2. * std::log(u0[lane])) };
+				double const ang{ twoPi * u1[lane] };
+				z0[lane] = rad * std::cos(ang);
+				z1[lane] = rad * std::sin(ang);
+			}
+		}
+		for (std::size_t kk{0u} ; kk < 3u ; ++kk)
+		{
+			double * const locs = parms[kk].data();
+			double * const angs = parms[3u + kk].data();
+			for (std::size_t lane{0u} ; lane < numLanes ; ++lane)
+			{
+				locs[lane] = meanLoc[kk] + sigmaLoc * locs[lane];
+				angs[lane] = meanAng.theBiv[kk] + sigmaAng * angs[lane];
+			}
+		}
+	}
+
+	/*! \brief Uniformly distributed parameters from uniform values.
+	 *
+	 * Same distribution as uniformTransform(), including reduction of
+	 * angle magnitude into the principal range.
+	 */
+	inline
+	void
+	uniformLaneParms
+		( LaneValues * const & ptParms
+		, LaneValues const & uni
+		, std::size_t const & numLanes
+		, std::pair<double, double> const & locMinMax
+		, std::pair<double, double> const & angMinMax
+		)
+	{
+		LaneValues & parms = *ptParms;
+		double const locDelta{ locMinMax.second - locMinMax.first };
+		double const angDelta{ angMinMax.second - angMinMax.first };
+		for (std::size_t kk{0u} ; kk < 3u ; ++kk)
+		{
+			for (std::size_t lane{0u} ; lane < numLanes ; ++lane)
+			{
+				parms[kk][lane]
+					= locMinMax.first + locDelta * uni[kk][lane];
+				parms[3u + kk][lane]
+					= angMinMax.first + angDelta * uni[3u + kk][lane];
+			}
+		}
+
+		// keep angle size within principal range (rarely needed)
+		using engabra::g3::turnHalf;
+		for (std::size_t lane{0u} ; lane < numLanes ; ++lane)
+		{
+			double const mag
+				{ std::hypot
+					(parms[3u][lane], parms[4u][lane], parms[5u][lane])
+				};
+			if (turnHalf < mag)
+			{
+				double const scl{ std::fmod(mag, turnHalf) / mag };
+				parms[3u][lane] *= scl;
+				parms[4u][lane] *= scl;
+				parms[5u][lane] *= scl;
+			}
+		}
+	}
+
+	//! Transformation from lane parameters
+	inline
+	rigibra::Transform
+	laneTransform
+		( LaneValues const & parms
+		, std::size_t const & lane
+		)
+	{
+		using namespace engabra::g3;
+		Vector const loc{ parms[0][lane], parms[1][lane], parms[2][lane] };
+		BiVector const ang{ parms[3][lane], parms[4][lane], parms[5][lane] };
+		return rigibra::Transform
+			{ loc, rigibra::Attitude{ rigibra::PhysAngle{ ang } } };
+	}
+
+	//! Store lane parameters into elements [beg, beg+numLanes)
+	inline
+	void
+	storeLaneParms
+		( TransformArrays * const & ptXforms
+		, std::size_t const & beg
+		, std::size_t const & numLanes
+		, LaneValues const & parms
+		)
+	{
+		for (std::size_t kk{0u} ; kk < 3u ; ++kk)
+		{
+			std::copy_n(parms[kk].cbegin(), numLanes
+				, ptXforms->theLocs[kk].begin() + beg);
+			std::copy_n(parms[3u + kk].cbegin(), numLanes
+				, ptXforms->theAngs[kk].begin() + beg);
+		}
+	}
+
+	/*! \brief Fill ptXforms with normally perturbed versions of expXform.
+	 *
+	 * Distribution is the same as for perturbedTransform() with
+	 * location (sigmaLoc) and angle (sigmaAng) deviations. All
+	 * ptXforms->size() elements are generated - in parallel by
+	 * (up to) numThreads threads (zero for hardware concurrency).
+	 */
+	inline
+	void
+	fillPerturbedTransforms
+		( TransformArrays * const & ptXforms
+		, rigibra::Transform const & expXform
+		, double const & sigmaLoc
+		, double const & sigmaAng
+		, CounterSource const & source
+		, std::size_t const & numThreads = 0u
+		)
+	{
+		engabra::g3::Vector const meanLoc{ expXform.theLoc };
+		rigibra::PhysAngle const meanAng{ expXform.theAtt.physAngle() };
+		parallel::forEachRange
+			( ptXforms->size()
+			, [&] (std::size_t const beg, std::size_t const end)
+			{
+				LaneValues uni;
+				LaneValues parms;
+				for (std::size_t grp{beg} ; grp < end ; grp += sBulkLanes)
+				{
+					std::size_t const num{ std::min(sBulkLanes, end - grp) };
+					philoxUniformParms(&uni, source, grp, num);
+					perturbedLaneParms
+						( &parms, uni, num, meanLoc, meanAng
+						, sigmaLoc, sigmaAng
+						);
+					storeLaneParms(ptXforms, grp, num, parms);
+				}
+			}
+			, numThreads
+			);
+	}
+
+	/*! \brief Fill ptXforms with uniformly distributed transforms.
+	 *
+	 * Distribution is the same as for uniformTransform().
+	 */
+	inline
+	void
+	fillUniformTransforms
+		( TransformArrays * const & ptXforms
+		, std::pair<double, double> const & locMinMax
+		, std::pair<double, double> const & angMinMax
+		, CounterSource const & source
+		, std::size_t const & numThreads = 0u
+		)
+	{
+		parallel::forEachRange
+			( ptXforms->size()
+			, [&] (std::size_t const beg, std::size_t const end)
+			{
+				LaneValues uni;
+				LaneValues parms;
+				for (std::size_t grp{beg} ; grp < end ; grp += sBulkLanes)
+				{
+					std::size_t const num{ std::min(sBulkLanes, end - grp) };
+					philoxUniformParms(&uni, source, grp, num);
+					uniformLaneParms(&parms, uni, num, locMinMax, angMinMax);
+					storeLaneParms(ptXforms, grp, num, parms);
+				}
+			}
+			, numThreads
+			);
+	}
+
+	/*! \brief Fill ptXforms with blunder transforms relative to expXform.
+	 *
+	 * Distribution is the same as for blunderTransform(). I.e. each
+	 * uniform error transform is applied on top of expXform.
+	 */
+	inline
+	void
+	fillBlunderTransforms
+		( TransformArrays * const & ptXforms
+		, rigibra::Transform const & expXform
+		, std::pair<double, double> const & locMinMax
+		, std::pair<double, double> const & angMinMax
+		, CounterSource const & source
+		, std::size_t const & numThreads = 0u
+		)
+	{
+		parallel::forEachRange
+			( ptXforms->size()
+			, [&] (std::size_t const beg, std::size_t const end)
+			{
+				LaneValues uni;
+				LaneValues parms;
+				for (std::size_t grp{beg} ; grp < end ; grp += sBulkLanes)
+				{
+					std::size_t const num{ std::min(sBulkLanes, end - grp) };
+					philoxUniformParms(&uni, source, grp, num);
+					uniformLaneParms(&parms, uni, num, locMinMax, angMinMax);
+					storeLaneParms(ptXforms, grp, num, parms);
+					for (std::size_t ndx{grp} ; ndx < (grp + num) ; ++ndx)
+					{
+						rigibra::Transform const xErrWrtExp
+							{ ptXforms->transform(ndx) };
+						ptXforms->setTransform(ndx, xErrWrtExp * expXform);
+					}
+				}
+			}
+			, numThreads
+			);
+	}
+
+	/*! \brief Fill ptXforms with transforms perturbed or blunderous.
+	 *
+	 * Distribution is the same as for noisyTransform(). Each element
+	 * is a blunder with probability noise.theProbErr (decided with
+	 * Philox block 3), else is normally perturbed.
+	 *
+	 * If ptIsBlunders is not null, it is resized and set to indicate
+	 * which elements are blunders.
+	 */
+	inline
+	void
+	fillNoisyTransforms
+		( TransformArrays * const & ptXforms
+		, rigibra::Transform const & expXform
+		, NoiseModel const & noise
+		, CounterSource const & source
+		, std::size_t const & numThreads = 0u
+		, std::vector<std::uint8_t> * const & ptIsBlunders = nullptr
+		)
+	{
+		if (ptIsBlunders)
+		{
+			ptIsBlunders->resize(ptXforms->size());
+		}
+		engabra::g3::Vector const meanLoc{ expXform.theLoc };
+		rigibra::PhysAngle const meanAng{ expXform.theAtt.physAngle() };
+		parallel::forEachRange
+			( ptXforms->size()
+			, [&] (std::size_t const beg, std::size_t const end)
+			{
+				LaneValues uni;
+				LaneValues parms;
+				LaneValues errs;
+				std::array<double, sBulkLanes> uErr;
+				std::array<double, sBulkLanes> uNotUsed;
+				for (std::size_t grp{beg} ; grp < end ; grp += sBulkLanes)
+				{
+					std::size_t const num{ std::min(sBulkLanes, end - grp) };
+					philoxUniformParms(&uni, source, grp, num);
+					philoxUniformLanes
+						(source, grp, num, 3u, uErr.data(), uNotUsed.data());
+					perturbedLaneParms
+						( &parms, uni, num, meanLoc, meanAng
+						, noise.theLocSigma, noise.theAngSigma
+						);
+					uniformLaneParms
+						( &errs, uni, num
+						, noise.theLocMinMax, noise.theAngMinMax
+						);
+					storeLaneParms(ptXforms, grp, num, parms);
+					for (std::size_t lane{0u} ; lane < num ; ++lane)
+					{
+						std::size_t const ndx{ grp + lane };
+						bool const isBlunder{ uErr[lane] < noise.theProbErr };
+						if (isBlunder)
+						{
+							rigibra::Transform const xErrWrtExp
+								{ laneTransform(errs, lane) };
+							ptXforms->setTransform(ndx, xErrWrtExp * expXform);
+						}
+						if (ptIsBlunders)
+						{
+							(*ptIsBlunders)[ndx] = isBlunder ? 1u : 0u;
+						}
+					}
+				}
+			}
+			, numThreads
+			);
+	}
+
+	/*! \brief Two uniform values in (0,1) for single counter index.
+	 *
+	 * Same values as philoxUniformLanes() produces for element index.
+	 * Useful for (stateless) random decisions associated with an index.
+	 */
+	inline
+	std::pair<double, double>
+	uniformPairAt
+		( CounterSource const & source
+		, std::uint64_t const & index
+		, std::uint32_t const & blockNdx = 0u
+		)
+	{
+		std::pair<double, double> uPair{};
+		philoxUniformLanes
+			(source, index, 1u, blockNdx, &uPair.first, &uPair.second);
+		return uPair;
+	}
+
+	/*! \brief Single noisy transform for counter index.
+	 *
+	 * The result is the same as element index of fillNoisyTransforms()
+	 * with the same source (to within roundoff since bulk output is
+	 * stored as parameter values) but is computed individually, e.g.
+	 * for use in streaming simulations.
+	 */
+	inline
+	rigibra::Transform
+	noisyTransformAt
+		( rigibra::Transform const & expXform
+		, NoiseModel const & noise
+		, CounterSource const & source
+		, std::uint64_t const & index
+		)
+	{
+		LaneValues uni;
+		LaneValues parms;
+		double uErr{};
+		double uNotUsed{};
+		philoxUniformParms(&uni, source, index, 1u);
+		philoxUniformLanes(source, index, 1u, 3u, &uErr, &uNotUsed);
+		rigibra::Transform xform{};
+		if (uErr < noise.theProbErr)
+		{
+			uniformLaneParms
+				(&parms, uni, 1u, noise.theLocMinMax, noise.theAngMinMax);
+			rigibra::Transform const xErrWrtExp{ laneTransform(parms, 0u) };
+			xform = xErrWrtExp * expXform;
+		}
+		else
+		{
+			perturbedLaneParms
+				( &parms, uni, 1u
+				, expXform.theLoc, expXform.theAtt.physAngle()
+				, noise.theLocSigma, noise.theAngSigma
+				);
+			xform = laneTransform(parms, 0u);
+		}
+		return xform;
+	}
+
+} // [random]
+
+} // [orinet]
+
+
+#endif // OriNet_randomBulk_INCL_
@@ -33,12 +33,15 @@
 
 
 #include "align.hpp"
+#include "trace.hpp"
 
 #include <Engabra>
 #include <Rigibra>
 
 #include <algorithm>
 #include <array>
+#include <iterator>
+#include <limits>
 #include <vector>
 
 
@@ -51,9 +54,12 @@ namespace robust
 {
 
 	/*! \brief Return the median value of array of \b NOT_CONSTANT values.
+	 *
+	 * The Real type may be any floating point type (e.g. float for
+	 * bulk screening of data in single precision).
 	 *
 	 * For non-empty collection containing 'N' elements:
-	 * \arg For empty sizes: returns engabra::g3::null<double>() value.
+	 * \arg For empty sizes: returns quiet_NaN (e.g. null<double>()) value.
 	 * \arg For odd sizes: returns the "N/2-th" element
 	 * \arg For even sizes: returns average of "N/2-th" and next element
 	 *
@@ -61,13 +67,14 @@ namespace robust
 	 * \note All data values are assumed to be valid (sortable) - e.g.
 	 * none of them are NaN or infinity or other than valid numeric values.
 	 */
+	template <typename Real>
 	inline
-	double
+	Real
 	medianOf
-		( std::vector<double> & values
+		( std::vector<Real> & values
 		)
 	{
-	 	double median{ engabra::g3::null<double>() };
+	 	Real median{ std::numeric_limits<Real>::quiet_NaN() };
 
 		if (! values.empty())
 		{
@@ -108,9 +115,10 @@ namespace robust
 				midN = halfN - 1u;
 			}
 
-			std::vector<double>::iterator const itBeg{ values.begin() };
-			std::vector<double>::iterator const itMid{ itBeg + midN };
-			std::vector<double>::iterator const itEnd{ values.end() };
+			using Iter = typename std::vector<Real>::iterator;
+			Iter const itBeg{ values.begin() };
+			Iter const itMid{ itBeg + midN };
+			Iter const itEnd{ values.end() };
 
 			// The largest of the smallest "half" of values
 			std::nth_element(itBeg, itMid, itEnd);
@@ -125,15 +133,14 @@ namespace robust
 				// of all values) with the next value which is
 				// the smallest of the remaining values (which are
 				// all larger then *itMid).
-				std::vector<double>::const_iterator const itNext
-					{ std::min_element(itMid + 1u, itEnd) };
+				Iter const itNext{ std::min_element(itMid + 1u, itEnd) };
 				if (itEnd == itNext)
 				{
 					std::cerr << __FILE__ << " - fatal error itEnd==itNext\n";
 				}
 				else
 				{
-					median = .5 * ((*itMid) + (*itNext));
+					median = Real{ .5 } * ((*itMid) + (*itNext));
 				}
 			}
 		}
@@ -180,6 +187,7 @@ namespace robust
 		rigibra::Transform median{ rigibra::null<rigibra::Transform>() };
 
 		std::size_t const numXforms{ static_cast<std::size_t>(end - beg) };
+		OriNet_TRACE_SPAN_ARG("robust::transformViaParameters", numXforms);
 		if (0u < numXforms)
 		{
 			//
@@ -271,6 +279,7 @@ namespace robust
 		rigibra::Transform median{ rigibra::null<rigibra::Transform>() };
 
 		std::size_t const numXforms{ static_cast<std::size_t>(end - beg) };
+		OriNet_TRACE_SPAN_ARG("robust::transformViaEffect", numXforms);
 		if (0u < numXforms)
 		{
 			using namespace engabra::g3;
@@ -357,6 +366,168 @@ namespace robust
 		return median;
 	}
 
+	/*! \brief Structure-of-arrays storage of transform "effect" values.
+	 *
+	 * Each element holds the values used by transformViaEffect(): the
+	 * transform offset (location) and the directions into which the
+	 * attitude rotates basis vectors e1 and e2. (The direction for e3
+	 * is their outer product dual, e.g. as computed in
+	 * compare::maxMagResultDifferences()).
+	 *
+	 * The Real type may be float for bulk screening of (many) candidate
+	 * transforms in single precision - which processes twice as many
+	 * values per vector instruction as double.
+	 */
+	template <typename Real>
+	struct EffectArrays
+	{
+		//! Offset components: theLocs[component][element]
+		std::array<std::vector<Real>, 3u> theLocs{};
+
+		//! Rotated e1 direction: theDirE1s[component][element]
+		std::array<std::vector<Real>, 3u> theDirE1s{};
+
+		//! Rotated e2 direction: theDirE2s[component][element]
+		std::array<std::vector<Real>, 3u> theDirE2s{};
+
+		//! Number of elements
+		inline
+		std::size_t
+		size  // EffectArrays::
+			() const
+		{
+			return theLocs[0].size();
+		}
+
+		//! Remove all elements (retains capacity)
+		inline
+		void
+		clear  // EffectArrays::
+			()
+		{
+			for (std::size_t kk{0u} ; kk < 3u ; ++kk)
+			{
+				theLocs[kk].clear();
+				theDirE1s[kk].clear();
+				theDirE2s[kk].clear();
+			}
+		}
+
+		//! Allocate space for numElem elements
+		inline
+		void
+		reserve  // EffectArrays::
+			( std::size_t const & numElem
+			)
+		{
+			for (std::size_t kk{0u} ; kk < 3u ; ++kk)
+			{
+				theLocs[kk].reserve(numElem);
+				theDirE1s[kk].reserve(numElem);
+				theDirE2s[kk].reserve(numElem);
+			}
+		}
+
+		//! Append effect values for xform (if it is valid)
+		inline
+		bool
+		append  // EffectArrays::
+			( rigibra::Transform const & xform
+			)
+		{
+			bool const okay{ rigibra::isValid(xform) };
+			if (okay)
+			{
+				using namespace engabra::g3;
+				Vector const & loc = xform.theLoc;
+				Vector const dirE1{ xform.theAtt(e1) };
+				Vector const dirE2{ xform.theAtt(e2) };
+				for (std::size_t kk{0u} ; kk < 3u ; ++kk)
+				{
+					theLocs[kk].emplace_back(static_cast<Real>(loc[kk]));
+					theDirE1s[kk].emplace_back(static_cast<Real>(dirE1[kk]));
+					theDirE2s[kk].emplace_back(static_cast<Real>(dirE2[kk]));
+				}
+			}
+			return okay;
+		}
+
+		/*! \brief Replace contents with (valid) transforms from [beg,end).
+		 *
+		 * \note Dereferencing to (* FwdIter) must be a rigibra::Transform.
+		 */
+		template <typename FwdIter>
+		inline
+		void
+		assign  // EffectArrays::
+			( FwdIter const & beg
+			, FwdIter const & end
+			)
+		{
+			clear();
+			reserve(static_cast<std::size_t>(std::distance(beg, end)));
+			for (FwdIter iter{beg} ; end != iter ; ++iter)
+			{
+				(void)append(*iter);
+			}
+		}
+
+	}; // EffectArrays
+
+	/*! \brief As transformViaEffect() for data in EffectArrays storage.
+	 *
+	 * The component medians are computed in the precision of Real. The
+	 * attitude is then formed (in double) from the median directions.
+	 * For Real==double, the result is the same as that from
+	 * transformViaEffect() for the same (valid) transforms.
+	 */
+	template <typename Real>
+	inline
+	rigibra::Transform
+	transformViaEffect
+		( EffectArrays<Real> const & effects
+		)
+	{
+		rigibra::Transform median{ rigibra::null<rigibra::Transform>() };
+
+		std::size_t const numXforms{ effects.size() };
+		OriNet_TRACE_SPAN_ARG("robust::transformViaEffect(arrays)", numXforms);
+		if (0u < numXforms)
+		{
+			using namespace engabra::g3;
+			static align::DirPair const refDirPair{ e1, e2 };
+
+			// medianOf() reorders values, so use a (reused) copy
+			std::vector<Real> work;
+			work.reserve(numXforms);
+			std::array<double, 9u> meds;
+			for (std::size_t kk{0u} ; kk < 3u ; ++kk)
+			{
+				work.assign(effects.theLocs[kk].cbegin()
+					, effects.theLocs[kk].cend());
+				meds[kk] = static_cast<double>(medianOf(work));
+				work.assign(effects.theDirE1s[kk].cbegin()
+					, effects.theDirE1s[kk].cend());
+				meds[3u + kk] = static_cast<double>(medianOf(work));
+				work.assign(effects.theDirE2s[kk].cbegin()
+					, effects.theDirE2s[kk].cend());
+				meds[6u + kk] = static_cast<double>(medianOf(work));
+			}
+
+			Vector const medianLoc{ meds[0], meds[1], meds[2] };
+			align::DirPair const bodDirPair
+				{ Vector{ meds[3], meds[4], meds[5] }
+				, Vector{ meds[6], meds[7], meds[8] }
+				};
+			rigibra::Attitude const medianAtt
+				{ align::attitudeFromDirPairs(refDirPair, bodDirPair) };
+
+			median = rigibra::Transform{ medianLoc, medianAtt };
+		}
+
+		return median;
+	}
+
 } // [robust]
 
 } // [orinet]
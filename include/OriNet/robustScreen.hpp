@@ -0,0 +1,144 @@
+//
+// MIT License
+//
+// Copyright (c) 2024 Stellacore Corporation
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+
+#ifndef OriNet_robustScreen_INCL_
+#define OriNet_robustScreen_INCL_
+
+/*! \file
+\brief Robust transform estimation with single precision bulk screening.
+
+Screening of many candidate transforms (e.g. thousands of observations
+for a single edge) does not need double precision. The functions here
+perform the bulk effort with float values in structure-of-arrays
+(robust::EffectArrays) storage and then refine the final estimate in
+double precision using only those candidates that pass the screening.
+
+Example:
+\snippet test_robustScreen.cpp DoxyExample01
+
+*/
+
+
+#include "compare.hpp"
+#include "robust.hpp"
+#include "trace.hpp"
+
+#include <Rigibra>
+
+#include <cstddef>
+#include <iterator>
+#include <vector>
+
+
+namespace orinet
+{
+
+namespace robust
+{
+
+	/*! \brief Robust transform from candidates screened in single precision.
+	 *
+	 * Algorithm involves:
+	 * \arg Load candidates into EffectArrays<float> storage
+	 * \arg Estimate coarse transform via transformViaEffect() (in float)
+	 * \arg Compute compare::maxMagResultDifferences() (in float)
+	 * \arg Retain candidates with differences less than maxMagTol
+	 * \arg Refine transformViaEffect() from retained candidates (in double)
+	 *
+	 * The maxMagTol value should be well above the single precision
+	 * resolution of the candidate values (e.g. several times the
+	 * expected measurement noise). If no candidates are retained, the
+	 * result is the double precision estimate from all candidates.
+	 *
+	 * If ptNumInliers is provided, it is set to the number of
+	 * candidates that were retained by the screening.
+	 *
+	 * \note Dereferencing to (* FwdIter) must be a rigibra::Transform.
+	 */
+	template <typename FwdIter>
+	inline
+	rigibra::Transform
+	transformViaScreening
+		( FwdIter const & beg
+		, FwdIter const & end
+		, double const & maxMagTol
+		, bool const & useNormalizedCompare = false
+		, std::size_t * const & ptNumInliers = nullptr
+		)
+	{
+		rigibra::Transform estimate{ rigibra::null<rigibra::Transform>() };
+
+		OriNet_TRACE_SPAN_ARG
+			( "robust::transformViaScreening"
+			, static_cast<std::size_t>(std::distance(beg, end))
+			);
+
+		// bulk screening in single precision
+		EffectArrays<float> effects;
+		effects.assign(beg, end);
+		rigibra::Transform const coarse{ transformViaEffect(effects) };
+		std::vector<float> mags;
+		compare::maxMagResultDifferences
+			(&mags, effects, coarse, useNormalizedCompare);
+
+		// retain (valid) candidates consistent with coarse estimate
+		std::vector<rigibra::Transform> inliers;
+		inliers.reserve(effects.size());
+		std::size_t ndx{ 0u };
+		for (FwdIter iter{beg} ; end != iter ; ++iter)
+		{
+			if (rigibra::isValid(*iter))
+			{
+				if (static_cast<double>(mags[ndx]) < maxMagTol)
+				{
+					inliers.emplace_back(*iter);
+				}
+				++ndx;
+			}
+		}
+
+		// refine in double precision
+		if (! inliers.empty())
+		{
+			estimate = transformViaEffect(inliers.cbegin(), inliers.cend());
+		}
+		else
+		{
+			estimate = transformViaEffect(beg, end);
+		}
+
+		if (ptNumInliers)
+		{
+			*ptNumInliers = inliers.size();
+		}
+		return estimate;
+	}
+
+} // [robust]
+
+} // [orinet]
+
+
+#endif // OriNet_robustScreen_INCL_
@@ -35,6 +35,8 @@ Example:
 
 
 #include "align.hpp"
+#include "applied.hpp"
+#include "parallel.hpp"
 #include "random.hpp"
 
 #include <Engabra>
@@ -42,8 +44,10 @@ Example:
 
 #include <algorithm>
 #include <map>
+#include <mutex>
 #include <numeric>
 #include <random>
+#include <span>
 #include <utility>
 #include <vector>
 
@@ -59,6 +63,36 @@ namespace sim
 	//! \brief Generate random pairs of directions
 	inline
 	align::DirPair
+	directionPair
+		( random::Context & ctx
+		, std::pair<double, double> const & minMaxAngleMag = { .1, 3. }
+		)
+	{
+		using namespace engabra::g3;
+		align::DirPair dirPair{ null<Vector>(), null<Vector>() };
+		for (;;)
+		{
+			Vector const aDir{ random::directionVector(ctx) };
+			Vector const bDir{ random::directionVector(ctx) };
+
+			BiVector const angle{ logG2(aDir * bDir).theBiv };
+			double const angleMag{ magnitude(angle) };
+
+			// avoid (anti)parallel dirs
+			double const & minAngleMag = minMaxAngleMag.first;
+			double const & maxAngleMag = minMaxAngleMag.second;
+			if ((minAngleMag < angleMag) && (angleMag < maxAngleMag))
+			{
+				dirPair = std::make_pair(aDir, bDir);
+				break;
+			}
+		}
+		return dirPair;
+	}
+
+	//! \brief Generate random pairs of directions (NOT thread safe)
+	inline
+	align::DirPair
 	directionPair
 		( std::pair<double, double> const & minMaxAngleMag = { .1, 3. }
 		)
@@ -89,7 +123,8 @@ namespace sim
 	inline
 	align::DirPair
 	bodyDirectionPair
-		( align::DirPair const & refDirPair
+		( random::Context & ctx
+		, align::DirPair const & refDirPair
 		, rigibra::Attitude const & attBodWrtRef
 		)
 	{
@@ -101,9 +136,8 @@ namespace sim
 
 		// perturb measurements by random error (the 4th measurement DOM)
 		// ref. theory/alignDifPairs.lyx
-		static std::mt19937 gen(47562958u);
 		std::uniform_real_distribution<> dist(1./128., 32./128.);
-		double const nu{ dist(gen) };
+		double const nu{ dist(ctx.generator()) };
 		double const wp{ 1. + nu };
 		double const wn{ 1. - nu };
 		// perturbed values that remain coplaner with (a0,b0)
@@ -117,6 +151,18 @@ namespace sim
 		return std::make_pair(a1, b1);
 	}
 
+	//! \brief Generate 'noisy' body frame direction pair (NOT thread safe)
+	inline
+	align::DirPair
+	bodyDirectionPair
+		( align::DirPair const & refDirPair
+		, rigibra::Attitude const & attBodWrtRef
+		)
+	{
+		static random::Context ctx(47562958u);
+		return bodyDirectionPair(ctx, refDirPair, attBodWrtRef);
+	}
+
 	//! Create a collection of (pseudo)random station orientations
 	inline
 	std::vector<rigibra::Transform>
@@ -141,6 +187,25 @@ namespace sim
 	//! Create a collection of (pseudo)random station orientations
 	inline
 	std::vector<rigibra::Transform>
+	randomStations
+		( random::Context & ctx
+		, std::size_t const & numStas
+		, std::pair<double, double> const & locMinMax
+		)
+	{
+		std::vector<rigibra::Transform> stas;
+		stas.reserve(numStas);
+		for (std::size_t numSta{0u} ; numSta < numStas ; ++numSta)
+		{
+			stas.emplace_back
+				(random::uniformTransform(ctx, locMinMax));
+		}
+		return stas;
+	}
+
+	//! Create a collection of (pseudo)random stations (NOT thread safe)
+	inline
+	std::vector<rigibra::Transform>
 	randomStations
 		( std::size_t const & numStas
 		, std::pair<double, double> const & locMinMax
@@ -159,6 +224,80 @@ namespace sim
 	//! simulate backsight observations
 	inline
 	std::map<NdxPair, std::vector<rigibra::Transform> >
+	backsightTransforms
+		( random::Context & ctx
+		, std::vector<rigibra::Transform> const & expStas
+		, std::size_t const & numBacksight
+		, std::size_t const & numMea
+		, std::size_t const & numErr
+		, std::pair<double, double> const & locMinMax
+		, std::pair<double, double> const & angMinMax
+			= { -engabra::g3::pi, engabra::g3::pi }
+		, double const & sigmaLoc = 1./8.
+		, double const & sigmaAng = 5./1024.
+		)
+	{
+		std::map<NdxPair, std::vector<rigibra::Transform> > pairXforms;
+
+		// simulate measurements station by station)
+		std::vector<std::size_t> staNdxs(expStas.size());
+		std::iota(staNdxs.begin(), staNdxs.end(), 0u);
+		for (std::size_t currSta{0u} ; currSta < expStas.size() ; ++currSta)
+		{
+			rigibra::Transform const & expCurrWrtRef = expStas[currSta];
+
+			// generate backsight transforms for this station
+			std::shuffle
+				(staNdxs.begin(), staNdxs.begin() + currSta, ctx.generator());
+
+			std::size_t const nbMax{ std::min(currSta, numBacksight) };
+			for (std::size_t backSta{0u} ; backSta < nbMax ; ++backSta)
+			{
+				std::size_t const & fromNdx = staNdxs[backSta];
+				std::size_t const & intoNdx = currSta;
+
+				// connect randomly with previous stations
+				rigibra::Transform const & expBackWrtRef = expStas[fromNdx];
+
+				// compute expected relative setup transformation
+				rigibra::Transform const expRefWrtBack
+					{ rigibra::inverse(expBackWrtRef) };
+				rigibra::Transform const expCurrWrtBack
+					{ expCurrWrtRef * expRefWrtBack };
+
+				// simulate backsight transformations
+				std::vector<rigibra::Transform> const obsXforms
+					{ random::noisyTransforms
+						( ctx
+						, expCurrWrtBack
+						, numMea
+						, numErr
+						, sigmaLoc
+						, sigmaAng
+						, locMinMax
+						, angMinMax
+						)
+					};
+
+				// record relative transforms for later processing
+				pairXforms.emplace_hint
+					( pairXforms.end()
+					, std::make_pair(NdxPair{fromNdx, intoNdx}, obsXforms)
+					);
+			}
+		}
+
+		return pairXforms;
+	}
+
+	/*! \brief simulate backsight observations (NOT thread safe)
+	 *
+	 * As backsightTransforms(ctx, ...) above but with the generators of
+	 * the context free functions (such that the sequences are the same
+	 * as for earlier versions of this function).
+	 */
+	inline
+	std::map<NdxPair, std::vector<rigibra::Transform> >
 	backsightTransforms
 		( std::vector<rigibra::Transform> const & expStas
 		, std::size_t const & numBacksight
@@ -223,6 +362,159 @@ namespace sim
 		return pairXforms;
 	}
 
+	/*! \brief Simulate backsight observations using multiple threads.
+	 *
+	 * Each station connects to (up to) numBacksight previous stations
+	 * (selected without replacement) with observations as for
+	 * backsightTransforms(). The work is partitioned by station over
+	 * (up to) numThreads threads (zero for hardware concurrency).
+	 *
+	 * All values for station currSta are generated with the random
+	 * context ctx.stream(currSta). The result therefore depends only
+	 * on ctx.seed() (and the other arguments) - not on the number of
+	 * threads. Each thread accumulates a separate output shard and
+	 * these are merged (without copying data) at the end.
+	 *
+	 * The expected relative transform offsets are computed in blocks
+	 * of stations with the applied::composeInverseEach() batch kernel
+	 * (rather than one rigibra composition at a time).
+	 */
+	inline
+	std::map<NdxPair, std::vector<rigibra::Transform> >
+	backsightTransformsParallel
+		( random::Context const & ctx
+		, std::vector<rigibra::Transform> const & expStas
+		, std::size_t const & numBacksight
+		, std::size_t const & numMea
+		, std::size_t const & numErr
+		, std::pair<double, double> const & locMinMax
+		, std::pair<double, double> const & angMinMax
+			= { -engabra::g3::pi, engabra::g3::pi }
+		, double const & sigmaLoc = 1./8.
+		, double const & sigmaAng = 5./1024.
+		, std::size_t const & numThreads = 0u
+		)
+	{
+		using PairMap = std::map<NdxPair, std::vector<rigibra::Transform> >;
+		std::vector<PairMap> shards;
+		std::mutex shardsMutex;
+
+		// applied form of each station (shared by all of its backsights)
+		applied::XformArrays staApps(expStas.size());
+		parallel::forEachRange
+			( expStas.size()
+			, [&] (std::size_t const beg, std::size_t const end)
+			{
+				for (std::size_t ndx{beg} ; ndx < end ; ++ndx)
+				{
+					staApps.setTransform(ndx, expStas[ndx]);
+				}
+			}
+			, numThreads
+			);
+
+		parallel::forEachRange
+			( expStas.size()
+			, [&] (std::size_t const beg, std::size_t const end)
+			{
+				PairMap shard;
+
+				// per block: select backsights, compute all expected
+				// relative transforms in one batch, then add noise
+				constexpr std::size_t blockSize{ applied::sBatchLanes };
+				std::vector<random::Context> staCtxs;
+				std::vector<std::size_t> currNdxs;
+				std::vector<std::size_t> backNdxs;
+				applied::XformArrays currApps;
+				applied::XformArrays backApps;
+				for (std::size_t blkBeg{beg} ; blkBeg < end
+					; blkBeg += blockSize)
+				{
+					std::size_t const blkEnd
+						{ std::min(end, blkBeg + blockSize) };
+
+					// connect randomly with previous stations
+					staCtxs.clear();
+					currNdxs.clear();
+					backNdxs.clear();
+					for (std::size_t currSta{blkBeg} ; currSta < blkEnd
+						; ++currSta)
+					{
+						staCtxs.emplace_back(ctx.stream(currSta));
+						for (std::size_t const & fromNdx
+							: random::distinctIndices
+								(staCtxs.back(), currSta, numBacksight))
+						{
+							currNdxs.emplace_back(currSta);
+							backNdxs.emplace_back(fromNdx);
+						}
+					}
+
+					// expCurrWrtBack = expCurrWrtRef * inverse(expBackWrtRef)
+					std::size_t const numPairs{ currNdxs.size() };
+					currApps.resize(numPairs);
+					backApps.resize(numPairs);
+					applied::gatherEach(currApps.outSpans(), staApps.inSpans()
+						, std::span<std::size_t const>(currNdxs));
+					applied::gatherEach(backApps.outSpans(), staApps.inSpans()
+						, std::span<std::size_t const>(backNdxs));
+					applied::composeInverseEach
+						( currApps.outSpans()
+						, currApps.inSpans()
+						, backApps.inSpans()
+						);
+
+					// noisy observations (in same order as selection above)
+					for (std::size_t nn{0u} ; nn < numPairs ; ++nn)
+					{
+						std::size_t const & currSta = currNdxs[nn];
+						std::size_t const & fromNdx = backNdxs[nn];
+						random::Context & staCtx = staCtxs[currSta - blkBeg];
+						// offset from batch, attitude composed as spinors
+						rigibra::Transform const expCurrWrtBack
+							{ engabra::g3::Vector
+								{ currApps.theLocs[0][nn]
+								, currApps.theLocs[1][nn]
+								, currApps.theLocs[2][nn]
+								}
+							, expStas[currSta].theAtt
+								* inverse(expStas[fromNdx].theAtt)
+							};
+						std::vector<rigibra::Transform> obsXforms
+							{ random::noisyTransforms
+								( staCtx
+								, expCurrWrtBack
+								, numMea
+								, numErr
+								, sigmaLoc
+								, sigmaAng
+								, locMinMax
+								, angMinMax
+								)
+							};
+						shard.emplace_hint
+							( shard.end()
+							, NdxPair{ fromNdx, currSta }
+							, std::move(obsXforms)
+							);
+					}
+				}
+				std::lock_guard<std::mutex> const lock(shardsMutex);
+				shards.emplace_back(std::move(shard));
+			}
+			, numThreads
+			, 64u
+			);
+
+		// keys of shards are disjoint - merge splices map nodes
+		PairMap pairXforms;
+		for (PairMap & shard : shards)
+		{
+			pairXforms.merge(shard);
+		}
+		return pairXforms;
+	}
+
 } // [sim]
 
 } // [orinet]
@@ -0,0 +1,582 @@
+//
+// MIT License
+//
+// Copyright (c) 2024 Stellacore Corporation
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+
+#ifndef OriNet_simNetwork_INCL_
+#define OriNet_simNetwork_INCL_
+
+/*! \file
+\brief Streaming simulation of (large) networks with selectable topology.
+
+Station orientations and edge observations are computed on demand from
+their indices (with counter based random values) and are delivered
+through callback functions. Nothing is stored, so that networks with
+very large numbers of edges can be generated in bounded memory.
+
+Example:
+\snippet test_simNetwork.cpp DoxyExample01
+
+*/
+
+
+#include "random.hpp"
+#include "randomBulk.hpp"
+#include "sim.hpp"
+
+#include <Engabra>
+#include <Rigibra>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <utility>
+
+
+namespace orinet
+{
+
+namespace sim
+{
+
+	//! Configuration for a NetworkSim instance.
+	struct NetworkSpec
+	{
+		//! Pattern of connections between stations
+		enum Topology
+		{
+			  Chain  //!< Traverse: each to theNumBack previous stations
+			, Grid  //!< Rows of theGridWidth, 4-neighbor connections
+			, RandomGeometric  //!< Stations within theRadius connected
+			, SmallWorld  //!< Watts-Strogatz ring with rewired edges
+			, SlamSessions  //!< Repeated trajectories with loop closures
+		};
+
+		//! Connection pattern to simulate
+		Topology theTopology{ Chain };
+
+		//! Number of stations in network
+		std::size_t theNumStas{ 100u };
+
+		//! Nominal distance between adjacent stations
+		double theSpacing{ 10. };
+
+		//! Station location perturbation (fraction of theSpacing)
+		double theJitter{ .125 };
+
+		//! Chain, SlamSessions: number of previous stations connected
+		std::size_t theNumBack{ 1u };
+
+		//! Grid, RandomGeometric: stations per row (0: square layout)
+		std::size_t theGridWidth{ 0u };
+
+		//! RandomGeometric: connection distance (multiple of theSpacing)
+		double theRadius{ 1.5 };
+
+		//! SmallWorld: (even) number of ring lattice neighbors
+		std::size_t theNumNeighbors{ 4u };
+
+		//! SmallWorld: probability of rewiring each lattice edge
+		double theRewireProb{ .125 };
+
+		//! SlamSessions: number of trajectory sessions (loops)
+		std::size_t theNumSessions{ 3u };
+
+		//! SlamSessions: loop closure with previous session this often
+		std::size_t theLoopEvery{ 8u };
+
+		//! Number of observations simulated for each edge
+		std::size_t theNumMea{ 1u };
+
+		//! Seed for all random values
+		std::uint64_t theSeed{ 0u };
+
+	}; // NetworkSpec
+
+
+	/*! \brief Streaming network simulation.
+	 *
+	 * Edges are produced in (fromNdx < intoNdx) order such that the
+	 * observations are of (expected) transform Into w.r.t. From. Each
+	 * edge is associated with exactly one "owner" station, so that
+	 * disjoint station index ranges produce disjoint sets of edges
+	 * (e.g. for use by different threads).
+	 *
+	 * For RandomGeometric, station locations are uniformly distributed
+	 * within the (square) cells of a grid - one station per cell. This
+	 * approximates a random geometric graph while allowing neighbors
+	 * to be found directly from station indices.
+	 *
+	 * For SmallWorld, rewired edges to a station already within the
+	 * ring neighborhood are left in place (not rewired). Two rewired
+	 * edges may (rarely) coincide.
+	 */
+	class NetworkSim
+	{
+		//! Value indicating all stations (for range end)
+		static constexpr std::size_t sNullKey
+			{ std::numeric_limits<std::size_t>::max() };
+
+		NetworkSpec theSpec{};
+
+		//! Counter streams for independent uses of random values
+		static constexpr std::uint32_t sStreamSta{ 1u };
+		static constexpr std::uint32_t sStreamTopo{ 2u };
+		static constexpr std::uint32_t sStreamObs{ 3u };
+
+		//! Counter based source for values of stream
+		inline
+		random::CounterSource
+		sourceFor  // NetworkSim::
+			( std::uint32_t const & stream
+			) const
+		{
+			return random::CounterSource
+				{ .theSeed = theSpec.theSeed
+				, .theStream = stream
+				, .theFirstIndex = 0u
+				};
+		}
+
+		//! Number of stations per grid row
+		inline
+		std::size_t
+		gridWidth  // NetworkSim::
+			() const
+		{
+			std::size_t width{ theSpec.theGridWidth };
+			if (0u == width)
+			{
+				width = static_cast<std::size_t>
+					(std::ceil(std::sqrt(double(theSpec.theNumStas))));
+			}
+			return std::max(width, std::size_t{ 1u });
+		}
+
+		//! Number of stations in each SlamSessions session (but last)
+		inline
+		std::size_t
+		sessionSize  // NetworkSim::
+			() const
+		{
+			std::size_t const numSess
+				{ std::max(theSpec.theNumSessions, std::size_t{ 1u }) };
+			return std::max
+				(theSpec.theNumStas / numSess, std::size_t{ 1u });
+		}
+
+		//! Session index and index within the session for staNdx
+		inline
+		std::pair<std::size_t, std::size_t>
+		sessionLocal  // NetworkSim::
+			( std::size_t const & staNdx
+			) const
+		{
+			std::size_t const size{ sessionSize() };
+			std::size_t const lastSess
+				{ std::max(theSpec.theNumSessions, std::size_t{ 1u }) - 1u };
+			std::size_t const sess{ std::min(staNdx / size, lastSess) };
+			return { sess, staNdx - sess*size };
+		}
+
+		//! Nominal (unperturbed) station location
+		inline
+		engabra::g3::Vector
+		nominalLocation  // NetworkSim::
+			( std::size_t const & staNdx
+			) const
+		{
+			using namespace engabra::g3;
+			double const & spacing = theSpec.theSpacing;
+			Vector loc{ zero<Vector>() };
+			switch (theSpec.theTopology)
+			{
+				case NetworkSpec::Chain:
+				{
+					loc = Vector{ spacing * double(staNdx), 0., 0. };
+					break;
+				}
+				case NetworkSpec::Grid:
+				case NetworkSpec::RandomGeometric:
+				{
+					std::size_t const width{ gridWidth() };
+					double const col{ double(staNdx % width) };
+					double const row{ double(staNdx / width) };
+					loc = Vector{ spacing * col, spacing * row, 0. };
+					break;
+				}
+				case NetworkSpec::SmallWorld:
+				case NetworkSpec::SlamSessions:
+				{
+					// stations around circle (for sessions, same circle)
+					double numOnCircle{ double(theSpec.theNumStas) };
+					double posOnCircle{ double(staNdx) };
+					if (NetworkSpec::SlamSessions == theSpec.theTopology)
+					{
+						numOnCircle = double(sessionSize());
+						posOnCircle = double(sessionLocal(staNdx).second);
+					}
+					double const radius
+						{ (spacing * numOnCircle) / (2. * pi) };
+					double const angle{ 2. * pi * posOnCircle / numOnCircle };
+					loc = Vector
+						{ radius * std::cos(angle)
+						, radius * std::sin(angle)
+						, 0.
+						};
+					break;
+				}
+			}
+			return loc;
+		}
+
+		//! Random (unit) location offsets and attitude values for station
+		inline
+		random::LaneValues
+		stationParms  // NetworkSim::
+			( std::size_t const & staNdx
+			) const
+		{
+			random::LaneValues uni;
+			random::LaneValues parms;
+			random::philoxUniformParms(&uni, sourceFor(sStreamSta), staNdx, 1u);
+			random::uniformLaneParms
+				( &parms, uni, 1u
+				, { -1., 1. }
+				, { -engabra::g3::pi, engabra::g3::pi }
+				);
+			return parms;
+		}
+
+		//! Station location from nominal position and random offsets
+		inline
+		engabra::g3::Vector
+		locationFrom  // NetworkSim::
+			( std::size_t const & staNdx
+			, random::LaneValues const & parms
+			) const
+		{
+			using namespace engabra::g3;
+			Vector const unitOffset{ parms[0][0], parms[1][0], parms[2][0] };
+			double scale{ theSpec.theJitter * theSpec.theSpacing };
+			Vector center{ nominalLocation(staNdx) };
+			if (NetworkSpec::RandomGeometric == theSpec.theTopology)
+			{
+				// uniform within (horizontal) cell
+				scale = .5 * theSpec.theSpacing;
+				center = center + scale * (e1 + e2);
+			}
+			return center + scale * unitOffset;
+		}
+
+		//! Location of station
+		inline
+		engabra::g3::Vector
+		stationLocation  // NetworkSim::
+			( std::size_t const & staNdx
+			) const
+		{
+			return locationFrom(staNdx, stationParms(staNdx));
+		}
+
+		//! Call edgeFunc(NdxPair) for each edge owned by station ndx
+		template <typename EdgeFunc>
+		inline
+		void
+		edgesOwnedBy  // NetworkSim::
+			( std::size_t const & ndx
+			, EdgeFunc const & edgeFunc
+			) const
+		{
+			std::size_t const & numStas = theSpec.theNumStas;
+			switch (theSpec.theTopology)
+			{
+				case NetworkSpec::Chain:
+				{
+					std::size_t const numBack
+						{ std::min(ndx, theSpec.theNumBack) };
+					for (std::size_t back{numBack} ; 0u < back ; --back)
+					{
+						edgeFunc(NdxPair{ ndx - back, ndx });
+					}
+					break;
+				}
+				case NetworkSpec::Grid:
+				{
+					std::size_t const width{ gridWidth() };
+					if (! (ndx < width))
+					{
+						edgeFunc(NdxPair{ ndx - width, ndx });
+					}
+					if (0u < (ndx % width))
+					{
+						edgeFunc(NdxPair{ ndx - 1u, ndx });
+					}
+					break;
+				}
+				case NetworkSpec::RandomGeometric:
+				{
+					edgesRandomGeometric(ndx, edgeFunc);
+					break;
+				}
+				case NetworkSpec::SmallWorld:
+				{
+					std::size_t const half{ theSpec.theNumNeighbors / 2u };
+					if (2u*half < numStas)
+					{
+						for (std::size_t step{1u} ; ! (half < step) ; ++step)
+						{
+							std::size_t const other
+								{ smallWorldOther(ndx, step, half) };
+							edgeFunc(NdxPair
+								{ std::min(ndx, other), std::max(ndx, other) });
+						}
+					}
+					break;
+				}
+				case NetworkSpec::SlamSessions:
+				{
+					std::pair<std::size_t, std::size_t> const sessLocal
+						{ sessionLocal(ndx) };
+					std::size_t const & sess = sessLocal.first;
+					std::size_t const & local = sessLocal.second;
+					// odometry along trajectory
+					std::size_t const numBack
+						{ std::min(local, theSpec.theNumBack) };
+					for (std::size_t back{numBack} ; 0u < back ; --back)
+					{
+						edgeFunc(NdxPair{ ndx - back, ndx });
+					}
+					// loop closure with same place in previous session
+					std::size_t const & every = theSpec.theLoopEvery;
+					if ((0u < sess) && (0u < every) && (0u == (local % every))
+						&& (local < sessionSize()))
+					{
+						std::size_t const prev
+							{ (sess - 1u)*sessionSize() + local };
+						edgeFunc(NdxPair{ prev, ndx });
+					}
+					break;
+				}
+			}
+		}
+
+		//! Station connected by (possibly rewired) ring lattice edge
+		inline
+		std::size_t
+		smallWorldOther  // NetworkSim::
+			( std::size_t const & ndx
+			, std::size_t const & step
+			, std::size_t const & half
+			) const
+		{
+			std::size_t const & numStas = theSpec.theNumStas;
+			std::size_t other{ (ndx + step) % numStas };
+			std::uint64_t const counter{ ndx * half + (step - 1u) };
+			std::pair<double, double> const uPair
+				{ random::uniformPairAt(sourceFor(sStreamTopo), counter) };
+			if (uPair.first < theSpec.theRewireProb)
+			{
+				double const where{ uPair.second * double(numStas) };
+				std::size_t const cand
+					{ std::min(static_cast<std::size_t>(where), numStas - 1u) };
+				std::size_t const dist
+					{ (cand < ndx) ? (ndx - cand) : (cand - ndx) };
+				std::size_t const ringDist{ std::min(dist, numStas - dist) };
+				if (half < ringDist)
+				{
+					other = cand;
+				}
+			}
+			return other;
+		}
+
+		//! Edges to lower index stations within theRadius of ndx
+		template <typename EdgeFunc>
+		inline
+		void
+		edgesRandomGeometric  // NetworkSim::
+			( std::size_t const & ndx
+			, EdgeFunc const & edgeFunc
+			) const
+		{
+			using namespace engabra::g3;
+			std::size_t const width{ gridWidth() };
+			double const maxDist{ theSpec.theRadius * theSpec.theSpacing };
+			// cells are spacing in size
+			long const reach{ static_cast<long>(std::ceil(theSpec.theRadius)) };
+			long const col{ static_cast<long>(ndx % width) };
+			long const row{ static_cast<long>(ndx / width) };
+			Vector const loc{ stationLocation(ndx) };
+			for (long dRow{-reach} ; ! (0 < dRow) ; ++dRow)
+			{
+				long const nRow{ row + dRow };
+				if (nRow < 0)
+				{
+					continue;
+				}
+				long const maxCol{ (0 == dRow) ? -1 : reach };
+				for (long dCol{-reach} ; ! (maxCol < dCol) ; ++dCol)
+				{
+					long const nCol{ col + dCol };
+					if ((nCol < 0) || (! (nCol < static_cast<long>(width))))
+					{
+						continue;
+					}
+					std::size_t const other
+						{ static_cast<std::size_t>(nRow) * width
+						+ static_cast<std::size_t>(nCol)
+						};
+					double const dist
+						{ magnitude(stationLocation(other) - loc) };
+					if (dist < maxDist)
+					{
+						edgeFunc(NdxPair{ other, ndx });
+					}
+				}
+			}
+		}
+
+	public:
+
+		//! Construct to simulate network according to spec
+		inline
+		explicit
+		NetworkSim  // NetworkSim::
+			( NetworkSpec const & spec
+			)
+			: theSpec{ spec }
+		{ }
+
+		//! Configuration
+		inline
+		NetworkSpec const &
+		spec  // NetworkSim::
+			() const
+		{
+			return theSpec;
+		}
+
+		//! Number of stations
+		inline
+		std::size_t
+		sizeStations  // NetworkSim::
+			() const
+		{
+			return theSpec.theNumStas;
+		}
+
+		//! Expected orientation of station staNdx (w.r.t. reference)
+		inline
+		rigibra::Transform
+		stationXform  // NetworkSim::
+			( std::size_t const & staNdx
+			) const
+		{
+			random::LaneValues const parms{ stationParms(staNdx) };
+			engabra::g3::BiVector const ang
+				{ parms[3][0], parms[4][0], parms[5][0] };
+			return rigibra::Transform
+				{ locationFrom(staNdx, parms)
+				, rigibra::Attitude{ rigibra::PhysAngle{ ang } }
+				};
+		}
+
+		/*! \brief Call edgeFunc(NdxPair) for each edge owned by stations.
+		 *
+		 * Edges owned by stations in range [staBeg, staEnd) (limited
+		 * to sizeStations()) are produced in order of owner station.
+		 */
+		template <typename EdgeFunc>
+		inline
+		void
+		forEachEdge  // NetworkSim::
+			( EdgeFunc const & edgeFunc
+			, std::size_t const & staBeg = 0u
+			, std::size_t const & staEnd = sNullKey
+			) const
+		{
+			std::size_t const end{ std::min(staEnd, sizeStations()) };
+			for (std::size_t ndx{staBeg} ; ndx < end ; ++ndx)
+			{
+				edgesOwnedBy(ndx, edgeFunc);
+			}
+		}
+
+		/*! \brief Call obsFunc(NdxPair, xIntoWrtFrom) for each observation.
+		 *
+		 * For each edge (as for forEachEdge()), theNumMea observations
+		 * are simulated with the noise model (as for noisyTransform()).
+		 * Each observation depends only on the seed, the edge station
+		 * indices and the observation number.
+		 */
+		template <typename ObsFunc>
+		inline
+		void
+		forEachObservation  // NetworkSim::
+			( random::NoiseModel const & noise
+			, ObsFunc const & obsFunc
+			, std::size_t const & staBeg = 0u
+			, std::size_t const & staEnd = sNullKey
+			) const
+		{
+			random::CounterSource const source{ sourceFor(sStreamObs) };
+			std::uint64_t const numStas{ sizeStations() };
+			std::uint64_t const numMea{ theSpec.theNumMea };
+			forEachEdge
+				( [&] (NdxPair const & ndxPair)
+				{
+					rigibra::Transform const expFromWrtRef
+						{ stationXform(ndxPair.first) };
+					rigibra::Transform const expIntoWrtRef
+						{ stationXform(ndxPair.second) };
+					rigibra::Transform const expIntoWrtFrom
+						{ expIntoWrtRef * rigibra::inverse(expFromWrtRef) };
+					std::uint64_t const edgeCount
+						{ ndxPair.first * numStas + ndxPair.second };
+					for (std::uint64_t nMea{0u} ; nMea < numMea ; ++nMea)
+					{
+						rigibra::Transform const xObs
+							{ random::noisyTransformAt
+								( expIntoWrtFrom, noise, source
+								, edgeCount * numMea + nMea
+								)
+							};
+						obsFunc(ndxPair, xObs);
+					}
+				}
+				, staBeg
+				, staEnd
+				);
+		}
+
+	}; // NetworkSim
+
+
+} // [sim]
+
+} // [orinet]
+
+
+#endif // OriNet_simNetwork_INCL_
@@ -0,0 +1,740 @@
+//
+// MIT License
+//
+// Copyright (c) 2024 Stellacore Corporation
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+
+#ifndef OriNet_simScene_INCL_
+#define OriNet_simScene_INCL_
+
+/*! \file
+\brief Simulation of moving cameras observing object space features.
+
+Provides trajectory models (camera orientation as a function of time)
+and a Scene class that generates camera-to-feature observations (e.g.
+for 'SLAM' simulations). Scene observations are generated in batches
+into caller owned (reusable) buffers such that high rate generation
+does not require memory allocation once buffers reach working size.
+
+Example:
+\snippet test_simScene.cpp DoxyExample01
+
+*/
+
+
+#include "random.hpp"
+
+#include <Engabra>
+#include <Rigibra>
+
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <utility>
+#include <vector>
+
+
+namespace orinet
+{
+
+namespace sim
+{
+	using CamKey = std::size_t;
+	using FeaKey = std::size_t;
+
+	// use offset values to make visual distinction in diganostic output
+	constexpr FeaKey sFeaKey0{  900 };
+	constexpr CamKey sCamKey0{ 1000 };
+
+	//! Uniformly distributed index into (non-empty) container.
+	inline
+	std::size_t
+	randomIndexInto
+		( random::Context & ctx
+		, std::size_t const & size
+		)
+	{
+		if (! (0u < size))
+		{
+			std::cerr << "FATAL:"
+				" calling randomIndexInto with empty container" << std::endl;
+			exit(1);
+		}
+		std::uniform_int_distribution<std::size_t> dist(0u, size-1u);
+		return dist(ctx.generator());
+	}
+
+	//! \brief As randomIndexInto(ctx, ...) above (but NOT thread safe)
+	inline
+	std::size_t
+	randomIndexInto
+		( std::size_t const & size
+		)
+	{
+		if (! (0u < size))
+		{
+			std::cerr << "FATAL:"
+				" calling randomIndexInto with empty container" << std::endl;
+			exit(1);
+		}
+		static random::Context ctx(35364653u);
+		std::uniform_int_distribution<> dist(0u, size-1u);
+		return dist(ctx.generator());
+	}
+
+	//! Simulate distribution of random object space features
+	inline
+	std::map<FeaKey, rigibra::Transform>
+	expFeaXforms
+		( random::Context & ctx
+		, std::size_t const & numFea
+		, double const & pmDist = 10.
+		)
+	{
+		using rigibra::Transform;
+		std::map<FeaKey, Transform> expFeaXforms;
+
+		// simulate object feature body distribution
+		std::pair<double, double> const locMinMax{ -pmDist, pmDist };
+		constexpr std::pair<double, double> angMinMax{ -1., 1. };
+
+		// assign key values to each (arbitrarily)
+		FeaKey feaKey{ sFeaKey0 };
+		for (std::size_t nn{0u} ; nn < numFea ; ++nn)
+		{
+			expFeaXforms.emplace_hint
+				( expFeaXforms.end()
+				, feaKey++
+				, random::uniformTransform(ctx, locMinMax, angMinMax)
+				);
+		}
+
+		return expFeaXforms;
+	}
+
+	//! \brief As expFeaXforms(ctx, ...) above (but NOT thread safe)
+	inline
+	std::map<FeaKey, rigibra::Transform>
+	expFeaXforms
+		( std::size_t const & numFea
+		, double const & pmDist = 10.
+		)
+	{
+		using rigibra::Transform;
+		std::map<FeaKey, Transform> expFeaXforms;
+
+		// simulate object feature body distribution
+		constexpr std::size_t numMea{ 0u }; // no impact here
+		constexpr double locSigma{ 0. }; // no impact here
+		constexpr double angSigma{ 0. }; // no impact here
+		std::pair<double, double> locMinMax{ -pmDist, pmDist };
+		constexpr std::pair<double, double> angMinMax{ -1., 1. };
+
+		// generate a collection of feature orientations
+		std::vector<Transform> const feaXforms
+			{ random::noisyTransforms
+				( rigibra::identity<Transform>()
+				, numMea, numFea
+				, locSigma, angSigma // unused for 0 measurements
+				, locMinMax, angMinMax
+				)
+			};
+
+		// assign key values to each (arbitrarily)
+		FeaKey feaKey{ sFeaKey0 };
+		for (Transform const & feaXform : feaXforms)
+		{
+			expFeaXforms[feaKey] = feaXform;
+			++feaKey;
+		}
+
+		return expFeaXforms;
+	}
+
+	/*! \brief Produce orientations as a function of time.
+	 *
+	 * Provides orientations which are (pseudo)random perturbations of
+	 * a simple deterministic path.
+	 */
+	struct Trajectory
+	{
+		double const theSpeed{ 1./4. }; // [m/s]
+
+		inline
+		Trajectory
+			( double const & speed
+			)
+			: theSpeed(speed)
+		{ }
+
+		inline
+		virtual
+		~Trajectory
+			() = default;
+
+		//! Orientation at time tau for deterministic trajectory model.
+		inline
+		virtual
+		rigibra::Transform
+		pathOrientation
+			( double const & tau // [s]
+			) const = 0;
+
+		//! Orientation at time tau perturbed according to noise model.
+		inline
+		rigibra::Transform
+		perturbedOrientation
+			( random::Context & ctx
+			, double const & tau // [s]
+			, random::NoiseModel const & noise
+			) const
+		{
+			rigibra::Transform xPathWrtRef{ pathOrientation(tau) };
+
+			// determine if return value should be measurement or blunder
+			std::uniform_real_distribution<> dist(0., 1.);
+			bool const isBlunder{ (dist(ctx.generator()) < noise.theProbErr) };
+
+			// simulate appropriate type of transform
+			rigibra::Transform xBodyWrtPath;
+			using namespace orinet::random;
+			if (isBlunder)
+			{
+				xBodyWrtPath = uniformTransform
+					(ctx, noise.theLocMinMax, noise.theAngMinMax);
+			}
+			else
+			{
+				xBodyWrtPath = perturbedTransform
+					(ctx, xPathWrtRef, noise.theLocSigma, noise.theAngSigma);
+			}
+
+			return (xBodyWrtPath * xPathWrtRef);
+		}
+
+		//! \brief As perturbedOrientation(ctx, ...) (but NOT thread safe)
+		inline
+		rigibra::Transform
+		perturbedOrientation
+			( double const & tau // [s]
+			, random::NoiseModel const & noise
+			) const
+		{
+			rigibra::Transform xPathWrtRef{ pathOrientation(tau) };
+
+			// determine if return value should be measurement or blunder
+			static random::Context ctx(47686779u);
+			std::uniform_real_distribution<> dist(0., 1.);
+			bool const isBlunder{ (dist(ctx.generator()) < noise.theProbErr) };
+
+			// simulate appropriate type of transform
+			rigibra::Transform xBodyWrtPath;
+			using namespace orinet::random;
+			if (isBlunder)
+			{
+				xBodyWrtPath = uniformTransform
+					(noise.theLocMinMax, noise.theAngMinMax);
+			}
+			else
+			{
+				xBodyWrtPath = perturbedTransform
+					(xPathWrtRef, noise.theLocSigma, noise.theAngSigma);
+			}
+
+			return (xBodyWrtPath * xPathWrtRef);
+		}
+
+	}; // Trajectory
+
+	/*! \brief Trajectory with an underlying linear model
+	 */
+	struct TrajectoryLine : public Trajectory
+	{
+		engabra::g3::Vector const theDir0{ engabra::g3::e1 };
+		engabra::g3::Vector const theStart
+			{ engabra::g3::zero<engabra::g3::Vector>() };
+		rigibra::Attitude const theAtt0
+			{ rigibra::identity<rigibra::Attitude>() };
+
+		inline
+		TrajectoryLine
+			( double const & speed = 1./4.
+			)
+			: Trajectory(speed)
+		{ }
+
+		//! Orientation at time tau for deterministic trajectory model.
+		inline
+		virtual
+		rigibra::Transform
+		pathOrientation
+			( double const & tau // [s]
+			) const
+		{
+			using namespace engabra::g3;
+			Vector const loc{ theStart + theSpeed*tau*theDir0 };
+			using namespace rigibra;
+			return Transform{ loc, theAtt0 };
+		} 
+
+	}; // TrajectoryLine
+
+	/*! \brief Trajectory with an underlying circular model
+	 */
+	struct TrajectoryCircle : public Trajectory
+	{
+		double const theRadius{ engabra::g3::null<double> () };
+		engabra::g3::Vector const theCenter
+			{ engabra::g3::zero<engabra::g3::Vector>() };
+		engabra::g3::Vector const thePlaneDir1{ engabra::g3::e1 };
+		engabra::g3::Vector const thePlaneDir2{ engabra::g3::e2 };
+		rigibra::Attitude const theAtt0
+			{ rigibra::identity<rigibra::Attitude>() };
+
+		engabra::g3::BiVector const thePlaneDir{ engabra::g3::e12 };
+
+		inline
+		TrajectoryCircle
+			( double const & radius
+				= 1.
+			, engabra::g3::Vector const & center
+				= engabra::g3::zero<engabra::g3::Vector>()
+			, engabra::g3::Vector const & planeDir1
+				= engabra::g3::e1
+			, engabra::g3::Vector const & planeDir2
+				= engabra::g3::e2
+			, double const & speed
+				= 1./4.
+			)
+			: Trajectory(speed)
+			, theRadius{ radius }
+			, theCenter{ center }
+			, thePlaneDir1{ planeDir1 }
+			, thePlaneDir2{ planeDir2 }
+			, thePlaneDir
+				{ engabra::g3::direction((thePlaneDir1*thePlaneDir2).theBiv) }
+		{ }
+
+		//! Period for a complete rotation (in seconds).
+		inline
+		double
+		period
+			() const
+		{
+			return ((engabra::g3::turnFull * theRadius) / theSpeed);
+		}
+
+		//! Orientation at time tau for deterministic trajectory model.
+		inline
+		virtual
+		rigibra::Transform
+		pathOrientation
+			( double const & tau // [s]
+			) const
+		{
+			using namespace engabra::g3;
+			using namespace rigibra;
+
+			// rotate starting vector through angle depending on time
+			double const angSpeed{ theSpeed / theRadius };
+			PhysAngle const ang{ tau * angSpeed * thePlaneDir };
+			Attitude const att(ang);
+			Vector const loc{ att(thePlaneDir1) };
+
+			return Transform{loc, theAtt0};
+		}
+
+	}; // TrajectoryCircle
+
+
+	/*! \brief Simulate camera observing several (distinct) features.
+	 *
+	 * \note The features are selected by index into a temporary array
+	 * of expFeaXforms iterators (rather than stepping through the map
+	 * for each pick). For repeated high rate use, consider the Scene
+	 * class which avoids this setup effort and the result map.
+	 */
+	inline
+	std::map<std::pair<CamKey, FeaKey>, rigibra::Transform>
+	xformCamWrtFeas
+		( Trajectory const & trajCam
+		, double const & tau
+		, std::map<FeaKey, rigibra::Transform> const & expFeaXforms
+		, std::size_t const & numFeas
+		, random::NoiseModel const & noise = {}
+		, CamKey const & camKey = sCamKey0
+		)
+	{
+		using rigibra::Transform;
+		std::map<std::pair<CamKey, FeaKey>, Transform> mapCamFeaXforms;
+
+		// get camera position
+		Transform const xCamWrtRef{ trajCam.perturbedOrientation(tau, noise) };
+
+		// random access to features
+		using Iter = std::map<FeaKey, Transform>::const_iterator;
+		std::vector<Iter> itFeaXforms;
+		itFeaXforms.reserve(expFeaXforms.size());
+		for (Iter it{expFeaXforms.cbegin()} ; expFeaXforms.cend() != it ; ++it)
+		{
+			itFeaXforms.emplace_back(it);
+		}
+
+		// get relative transformations to several targets
+		std::size_t const numUse{ std::min(numFeas, expFeaXforms.size()) };
+		while (mapCamFeaXforms.size() < numUse)
+		{
+			// select a pseudo-random feature to be "observed" next
+			std::size_t const randNdx
+				{ randomIndexInto(itFeaXforms.size()) };
+			Iter const & itFeaXform = itFeaXforms[randNdx];
+			FeaKey const & feaKey = itFeaXform->first;
+			Transform const & xFeaWrtRef = itFeaXform->second;
+
+			Transform const xRefWrtFea{ inverse(xFeaWrtRef) };
+			Transform const xCamWrtFea{ xCamWrtRef * xRefWrtFea };
+			//
+			mapCamFeaXforms.emplace
+				( std::make_pair(camKey, feaKey)
+				, xCamWrtFea
+				);
+		}
+		return mapCamFeaXforms;
+	}
+
+
+	//! A single camera to feature observation
+	struct Observation
+	{
+		CamKey theCamKey{};
+		FeaKey theFeaKey{};
+		rigibra::Transform theXformCamWrtFea{};
+
+	}; // Observation
+
+	//! A single camera exposure (into a FrameBatch observation buffer).
+	struct Frame
+	{
+		CamKey theCamKey{};
+		double theTau{};
+
+		//! (Perturbed) camera orientation at time of exposure
+		rigibra::Transform theXformCamWrtRef{};
+
+		//! Range of FrameBatch::theObservations for this exposure
+		std::size_t theObsBeg{ 0u };
+		std::size_t theObsEnd{ 0u };
+
+		//! Number of features observed in this frame
+		inline
+		std::size_t
+		size  // Frame::
+			() const
+		{
+			return (theObsEnd - theObsBeg);
+		}
+
+	}; // Frame
+
+	/*! \brief Reusable buffers into which Scene generates frames.
+	 *
+	 * Use reserve() once (or let buffers grow during first use), then
+	 * clear() between batches. Capacity is retained so that subsequent
+	 * batches of similar size do not allocate memory.
+	 */
+	struct FrameBatch
+	{
+		std::vector<Frame> theFrames{};
+		std::vector<Observation> theObservations{};
+
+		//! Feature index permutation (workspace, identity between uses)
+		std::vector<std::size_t> theFeaNdxs{};
+
+		//! Feature indices selected for current frame (workspace)
+		std::vector<std::size_t> theSelNdxs{};
+
+		//! Allocate space for numFrames each with numObsPerFrame.
+		inline
+		void
+		reserve  // FrameBatch::
+			( std::size_t const & numFrames
+			, std::size_t const & numObsPerFrame
+			, std::size_t const & numFeas
+			)
+		{
+			theFrames.reserve(numFrames);
+			theObservations.reserve(numFrames * numObsPerFrame);
+			theFeaNdxs.reserve(numFeas);
+			theSelNdxs.reserve(numObsPerFrame);
+		}
+
+		//! Remove content (but retain capacity)
+		inline
+		void
+		clear  // FrameBatch::
+			()
+		{
+			theFrames.clear();
+			theObservations.clear();
+		}
+
+		//! Observation at start of frame
+		inline
+		std::vector<Observation>::const_iterator
+		begin  // FrameBatch::
+			( Frame const & frame
+			) const
+		{
+			return theObservations.cbegin() + frame.theObsBeg;
+		}
+
+		//! Observation (one past) end of frame
+		inline
+		std::vector<Observation>::const_iterator
+		end  // FrameBatch::
+			( Frame const & frame
+			) const
+		{
+			return theObservations.cbegin() + frame.theObsEnd;
+		}
+
+	}; // FrameBatch
+
+
+	/*! \brief Object space features observed by (several) moving cameras.
+	 *
+	 * Features are stored in arrays (with precomputed inverses) so
+	 * that selection of features for each frame is by partial
+	 * Fisher-Yates shuffle: O(1) per observed feature (independent
+	 * of the total number of features) and without repeats.
+	 *
+	 * Each camera follows its own trajectory. All cameras expose
+	 * concurrently (one frame each per time value).
+	 *
+	 * Observations within each frame are ordered by increasing
+	 * feature key (e.g. consistent with network::EdgeDir conventions
+	 * for feature pairs).
+	 */
+	class Scene
+	{
+		//! A camera (key) moving along a trajectory
+		struct Camera
+		{
+			CamKey theCamKey{};
+			std::shared_ptr<Trajectory const> theTrajectory{};
+		};
+
+		std::vector<FeaKey> theFeaKeys{};
+		std::vector<rigibra::Transform> theFeaWrtRefs{};
+		std::vector<rigibra::Transform> theRefWrtFeas{};
+		std::vector<Camera> theCameras{};
+
+	public:
+
+		//! Scene containing features (no cameras until addCamera())
+		inline
+		explicit
+		Scene  // Scene::
+			( std::map<FeaKey, rigibra::Transform> const & feaXforms
+			)
+		{
+			theFeaKeys.reserve(feaXforms.size());
+			theFeaWrtRefs.reserve(feaXforms.size());
+			theRefWrtFeas.reserve(feaXforms.size());
+			for (std::map<FeaKey, rigibra::Transform>::value_type
+				const & feaXform : feaXforms)
+			{
+				theFeaKeys.emplace_back(feaXform.first);
+				theFeaWrtRefs.emplace_back(feaXform.second);
+				theRefWrtFeas.emplace_back(inverse(feaXform.second));
+			}
+		}
+
+		//! Add camera moving along trajectory (exposes in each frame)
+		inline
+		void
+		addCamera  // Scene::
+			( CamKey const & camKey
+			, std::shared_ptr<Trajectory const> const & ptTrajectory
+			)
+		{
+			theCameras.emplace_back(Camera{ camKey, ptTrajectory });
+		}
+
+		//! Number of features
+		inline
+		std::size_t
+		sizeFeatures  // Scene::
+			() const
+		{
+			return theFeaKeys.size();
+		}
+
+		//! Number of cameras
+		inline
+		std::size_t
+		sizeCameras  // Scene::
+			() const
+		{
+			return theCameras.size();
+		}
+
+		//! Key for feature at (sorted order) index feaNdx
+		inline
+		FeaKey const &
+		featureKey  // Scene::
+			( std::size_t const & feaNdx
+			) const
+		{
+			return theFeaKeys[feaNdx];
+		}
+
+		//! Orientation of feature at index feaNdx
+		inline
+		rigibra::Transform const &
+		featureXform  // Scene::
+			( std::size_t const & feaNdx
+			) const
+		{
+			return theFeaWrtRefs[feaNdx];
+		}
+
+		/*! \brief Append one frame per camera for time tau to ptBatch.
+		 *
+		 * Each frame contains (up to) numFeas distinct features. Camera
+		 * orientations are perturbed per camNoise. Observations are
+		 * exact (relative to perturbed camera) - observation noise
+		 * may be added as needed by consumer (e.g. noisyTransform()).
+		 */
+		inline
+		void
+		appendFrames  // Scene::
+			( random::Context & ctx
+			, double const & tau
+			, std::size_t const & numFeas
+			, random::NoiseModel const & camNoise
+			, FrameBatch * const & ptBatch
+			) const
+		{
+			using rigibra::Transform;
+			std::size_t const numAll{ theFeaKeys.size() };
+			std::size_t const numUse{ std::min(numFeas, numAll) };
+
+			// identity permutation - restored after each selection
+			std::vector<std::size_t> & feaNdxs = ptBatch->theFeaNdxs;
+			if (! (numAll == feaNdxs.size()))
+			{
+				feaNdxs.resize(numAll);
+				std::iota(feaNdxs.begin(), feaNdxs.end(), 0u);
+			}
+			std::vector<std::size_t> & selNdxs = ptBatch->theSelNdxs;
+			selNdxs.resize(numUse);
+
+			std::vector<Observation> & obs = ptBatch->theObservations;
+			for (Camera const & camera : theCameras)
+			{
+				Transform const xCamWrtRef
+					{ camera.theTrajectory->perturbedOrientation
+						(ctx, tau, camNoise)
+					};
+
+				// partial Fisher-Yates: first numUse are the selection
+				for (std::size_t nn{0u} ; nn < numUse ; ++nn)
+				{
+					std::uniform_int_distribution<std::size_t>
+						dist(nn, numAll - 1u);
+					selNdxs[nn] = dist(ctx.generator());
+					std::swap(feaNdxs[nn], feaNdxs[selNdxs[nn]]);
+				}
+
+				// undo swaps (in reverse) while retrieving the selection
+				// (later swaps do not involve earlier positions)
+				for (std::size_t nn{numUse} ; 0u < nn ; --nn)
+				{
+					std::size_t const & swapNdx = selNdxs[nn - 1u];
+					std::size_t const feaNdx{ feaNdxs[nn - 1u] };
+					std::swap(feaNdxs[nn - 1u], feaNdxs[swapNdx]);
+					selNdxs[nn - 1u] = feaNdx;
+				}
+				std::sort(selNdxs.begin(), selNdxs.end());
+
+				std::size_t const obsBeg{ obs.size() };
+				for (std::size_t const & feaNdx : selNdxs)
+				{
+					obs.emplace_back
+						( Observation
+							{ .theCamKey = camera.theCamKey
+							, .theFeaKey = theFeaKeys[feaNdx]
+							, .theXformCamWrtFea
+								= xCamWrtRef * theRefWrtFeas[feaNdx]
+							}
+						);
+				}
+				ptBatch->theFrames.emplace_back
+					( Frame
+						{ .theCamKey = camera.theCamKey
+						, .theTau = tau
+						, .theXformCamWrtRef = xCamWrtRef
+						, .theObsBeg = obsBeg
+						, .theObsEnd = obs.size()
+						}
+					);
+			}
+		}
+
+		/*! \brief Replace ptBatch contents with frames for numTimes epochs.
+		 *
+		 * Epoch times are tauBeg + nn*tauDelta for nn in [0,numTimes).
+		 * Frames are ordered by time and then by camera (addCamera order).
+		 */
+		inline
+		void
+		fillFrames  // Scene::
+			( random::Context & ctx
+			, double const & tauBeg
+			, double const & tauDelta
+			, std::size_t const & numTimes
+			, std::size_t const & numFeas
+			, random::NoiseModel const & camNoise
+			, FrameBatch * const & ptBatch
+			) const
+		{
+			ptBatch->clear();
+			for (std::size_t nn{0u} ; nn < numTimes ; ++nn)
+			{
+				double const tau{ tauBeg + double(nn) * tauDelta };
+				appendFrames(ctx, tau, numFeas, camNoise, ptBatch);
+			}
+		}
+
+	}; // Scene
+
+} // [sim]
+
+} // [orinet]
+
+
+#endif // OriNet_simScene_INCL_
@@ -43,6 +43,13 @@ Example:
 
 #include <algorithm>
 #include <array>
+#include <cmath>
+#include <cstdint>
+#include <istream>
+#include <iterator>
+#include <limits>
+#include <ostream>
+#include <random>
 #include <vector>
 
 
@@ -60,6 +67,36 @@ namespace track
 	{
 		std::vector<double> theValues{};
 
+		//! Limit on data size for streams of unknown length (bytes)
+		static constexpr std::uint64_t sMaxStreamSize{ 1ull << 34u };
+
+		/*! \brief Number of bytes remaining in istrm.
+		 *
+		 * For streams that do not support positioning (e.g. pipes), the
+		 * result is sMaxStreamSize (as a sanity limit on data sizes).
+		 */
+		inline
+		static
+		std::uint64_t
+		remainingSize  // Values::
+			( std::istream & istrm
+			)
+		{
+			std::uint64_t size{ sMaxStreamSize };
+			std::istream::pos_type const posNow{ istrm.tellg() };
+			if (std::istream::pos_type(-1) != posNow)
+			{
+				istrm.seekg(0, std::ios::end);
+				std::istream::pos_type const posEnd{ istrm.tellg() };
+				istrm.seekg(posNow);
+				if ((std::istream::pos_type(-1) != posEnd) && istrm.good())
+				{
+					size = static_cast<std::uint64_t>(posEnd - posNow);
+				}
+			}
+			return size;
+		}
+
 	public:
 
 		/*! \brief Allocate space to hold all data values
@@ -103,6 +140,111 @@ namespace track
 			theValues.insert(itFind, value);
 		}
 
+		/*! \brief Incorporate many values (e.g. bulk load) at once.
+		 *
+		 * Same result as insert() for each value, but the new values
+		 * are sorted together and merged with existing ones (i.e.
+		 * O(N*log(N)) rather than O(N^2) for N values).
+		 */
+		template <typename FwdIter>
+		inline
+		void
+		insertMany
+			( FwdIter const & beg
+			, FwdIter const & end
+			)
+		{
+			std::size_t const numPrev{ theValues.size() };
+			theValues.insert(theValues.end(), beg, end);
+			std::vector<double>::iterator const itMid
+				{ theValues.begin() + numPrev };
+			std::sort(itMid, theValues.end());
+			std::inplace_merge(theValues.begin(), itMid, theValues.end());
+		}
+
+		/*! \brief Save collection (in binary form) to stream.
+		 *
+		 * Values are written in (native byte order) binary form such
+		 * that readFrom() restores them exactly.
+		 */
+		inline
+		void
+		writeTo
+			( std::ostream & ostrm
+			) const
+		{
+			std::uint64_t const numElem{ theValues.size() };
+			ostrm.write
+				(reinterpret_cast<char const *>(&numElem), sizeof(numElem));
+			ostrm.write
+				( reinterpret_cast<char const *>(theValues.data())
+				, static_cast<std::streamsize>(numElem * sizeof(double))
+				);
+		}
+
+		/*! \brief Replace collection with one saved by writeTo().
+		 *
+		 * The (saved) element count must fit in the rest of istrm,
+		 * otherwise (e.g. corrupt data) the result is false and this
+		 * instance is unchanged.
+		 */
+		inline
+		bool
+		readFrom
+			( std::istream & istrm
+			)
+		{
+			std::uint64_t numElem{ 0u };
+			istrm.read(reinterpret_cast<char *>(&numElem), sizeof(numElem));
+			// size from (possibly corrupt) data must fit in the stream
+			if (istrm.good()
+				&& (remainingSize(istrm) / sizeof(double) < numElem))
+			{
+				istrm.setstate(std::ios::failbit);
+			}
+			if (istrm.good())
+			{
+				theValues.resize(numElem);
+				istrm.read
+					( reinterpret_cast<char *>(theValues.data())
+					, static_cast<std::streamsize>(numElem * sizeof(double))
+					);
+			}
+			return istrm.good();
+		}
+
+		//! \brief True if (an instance of) value is in data collection.
+		inline
+		bool
+		contains
+			( double const & value
+			) const
+		{
+			return std::binary_search
+				(theValues.cbegin(), theValues.cend(), value);
+		}
+
+		/*! \brief Remove (one instance of) value from data collection.
+		 *
+		 * Returns true if value was present (and has been removed).
+		 */
+		inline
+		bool
+		erase
+			( double const & value
+			)
+		{
+			bool found{ false };
+			std::vector<double>::iterator const itFind
+				{ std::lower_bound(theValues.begin(), theValues.end(), value) };
+			if ((theValues.end() != itFind) && (value == *itFind))
+			{
+				theValues.erase(itFind);
+				found = true;
+			}
+			return found;
+		}
+
 		/*! \brief Median value of all inserted items.
 		 *
 		 * Returns engabra::g3::null<double>() if empty. Otherwise
@@ -176,6 +318,43 @@ namespace track
 			return prev;
 		}
 
+		/*! \brief Collection of values resampled (with replacement).
+		 *
+		 * The result has the same size() with each value drawn
+		 * independently and uniformly from the values here (e.g. a
+		 * bootstrap replicate for estimating the uncertainty of the
+		 * median()). The gen is a uniform random bit generator (e.g.
+		 * random::Context::generator()). Since values are held in
+		 * sorted order, the (sorted) result is formed from the draw
+		 * count for each value with O(size()) effort.
+		 */
+		template <typename Generator>
+		inline
+		Values
+		resampled
+			( Generator & gen
+			) const
+		{
+			std::size_t const numElem{ theValues.size() };
+			Values result(numElem);
+			if (0u < numElem)
+			{
+				std::vector<std::size_t> counts(numElem, 0u);
+				std::uniform_int_distribution<std::size_t> dist
+					(0u, numElem - 1u);
+				for (std::size_t nn{0u} ; nn < numElem ; ++nn)
+				{
+					++counts[dist(gen)];
+				}
+				for (std::size_t ndx{0u} ; ndx < numElem ; ++ndx)
+				{
+					result.theValues.insert
+						(result.theValues.end(), counts[ndx], theValues[ndx]);
+				}
+			}
+			return result;
+		}
+
 	}; // Values
 
 	//! Track running statistics for individual data values.
@@ -228,6 +407,90 @@ namespace track
 			theValues[2].insert(value[2]);
 		}
 
+		//! \brief Incorporate many values at once (ref Values::insertMany())
+		template <typename FwdIter>
+		inline
+		void
+		insertMany
+			( FwdIter const & beg
+			, FwdIter const & end
+			)
+		{
+			std::vector<double> comps;
+			comps.reserve(static_cast<std::size_t>(std::distance(beg, end)));
+			for (std::size_t kk{0u} ; kk < 3u ; ++kk)
+			{
+				comps.clear();
+				for (FwdIter iter{beg} ; end != iter ; ++iter)
+				{
+					engabra::g3::Vector const & value = *iter;
+					comps.emplace_back(value[kk]);
+				}
+				theValues[kk].insertMany(comps.cbegin(), comps.cend());
+			}
+		}
+
+		//! \brief Save collection to stream (ref Values::writeTo()).
+		inline
+		void
+		writeTo
+			( std::ostream & ostrm
+			) const
+		{
+			theValues[0].writeTo(ostrm);
+			theValues[1].writeTo(ostrm);
+			theValues[2].writeTo(ostrm);
+		}
+
+		//! \brief Replace collection (ref Values::readFrom()).
+		inline
+		bool
+		readFrom
+			( std::istream & istrm
+			)
+		{
+			return
+				(  theValues[0].readFrom(istrm)
+				&& theValues[1].readFrom(istrm)
+				&& theValues[2].readFrom(istrm)
+				);
+		}
+
+		//! \brief True if each component of value is in data collection.
+		inline
+		bool
+		contains
+			( engabra::g3::Vector const & value
+			) const
+		{
+			return
+				(  theValues[0].contains(value[0])
+				&& theValues[1].contains(value[1])
+				&& theValues[2].contains(value[2])
+				);
+		}
+
+		/*! \brief Remove (one instance of) value from data collection.
+		 *
+		 * Nothing is removed unless all components are present (such
+		 * that the component collections remain consistent).
+		 */
+		inline
+		bool
+		erase
+			( engabra::g3::Vector const & value
+			)
+		{
+			bool const found{ contains(value) };
+			if (found)
+			{
+				theValues[0].erase(value[0]);
+				theValues[1].erase(value[1]);
+				theValues[2].erase(value[2]);
+			}
+			return found;
+		}
+
 		/*! \brief Vector comprised of median of all coordinate values.
 		 *
 		 * Returns engabra::g3::null<Vector>() if empty. Otherwise
@@ -275,6 +538,27 @@ namespace track
 				};
 		}
 
+		/*! \brief Collection resampled (ref Values::resampled()).
+		 *
+		 * Each coordinate is resampled independently (the sorted
+		 * coordinate collections do not retain which values came
+		 * from the same vector).
+		 */
+		template <typename Generator>
+		inline
+		Vectors
+		resampled
+			( Generator & gen
+			) const
+		{
+			Vectors result(0u);
+			for (std::size_t ndx{0u} ; ndx < theValues.size() ; ++ndx)
+			{
+				result.theValues[ndx] = theValues[ndx].resampled(gen);
+			}
+			return result;
+		}
+
 	}; // Vectors
 
 	//! Track running statistics for individual Attitudes.
@@ -332,6 +616,98 @@ namespace track
 			theIntoVecs[1].insert(into1);
 		}
 
+		//! \brief Incorporate many values at once (ref Values::insertMany())
+		template <typename FwdIter>
+		inline
+		void
+		insertMany
+			( FwdIter const & beg
+			, FwdIter const & end
+			)
+		{
+			using namespace engabra::g3;
+			std::size_t const numElem
+				{ static_cast<std::size_t>(std::distance(beg, end)) };
+			std::vector<Vector> into0s;
+			std::vector<Vector> into1s;
+			into0s.reserve(numElem);
+			into1s.reserve(numElem);
+			for (FwdIter iter{beg} ; end != iter ; ++iter)
+			{
+				rigibra::Attitude const & value = *iter;
+				into0s.emplace_back(value(e1));
+				into1s.emplace_back(value(e2));
+			}
+			theIntoVecs[0].insertMany(into0s.cbegin(), into0s.cend());
+			theIntoVecs[1].insertMany(into1s.cbegin(), into1s.cend());
+		}
+
+		//! \brief Save collection to stream (ref Values::writeTo()).
+		inline
+		void
+		writeTo
+			( std::ostream & ostrm
+			) const
+		{
+			theIntoVecs[0].writeTo(ostrm);
+			theIntoVecs[1].writeTo(ostrm);
+		}
+
+		//! \brief Replace collection (ref Values::readFrom()).
+		inline
+		bool
+		readFrom
+			( std::istream & istrm
+			)
+		{
+			return
+				(  theIntoVecs[0].readFrom(istrm)
+				&& theIntoVecs[1].readFrom(istrm)
+				);
+		}
+
+		//! \brief True if attitude information is in data collection.
+		inline
+		bool
+		contains
+			( rigibra::Attitude const & value
+			) const
+		{
+			using namespace engabra::g3;
+			return
+				(  theIntoVecs[0].contains(value(e1))
+				&& theIntoVecs[1].contains(value(e2))
+				);
+		}
+
+		/*! \brief Remove attitude information from data collection.
+		 *
+		 * The value should be one that was previously inserted. The
+		 * transformed basis vectors are recomputed in the same way as
+		 * for insert() and removed from the individual trackers. Nothing
+		 * is removed unless both are present.
+		 */
+		inline
+		bool
+		erase
+			( rigibra::Attitude const & value
+			)
+		{
+			using namespace engabra::g3;
+			Vector const into0{ value(e1) };
+			Vector const into1{ value(e2) };
+			bool const found
+				{ theIntoVecs[0].contains(into0)
+				&& theIntoVecs[1].contains(into1)
+				};
+			if (found)
+			{
+				theIntoVecs[0].erase(into0);
+				theIntoVecs[1].erase(into1);
+			}
+			return found;
+		}
+
 		//! Attitude that 'best' transforms {e1,e2} to into_{e1,e2} pair.
 		inline
 		static
@@ -392,6 +768,20 @@ namespace track
 			return attitudeFrom_e1e2(intoA, intoB);
 		}
 
+		//! \brief Collection resampled (ref Vectors::resampled()).
+		template <typename Generator>
+		inline
+		Attitudes
+		resampled
+			( Generator & gen
+			) const
+		{
+			Attitudes result(0u);
+			result.theIntoVecs[0] = theIntoVecs[0].resampled(gen);
+			result.theIntoVecs[1] = theIntoVecs[1].resampled(gen);
+			return result;
+		}
+
 	}; // Attitudes
 
 	//! Track running statistics for individual Transforms.
@@ -445,6 +835,79 @@ namespace track
 			theAtts.insert(value.theAtt);
 		}
 
+		/*! \brief Incorporate many transforms at once (e.g. bulk load).
+		 *
+		 * Same result as insert() for each value (ref
+		 * Values::insertMany()).
+		 */
+		template <typename FwdIter>
+		inline
+		void
+		insertMany
+			( FwdIter const & beg
+			, FwdIter const & end
+			)
+		{
+			std::size_t const numElem
+				{ static_cast<std::size_t>(std::distance(beg, end)) };
+			std::vector<engabra::g3::Vector> locs;
+			std::vector<rigibra::Attitude> atts;
+			locs.reserve(numElem);
+			atts.reserve(numElem);
+			for (FwdIter iter{beg} ; end != iter ; ++iter)
+			{
+				rigibra::Transform const & value = *iter;
+				locs.emplace_back(value.theLoc);
+				atts.emplace_back(value.theAtt);
+			}
+			theLocs.insertMany(locs.cbegin(), locs.cend());
+			theAtts.insertMany(atts.cbegin(), atts.cend());
+		}
+
+		//! \brief Save collection to stream (ref Values::writeTo()).
+		inline
+		void
+		writeTo
+			( std::ostream & ostrm
+			) const
+		{
+			theLocs.writeTo(ostrm);
+			theAtts.writeTo(ostrm);
+		}
+
+		//! \brief Replace collection (ref Values::readFrom()).
+		inline
+		bool
+		readFrom
+			( std::istream & istrm
+			)
+		{
+			return (theLocs.readFrom(istrm) && theAtts.readFrom(istrm));
+		}
+
+		/*! \brief Remove (previously inserted) transform from collection.
+		 *
+		 * Nothing is removed unless both location and attitude
+		 * information are present.
+		 */
+		inline
+		bool
+		erase
+			( rigibra::Transform const & value
+			)
+		{
+			bool const found
+				{ theLocs.contains(value.theLoc)
+				&& theAtts.contains(value.theAtt)
+				};
+			if (found)
+			{
+				theLocs.erase(value.theLoc);
+				theAtts.erase(value.theAtt);
+			}
+			return found;
+		}
+
 		/*! \brief Vector comprised of median of all coordinate values.
 		 *
 		 * Returns engabra::g3::null<Vector>() if empty. Otherwise
@@ -526,11 +989,221 @@ namespace track
 			return err;
 		}
 
+		/*! \brief Collection resampled (ref Vectors::resampled()).
+		 *
+		 * The median() and medianErrorEstimate() of the result provide
+		 * one bootstrap replicate of the estimates from this instance.
+		 * Since each component is resampled independently, this is a
+		 * marginal bootstrap (where whole observations are available,
+		 * resample those instead - e.g. insertMany() of the draws).
+		 */
+		template <typename Generator>
+		inline
+		Transforms
+		resampled
+			( Generator & gen
+			) const
+		{
+			Transforms result(0u);
+			result.theLocs = theLocs.resampled(gen);
+			result.theAtts = theAtts.resampled(gen);
+			return result;
+		}
+
 	}; // Transforms
 
 
+	/*! \brief Policy for discarding stale (time stamped) observations.
+	 *
+	 * The relevance of an observation is modeled as a weight that decays
+	 * exponentially with age, i.e. as exp(-age/theDecayTime). Observations
+	 * for which the weight drops below theMinWeight are considered stale.
+	 * Independent of age, only the most recent theMaxSize observations
+	 * are retained.
+	 *
+	 * The default values never discard anything.
+	 */
+	struct Forgetting
+	{
+		//! Time constant for exponential decay of observation weights.
+		double theDecayTime{ std::numeric_limits<double>::infinity() };
+
+		//! Observations with less weight than this are discarded
+		double theMinWeight{ 1./16. };
+
+		//! Maximum number of (most recent) observations to retain
+		std::size_t theMaxSize{ std::numeric_limits<std::size_t>::max() };
+
+		//! Relative weight for observation of given age (time units)
+		inline
+		double
+		weight
+			( double const & age
+			) const
+		{
+			return std::exp(-age / theDecayTime);
+		}
+
+		//! Age (time units) beyond which an observation is stale.
+		inline
+		double
+		maxAge
+			() const
+		{
+			return (-theDecayTime * std::log(theMinWeight));
+		}
+
+		//! True if observation with this age should be discarded.
+		inline
+		bool
+		isStale
+			( double const & age
+			) const
+		{
+			return (maxAge() < age);
+		}
+
+	}; // Forgetting
+
+
 } // [track]
 
+
+	/*! \brief Mergeable summary statistics (count, mean, variance, min/max).
+	 *
+	 * Values are accumulated with Welford's running update and need
+	 * not be stored. Instances accumulated separately (e.g. in different
+	 * threads) are combined with merge() (Chan et al. pairwise update).
+	 */
+	class Summary
+	{
+		std::size_t theCount{ 0u };
+		double theMean{ 0. };
+		double theSumSqDev{ 0. };
+		double theMin{ std::numeric_limits<double>::infinity() };
+		double theMax{ -std::numeric_limits<double>::infinity() };
+
+	public:
+
+		//! Incorporate value into statistics
+		inline
+		void
+		add  // Summary::
+			( double const & value
+			)
+		{
+			++theCount;
+			double const delta{ value - theMean };
+			theMean += delta / static_cast<double>(theCount);
+			theSumSqDev += delta * (value - theMean);
+			theMin = std::min(theMin, value);
+			theMax = std::max(theMax, value);
+		}
+
+		//! Incorporate statistics accumulated by another instance
+		inline
+		void
+		merge  // Summary::
+			( Summary const & other
+			)
+		{
+			if (0u == theCount)
+			{
+				*this = other;
+			}
+			else
+			if (0u < other.theCount)
+			{
+				double const numA{ static_cast<double>(theCount) };
+				double const numB{ static_cast<double>(other.theCount) };
+				double const numAB{ numA + numB };
+				double const delta{ other.theMean - theMean };
+				theMean += delta * (numB / numAB);
+				theSumSqDev += other.theSumSqDev
+					+ delta * delta * (numA * numB / numAB);
+				theCount += other.theCount;
+				theMin = std::min(theMin, other.theMin);
+				theMax = std::max(theMax, other.theMax);
+			}
+		}
+
+		//! Number of values incorporated
+		inline
+		std::size_t
+		count  // Summary::
+			() const
+		{
+			return theCount;
+		}
+
+		//! Average of values (null if none)
+		inline
+		double
+		mean  // Summary::
+			() const
+		{
+			double ave{ engabra::g3::null<double>() };
+			if (0u < theCount)
+			{
+				ave = theMean;
+			}
+			return ave;
+		}
+
+		//! Sample variance (null unless at least two values)
+		inline
+		double
+		variance  // Summary::
+			() const
+		{
+			double var{ engabra::g3::null<double>() };
+			if (1u < theCount)
+			{
+				var = theSumSqDev / static_cast<double>(theCount - 1u);
+			}
+			return var;
+		}
+
+		//! Sample standard deviation (null unless at least two values)
+		inline
+		double
+		deviation  // Summary::
+			() const
+		{
+			return std::sqrt(variance());
+		}
+
+		//! Smallest value (null if none)
+		inline
+		double
+		min  // Summary::
+			() const
+		{
+			double value{ engabra::g3::null<double>() };
+			if (0u < theCount)
+			{
+				value = theMin;
+			}
+			return value;
+		}
+
+		//! Largest value (null if none)
+		inline
+		double
+		max  // Summary::
+			() const
+		{
+			double value{ engabra::g3::null<double>() };
+			if (0u < theCount)
+			{
+				value = theMax;
+			}
+			return value;
+		}
+
+	}; // Summary
+
+
 } // [stat]
 
 } // [orinet]
@@ -0,0 +1,375 @@
+//
+// MIT License
+//
+// Copyright (c) 2024 Stellacore Corporation
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+
+#ifndef OriNet_trace_INCL_
+#define OriNet_trace_INCL_
+
+/*! \file
+\brief Recording of timed spans (trace events) for processing stages.
+
+Instrumented code marks a stage with the OriNet_TRACE_SPAN(name) macro
+(or OriNet_TRACE_SPAN_ARG(name, value)) which records a "complete"
+event (name, start time, duration and thread) for the enclosing scope.
+
+Instrumentation is compiled in only if the macro OriNet_TRACE is
+defined (e.g. by configuring CMake with -DOriNet_TRACE=ON). Otherwise,
+the macros expand to nothing and there is no run-time cost.
+
+Events are appended to a buffer owned by the recording thread (no locks
+after the first event in each thread). The buffer initially has space
+for sInitEventsPerThread events and grows (with occasional allocation)
+up to sMaxEventsPerThread after which events are dropped. The events from
+all threads can be saved as Chrome trace-event JSON, e.g. for viewing
+with chrome://tracing or https://ui.perfetto.dev, by writeChromeJson().
+
+Example:
+\snippet test_trace.cpp DoxyExample01
+
+*/
+
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+
+namespace orinet
+{
+
+/*! \brief Trace-event recording (timeline of processing stages).
+ */
+namespace trace
+{
+	//! Number of events for which space is allocated with each buffer
+	constexpr std::size_t sInitEventsPerThread{ 4096u };
+
+	//! Maximum number of events retained per thread (later ones dropped)
+	constexpr std::size_t sMaxEventsPerThread{ 1024u * 1024u };
+
+	//! A timed span of processing (Chrome trace "complete" event)
+	struct Event
+	{
+		//! Name of stage (static storage, e.g. string literal)
+		char const * theName{ nullptr };
+
+		//! Start time since trace epoch
+		std::uint64_t theBegNs{ 0u };
+
+		//! Duration of span
+		std::uint64_t theDurNs{ 0u };
+
+		//! Optional value (e.g. problem size), reported if hasArg
+		std::uint64_t theArg{ 0u };
+		bool theHasArg{ false };
+
+	}; // Event
+
+	//! Events recorded by one thread
+	struct ThreadBuffer
+	{
+		//! Sequential id (in order of first event in thread)
+		std::size_t theTid{ 0u };
+
+		//! Recorded events (capacity allocated with first event)
+		std::vector<Event> theEvents{};
+
+		//! Number of events not recorded (buffer full)
+		std::size_t theNumDropped{ 0u };
+
+	}; // ThreadBuffer
+
+	//! Collection of all thread buffers (for internal use)
+	class Registry
+	{
+		std::mutex theMutex{};
+		std::vector<std::shared_ptr<ThreadBuffer> > theBuffers{};
+		std::chrono::steady_clock::time_point const theEpoch
+			{ std::chrono::steady_clock::now() };
+
+	public:
+
+		//! Process wide instance
+		inline
+		static
+		Registry &
+		instance
+			()
+		{
+			static Registry registry{};
+			return registry;
+		}
+
+		//! Time since trace epoch (start of process tracing)
+		inline
+		std::uint64_t
+		nowNs  // Registry::
+			() const
+		{
+			return static_cast<std::uint64_t>
+				( std::chrono::duration_cast<std::chrono::nanoseconds>
+					(std::chrono::steady_clock::now() - theEpoch).count()
+				);
+		}
+
+		//! New buffer for calling thread (retained after thread exits)
+		inline
+		std::shared_ptr<ThreadBuffer>
+		newBuffer  // Registry::
+			()
+		{
+			std::shared_ptr<ThreadBuffer> const ptBuffer
+				{ std::make_shared<ThreadBuffer>() };
+			ptBuffer->theEvents.reserve(sInitEventsPerThread);
+			std::lock_guard<std::mutex> const lock(theMutex);
+			ptBuffer->theTid = theBuffers.size();
+			theBuffers.emplace_back(ptBuffer);
+			return ptBuffer;
+		}
+
+		//! Buffers from all threads (which should not be recording now)
+		inline
+		std::vector<std::shared_ptr<ThreadBuffer> >
+		buffers  // Registry::
+			()
+		{
+			std::lock_guard<std::mutex> const lock(theMutex);
+			return theBuffers;
+		}
+
+	}; // Registry
+
+	//! Buffer for calling thread (created on first use)
+	inline
+	ThreadBuffer &
+	threadBuffer
+		()
+	{
+		thread_local std::shared_ptr<ThreadBuffer> const tPtBuffer
+			{ Registry::instance().newBuffer() };
+		return *tPtBuffer;
+	}
+
+	//! Append event to calling thread buffer
+	inline
+	void
+	record
+		( Event const & event
+		)
+	{
+		ThreadBuffer & buffer = threadBuffer();
+		if (buffer.theEvents.size() < sMaxEventsPerThread)
+		{
+			buffer.theEvents.emplace_back(event);
+		}
+		else
+		{
+			++buffer.theNumDropped;
+		}
+	}
+
+	/*! \brief Record an event spanning the lifetime of this instance.
+	 *
+	 * Generally used via OriNet_TRACE_SPAN() macros (so that it is
+	 * compiled only if OriNet_TRACE is defined).
+	 */
+	class Span
+	{
+		Event theEvent{};
+
+	public:
+
+		//! Start span for (static storage) name
+		inline
+		explicit
+		Span
+			( char const * const & name
+			)
+			: theEvent
+				{ .theName = name
+				, .theBegNs = Registry::instance().nowNs()
+				}
+		{ }
+
+		//! Start span for name with an associated value (e.g. a size)
+		inline
+		explicit
+		Span
+			( char const * const & name
+			, std::uint64_t const & arg
+			)
+			: theEvent
+				{ .theName = name
+				, .theBegNs = Registry::instance().nowNs()
+				, .theArg = arg
+				, .theHasArg = true
+				}
+		{ }
+
+		//! Record the event
+		inline
+		~Span
+			()
+		{
+			std::uint64_t const endNs{ Registry::instance().nowNs() };
+			theEvent.theDurNs = endNs - theEvent.theBegNs;
+			record(theEvent);
+		}
+
+		Span(Span const &) = delete;
+		Span & operator=(Span const &) = delete;
+
+	}; // Span
+
+	//! Number of events recorded (by all threads)
+	inline
+	std::size_t
+	numEvents
+		()
+	{
+		std::size_t count{ 0u };
+		for (std::shared_ptr<ThreadBuffer> const & ptBuffer
+			: Registry::instance().buffers())
+		{
+			count += ptBuffer->theEvents.size();
+		}
+		return count;
+	}
+
+	/*! \brief Remove all recorded events.
+	 *
+	 * \note Other threads must not be recording during this call.
+	 */
+	inline
+	void
+	clear
+		()
+	{
+		for (std::shared_ptr<ThreadBuffer> const & ptBuffer
+			: Registry::instance().buffers())
+		{
+			ptBuffer->theEvents.clear();
+			ptBuffer->theNumDropped = 0u;
+		}
+	}
+
+	/*! \brief Put all events to stream as Chrome trace-event JSON.
+	 *
+	 * \note Other threads must not be recording during this call
+	 * (e.g. call after parallel processing has been joined).
+	 */
+	inline
+	void
+	writeChromeJson
+		( std::ostream & ostrm
+		)
+	{
+		ostrm << "{\"displayTimeUnit\": \"ns\", \"traceEvents\": [";
+		std::string sep{ "\n" };
+		ostrm << std::fixed << std::setprecision(3);
+		for (std::shared_ptr<ThreadBuffer> const & ptBuffer
+			: Registry::instance().buffers())
+		{
+			ThreadBuffer const & buffer = *ptBuffer;
+			// thread identification (metadata event)
+			ostrm << sep
+				<< "{\"name\": \"thread_name\", \"ph\": \"M\""
+				<< ", \"pid\": 1, \"tid\": " << buffer.theTid
+				<< ", \"args\": {\"name\": \"thread " << buffer.theTid
+				<< "\"}}";
+			sep = ",\n";
+			for (Event const & event : buffer.theEvents)
+			{
+				// (times are in microseconds)
+				ostrm << sep
+					<< "{\"name\": \"" << event.theName << '"'
+					<< ", \"cat\": \"OriNet\", \"ph\": \"X\""
+					<< ", \"ts\": " << (1.e-3 * double(event.theBegNs))
+					<< ", \"dur\": " << (1.e-3 * double(event.theDurNs))
+					<< ", \"pid\": 1, \"tid\": " << buffer.theTid;
+				if (event.theHasArg)
+				{
+					ostrm << ", \"args\": {\"n\": " << event.theArg << '}';
+				}
+				ostrm << '}';
+			}
+			if (0u < buffer.theNumDropped)
+			{
+				std::cerr << "Warning: trace: thread " << buffer.theTid
+					<< " dropped " << buffer.theNumDropped << " events\n";
+			}
+		}
+		ostrm << "\n]}\n";
+	}
+
+	//! Save writeChromeJson() output to path (false on error)
+	inline
+	bool
+	saveChromeJson
+		( std::string const & path
+		)
+	{
+		std::ofstream ofs(path);
+		writeChromeJson(ofs);
+		return ofs.good();
+	}
+
+} // [trace]
+
+} // [orinet]
+
+
+//! Concatenation of tokens (after expansion)
+#define OriNet_TRACE_CAT_(aa, bb) aa ## bb
+#define OriNet_TRACE_CAT(aa, bb) OriNet_TRACE_CAT_(aa, bb)
+
+#if defined(OriNet_TRACE)
+
+	//! Record a trace span (for enclosing scope) with given name.
+#	define OriNet_TRACE_SPAN(name) \
+		orinet::trace::Span const OriNet_TRACE_CAT(traceSpan_, __LINE__) \
+			{ name }
+
+	//! Record a trace span with an associated (integer) value.
+#	define OriNet_TRACE_SPAN_ARG(name, arg) \
+		orinet::trace::Span const OriNet_TRACE_CAT(traceSpan_, __LINE__) \
+			{ name, static_cast<std::uint64_t>(arg) }
+
+#else
+
+	// tracing not compiled in
+#	define OriNet_TRACE_SPAN(name)
+#	define OriNet_TRACE_SPAN_ARG(name, arg)
+
+#endif
+
+
+#endif // OriNet_trace_INCL_
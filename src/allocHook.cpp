@@ -0,0 +1,166 @@
+//
+// MIT License
+//
+// Copyright (c) 2024 Stellacore Corporation
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+
+/*! \file
+\brief Replacement global allocation functions that count allocations.
+
+This file is the OriNet::AllocHook support library (and is NOT part of
+the main OriNet library). Linking it into a program replaces the global
+operator new/delete functions with versions that update the counters
+in OriNet/alloc.hpp. Replacements are provided for the scalar and the
+aligned forms. The array and nothrow forms (by default) call these.
+
+*/
+
+
+#include "OriNet/alloc.hpp"
+
+#include <cstdlib>
+#include <new>
+
+
+namespace
+{
+	//! Activate counting (at static initialization)
+	struct TrackingOn
+	{
+		TrackingOn
+			()
+		{
+			orinet::alloc::detail::sIsTracking = true;
+		}
+	};
+
+	TrackingOn const sTrackingOn{};
+
+	//! Memory from malloc (or std::bad_alloc if not available)
+	inline
+	void *
+	countedAlloc
+		( std::size_t const & size
+		)
+	{
+		orinet::alloc::detail::noteAlloc(size);
+		void * const ptr{ std::malloc((0u < size) ? size : 1u) };
+		if (! ptr)
+		{
+			throw std::bad_alloc{};
+		}
+		return ptr;
+	}
+
+	//! Memory from aligned_alloc (or std::bad_alloc if not available)
+	inline
+	void *
+	countedAlignedAlloc
+		( std::size_t const & size
+		, std::align_val_t const & align
+		)
+	{
+		orinet::alloc::detail::noteAlloc(size);
+		// aligned_alloc requires size to be a multiple of alignment
+		std::size_t const alignSize{ static_cast<std::size_t>(align) };
+		std::size_t const useSize
+			{ ((size + alignSize - 1u) / alignSize) * alignSize };
+		void * const ptr
+			{ std::aligned_alloc
+				(alignSize, (0u < useSize) ? useSize : alignSize)
+			};
+		if (! ptr)
+		{
+			throw std::bad_alloc{};
+		}
+		return ptr;
+	}
+
+	//! Return memory from either of the functions above
+	inline
+	void
+	countedFree
+		( void * const & ptr
+		) noexcept
+	{
+		if (ptr)
+		{
+			orinet::alloc::detail::noteFree();
+			std::free(ptr);
+		}
+	}
+
+} // [anon]
+
+
+void *
+operator new
+	( std::size_t size
+	)
+{
+	return countedAlloc(size);
+}
+
+void *
+operator new
+	( std::size_t size
+	, std::align_val_t align
+	)
+{
+	return countedAlignedAlloc(size, align);
+}
+
+void
+operator delete
+	( void * ptr
+	) noexcept
+{
+	countedFree(ptr);
+}
+
+void
+operator delete
+	( void * ptr
+	, std::size_t // size
+	) noexcept
+{
+	countedFree(ptr);
+}
+
+void
+operator delete
+	( void * ptr
+	, std::align_val_t // align
+	) noexcept
+{
+	countedFree(ptr);
+}
+
+void
+operator delete
+	( void * ptr
+	, std::size_t // size
+	, std::align_val_t // align
+	) noexcept
+{
+	countedFree(ptr);
+}
@@ -34,7 +34,9 @@ Example:
 #include "OriNet/networkGeometry.hpp"
 
 #include "OriNet/compare.hpp"
+#include "OriNet/parallel.hpp"
 #include "OriNet/robust.hpp"
+#include "OriNet/trace.hpp"
 
 #include <Engabra>
 #include <graaflib/algorithm/graph_traversal/breadth_first_search.h>
@@ -44,11 +46,17 @@ Example:
 #include <Rigibra>
 
 #include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
 #include <filesystem>
 #include <iomanip>
+#include <limits>
 #include <map>
+#include <span>
 #include <sstream>
 #include <string>
+#include <unordered_set>
 #include <utility>
 #include <vector>
 
@@ -93,6 +101,89 @@ namespace network
 		return lbl.str();
 	}
 
+	//! Interleave bits (lowest 21) of each value (3D Morton code)
+	inline
+	std::uint64_t
+	mortonCode
+		( std::array<std::uint64_t, 3u> const & cells
+		)
+	{
+		std::uint64_t code{ 0u };
+		for (std::size_t bit{0u} ; bit < 21u ; ++bit)
+		{
+			for (std::size_t kk{0u} ; kk < 3u ; ++kk)
+			{
+				std::uint64_t const bitVal{ (cells[kk] >> bit) & 1u };
+				code |= (bitVal << (3u * bit + kk));
+			}
+		}
+		return code;
+	}
+
+std::vector<StaKey>
+spaceFillingOrder
+	( std::map<StaKey, rigibra::Transform> const & staXforms
+	)
+{
+	using engabra::g3::Vector;
+
+	// bounding box of (valid) station locations
+	std::array<double, 3u> mins;
+	std::array<double, 3u> maxs;
+	mins.fill(std::numeric_limits<double>::max());
+	maxs.fill(std::numeric_limits<double>::lowest());
+	for (std::map<StaKey, rigibra::Transform>::value_type const & staXform
+		: staXforms)
+	{
+		Vector const & loc = staXform.second.theLoc;
+		for (std::size_t kk{0u} ; kk < 3u ; ++kk)
+		{
+			if (std::isfinite(loc[kk]))
+			{
+				mins[kk] = std::min(mins[kk], loc[kk]);
+				maxs[kk] = std::max(maxs[kk], loc[kk]);
+			}
+		}
+	}
+
+	// quantize into (2^21)^3 cubical cells and sort by Morton code
+	double range{ 0. };
+	for (std::size_t kk{0u} ; kk < 3u ; ++kk)
+	{
+		if (mins[kk] < maxs[kk])
+		{
+			range = std::max(range, maxs[kk] - mins[kk]);
+		}
+	}
+	constexpr double maxCell{ double((1u << 21u) - 1u) };
+	std::vector<std::pair<std::uint64_t, StaKey> > codeKeys;
+	codeKeys.reserve(staXforms.size());
+	for (std::map<StaKey, rigibra::Transform>::value_type const & staXform
+		: staXforms)
+	{
+		Vector const & loc = staXform.second.theLoc;
+		std::array<std::uint64_t, 3u> cells{ 0u, 0u, 0u };
+		for (std::size_t kk{0u} ; kk < 3u ; ++kk)
+		{
+			if (std::isfinite(loc[kk]) && (0. < range))
+			{
+				double const frac{ (loc[kk] - mins[kk]) / range };
+				cells[kk] = static_cast<std::uint64_t>(frac * maxCell);
+			}
+		}
+		codeKeys.emplace_back(mortonCode(cells), staXform.first);
+	}
+	std::sort(codeKeys.begin(), codeKeys.end());
+
+	std::vector<StaKey> staKeys;
+	staKeys.reserve(codeKeys.size());
+	for (std::pair<std::uint64_t, StaKey> const & codeKey : codeKeys)
+	{
+		staKeys.emplace_back(codeKey.second);
+	}
+	return staKeys;
+}
+
 
 bool
 Geometry :: hasStaKey
@@ -112,6 +203,38 @@ Geometry :: ensureStaFrameExists
 		StaFrame const staFrame{ staKey };
 		VertId const vId{ theGraph.add_vertex(staFrame) };
 		theVertIdFromStaKey[staKey] = vId;
+		if (theTracksChanges)
+		{
+			theChanges.theStaKeys.emplace_back(staKey);
+		}
+	}
+}
+
+void
+Geometry :: reestimateEdges
+	() const
+{
+	using GType = graaf::undirected_graph<StaFrame, std::shared_ptr<EdgeBase> >;
+	for (GType::edge_id_to_edge_t::value_type const & eType
+		: theGraph.get_edges())
+	{
+		std::shared_ptr<EdgeRobust> const ptRobust
+			{ std::dynamic_pointer_cast<EdgeRobust>(eType.second) };
+		if (ptRobust)
+		{
+			ptRobust->reestimate();
+		}
+	}
+}
+
+void
+Geometry :: insertStations
+	( std::vector<StaKey> const & staKeys
+	)
+{
+	for (StaKey const & staKey : staKeys)
+	{
+		ensureStaFrameExists(staKey);
 	}
 }
 
@@ -234,8 +357,102 @@ Geometry::Propagator :: operator()
 	}
 
 	// compute ending propagated transform
-	Transform xIntoWrtRef{ xIntoWrtFrom * xFromWrtRef };
+	Transform xIntoWrtRef{ null<Transform>() };
+	if (fromKey == thePrevFromKey)
+	{
+		// Traversal visits all edges from a station in sequence. For
+		// these, the (from) attitude is applied to each edge offset
+		// and an applied form saves the repeated sandwich products.
+		if (! applied::isValid(thePrevFromApplied))
+		{
+			thePrevFromApplied = applied::Xform(xFromWrtRef);
+		}
+		// same as (xIntoWrtFrom * xFromWrtRef)
+		xIntoWrtRef = Transform
+			{ xFromWrtRef.theLoc
+				+ thePrevFromApplied.rotatedInverse(xIntoWrtFrom.theLoc)
+			, xIntoWrtFrom.theAtt * xFromWrtRef.theAtt
+			};
+	}
+	else
+	{
+		thePrevFromKey = fromKey;
+		thePrevFromApplied = applied::Xform{};
+		xIntoWrtRef = xIntoWrtFrom * xFromWrtRef;
+	}
 	(*thePtStaXforms)[intoKey] = xIntoWrtRef;
+
+	// path information (if requested) - from vertex is already present
+	if (thePtMetrics)
+	{
+		VertId const & vIdFrom = eId.first;
+		VertId const & vIdInto = eId.second;
+		if (! (vIdInto < theMetricNdxs.size()))
+		{
+			theMetricNdxs.resize(vIdInto + 1u, PathMetrics::sNullNdx);
+		}
+		theMetricNdxs[vIdInto] = thePtMetrics->appendChild
+			(intoKey, theMetricNdxs[vIdFrom], ptUseEdge->get_weight());
+	}
+}
+
+std::vector<VertId>
+Geometry :: traversalVertIds
+	( std::vector<VertId> const & startVIds
+	, std::vector<std::size_t> const * const & ptDegrees
+	) const
+{
+	// vertex ids are sequential (from add_vertex())
+	std::size_t const numVerts{ theGraph.vertex_count() };
+	std::vector<VertId> order;
+	order.reserve(numVerts);
+	std::vector<char> seens(numVerts, 0);
+
+	// neighbor visit order (by degree if provided, then by id)
+	auto const visitsBefore
+		{ [&ptDegrees] (VertId const & vIdA, VertId const & vIdB)
+			{
+				bool isBefore{ vIdA < vIdB };
+				if (ptDegrees)
+				{
+					std::vector<std::size_t> const & degrees = *ptDegrees;
+					isBefore = (degrees[vIdA] < degrees[vIdB])
+						|| ((degrees[vIdA] == degrees[vIdB]) && (vIdA < vIdB));
+				}
+				return isBefore;
+			}
+		};
+
+	std::vector<VertId> nbors;
+	for (VertId const & startVId : startVIds)
+	{
+		if ((startVId < numVerts) && (! seens[startVId]))
+		{
+			// breadth first (order itself is used as the queue)
+			std::size_t nextNdx{ order.size() };
+			seens[startVId] = 1;
+			order.emplace_back(startVId);
+			while (nextNdx < order.size())
+			{
+				VertId const currVId{ order[nextNdx++] };
+				nbors.clear();
+				for (VertId const & nborVId : theGraph.get_neighbors(currVId))
+				{
+					if (! seens[nborVId])
+					{
+						nbors.emplace_back(nborVId);
+					}
+				}
+				std::sort(nbors.begin(), nbors.end(), visitsBefore);
+				for (VertId const & nborVId : nbors)
+				{
+					seens[nborVId] = 1;
+					order.emplace_back(nborVId);
+				}
+			}
+		}
+	}
+	return order;
 }
 
 // public:
@@ -245,6 +462,8 @@ Geometry :: insertEdge
 	( std::shared_ptr<EdgeBase> const & ptEdge
 	)
 {
+	OriNet_TRACE_SPAN("Geometry::insertEdge");
+
 	// check if vertices (station nodes) are already in the graph
 	StaKey const & sta1 = ptEdge->fromKey();
 	StaKey const & sta2 = ptEdge->intoKey();
@@ -265,6 +484,7 @@ Geometry :: insertEdge
 		exit(1);
 	}
 	theGraph.add_edge(vId1, vId2, ptEdge);
+	markChanged(ptEdge->edgeDir());
 }
 
 std::shared_ptr<EdgeBase>
@@ -295,10 +515,141 @@ Geometry :: edge
 	return ptEdge;
 }
 
+void
+Geometry :: accumulateEdgeXform
+	( EdgeDir const & edgeDir
+	, rigibra::Transform const & xIntoWrtFrom
+	, std::size_t const & reserveSize
+	)
+{
+	std::shared_ptr<EdgeBase> const ptGraphEdge{ edge(edgeDir) };
+	if (ptGraphEdge)
+	{
+		// accumulate into already existing (robust) edge
+		std::shared_ptr<EdgeRobust> const ptEdgeRobust
+			{ std::dynamic_pointer_cast<EdgeRobust>(ptGraphEdge) };
+		if (ptEdgeRobust)
+		{
+			// express observation in the direction of the stored edge
+			EdgeDir::DirCompare const dirComp
+				{ ptEdgeRobust->edgeDir().compareTo(edgeDir) };
+			if (EdgeDir::Reverse == dirComp)
+			{
+				ptEdgeRobust->accumulateXform(rigibra::inverse(xIntoWrtFrom));
+			}
+			else
+			{
+				ptEdgeRobust->accumulateXform(xIntoWrtFrom);
+			}
+			markChanged(edgeDir);
+		}
+		else
+		{
+			std::cerr << "Geometry::accumulateEdgeXform:"
+				<< " existing edge is not EdgeRobust type"
+				<< " edgeDir: " << edgeDir
+				<< '\n';
+		}
+	}
+	else
+	{
+		// create and insert new robust edge into network
+		std::shared_ptr<EdgeBase> const ptEdge
+			{ std::make_shared<EdgeRobust>
+				(edgeDir, xIntoWrtFrom, reserveSize)
+			};
+		insertEdge(ptEdge);
+	}
+}
+
+void
+Geometry :: insertStarObservations
+	( StaKey const & hubKey
+	, std::vector<std::pair<StaKey, rigibra::Transform> >
+		const & xHubWrtSpokes
+	, std::size_t const & reserveSize
+	)
+{
+	using namespace rigibra;
+	for (std::pair<StaKey, Transform> const & xHubWrtSpoke : xHubWrtSpokes)
+	{
+		StaKey const & spokeKey = xHubWrtSpoke.first;
+		Transform const & xHubWrtSpokeXform = xHubWrtSpoke.second;
+
+		// express observation consistent with (fromKey < intoKey)
+		EdgeDir const spokeHubDir{ spokeKey, hubKey };
+		if (! spokeHubDir.isValid())
+		{
+			std::cerr << "Geometry::insertStarObservations:"
+				<< " invalid hub/spoke keys: " << spokeHubDir
+				<< '\n';
+		}
+		else
+		if (spokeHubDir.isForward())
+		{
+			accumulateEdgeXform(spokeHubDir, xHubWrtSpokeXform, reserveSize);
+		}
+		else
+		{
+			accumulateEdgeXform
+				( spokeHubDir.reverseEdgeDir()
+				, inverse(xHubWrtSpokeXform)
+				, reserveSize
+				);
+		}
+	}
+}
+
+rigibra::Transform
+Geometry :: xformViaHubs
+	( EdgeDir const & edgeDir
+	) const
+{
+	using namespace rigibra;
+	Transform xIntoWrtFrom{ null<Transform>() };
+
+	VertId const vIdFrom{ vertIdForStaKey(edgeDir.fromKey()) };
+	VertId const vIdInto{ vertIdForStaKey(edgeDir.intoKey()) };
+	if (isValid(vIdFrom) && isValid(vIdInto))
+	{
+		using GType
+			= graaf::undirected_graph<StaFrame, std::shared_ptr<EdgeBase> >;
+		using VertIds = GType::vertex_ids_t;
+		VertIds const fromNeighbors{ theGraph.get_neighbors(vIdFrom) };
+		VertIds const intoNeighbors{ theGraph.get_neighbors(vIdInto) };
+
+		// candidate transforms through each common neighbor
+		std::vector<Transform> xforms;
+		xforms.reserve(std::min(fromNeighbors.size(), intoNeighbors.size()));
+		for (VertId const & vIdHub : fromNeighbors)
+		{
+			if (intoNeighbors.end() != intoNeighbors.find(vIdHub))
+			{
+				std::shared_ptr<EdgeBase> const ptHubWrtFrom
+					{ edgeBaseForEdgeId(graaf::edge_id_t{ vIdFrom, vIdHub }) };
+				std::shared_ptr<EdgeBase> const ptIntoWrtHub
+					{ edgeBaseForEdgeId(graaf::edge_id_t{ vIdHub, vIdInto }) };
+				if (ptHubWrtFrom && ptIntoWrtHub)
+				{
+					xforms.emplace_back
+						(ptIntoWrtHub->xform() * ptHubWrtFrom->xform());
+				}
+			}
+		}
+
+		xIntoWrtFrom
+			= robust::transformViaEffect(xforms.cbegin(), xforms.cend());
+	}
+
+	return xIntoWrtFrom;
+}
+
 std::vector<graaf::edge_id_t>
 Geometry :: spanningEdgeBases
 	() const
 {
+	OriNet_TRACE_SPAN_ARG("Geometry::spanningEdgeBases", sizeEdges());
+	reestimateEdges(); // (noexcept) get_weight() does not
 	return graaf::algorithm::kruskal_minimum_spanning_tree(theGraph);
 }
 
@@ -307,6 +658,8 @@ Geometry :: networkTree
 	( std::vector<graaf::edge_id_t> const eIds
 	) const
 {
+	OriNet_TRACE_SPAN_ARG("Geometry::networkTree", eIds.size());
+
 	Geometry network{};
 
 	for (graaf::edge_id_t const & eId : eIds)
@@ -343,12 +696,132 @@ Geometry :: networkTree
 	return network;
 }
 
+std::vector<StaKey>
+Geometry :: breadthFirstOrder
+	( StaKey const & staKey0
+	) const
+{
+	// start from staKey0, then from any unvisited ones in vertex order
+	std::size_t const numVerts{ theGraph.vertex_count() };
+	std::vector<VertId> startVIds;
+	startVIds.reserve(numVerts + 1u);
+	VertId const vId0{ vertIdForStaKey(staKey0) };
+	if (isValid(vId0))
+	{
+		startVIds.emplace_back(vId0);
+	}
+	for (VertId vId{0u} ; vId < numVerts ; ++vId)
+	{
+		startVIds.emplace_back(vId);
+	}
+
+	std::vector<VertId> const vIds{ traversalVertIds(startVIds, nullptr) };
+	std::vector<StaKey> staKeys;
+	staKeys.reserve(vIds.size());
+	for (VertId const & vId : vIds)
+	{
+		staKeys.emplace_back(staKeyForVertId(vId));
+	}
+	return staKeys;
+}
+
+std::vector<StaKey>
+Geometry :: cuthillMcKeeOrder
+	() const
+{
+	std::size_t const numVerts{ theGraph.vertex_count() };
+	std::vector<std::size_t> degrees(numVerts, 0u);
+	for (VertId vId{0u} ; vId < numVerts ; ++vId)
+	{
+		degrees[vId] = theGraph.get_neighbors(vId).size();
+	}
+
+	// each component starts from (one of) its minimum degree vertex
+	std::vector<VertId> startVIds(numVerts);
+	for (VertId vId{0u} ; vId < numVerts ; ++vId)
+	{
+		startVIds[vId] = vId;
+	}
+	std::stable_sort
+		( startVIds.begin(), startVIds.end()
+		, [&degrees] (VertId const & vIdA, VertId const & vIdB)
+			{ return (degrees[vIdA] < degrees[vIdB]); }
+		);
+
+	std::vector<VertId> const vIds{ traversalVertIds(startVIds, &degrees) };
+	std::vector<StaKey> staKeys;
+	staKeys.reserve(vIds.size());
+	for (std::vector<VertId>::const_reverse_iterator
+		iter{vIds.crbegin()} ; vIds.crend() != iter ; ++iter)
+	{
+		staKeys.emplace_back(staKeyForVertId(*iter));
+	}
+	return staKeys;
+}
+
+Geometry
+Geometry :: renumbered
+	( std::vector<StaKey> const & staKeyOrder
+	) const
+{
+	OriNet_TRACE_SPAN_ARG("Geometry::renumbered", sizeVerts());
+
+	Geometry network{};
+
+	// vertices in requested order, then any others in current order
+	for (StaKey const & staKey : staKeyOrder)
+	{
+		if (hasStaKey(staKey))
+		{
+			network.ensureStaFrameExists(staKey);
+		}
+	}
+	std::size_t const numVerts{ theGraph.vertex_count() };
+	for (VertId vId{0u} ; vId < numVerts ; ++vId)
+	{
+		network.ensureStaFrameExists(staKeyForVertId(vId));
+	}
+
+	// edges in order of new (lo,hi) vertex ids
+	using NewEdge = std::pair<graaf::edge_id_t, std::shared_ptr<EdgeBase> >;
+	std::vector<NewEdge> newEdges;
+	newEdges.reserve(theGraph.edge_count());
+	using GType = graaf::undirected_graph<StaFrame, std::shared_ptr<EdgeBase> >;
+	GType::edge_id_to_edge_t const & eTypeById = theGraph.get_edges();
+	for (GType::edge_id_to_edge_t ::const_iterator
+		iter{eTypeById.cbegin()} ; eTypeById.cend() != iter ; ++iter)
+	{
+		std::shared_ptr<EdgeBase> const & ptEdge = iter->second;
+		VertId const vId1{ network.vertIdForStaKey(ptEdge->fromKey()) };
+		VertId const vId2{ network.vertIdForStaKey(ptEdge->intoKey()) };
+		graaf::edge_id_t const newId
+			{ std::min(vId1, vId2), std::max(vId1, vId2) };
+		newEdges.emplace_back(newId, ptEdge);
+	}
+	std::sort
+		( newEdges.begin(), newEdges.end()
+		, [] (NewEdge const & edgeA, NewEdge const & edgeB)
+			{ return (edgeA.first < edgeB.first); }
+		);
+	for (NewEdge const & newEdge : newEdges)
+	{
+		network.theGraph.add_edge
+			(newEdge.first.first, newEdge.first.second, newEdge.second);
+		network.markChanged(newEdge.second->edgeDir());
+	}
+
+	return network;
+}
+
 std::map<StaKey, rigibra::Transform>
 Geometry :: propagateTransforms
 	( StaKey const & staKey0
 	, rigibra::Transform const & staXform0
+	, PathMetrics * const & ptMetrics
 	) const
 {
+	OriNet_TRACE_SPAN_ARG("Geometry::propagateTransforms", sizeVerts());
+
 	std::map<StaKey, rigibra::Transform> staXforms;
 
 	std::size_t const numStaKeys{ theGraph.vertex_count() };
@@ -360,7 +833,16 @@ Geometry :: propagateTransforms
 		VertId const vId0{ vertIdForStaKey(staKey0) };
 		if (isValid(vId0))
 		{
-			Propagator const propagator{ this, &staXforms };
+			Propagator const propagator{ this, &staXforms, ptMetrics };
+			if (ptMetrics)
+			{
+				ptMetrics->reset(numStaKeys);
+				std::vector<std::size_t> & metricNdxs
+					= propagator.theMetricNdxs;
+				metricNdxs.resize
+					(std::max(numStaKeys, vId0 + 1u), PathMetrics::sNullNdx);
+				metricNdxs[vId0] = ptMetrics->appendStart(staKey0);
+			}
 			graaf::algorithm::breadth_first_traverse
 				(theGraph, vId0, propagator);
 		}
@@ -376,6 +858,217 @@ Geometry :: propagateTransforms
 	return staXforms;
 }
 
+std::map<StaKey, rigibra::Transform>
+Geometry :: propagateTransformsByLevel
+	( StaKey const & staKey0
+	, rigibra::Transform const & staXform0
+	, std::size_t const & numThreads
+	, PathMetrics * const & ptMetrics
+	) const
+{
+	OriNet_TRACE_SPAN_ARG("Geometry::propagateTransformsByLevel", sizeVerts());
+
+	std::map<StaKey, rigibra::Transform> staXforms;
+
+	std::size_t const numStaKeys{ theGraph.vertex_count() };
+	if (0u < numStaKeys)
+	{
+		// set first station orientation
+		staXforms[staKey0] = staXform0;
+
+		VertId const vId0{ vertIdForStaKey(staKey0) };
+		if (isValid(vId0))
+		{
+			// stations (and their transforms) for current level
+			std::vector<VertId> currVIds{ vId0 };
+			std::vector<rigibra::Transform> currXforms{ staXform0 };
+			applied::XformArrays currApps(1u);
+			currApps.setTransform(0u, staXform0);
+
+			// path information (if requested) - entries in level order
+			std::size_t currMetricBeg{ 0u };
+			if (ptMetrics)
+			{
+				ptMetrics->reset(numStaKeys);
+				ptMetrics->appendStart(staKey0);
+			}
+
+			// work space (reused for each level)
+			std::unordered_set<VertId> seenVIds{ vId0 };
+			seenVIds.reserve(numStaKeys);
+			std::vector<VertId> nextVIds;
+			std::vector<std::size_t> parentNdxs;
+			applied::XformArrays edgeApps;
+			applied::XformArrays nextApps;
+			std::vector<rigibra::Transform> nextXforms;
+			while (! currVIds.empty())
+			{
+				// stations first reached from the current level
+				nextVIds.clear();
+				parentNdxs.clear();
+				for (std::size_t ndx{0u} ; ndx < currVIds.size() ; ++ndx)
+				{
+					for (VertId const & vId
+						: theGraph.get_neighbors(currVIds[ndx]))
+					{
+						if (seenVIds.insert(vId).second)
+						{
+							nextVIds.emplace_back(vId);
+							parentNdxs.emplace_back(ndx);
+						}
+					}
+				}
+				std::size_t const numNext{ nextVIds.size() };
+
+				// edge (next wrt parent) transforms - each edge once
+				edgeApps.resize(numNext);
+				nextXforms.resize(numNext);
+				parallel::forEachRange
+					( numNext
+					, [&] (std::size_t const beg, std::size_t const end)
+					{
+						for (std::size_t nn{beg} ; nn < end ; ++nn)
+						{
+							graaf::edge_id_t const eId
+								{ currVIds[parentNdxs[nn]], nextVIds[nn] };
+							std::shared_ptr<EdgeBase> const ptEdge
+								{ edgeBaseForEdgeId(eId) };
+							rigibra::Transform const xEdge{ ptEdge->xform() };
+							edgeApps.setTransform(nn, xEdge);
+							// attitude composed directly (as spinors)
+							nextXforms[nn].theAtt = xEdge.theAtt
+								* currXforms[parentNdxs[nn]].theAtt;
+						}
+					}
+					, numThreads
+					);
+
+				// propagate: xNextWrtRef = xNextWrtParent * xParentWrtRef
+				nextApps.resize(numNext);
+				applied::gatherEach(nextApps.outSpans(), currApps.inSpans()
+					, std::span<std::size_t const>(parentNdxs));
+				applied::composeEach
+					( nextApps.outSpans()
+					, edgeApps.inSpans()
+					, nextApps.inSpans()
+					);
+
+				// record results
+				for (std::size_t nn{0u} ; nn < numNext ; ++nn)
+				{
+					nextXforms[nn].theLoc = engabra::g3::Vector
+						{ nextApps.theLocs[0][nn]
+						, nextApps.theLocs[1][nn]
+						, nextApps.theLocs[2][nn]
+						};
+					staXforms[staKeyForVertId(nextVIds[nn])] = nextXforms[nn];
+				}
+				if (ptMetrics)
+				{
+					std::size_t const nextMetricBeg{ ptMetrics->size() };
+					for (std::size_t nn{0u} ; nn < numNext ; ++nn)
+					{
+						graaf::edge_id_t const eId
+							{ currVIds[parentNdxs[nn]], nextVIds[nn] };
+						ptMetrics->appendChild
+							( staKeyForVertId(nextVIds[nn])
+							, currMetricBeg + parentNdxs[nn]
+							, theGraph.get_edge(eId)->get_weight()
+							);
+					}
+					currMetricBeg = nextMetricBeg;
+				}
+
+				currVIds.swap(nextVIds);
+				currXforms.swap(nextXforms);
+				std::swap(currApps, nextApps);
+			}
+		}
+		else
+		{
+			std::cerr << "Invalid initial station reference:"
+				<< " staKey0: " << staKey0
+				<< " vId0: " << vId0
+				<< '\n';
+		}
+	}
+
+	return staXforms;
+}
+
+void
+Geometry :: trackChanges
+	( bool const & enable
+	)
+{
+	theTracksChanges = enable;
+	if (! theTracksChanges)
+	{
+		theChanges = ChangeSet{};
+	}
+}
+
+bool
+Geometry :: tracksChanges
+	() const
+{
+	return theTracksChanges;
+}
+
+void
+Geometry :: markChanged
+	( EdgeDir const & edgeDir
+	)
+{
+	if (theTracksChanges)
+	{
+		theChanges.theEdgeKeys.insert(ChangeSet::edgeKeyFor(edgeDir));
+	}
+}
+
+ChangeSet
+Geometry :: takeChanges
+	()
+{
+	ChangeSet changes{};
+	std::swap(changes, theChanges);
+	return changes;
+}
+
+ChangeSet
+Geometry :: allContents
+	() const
+{
+	ChangeSet all{};
+
+	// stations in order of vertex creation (vertex ids are sequential)
+	std::vector<std::pair<VertId, StaKey> > vIdStaKeys;
+	vIdStaKeys.reserve(theVertIdFromStaKey.size());
+	for (std::pair<StaKey const, VertId> const & staKeyVId
+		: theVertIdFromStaKey)
+	{
+		vIdStaKeys.emplace_back(staKeyVId.second, staKeyVId.first);
+	}
+	std::sort(vIdStaKeys.begin(), vIdStaKeys.end());
+	all.theStaKeys.reserve(vIdStaKeys.size());
+	for (std::pair<VertId, StaKey> const & vIdStaKey : vIdStaKeys)
+	{
+		all.theStaKeys.emplace_back(vIdStaKey.second);
+	}
+
+	// edges
+	using GType = graaf::undirected_graph<StaFrame, std::shared_ptr<EdgeBase> >;
+	GType::edge_id_to_edge_t const & eTypeById = theGraph.get_edges();
+	for (GType::edge_id_to_edge_t ::const_iterator
+		iter{eTypeById.cbegin()} ; eTypeById.cend() != iter ; ++iter)
+	{
+		std::shared_ptr<EdgeBase> const & ptEdge = iter->second;
+		all.theEdgeKeys.insert(ChangeSet::edgeKeyFor(ptEdge->edgeDir()));
+	}
+
+	return all;
+}
+
 std::size_t
 Geometry :: sizeVerts
 	() const
@@ -481,6 +1174,7 @@ Geometry :: saveNetworkGraphic
 	( std::filesystem::path const & dotPath
 	) const
 {
+	reestimateEdges();
 	graaf::io::to_dot(theGraph, dotPath, vertLabel, edgeLabel);
 }
 
@@ -0,0 +1,305 @@
+//
+// MIT License
+//
+// Copyright (c) 2024 Stellacore Corporation
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+
+/*! \file
+\brief Unit tests (and example) code for OriNet::alloc
+
+This test program links OriNet::AllocHook (for allocation counting).
+*/
+
+
+#include "OriNet/alloc.hpp"
+#include "OriNet/perf.hpp"
+#include "OriNet/random.hpp"
+#include "OriNet/simScene.hpp"
+
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+
+namespace
+{
+	//! Destination for keep()
+	void const * volatile sKeepPtr{ nullptr };
+
+	//! Escape address (so that compiler can not elide allocations)
+	inline
+	void
+	keep
+		( void const * const & ptr
+		)
+	{
+		sKeepPtr = ptr;
+	}
+
+	//! Examples for documentation
+	void
+	test0
+		( std::ostream & oss
+		)
+	{
+		// [DoxyExample01]
+
+		// false unless program is linked with OriNet::AllocHook
+		bool const isTracking{ orinet::alloc::isTracking() };
+
+		// buffers allocated once (e.g. during setup)
+		std::vector<double> values;
+		values.reserve(1024u);
+
+		std::size_t numAllocsSteady{ 0u };
+		{
+			// count allocations (by this thread) during scope lifetime
+			orinet::alloc::Scope const allocScope{};
+
+			// ... steady state processing (e.g. hot path)
+			values.clear();
+			for (std::size_t nn{0u} ; nn < 1024u ; ++nn)
+			{
+				values.emplace_back(double(nn));
+			}
+
+			numAllocsSteady = allocScope.numAllocs();
+		}
+		// expect no allocations in steady state (reusing buffers)
+
+		// [DoxyExample01]
+
+		if (! isTracking)
+		{
+			oss << "Failure of isTracking test (AllocHook not linked)\n";
+		}
+
+		if (! (0u == numAllocsSteady))
+		{
+			oss << "Failure of steady state numAllocs test\n";
+			oss << "exp: " << 0u << '\n';
+			oss << "got: " << numAllocsSteady << '\n';
+		}
+	}
+
+	//! Check counting of each form of allocation
+	void
+	test1
+		( std::ostream & oss
+		)
+	{
+		using orinet::alloc::Counts;
+		orinet::alloc::Scope const allocScope{};
+
+		// scalar, array and aligned forms
+		std::unique_ptr<double> const ptScalar{ new double{ 1. } };
+		std::unique_ptr<double[]> const ptArray{ new double[10u] };
+		struct alignas(64u) Wide { double theValues[8u]; };
+		std::unique_ptr<Wide> const ptWide{ new Wide{} };
+		keep(ptScalar.get());
+		keep(ptArray.get());
+		keep(ptWide.get());
+
+		Counts const gotUsed{ allocScope.counts() };
+		Counts const expUsed
+			{ .theNumAllocs = 3u
+			, .theNumFrees = 0u
+			, .theNumBytes = sizeof(double) + 10u*sizeof(double) + sizeof(Wide)
+			};
+		bool const okayAddress
+			{ 0u == (reinterpret_cast<std::uintptr_t>(ptWide.get()) % 64u) };
+
+		if (! okayAddress)
+		{
+			oss << "Failure of aligned allocation address test\n";
+		}
+
+		if (! ( (expUsed.theNumAllocs == gotUsed.theNumAllocs)
+			 && (expUsed.theNumFrees == gotUsed.theNumFrees)
+			 && (expUsed.theNumBytes == gotUsed.theNumBytes)
+			  ))
+		{
+			oss << "Failure of allocation counts test\n";
+			oss << expUsed.infoString("exp:") << '\n';
+			oss << gotUsed.infoString("got:") << '\n';
+		}
+
+		// frees are counted too (and nothing else is)
+		Counts gotFreed{};
+		{
+			orinet::alloc::Scope const freeScope{};
+			{
+				std::vector<int> const tmp(100u, 0);
+				keep(tmp.data());
+			}
+			gotFreed = freeScope.counts();
+		}
+		if (! ((1u == gotFreed.theNumAllocs) && (1u == gotFreed.theNumFrees)))
+		{
+			oss << "Failure of alloc/free pair test\n";
+			oss << "exp: allocs: 1 frees: 1\n";
+			oss << gotFreed.infoString("got:") << '\n';
+		}
+	}
+
+	//! Check that Scope is not affected by other threads
+	void
+	test2
+		( std::ostream & oss
+		)
+	{
+		using orinet::alloc::Counts;
+		Counts const procBeg{ orinet::alloc::processCounts() };
+		orinet::alloc::Scope const allocScope{};
+
+		std::size_t numInThread{ 0u };
+		constexpr std::size_t numOther{ 17u };
+		std::thread other
+			( [&numInThread] ()
+				{
+					orinet::alloc::Scope const threadScope{};
+					for (std::size_t nn{0u} ; nn < numOther ; ++nn)
+					{
+						std::unique_ptr<int> const ptInt
+							{ std::make_unique<int>(int(nn)) };
+						keep(ptInt.get());
+					}
+					numInThread = threadScope.numAllocs();
+				}
+			);
+		std::size_t const numBeforeJoin{ allocScope.numAllocs() };
+		other.join();
+
+		// std::thread construction may allocate (in this thread)
+		std::size_t const gotInScope{ allocScope.numAllocs() };
+		std::size_t const gotInProc
+			{ orinet::alloc::processCounts().since(procBeg).theNumAllocs };
+
+		if (! (numOther == numInThread))
+		{
+			oss << "Failure of other thread scope test\n";
+			oss << "exp: " << numOther << '\n';
+			oss << "got: " << numInThread << '\n';
+		}
+		if (! (numBeforeJoin == gotInScope))
+		{
+			oss << "Failure of thread isolation test\n";
+			oss << "exp: " << numBeforeJoin << '\n';
+			oss << "got: " << gotInScope << '\n';
+		}
+		if (! ((gotInScope + numOther) <= gotInProc))
+		{
+			oss << "Failure of process counts test\n";
+			oss << "exp: (at least) " << (gotInScope + numOther) << '\n';
+			oss << "got: " << gotInProc << '\n';
+		}
+	}
+
+	//! Check for zero allocations in (steady state) hot paths
+	void
+	test3
+		( std::ostream & oss
+		)
+	{
+		// latency recording (e.g. during each frame of an update)
+		{
+			using orinet::perf::Phase;
+			orinet::perf::Latencies latencies;
+			orinet::alloc::Scope const allocScope{};
+			for (std::size_t nFrame{0u} ; nFrame < 100u ; ++nFrame)
+			{
+				orinet::perf::ScopedTimer const timer
+					(&latencies, Phase::Propagation);
+				latencies.recordAllocations(nFrame);
+			}
+			std::size_t const gotAllocs{ allocScope.numAllocs() };
+			if (! (0u == gotAllocs))
+			{
+				oss << "Failure of Latencies zero allocation test\n";
+				oss << "got: " << gotAllocs << '\n';
+			}
+		}
+
+		// scene frame generation into a reused FrameBatch
+		{
+			namespace sim = orinet::sim;
+			orinet::random::Context ctx(12345u);
+			sim::Scene scene(sim::expFeaXforms(ctx, 100u));
+			scene.addCamera
+				(sim::sCamKey0, std::make_shared<sim::TrajectoryCircle>());
+			orinet::random::NoiseModel const camNoise{};
+			constexpr std::size_t numTimes{ 8u };
+			constexpr std::size_t numFeas{ 7u };
+			constexpr double tauDelta{ 1./32. };
+
+			// first use sizes the buffers
+			sim::FrameBatch batch;
+			scene.fillFrames
+				(ctx, 0., tauDelta, numTimes, numFeas, camNoise, &batch);
+
+			orinet::alloc::Scope const allocScope{};
+			for (std::size_t nBatch{1u} ; nBatch < 50u ; ++nBatch)
+			{
+				double const tauBeg{ double(nBatch*numTimes) * tauDelta };
+				scene.fillFrames
+					( ctx, tauBeg, tauDelta, numTimes, numFeas, camNoise
+					, &batch
+					);
+			}
+			std::size_t const gotAllocs{ allocScope.numAllocs() };
+			if (! (0u == gotAllocs))
+			{
+				oss << "Failure of Scene::fillFrames zero allocation test\n";
+				oss << "got: " << gotAllocs << '\n';
+			}
+		}
+	}
+
+}
+
+//! Check behavior of alloc counting
+int
+main
+	()
+{
+	int status{ 1 };
+	std::stringstream oss;
+
+	test0(oss);
+	test1(oss);
+	test2(oss);
+	test3(oss);
+
+	if (oss.str().empty()) // Only pass if no errors were encountered
+	{
+		status = 0;
+	}
+	else
+	{
+		// else report error messages
+		std::cerr << "### FAILURE in test file: " << __FILE__ << std::endl;
+		std::cerr << oss.str();
+	}
+	return status;
+}
@@ -0,0 +1,313 @@
+//
+// MIT License
+//
+// Copyright (c) 2024 Stellacore Corporation
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+
+/*! \file
+\brief Unit tests (and example) code for OriNet::applied
+*/
+
+
+#include "OriNet/applied.hpp"
+
+#include "OriNet/compare.hpp"
+#include "OriNet/random.hpp" // for simulation support
+
+#include <Engabra>
+#include <Rigibra>
+
+#include <cmath>
+#include <iostream>
+#include <span>
+#include <sstream>
+#include <vector>
+
+
+namespace
+{
+	//! Examples for documentation
+	void
+	test0
+		( std::ostream & oss
+		)
+	{
+		using namespace engabra::g3;
+		using namespace rigibra;
+		orinet::random::Context ctx(59130478u);
+		Transform const xform
+			{ orinet::random::uniformTransform(ctx, { -10., 10. }) };
+		std::vector<Vector> const vecs
+			{ Vector{ 1., 2., 3. }
+			, Vector{ -7., 5., 0. }
+			, Vector{ 0., 0., 9. }
+			};
+
+		// [DoxyExample01]
+
+		// form rotation matrix once (from rigibra::Transform) ...
+		orinet::applied::Xform const app(xform);
+
+		// ... and apply it to several vectors
+		std::vector<Vector> gotVecs;
+		for (Vector const & vec : vecs)
+		{
+			// same as xform(vec) - but less effort
+			gotVecs.emplace_back(app(vec));
+		}
+
+		// convert back (e.g. at end of a sequence of computations)
+		Transform const gotXform{ app.transform() };
+
+		// [DoxyExample01]
+
+		constexpr double tol{ 64. * std::numeric_limits<double>::epsilon() };
+		for (std::size_t nn{0u} ; nn < vecs.size() ; ++nn)
+		{
+			Vector const expVec{ xform(vecs[nn]) };
+			if (! nearlyEquals(gotVecs[nn], expVec, tol))
+			{
+				oss << "Failure of applied vector test\n";
+				oss << "exp: " << expVec << '\n';
+				oss << "got: " << gotVecs[nn] << '\n';
+			}
+		}
+
+		if (! orinet::compare::similarResult(gotXform, xform, true, tol))
+		{
+			oss << "Failure of applied round trip transform test\n";
+			oss << "exp: " << xform << '\n';
+			oss << "got: " << gotXform << '\n';
+		}
+	}
+
+	//! Check composition and inversion against rigibra::Transform
+	void
+	test1
+		( std::ostream & oss
+		)
+	{
+		using namespace engabra::g3;
+		using namespace rigibra;
+		using orinet::applied::Xform;
+		orinet::random::Context ctx(20486317u);
+
+		constexpr double tol{ 256. * std::numeric_limits<double>::epsilon() };
+		constexpr std::size_t numTrials{ 100u };
+		for (std::size_t nn{0u} ; nn < numTrials ; ++nn)
+		{
+			Transform const xCwB
+				{ orinet::random::uniformTransform(ctx, { -10., 10. }) };
+			Transform const xBwA
+				{ orinet::random::uniformTransform(ctx, { -10., 10. }) };
+			Vector const vec
+				{ orinet::random::uniformTransform(ctx, { -10., 10. }).theLoc };
+
+			Xform const appCwB(xCwB);
+			Xform const appBwA(xBwA);
+
+			// composition
+			Xform const gotCwA{ appCwB * appBwA };
+			Transform const expCwA{ xCwB * xBwA };
+			Vector const gotVec{ gotCwA(vec) };
+			Vector const expVec{ expCwA(vec) };
+			bool const okayComp
+				{ nearlyEquals(gotVec, expVec, tol)
+				&& nearlyEquals(gotCwA.theLoc, expCwA.theLoc, tol)
+				};
+
+			// inversion
+			Xform const gotInv{ inverse(appCwB) };
+			Transform const expInv{ inverse(xCwB) };
+			bool const okayInv
+				{ nearlyEquals(gotInv(vec), expInv(vec), tol)
+				&& nearlyEquals(gotInv.theLoc, expInv.theLoc, tol)
+				};
+
+			// rotation only
+			bool const okayRot
+				{ nearlyEquals(appCwB.rotated(vec), xCwB.theAtt(vec), tol)
+				&& nearlyEquals
+					(appCwB.rotatedInverse(vec), inverse(xCwB.theAtt)(vec), tol)
+				&& nearlyEquals(appCwB.rotatedBasis(2u), xCwB.theAtt(e3), tol)
+				};
+
+			if (! (okayComp && okayInv && okayRot))
+			{
+				oss << "Failure of applied operation test\n";
+				oss << "okayComp: " << okayComp << '\n';
+				oss << "okayInv: " << okayInv << '\n';
+				oss << "okayRot: " << okayRot << '\n';
+				break;
+			}
+		}
+
+		// null instances are invalid
+		if (  orinet::applied::isValid(Xform{})
+		   || orinet::applied::isValid(Xform(rigibra::null<Transform>()))
+		   )
+		{
+			oss << "Failure of applied null validity test\n";
+		}
+	}
+
+	//! Check compare kernels (now via applied form) with direct evaluation
+	void
+	test2
+		( std::ostream & oss
+		)
+	{
+		using namespace engabra::g3;
+		using namespace rigibra;
+		orinet::random::Context ctx(83102954u);
+		Transform const xfm1
+			{ orinet::random::uniformTransform(ctx, { -10., 10. }) };
+		Transform const xfm2
+			{ orinet::random::uniformTransform(ctx, { -10., 10. }) };
+
+		// direct evaluation via transformation of each hexad vector
+		std::array<Vector, 6u> const hexad{ e1, -e1, e2, -e2, e3, -e3 };
+		double expMax{ -1. };
+		for (Vector const & vec : hexad)
+		{
+			expMax = std::max(expMax, magnitude(xfm1(vec) - xfm2(vec)));
+		}
+
+		double const gotMax
+			{ orinet::compare::maxMagResultDifference(xfm1, xfm2, false) };
+		constexpr double tol{ 256. * std::numeric_limits<double>::epsilon() };
+		if (! nearlyEquals(gotMax, expMax, tol))
+		{
+			oss << "Failure of applied form compare test\n";
+			oss << "exp: " << expMax << '\n';
+			oss << "got: " << gotMax << '\n';
+		}
+	}
+
+	//! Check batch kernels against rigibra::Transform operations
+	void
+	test3
+		( std::ostream & oss
+		)
+	{
+		using namespace engabra::g3;
+		using namespace rigibra;
+		using orinet::applied::XformArrays;
+		orinet::random::Context ctx(90347215u);
+
+		// size not a multiple of batch lanes (to check partial group)
+		constexpr std::size_t numElem
+			{ 3u * orinet::applied::sBatchLanes + 5u };
+		std::vector<Transform> xAs;
+		std::vector<Transform> xBs;
+		XformArrays as(numElem);
+		XformArrays bs(numElem);
+		for (std::size_t nn{0u} ; nn < numElem ; ++nn)
+		{
+			xAs.emplace_back
+				(orinet::random::uniformTransform(ctx, { -10., 10. }));
+			xBs.emplace_back
+				(orinet::random::uniformTransform(ctx, { -10., 10. }));
+			as.setTransform(nn, xAs.back());
+			bs.setTransform(nn, xBs.back());
+		}
+
+		XformArrays gotComps(numElem);
+		orinet::applied::composeEach
+			(gotComps.outSpans(), as.inSpans(), bs.inSpans());
+		XformArrays gotInvs(numElem);
+		orinet::applied::inverseEach(gotInvs.outSpans(), as.inSpans());
+		XformArrays gotRels(numElem);
+		orinet::applied::composeInverseEach
+			(gotRels.outSpans(), as.inSpans(), bs.inSpans());
+
+		// reversed order (via gather) and in-place (output is input)
+		std::vector<std::size_t> revNdxs(numElem);
+		for (std::size_t nn{0u} ; nn < numElem ; ++nn)
+		{
+			revNdxs[nn] = numElem - 1u - nn;
+		}
+		XformArrays gotRevs(numElem);
+		orinet::applied::gatherEach
+			( gotRevs.outSpans()
+			, as.inSpans()
+			, std::span<std::size_t const>(revNdxs)
+			);
+		orinet::applied::composeEach
+			(gotRevs.outSpans(), gotRevs.inSpans(), bs.inSpans());
+
+		constexpr double tol{ 256. * std::numeric_limits<double>::epsilon() };
+		// attitude reconstruction (ref test_alignDirPair) is less precise
+		static double const xfmTol
+			{ std::sqrt(std::numeric_limits<double>::epsilon()) };
+		Vector const vec{ 1.25, -3.5, 7. };
+		bool okay{ true };
+		for (std::size_t nn{0u} ; okay && (nn < numElem) ; ++nn)
+		{
+			Transform const expComp{ xAs[nn] * xBs[nn] };
+			Transform const expInv{ inverse(xAs[nn]) };
+			Transform const expRel{ xAs[nn] * inverse(xBs[nn]) };
+			Transform const expRev{ xAs[numElem - 1u - nn] * xBs[nn] };
+			okay = nearlyEquals(gotComps.xform(nn)(vec), expComp(vec), tol)
+				&& nearlyEquals(gotInvs.xform(nn)(vec), expInv(vec), tol)
+				&& nearlyEquals(gotRels.xform(nn)(vec), expRel(vec), tol)
+				&& nearlyEquals(gotRevs.xform(nn)(vec), expRev(vec), tol)
+				&& orinet::compare::similarResult
+					(gotRels.transform(nn), expRel, true, xfmTol)
+				;
+			if (! okay)
+			{
+				oss << "Failure of batch kernel test\n";
+				oss << "nn: " << nn << '\n';
+				oss << "expRel: " << expRel << '\n';
+				oss << "gotRel: " << gotRels.transform(nn) << '\n';
+			}
+		}
+	}
+
+}
+
+//! Check behavior of applied form transformations
+int
+main
+	()
+{
+	int status{ 1 };
+	std::stringstream oss;
+
+	test0(oss);
+	test1(oss);
+	test2(oss);
+	test3(oss);
+
+	if (oss.str().empty()) // Only pass if no errors were encountered
+	{
+		status = 0;
+	}
+	else
+	{
+		// else report error messages
+		std::cerr << "### FAILURE in test file: " << __FILE__ << std::endl;
+		std::cerr << oss.str();
+	}
+	return status;
+}
@@ -0,0 +1,447 @@
+//
+// MIT License
+//
+// Copyright (c) 2024 Stellacore Corporation
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+
+/*! \file
+\brief Unit tests (and example) code for OriNet::checkpoint
+*/
+
+
+#include "OriNet/checkpoint.hpp"
+
+#include "OriNet/random.hpp" // for simulation support
+
+#include <Engabra>
+#include <Rigibra>
+
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+
+namespace
+{
+	//! Station keys and (noisy) relative transform for a simulated edge
+	struct Obs
+	{
+		orinet::network::EdgeDir theEdgeDir;
+		rigibra::Transform theXform;
+	};
+
+	//! Simulated (noisy) observations among a few stations
+	std::vector<Obs>
+	simObservations
+		( std::size_t const & numObs
+		, std::size_t const & seed
+		)
+	{
+		using namespace rigibra;
+		orinet::random::Context ctx(seed);
+		constexpr std::size_t numSta{ 9u };
+		std::vector<Obs> obss;
+		for (std::size_t nn{0u} ; nn < numObs ; ++nn)
+		{
+			std::size_t const from{ (5u * nn) % numSta };
+			std::size_t const into{ (from + 1u + (nn % 3u)) % numSta };
+			Transform const xform
+				{ orinet::random::uniformTransform
+					(ctx, { -5., 5. }, { -1., 1. })
+				};
+			obss.emplace_back
+				(Obs{ orinet::network::EdgeDir{ from, into }, xform });
+		}
+		return obss;
+	}
+
+	//! Empty directory for checkpoint files
+	std::filesystem::path
+	tmpDir
+		( std::string const & name
+		)
+	{
+		std::filesystem::path const dir
+			{ std::filesystem::temp_directory_path() / name };
+		std::filesystem::remove_all(dir);
+		return dir;
+	}
+
+	//! True if edges in gotGeo have the same content as those in expGeo
+	bool
+	sameEdges
+		( orinet::network::Geometry const & gotGeo
+		, orinet::network::Geometry const & expGeo
+		, std::ostream & oss
+		)
+	{
+		using namespace orinet::network;
+		bool same
+			{  (expGeo.sizeVerts() == gotGeo.sizeVerts())
+			&& (expGeo.sizeEdges() == gotGeo.sizeEdges())
+			&& (expGeo.allContents().theStaKeys
+				== gotGeo.allContents().theStaKeys)
+			};
+		ChangeSet const expAll{ expGeo.allContents() };
+		for (std::pair<StaKey, StaKey> const & edgeKey : expAll.theEdgeKeys)
+		{
+			EdgeDir const edgeDir{ edgeKey.first, edgeKey.second };
+			std::shared_ptr<EdgeBase> const ptExp{ expGeo.edge(edgeDir) };
+			std::shared_ptr<EdgeBase> const ptGot{ gotGeo.edge(edgeDir) };
+			std::shared_ptr<EdgeRobust> const ptExpRobust
+				{ std::dynamic_pointer_cast<EdgeRobust>(ptExp) };
+			std::shared_ptr<EdgeRobust> const ptGotRobust
+				{ std::dynamic_pointer_cast<EdgeRobust>(ptGot) };
+			bool okay
+				{  ptGot
+				&& (EdgeDir::Forward
+					== ptExp->edgeDir().compareTo(ptGot->edgeDir()))
+				&& nearlyEquals(ptGot->xform(), ptExp->xform(), 0.)
+				&& (ptExp->get_weight() == ptGot->get_weight())
+				&& ((nullptr == ptExpRobust) == (nullptr == ptGotRobust))
+				};
+			if (okay && ptExpRobust)
+			{
+				okay
+					=  (ptExpRobust->theXformTracker.size()
+						== ptGotRobust->theXformTracker.size())
+					&& (ptExpRobust->theTimedXforms.size()
+						== ptGotRobust->theTimedXforms.size())
+					&& (ptExpRobust->theForgetting.theMaxSize
+						== ptGotRobust->theForgetting.theMaxSize)
+					;
+			}
+			if (! okay)
+			{
+				oss << "edgeDir: " << edgeDir << '\n';
+				oss << "exp: " << ptExp->infoString() << '\n';
+				if (ptGot)
+				{
+					oss << "got: " << ptGot->infoString() << '\n';
+				}
+				same = false;
+				break;
+			}
+		}
+		return same;
+	}
+
+	//! Examples for documentation
+	void
+	test0
+		( std::ostream & oss
+		)
+	{
+		using namespace orinet;
+		std::vector<Obs> const obss{ simObservations(200u, 40193725u) };
+		std::filesystem::path const dir{ tmpDir("test_checkpoint_0") };
+		constexpr std::size_t reserveSize{ 64u };
+		network::Geometry geo;
+
+		// [DoxyExample01]
+
+		checkpoint::Writer writer(dir);
+
+		// ingest data and periodically save (changes) - e.g. every 50
+		for (std::size_t nn{0u} ; nn < obss.size() ; ++nn)
+		{
+			geo.accumulateEdgeXform
+				(obss[nn].theEdgeDir, obss[nn].theXform, reserveSize);
+			if (0u == ((nn + 1u) % 50u))
+			{
+				// first save is full, others have only changed edges
+				// (file is written in background while ingest continues)
+				writer.saveIncremental(geo);
+			}
+		}
+		bool const okaySave{ writer.wait() };
+
+		// ... (e.g. after a restart) rebuild network from checkpoints
+		network::Geometry gotGeo;
+		std::size_t const numFiles{ checkpoint::restore(dir, gotGeo) };
+
+		// [DoxyExample01]
+
+		if (! (okaySave && (4u == numFiles) && sameEdges(gotGeo, geo, oss)))
+		{
+			oss << "Failure of checkpoint restore test\n";
+			oss << "okaySave: " << okaySave << '\n';
+			oss << "numFiles: " << numFiles << '\n';
+			oss << geo.infoString("exp") << '\n';
+			oss << gotGeo.infoString("got") << '\n';
+		}
+
+		std::filesystem::remove_all(dir);
+	}
+
+	//! Check change tracking and incremental content
+	void
+	test1
+		( std::ostream & oss
+		)
+	{
+		using namespace orinet;
+		using network::EdgeDir;
+		std::vector<Obs> const obss{ simObservations(100u, 81735906u) };
+		std::filesystem::path const dir{ tmpDir("test_checkpoint_1") };
+		network::Geometry geo;
+		for (Obs const & obs : obss)
+		{
+			geo.accumulateEdgeXform(obs.theEdgeDir, obs.theXform, 16u);
+		}
+		geo.insertEdge
+			( std::make_shared<network::EdgeOri>
+				(EdgeDir{ 20u, 21u }, obss[0].theXform, .25)
+			);
+
+		// changes are not noted until a checkpoint::Writer uses geo
+		if (geo.tracksChanges() || (! geo.takeChanges().empty()))
+		{
+			oss << "Failure of untracked geo changes empty test\n";
+		}
+
+		checkpoint::Writer writer(dir);
+		std::size_t const numFull{ writer.saveIncremental(geo) }; // full
+		if (! (geo.sizeEdges() == numFull))
+		{
+			oss << "Failure of first (full) save size test\n";
+			oss << "exp: " << geo.sizeEdges() << '\n';
+			oss << "got: " << numFull << '\n';
+		}
+
+		// change two edges - via Geometry and directly (with markChanged)
+		EdgeDir const edgeA{ obss[3].theEdgeDir };
+		EdgeDir const edgeB{ obss[4].theEdgeDir };
+		geo.accumulateEdgeXform(edgeA.reverseEdgeDir(), obss[5].theXform, 16u);
+		std::shared_ptr<network::EdgeRobust> const ptEdgeB
+			{ std::dynamic_pointer_cast<network::EdgeRobust>(geo.edge(edgeB)) };
+		ptEdgeB->accumulateXform(obss[6].theXform);
+		geo.markChanged(edgeB);
+
+		// and add a new edge (and station)
+		geo.accumulateEdgeXform(EdgeDir{ 8u, 30u }, obss[7].theXform, 16u);
+
+		std::size_t const numIncr{ writer.saveIncremental(geo) };
+		std::size_t const numNone{ writer.saveIncremental(geo) };
+		if (! ((3u == numIncr) && (0u == numNone)))
+		{
+			oss << "Failure of incremental save size test\n";
+			oss << "numIncr: exp: 3 got: " << numIncr << '\n';
+			oss << "numNone: exp: 0 got: " << numNone << '\n';
+		}
+
+		writer.wait(); // for background file writing
+		network::Geometry gotGeo;
+		std::size_t const numFiles{ checkpoint::restore(dir, gotGeo) };
+		if (! ((3u == numFiles) && sameEdges(gotGeo, geo, oss)))
+		{
+			oss << "Failure of incremental restore test\n";
+			oss << "numFiles: exp: 3 got: " << numFiles << '\n';
+		}
+		if (! gotGeo.takeChanges().empty())
+		{
+			oss << "Failure of restored geo changes empty test\n";
+		}
+
+		std::filesystem::remove_all(dir);
+	}
+
+	//! Check that restored time stamped edges continue identically
+	void
+	test2
+		( std::ostream & oss
+		)
+	{
+		using namespace orinet;
+		std::vector<Obs> const obss{ simObservations(400u, 27450913u) };
+		std::filesystem::path const dir{ tmpDir("test_checkpoint_2") };
+		stat::track::Forgetting forgetting{};
+		forgetting.theDecayTime = 30.;
+		forgetting.theMaxSize = 12u;
+
+		// accumulate timed observations into robust edges
+		auto const ingest
+			{ [&obss, &forgetting]
+				( network::Geometry & geo
+				, std::size_t const & beg
+				, std::size_t const & end
+				)
+			{
+				for (std::size_t nn{beg} ; nn < end ; ++nn)
+				{
+					network::EdgeDir const & edgeDir = obss[nn].theEdgeDir;
+					double const tau{ (double)nn };
+					std::shared_ptr<network::EdgeRobust> const ptEdge
+						{ std::dynamic_pointer_cast<network::EdgeRobust>
+							(geo.edge(edgeDir))
+						};
+					if (ptEdge)
+					{
+						rigibra::Transform xform{ obss[nn].theXform };
+						if (edgeDir.fromKey() != ptEdge->fromKey())
+						{
+							xform = rigibra::inverse(xform);
+						}
+						ptEdge->accumulateXform(xform, tau);
+						geo.markChanged(edgeDir);
+					}
+					else
+					{
+						geo.insertEdge
+							( std::make_shared<network::EdgeRobust>
+								( edgeDir, obss[nn].theXform, tau
+								, 16u, forgetting
+								)
+							);
+					}
+				}
+			}
+			};
+
+		constexpr std::size_t numHalf{ 200u };
+		network::Geometry expGeo;
+		ingest(expGeo, 0u, numHalf);
+		{
+			checkpoint::Writer writer(dir);
+			writer.saveFull(expGeo);
+		}
+
+		// continue with both original and restored networks
+		network::Geometry gotGeo;
+		checkpoint::restore(dir, gotGeo);
+		ingest(expGeo, numHalf, obss.size());
+		ingest(gotGeo, numHalf, obss.size());
+		if (! sameEdges(gotGeo, expGeo, oss))
+		{
+			oss << "Failure of continued time stamped edge test\n";
+		}
+
+		std::filesystem::remove_all(dir);
+	}
+
+	//! Check handling of interrupted and corrupted checkpoint files
+	void
+	test3
+		( std::ostream & oss
+		)
+	{
+		using namespace orinet;
+		std::vector<Obs> const obss{ simObservations(90u, 63019842u) };
+		std::filesystem::path const dir{ tmpDir("test_checkpoint_3") };
+		network::Geometry geo;
+		{
+			checkpoint::Writer writer(dir);
+			for (std::size_t nn{0u} ; nn < obss.size() ; ++nn)
+			{
+				geo.accumulateEdgeXform
+					(obss[nn].theEdgeDir, obss[nn].theXform, 16u);
+				if (0u == ((nn + 1u) % 30u))
+				{
+					writer.saveIncremental(geo); // seq: 1(full), 2, 3
+				}
+			}
+		}
+
+		// network expected from first two files
+		network::Geometry expGeo;
+		for (std::size_t nn{0u} ; nn < 60u ; ++nn)
+		{
+			expGeo.accumulateEdgeXform
+				(obss[nn].theEdgeDir, obss[nn].theXform, 16u);
+		}
+
+		// corrupt the last one and leave an (interrupted) temporary file
+		std::filesystem::path const path3{ checkpoint::pathFor(dir, 3u) };
+		{
+			std::fstream fs
+				(path3, std::ios::binary | std::ios::in | std::ios::out);
+			fs.seekp(60);
+			fs.put('X');
+		}
+		{
+			std::filesystem::path tmpPath{ checkpoint::pathFor(dir, 4u) };
+			tmpPath += ".tmp";
+			std::ofstream ofs(tmpPath, std::ios::binary);
+			ofs << "partial";
+		}
+
+		network::Geometry gotGeo;
+		std::size_t const numFiles{ checkpoint::restore(dir, gotGeo) };
+		if (! ((2u == numFiles) && sameEdges(gotGeo, expGeo, oss)))
+		{
+			oss << "Failure of corrupted checkpoint restore test\n";
+			oss << "numFiles: exp: 2 got: " << numFiles << '\n';
+		}
+
+		// a full save (continuing numbering) replaces the older files
+		{
+			checkpoint::Writer writer(dir);
+			writer.saveFull(geo);
+		}
+		std::size_t const numOnc{ checkpoint::checkpointPaths(dir).size() };
+		network::Geometry fullGeo;
+		std::size_t const numFull{ checkpoint::restore(dir, fullGeo) };
+		if (! ( (1u == numOnc)
+			 && checkpoint::checkpointPaths(dir).contains(4u)
+			 && (1u == numFull)
+			 && sameEdges(fullGeo, geo, oss)
+			  ))
+		{
+			oss << "Failure of full save replacement test\n";
+			oss << "numOnc: exp: 1 got: " << numOnc << '\n';
+			oss << "numFull: exp: 1 got: " << numFull << '\n';
+		}
+
+		std::filesystem::remove_all(dir);
+	}
+
+}
+
+//! Check behavior of network checkpoint and restore
+int
+main
+	()
+{
+	int status{ 1 };
+	std::stringstream oss;
+
+	test0(oss);
+	test1(oss);
+	test2(oss);
+	test3(oss);
+
+	if (oss.str().empty()) // Only pass if no errors were encountered
+	{
+		status = 0;
+	}
+	else
+	{
+		// else report error messages
+		std::cerr << "### FAILURE in test file: " << __FILE__ << std::endl;
+		std::cerr << oss.str();
+	}
+	return status;
+}
@@ -0,0 +1,355 @@
+//
+// MIT License
+//
+// Copyright (c) 2024 Stellacore Corporation
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+
+/*! \file
+\brief Unit tests (and example) code for OriNet::ensemble
+*/
+
+
+#include "OriNet/ensemble.hpp"
+
+#include "OriNet/random.hpp" // for simulation support
+#include "OriNet/stat.hpp"
+
+#include <Engabra>
+#include <Rigibra>
+
+#include <algorithm>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <vector>
+
+
+namespace
+{
+	/*! \brief Chain of stations with robust edges from noisy observations
+	 *
+	 * Station transforms are returned in *ptStaXforms (if not null).
+	 */
+	orinet::network::Geometry
+	noisyChain
+		( std::size_t const & numSta
+		, std::size_t const & numObs
+		, double const & sigma
+		, std::map<orinet::network::StaKey, rigibra::Transform>
+			* const & ptStaXforms = nullptr
+		)
+	{
+		using namespace rigibra;
+		using namespace orinet;
+		random::Context ctx(47589u);
+		std::vector<Transform> staXforms;
+		for (std::size_t nSta{0u} ; nSta < numSta ; ++nSta)
+		{
+			staXforms.emplace_back
+				(random::uniformTransform(ctx, { -5., 5. }, { -1., 1. }));
+			if (ptStaXforms)
+			{
+				(*ptStaXforms)[nSta] = staXforms.back();
+			}
+		}
+		network::Geometry geo;
+		for (std::size_t nSta{1u} ; nSta < numSta ; ++nSta)
+		{
+			Transform const & xFrom = staXforms[nSta - 1u];
+			Transform const & xInto = staXforms[nSta];
+			Transform const xIntoWrtFrom{ xInto * inverse(xFrom) };
+			network::EdgeDir const edgeDir{ nSta - 1u, nSta };
+			std::vector<Transform> const obsXforms
+				{ random::noisyTransforms
+					(ctx, xIntoWrtFrom, numObs, 0u, sigma, sigma)
+				};
+			for (Transform const & obsXform : obsXforms)
+			{
+				geo.accumulateEdgeXform(edgeDir, obsXform, numObs);
+			}
+		}
+		return geo;
+	}
+
+	//! Examples for documentation
+	void
+	test0
+		( std::ostream & oss
+		)
+	{
+		using namespace orinet;
+		std::map<network::StaKey, rigibra::Transform> expStaXforms;
+		network::Geometry const geo
+			{ noisyChain(6u, 15u, .01, &expStaXforms) };
+
+		// [DoxyExample01]
+
+		// network with EdgeRobust edges (e.g. from accumulateEdgeXform())
+		// with station 0 held at its known orientation.
+		network::StaKey const staKey0{ 0u };
+		rigibra::Transform const & staXform0 = expStaXforms[staKey0];
+
+		// run bootstrap replicates (in parallel) of the entire chain
+		// spanningEdgeBases(), networkTree(), propagateTransforms()
+		constexpr std::size_t numReps{ 32u };
+		random::Context const ctx(12345u);
+		ensemble::Spread const spread
+			{ ensemble::stationSpread(geo, staKey0, staXform0, numReps, ctx) };
+
+		// spread of replicate results (relative to reference solution)
+		compare::Stats const & stats0 = spread.theStaStats.at(0u);
+		compare::Stats const & stats1 = spread.theStaStats.at(1u);
+		compare::Stats const & stats5 = spread.theStaStats.at(5u);
+		// held station does not vary, and uncertainty accumulates
+		// with distance along the chain from held station.
+
+		// [DoxyExample01]
+
+		std::size_t const numStats{ spread.theStaStats.size() };
+		if (! ((6u == numStats) && (numReps == spread.theNumReps)))
+		{
+			oss << "Failure of stationSpread size test\n";
+			oss << "numStats: exp: 6 got: " << numStats << '\n';
+		}
+
+		if (! (  (numReps == stats0.theNumSamps)
+			  && (numReps == stats5.theNumSamps)
+			  && (stats0.theMaxMagDiff < 1.e-12)
+			  && (0. < stats1.theMedMagDiff)
+			  && (stats1.theMedMagDiff < stats5.theMedMagDiff)
+			  ))
+		{
+			oss << "Failure of stationSpread accumulation test\n";
+			oss << "stats0.max: " << stats0.theMaxMagDiff << '\n';
+			oss << "stats1.med: " << stats1.theMedMagDiff << '\n';
+			oss << "stats5.med: " << stats5.theMedMagDiff << '\n';
+		}
+
+		// reference solution near the (simulated) expected values
+		rigibra::Transform const & gotXform5 = spread.theRefXforms.at(5u);
+		rigibra::Transform const & expXform5 = expStaXforms.at(5u);
+		if (! nearlyEquals(gotXform5, expXform5, .1))
+		{
+			oss << "Failure of stationSpread reference test\n";
+			oss << "exp: " << expXform5 << '\n';
+			oss << "got: " << gotXform5 << '\n';
+		}
+	}
+
+	//! Check ensemble independent of thread count and scaled with noise
+	void
+	test1
+		( std::ostream & oss
+		)
+	{
+		using namespace orinet;
+		std::map<network::StaKey, rigibra::Transform> expStaXforms;
+		network::Geometry const geoA
+			{ noisyChain(8u, 11u, .01, &expStaXforms) };
+		network::Geometry const geoB{ noisyChain(8u, 11u, .04) };
+		rigibra::Transform const & staXform0 = expStaXforms[0u];
+		constexpr std::size_t numReps{ 24u };
+		random::Context const ctx(7u);
+
+		std::vector<std::map<network::StaKey, rigibra::Transform> > repsA1;
+		std::vector<std::map<network::StaKey, rigibra::Transform> > repsA4;
+		ensemble::Spread const spreadA1
+			{ ensemble::stationSpread
+				(geoA, 0u, staXform0, numReps, ctx, 1u, &repsA1)
+			};
+		ensemble::Spread const spreadA4
+			{ ensemble::stationSpread
+				(geoA, 0u, staXform0, numReps, ctx, 4u, &repsA4)
+			};
+		ensemble::Spread const spreadB
+			{ ensemble::stationSpread(geoB, 0u, staXform0, numReps, ctx) };
+
+		// replicates depend only on replicate index (not threads)
+		bool same{ (numReps == repsA1.size()) && (numReps == repsA4.size()) };
+		for (std::size_t nRep{0u} ; same && (nRep < numReps) ; ++nRep)
+		{
+			for (std::pair<network::StaKey const, rigibra::Transform>
+				const & staXform : repsA1[nRep])
+			{
+				same &= nearlyEquals
+					(staXform.second, repsA4[nRep].at(staXform.first), 0.);
+			}
+		}
+		double const medA1{ spreadA1.theStaStats.at(7u).theMedMagDiff };
+		double const medA4{ spreadA4.theStaStats.at(7u).theMedMagDiff };
+		if (! (same && (medA1 == medA4)))
+		{
+			oss << "Failure of stationSpread thread independence test\n";
+			oss << "medA1: " << medA1 << '\n';
+			oss << "medA4: " << medA4 << '\n';
+		}
+
+		// same observation pattern with larger noise has larger spread
+		double const medB{ spreadB.theStaStats.at(7u).theMedMagDiff };
+		double const ratio{ medB / medA1 };
+		if (! ((2. < ratio) && (ratio < 8.)))
+		{
+			oss << "Failure of stationSpread noise scaling test\n";
+			oss << "medA: " << medA1 << '\n';
+			oss << "medB: " << medB << '\n';
+			oss << "ratio: exp: 4 got: " << ratio << '\n';
+		}
+	}
+
+	//! Check resampling of tracked values
+	void
+	test2
+		( std::ostream & oss
+		)
+	{
+		using namespace orinet;
+		std::vector<double> const values{ 5., 1., 4., 2., 3., 2., 7. };
+		stat::track::Values tracker(values.size());
+		tracker.insertMany(values.cbegin(), values.cend());
+
+		random::Context ctx(3u);
+		stat::track::Values const resamp{ tracker.resampled(ctx.generator()) };
+		bool okay{ values.size() == resamp.size() };
+		// resampled collection (still sorted) values are from original
+		double const med{ resamp.median() };
+		std::vector<double>::const_iterator const itFind
+			{ std::find(values.cbegin(), values.cend(), med) };
+		okay &= (values.cend() != itFind);
+		okay &= (1. <= med) && (med <= 7.);
+
+		// resampling of a constant collection reproduces it
+		stat::track::Transforms xTracker(5u);
+		rigibra::Transform const xform
+			{ random::uniformTransform(ctx, { -5., 5. }, { -1., 1. }) };
+		for (std::size_t nn{0u} ; nn < 5u ; ++nn)
+		{
+			xTracker.insert(xform);
+		}
+		stat::track::Transforms const xResamp
+			{ xTracker.resampled(ctx.generator()) };
+		okay &= (xTracker.size() == xResamp.size());
+		okay &= nearlyEquals(xResamp.median(), xTracker.median(), 1.e-12);
+
+		stat::track::Values const empty
+			{ stat::track::Values(0u).resampled(ctx.generator()) };
+		okay &= (0u == empty.size());
+
+		if (! okay)
+		{
+			oss << "Failure of tracker resampled test\n";
+			oss << "resamp.size: " << resamp.size() << '\n';
+			oss << "resamp.median: " << med << '\n';
+			oss << "xResamp.size: " << xResamp.size() << '\n';
+		}
+	}
+
+	//! Check joint (timed) and marginal (untimed) edge resampling
+	void
+	test3
+		( std::ostream & oss
+		)
+	{
+		using namespace orinet;
+		random::Context ctx(47u);
+		rigibra::Attitude const att
+			{ random::uniformTransform(ctx, { -5., 5. }, { -1., 1. }).theAtt };
+
+		// observations with (perfectly) correlated location components
+		constexpr std::size_t numObs{ 5u };
+		std::vector<rigibra::Transform> xforms;
+		for (std::size_t nn{0u} ; nn < numObs ; ++nn)
+		{
+			double const val{ (double)nn };
+			engabra::g3::Vector const loc{ val, val, val };
+			xforms.emplace_back(rigibra::Transform{ loc, att });
+		}
+		network::EdgeDir const edgeDir{ 1u, 2u };
+		network::EdgeRobust untimed(edgeDir, xforms[0], numObs);
+		network::EdgeRobust timed
+			(edgeDir, xforms[0], 0., numObs, stat::track::Forgetting{});
+		for (std::size_t nn{1u} ; nn < numObs ; ++nn)
+		{
+			untimed.accumulateXform(xforms[nn]);
+			timed.accumulateXform(xforms[nn], (double)nn);
+		}
+
+		// fraction of replicate medians on the observation diagonal
+		auto const diagFrac
+			{ [&ctx] (network::EdgeRobust const & edge)
+				{
+					constexpr std::size_t numReps{ 64u };
+					std::size_t numDiag{ 0u };
+					for (std::size_t nRep{0u} ; nRep < numReps ; ++nRep)
+					{
+						engabra::g3::Vector const loc
+							{ edge.resampledInstance(ctx.generator())
+								->xform().theLoc
+							};
+						if ((loc[0] == loc[1]) && (loc[1] == loc[2]))
+						{
+							++numDiag;
+						}
+					}
+					return (double(numDiag) / double(numReps));
+				}
+			};
+
+		// whole observations are drawn - components stay together
+		double const gotTimed{ diagFrac(timed) };
+		// limitation: marginal draws combine different observations
+		double const gotUntimed{ diagFrac(untimed) };
+		if (! ((1. == gotTimed) && (gotUntimed < 1.)))
+		{
+			oss << "Failure of joint/marginal resampledInstance test\n";
+			oss << "exp: timed: 1 untimed: < 1\n";
+			oss << "got: timed: " << gotTimed
+				<< " untimed: " << gotUntimed << '\n';
+		}
+	}
+
+}
+
+//! Check behavior of bootstrap ensemble estimation
+int
+main
+	()
+{
+	int status{ 1 };
+	std::stringstream oss;
+
+	test0(oss);
+	test1(oss);
+	test2(oss);
+	test3(oss);
+
+	if (oss.str().empty()) // Only pass if no errors were encountered
+	{
+		status = 0;
+	}
+	else
+	{
+		// else report error messages
+		std::cerr << "### FAILURE in test file: " << __FILE__ << std::endl;
+		std::cerr << oss.str();
+	}
+	return status;
+}
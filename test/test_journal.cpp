@@ -0,0 +1,514 @@
+//
+// MIT License
+//
+// Copyright (c) 2024 Stellacore Corporation
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+
+/*! \file
+\brief Unit tests (and example) code for OriNet::journal
+*/
+
+
+#include "OriNet/journal.hpp"
+
+#include "OriNet/random.hpp" // for simulation support
+
+#include <Engabra>
+#include <Rigibra>
+
+#include <cmath>
+#include <cstddef>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <utility>
+#include <vector>
+
+
+namespace
+{
+	//! Simulated observation
+	struct Obs
+	{
+		orinet::network::EdgeDir theEdgeDir;
+		rigibra::Transform theXform;
+		double theTau;
+	};
+
+	//! Noisy observations (in both directions) for a few station pairs
+	std::vector<Obs>
+	simObservations
+		( std::size_t const & numObs
+		, bool const & useTime
+		)
+	{
+		using namespace engabra::g3;
+		using namespace rigibra;
+		using orinet::network::EdgeDir;
+		orinet::random::Context ctx(71830462u);
+
+		constexpr std::size_t numSta{ 7u };
+		std::vector<Transform> expXforms;
+		for (std::size_t nn{0u} ; nn < numSta ; ++nn)
+		{
+			expXforms.emplace_back
+				(orinet::random::uniformTransform
+					(ctx, { -5., 5. }, { -1., 1. }));
+		}
+
+		std::vector<Obs> obss;
+		for (std::size_t nn{0u} ; nn < numObs ; ++nn)
+		{
+			std::size_t const from{ (3u * nn) % numSta };
+			std::size_t const into{ (from + 1u + (nn % 2u)) % numSta };
+			Transform const expIntoWrtFrom
+				{ expXforms[into] * inverse(expXforms[from]) };
+			Transform const noise
+				{ orinet::random::uniformTransform
+					(ctx, { -.01, .01 }, { -.001, .001 })
+				};
+			double tau{ engabra::g3::null<double>() };
+			if (useTime)
+			{
+				tau = .5 * (double)nn;
+			}
+			obss.emplace_back
+				(Obs{ EdgeDir{ from, into }, noise * expIntoWrtFrom, tau });
+		}
+		return obss;
+	}
+
+	//! Location for temporary journal files
+	std::filesystem::path
+	tmpPath
+		( std::string const & name
+		)
+	{
+		std::filesystem::path const path
+			{ std::filesystem::temp_directory_path() / name };
+		std::filesystem::remove(path);
+		return path;
+	}
+
+	//! Network from sequential accumulation (of values as held in journal)
+	orinet::network::Geometry
+	sequentialGeometry
+		( std::vector<Obs> const & obss
+		, std::size_t const & reserveSize
+		, orinet::stat::track::Forgetting const & forgetting = {}
+		)
+	{
+		using namespace orinet::network;
+		Geometry geo;
+		for (Obs const & obs : obss)
+		{
+			orinet::journal::Record const record
+				{ orinet::journal::Record::from
+					(obs.theEdgeDir, obs.theXform, obs.theTau)
+				};
+
+			// accumulate in direction of edge (from first observation)
+			EdgeDir const & useDir = obs.theEdgeDir;
+			rigibra::Transform useXform{ record.xform() };
+			std::shared_ptr<EdgeRobust> const ptEdge
+				{ std::dynamic_pointer_cast<EdgeRobust>(geo.edge(useDir)) };
+			if (ptEdge && (EdgeDir::Reverse
+				== ptEdge->edgeDir().compareTo(useDir)))
+			{
+				useXform = rigibra::inverse(useXform);
+			}
+
+			if (! ptEdge)
+			{
+				if (record.isTimed())
+				{
+					geo.insertEdge
+						( std::make_shared<EdgeRobust>
+							( useDir, useXform, record.theTau
+							, reserveSize, forgetting
+							)
+						);
+				}
+				else
+				{
+					std::shared_ptr<EdgeRobust> const ptNew
+						{ std::make_shared<EdgeRobust>
+							(useDir, useXform, reserveSize)
+						};
+					ptNew->theForgetting = forgetting;
+					geo.insertEdge(ptNew);
+				}
+			}
+			else
+			if (record.isTimed())
+			{
+				ptEdge->accumulateXform(useXform, record.theTau);
+			}
+			else
+			{
+				ptEdge->accumulateXform(useXform);
+			}
+		}
+		return geo;
+	}
+
+	//! Check that edges of gotGeo match those of expGeo
+	void
+	checkGeometry
+		( std::ostream & oss
+		, orinet::network::Geometry const & gotGeo
+		, orinet::network::Geometry const & expGeo
+		, std::vector<Obs> const & obss
+		, std::string const & tname
+		)
+	{
+		using namespace orinet::network;
+		constexpr double tol{ 64. * std::numeric_limits<double>::epsilon() };
+		for (Obs const & obs : obss)
+		{
+			std::shared_ptr<EdgeRobust> const ptGot
+				{ std::dynamic_pointer_cast<EdgeRobust>
+					(gotGeo.edge(obs.theEdgeDir))
+				};
+			std::shared_ptr<EdgeRobust> const ptExp
+				{ std::dynamic_pointer_cast<EdgeRobust>
+					(expGeo.edge(obs.theEdgeDir))
+				};
+			bool okay{ ptGot && ptExp };
+			if (okay)
+			{
+				okay
+					=  (EdgeDir::Forward
+						== ptExp->edgeDir().compareTo(ptGot->edgeDir()))
+					&& (ptExp->theXformTracker.size()
+						== ptGot->theXformTracker.size())
+					&& (ptExp->theTimedXforms.size()
+						== ptGot->theTimedXforms.size())
+					&& nearlyEquals(ptGot->xform(), ptExp->xform(), tol)
+					;
+			}
+			if (! okay)
+			{
+				oss << "Failure of replay edge test: " << tname << '\n';
+				oss << "edgeDir: " << obs.theEdgeDir << '\n';
+				if (ptGot && ptExp)
+				{
+					oss << "exp: " << ptExp->xform() << '\n';
+					oss << "got: " << ptGot->xform() << '\n';
+					oss << "expSize: " << ptExp->theXformTracker.size() << '\n';
+					oss << "gotSize: " << ptGot->theXformTracker.size() << '\n';
+				}
+				break;
+			}
+		}
+	}
+
+	//! Append observation to journal
+	void
+	append
+		( orinet::journal::Writer & writer
+		, Obs const & obs
+		)
+	{
+		writer.append(obs.theEdgeDir, obs.theXform, obs.theTau);
+	}
+
+	//! Examples for documentation
+	void
+	test0
+		( std::ostream & oss
+		)
+	{
+		std::vector<Obs> const obss{ simObservations(100u, false) };
+		std::filesystem::path const path{ tmpPath("test_journal_0.onj") };
+		constexpr std::size_t reserveSize{ 64u };
+
+		// [DoxyExample01]
+
+		// record observations (e.g. as they are accumulated into network)
+		{
+			orinet::journal::Writer writer(path);
+			for (Obs const & obs : obss)
+			{
+				writer.append(obs.theEdgeDir, obs.theXform);
+			}
+		} // closes file
+
+		// ... later - rebuild network from journal
+		orinet::network::Geometry gotGeo;
+		std::size_t const numApplied
+			{ orinet::journal::replay(path, gotGeo, reserveSize) };
+
+		// [DoxyExample01]
+
+		if (! (obss.size() == numApplied))
+		{
+			oss << "Failure of replay numApplied test\n";
+			oss << "exp: " << obss.size() << '\n';
+			oss << "got: " << numApplied << '\n';
+		}
+
+		orinet::network::Geometry const expGeo
+			{ sequentialGeometry(obss, reserveSize) };
+		checkGeometry(oss, gotGeo, expGeo, obss, "untimed");
+
+		std::filesystem::remove(path);
+	}
+
+	//! Check bulk loading against individual insertion
+	void
+	test1
+		( std::ostream & oss
+		)
+	{
+		using namespace orinet;
+		std::vector<Obs> const obss{ simObservations(300u, true) };
+
+		// tracker bulk insertion
+		stat::track::Transforms expTrack(obss.size());
+		std::vector<rigibra::Transform> xforms;
+		for (Obs const & obs : obss)
+		{
+			expTrack.insert(obs.theXform);
+			xforms.emplace_back(obs.theXform);
+		}
+		stat::track::Transforms gotTrack(obss.size());
+		gotTrack.insert(xforms[0]);
+		gotTrack.insertMany(xforms.cbegin() + 1u, xforms.cend());
+		if (! ( (expTrack.size() == gotTrack.size())
+			 && nearlyEquals(gotTrack.median(), expTrack.median())
+			  ))
+		{
+			oss << "Failure of tracker insertMany test\n";
+			oss << "exp: " << expTrack.median() << '\n';
+			oss << "got: " << gotTrack.median() << '\n';
+		}
+
+		// timed bulk accumulation (with forgetting) on a single edge
+		stat::track::Forgetting forgetting{};
+		forgetting.theDecayTime = 20.;
+		forgetting.theMaxSize = 50u;
+		network::EdgeDir const edgeDir{ 3u, 4u };
+		network::EdgeRobust expEdge
+			(edgeDir, xforms[0], 0., obss.size(), forgetting);
+		network::EdgeRobust gotEdge
+			(edgeDir, xforms[0], 0., obss.size(), forgetting);
+		std::vector<std::pair<double, rigibra::Transform> > timedXforms;
+		for (std::size_t nn{1u} ; nn < xforms.size() ; ++nn)
+		{
+			double const tau{ (double)nn };
+			expEdge.accumulateXform(xforms[nn], tau);
+			timedXforms.emplace_back(tau, xforms[nn]);
+			if (0u == (nn % 97u)) // load in a few batches
+			{
+				gotEdge.accumulateTimedXforms
+					(timedXforms.cbegin(), timedXforms.cend());
+				timedXforms.clear();
+			}
+		}
+		gotEdge.accumulateTimedXforms(timedXforms.cbegin(), timedXforms.cend());
+		if (! ( (expEdge.theTimedXforms.size() == gotEdge.theTimedXforms.size())
+			 && (expEdge.theXformTracker.size()
+				== gotEdge.theXformTracker.size())
+			 && nearlyEquals(gotEdge.xform(), expEdge.xform())
+			  ))
+		{
+			oss << "Failure of accumulateTimedXforms test\n";
+			oss << "expSize: " << expEdge.theTimedXforms.size() << '\n';
+			oss << "gotSize: " << gotEdge.theTimedXforms.size() << '\n';
+			oss << "exp: " << expEdge.xform() << '\n';
+			oss << "got: " << gotEdge.xform() << '\n';
+		}
+	}
+
+	//! Check reopening, torn writes and corrupted chunks
+	void
+	test2
+		( std::ostream & oss
+		)
+	{
+		using namespace orinet;
+		std::vector<Obs> const obss{ simObservations(50u, true) };
+		std::filesystem::path const path{ tmpPath("test_journal_2.onj") };
+		constexpr std::size_t recsPerIndex{ 8u };
+
+		// write in two sessions (second reopens and appends)
+		constexpr std::size_t numFirst{ 21u };
+		{
+			journal::Writer writer(path, recsPerIndex);
+			for (std::size_t nn{0u} ; nn < numFirst ; ++nn)
+			{
+				append(writer, obss[nn]);
+			}
+		}
+		{
+			// simulate interrupted write (partial trailing record)
+			std::ofstream ofs(path, std::ios::binary | std::ios::app);
+			ofs << "partial";
+		}
+		std::size_t gotSize{ 0u };
+		{
+			journal::Writer writer(path, 1000u); // size from existing file
+			for (std::size_t nn{numFirst} ; nn < obss.size() ; ++nn)
+			{
+				append(writer, obss[nn]);
+			}
+			gotSize = writer.size();
+			if (! writer.isValid())
+			{
+				oss << "Failure of reopened writer isValid test\n";
+			}
+		}
+
+		std::size_t numBad{ 0u };
+		std::vector<journal::Record> const records
+			{ journal::readRecords(path, 0u, &numBad) };
+		bool okay
+			{  (obss.size() == gotSize)
+			&& (obss.size() == records.size())
+			&& (0u == numBad)
+			};
+		for (std::size_t nn{0u} ; okay && (nn < records.size()) ; ++nn)
+		{
+			journal::Record const expRec
+				{ journal::Record::from
+					(obss[nn].theEdgeDir, obss[nn].theXform, obss[nn].theTau)
+				};
+			okay = (0 == std::memcmp(&expRec, &(records[nn]), sizeof(expRec)));
+		}
+		if (! okay)
+		{
+			oss << "Failure of reopen/append readRecords test\n";
+			oss << "exp: " << obss.size() << '\n';
+			oss << "gotSize: " << gotSize << '\n';
+			oss << "got: " << records.size() << '\n';
+			oss << "numBad: " << numBad << '\n';
+		}
+
+		// corrupt a record in the second chunk
+		{
+			std::fstream fs
+				(path, std::ios::binary | std::ios::in | std::ios::out);
+			fs.seekp
+				( sizeof(journal::FileHeader)
+				+ recsPerIndex * sizeof(journal::Record)
+				+ sizeof(journal::IndexBlock)
+				+ 3u * sizeof(journal::Record)
+				+ offsetof(journal::Record, theLoc)
+				);
+			double const bad{ 12345. };
+			fs.write(reinterpret_cast<char const *>(&bad), sizeof(bad));
+		}
+		std::vector<journal::Record> const goodRecords
+			{ journal::readRecords(path, 0u, &numBad) };
+		if (! ( (1u == numBad)
+			 && ((obss.size() - recsPerIndex) == goodRecords.size())
+			  ))
+		{
+			oss << "Failure of corrupted chunk test\n";
+			oss << "numBad: " << numBad << '\n';
+			oss << "exp: " << (obss.size() - recsPerIndex) << '\n';
+			oss << "got: " << goodRecords.size() << '\n';
+		}
+
+		std::filesystem::remove(path);
+	}
+
+	//! Check timed replay (with forgetting) and thread independence
+	void
+	test3
+		( std::ostream & oss
+		)
+	{
+		using namespace orinet;
+		std::vector<Obs> const obss{ simObservations(2000u, true) };
+		std::filesystem::path const path{ tmpPath("test_journal_3.onj") };
+		constexpr std::size_t reserveSize{ 256u };
+		stat::track::Forgetting forgetting{};
+		forgetting.theDecayTime = 100.;
+		forgetting.theMaxSize = 200u;
+
+		// prefix already in network (replay accumulates into it)
+		constexpr std::size_t numPrior{ 30u };
+		std::vector<Obs> const priorObss
+			(obss.cbegin(), obss.cbegin() + numPrior);
+		{
+			journal::Writer writer(path, 64u);
+			for (std::size_t nn{numPrior} ; nn < obss.size() ; ++nn)
+			{
+				append(writer, obss[nn]);
+			}
+		}
+
+		network::Geometry const expGeo
+			{ sequentialGeometry(obss, reserveSize, forgetting) };
+		for (std::size_t const numThreads : { 1u, 4u })
+		{
+			network::Geometry gotGeo
+				{ sequentialGeometry(priorObss, reserveSize, forgetting) };
+			std::size_t const numApplied
+				{ journal::replay
+					(path, gotGeo, reserveSize, forgetting, numThreads)
+				};
+			if (! ((obss.size() - numPrior) == numApplied))
+			{
+				oss << "Failure of timed replay numApplied test\n";
+				oss << "numThreads: " << numThreads << '\n';
+			}
+			checkGeometry
+				( oss, gotGeo, expGeo, obss
+				, "timed numThreads: " + std::to_string(numThreads)
+				);
+		}
+
+		std::filesystem::remove(path);
+	}
+
+}
+
+//! Check behavior of observation journal
+int
+main
+	()
+{
+	int status{ 1 };
+	std::stringstream oss;
+
+	test0(oss);
+	test1(oss);
+	test2(oss);
+	test3(oss);
+
+	if (oss.str().empty()) // Only pass if no errors were encountered
+	{
+		status = 0;
+	}
+	else
+	{
+		// else report error messages
+		std::cerr << "### FAILURE in test file: " << __FILE__ << std::endl;
+		std::cerr << oss.str();
+	}
+	return status;
+}
@@ -0,0 +1,230 @@
+//
+// MIT License
+//
+// Copyright (c) 2024 Stellacore Corporation
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+
+/*! \file
+\brief Unit tests (and example) code for OriNet::mc (Monte-Carlo studies)
+*/
+
+
+#include "OriNet/monteCarlo.hpp"
+
+#include "OriNet/compare.hpp"
+#include "OriNet/random.hpp"
+#include "OriNet/stat.hpp"
+
+#include <Engabra>
+#include <Rigibra>
+
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <vector>
+
+
+namespace
+{
+	//! Examples for documentation
+	void
+	test0
+		( std::ostream & oss
+		)
+	{
+		// [DoxyExample01]
+
+		// study grid: statistics of differences for each sigmaLoc value
+		std::vector<double> const sigmaLocs{ .01, .02, .04, .08 };
+		constexpr std::size_t numReps{ 16u }; // replicates for each cell
+
+		// compute (mergeable) statistics for one replicate of one cell
+		auto const taskFunc
+			{ [&sigmaLocs]
+				( orinet::stat::Summary * const ptSummary
+				, std::size_t const cellNdx
+				, std::size_t const // repNdx
+				, orinet::random::Context & ctx
+				)
+				{
+					using orinet::random::uniformTransform;
+					rigibra::Transform const xBase
+						{ uniformTransform(ctx, { -10., 10. }) };
+					std::vector<rigibra::Transform> const xSamps
+						{ orinet::random::noisyTransforms
+							(ctx, xBase, 8u, 0u, sigmaLocs[cellNdx], 0.)
+						};
+					for (rigibra::Transform const & xSamp : xSamps)
+					{
+						using orinet::compare::maxMagResultDifference;
+						ptSummary->add
+							(maxMagResultDifference(xSamp, xBase, false));
+					}
+				}
+			};
+
+		// evaluate all cells (and replicates) using all hardware threads
+		orinet::random::Context const ctx(8675309u);
+		std::vector<orinet::stat::Summary> const cellStats
+			{ orinet::mc::cellResults<orinet::stat::Summary>
+				(sigmaLocs.size(), numReps, taskFunc, ctx)
+			};
+
+		// save results in binary columnar format
+		orinet::mc::Columns cols;
+		std::vector<double> means;
+		for (orinet::stat::Summary const & cellStat : cellStats)
+		{
+			means.emplace_back(cellStat.mean());
+		}
+		cols.addColumn("sigmaLoc", sigmaLocs);
+		cols.addColumn("maxMagMean", means);
+		std::ostringstream ostrm; // e.g. std::ofstream(..., binary)
+		cols.write(ostrm);
+
+		// [DoxyExample01]
+
+		// same result with a single thread
+		std::vector<orinet::stat::Summary> const cellStats1
+			{ orinet::mc::cellResults<orinet::stat::Summary>
+				(sigmaLocs.size(), numReps, taskFunc, ctx, 1u)
+			};
+		bool same{ cellStats1.size() == cellStats.size() };
+		for (std::size_t nn{0u} ; same && (nn < cellStats.size()) ; ++nn)
+		{
+			same = (cellStats1[nn].mean() == cellStats[nn].mean())
+				&& (cellStats1[nn].variance() == cellStats[nn].variance())
+				&& (cellStats1[nn].count() == (8u * numReps));
+		}
+		if (! same)
+		{
+			oss << "Failure of thread count independence test\n";
+		}
+
+		// statistics grow with sigmaLoc
+		bool increasing{ true };
+		for (std::size_t nn{1u} ; nn < cellStats.size() ; ++nn)
+		{
+			increasing &= (cellStats[nn-1u].mean() < cellStats[nn].mean());
+		}
+		if (! increasing)
+		{
+			oss << "Failure of cell result trend test\n";
+		}
+
+		// columns can be read back
+		std::istringstream istrm(ostrm.str());
+		orinet::mc::Columns const gotCols{ orinet::mc::Columns::read(istrm) };
+		if (! ( gotCols.isValid()
+			&& (gotCols.theNames == cols.theNames)
+			&& (gotCols.theValues == cols.theValues)
+			))
+		{
+			oss << "Failure of columnar write/read test\n";
+		}
+
+		// corrupt sizes (e.g. huge row count) are rejected on read
+		std::string badData{ ostrm.str() };
+		std::uint64_t const badNumRows{ std::uint64_t{ 1u } << 60u };
+		std::memcpy
+			(badData.data() + 16u, &badNumRows, sizeof(badNumRows));
+		std::istringstream badStrm(badData);
+		orinet::mc::Columns const badCols
+			{ orinet::mc::Columns::read(badStrm) };
+		if (badCols.isValid())
+		{
+			oss << "Failure of corrupt columnar read test\n";
+		}
+	}
+
+	//! Check merging of summary statistics
+	void
+	test1
+		( std::ostream & oss
+		)
+	{
+		std::mt19937 gen(12345u);
+		std::normal_distribution<> dist(5., 2.);
+
+		orinet::stat::Summary all;
+		orinet::stat::Summary partA;
+		orinet::stat::Summary partB;
+		for (std::size_t nn{0u} ; nn < 1000u ; ++nn)
+		{
+			double const value{ dist(gen) };
+			all.add(value);
+			if (nn < 300u)
+			{
+				partA.add(value);
+			}
+			else
+			{
+				partB.add(value);
+			}
+		}
+		orinet::stat::Summary merged;
+		merged.merge(partA);
+		merged.merge(partB);
+
+		constexpr double tol{ 1.e-12 };
+		using engabra::g3::nearlyEquals;
+		if (! ( (all.count() == merged.count())
+			&& nearlyEquals(all.mean(), merged.mean(), tol)
+			&& nearlyEquals(all.variance(), merged.variance(), tol)
+			&& (all.min() == merged.min())
+			&& (all.max() == merged.max())
+			))
+		{
+			oss << "Failure of Summary merge test\n";
+			oss << "exp: " << all.mean() << ' ' << all.variance() << '\n';
+			oss << "got: " << merged.mean() << ' ' << merged.variance()
+				<< '\n';
+		}
+	}
+
+}
+
+//! Check behavior of NS
+int
+main
+	()
+{
+	int status{ 1 };
+	std::stringstream oss;
+
+	test0(oss);
+	test1(oss);
+
+	if (oss.str().empty()) // Only pass if no errors were encountered
+	{
+		status = 0;
+	}
+	else
+	{
+		// else report error messages
+		std::cerr << "### FAILURE in test file: " << __FILE__ << std::endl;
+		std::cerr << oss.str();
+	}
+	return status;
+}
@@ -30,6 +30,7 @@
 
 #include "OriNet/network.hpp"
 
+#include "OriNet/compare.hpp"
 #include "OriNet/random.hpp"
 
 #include <Engabra>
@@ -38,6 +39,7 @@
 #include <cmath>
 #include <iostream>
 #include <limits>
+#include <map>
 #include <set>
 #include <sstream>
 #include <string>
@@ -329,6 +331,323 @@ namespace
 		// [DoxyExample01]
 	}
 
+	//! Check forgetting of stale observations in robust edges
+	void
+	test3
+		( std::ostream & oss
+		)
+	{
+		using namespace orinet::network;
+		using namespace rigibra;
+		using namespace engabra::g3;
+
+		// relationship changes part way through the observation sequence
+		Transform const xOld{ Vector{ 1., 2., 3. }, identity<Attitude>() };
+		Transform const xNew
+			{ Vector{ 1.5, 2., 3. }, Attitude{ PhysAngle{ .25*e12 } } };
+
+		// observations older than about 3 decay times are discarded
+		orinet::stat::track::Forgetting const forgetting
+			{ .theDecayTime = 1.
+			, .theMinWeight = 1./20.
+			};
+		constexpr std::size_t reserveSize{ 64u };
+		constexpr double tauDelta{ 1./8. };
+		EdgeRobust edge(EdgeDir{ 7u, 9u }, xOld, 0., reserveSize, forgetting);
+		double tau{ 0. };
+		for (std::size_t nn{1u} ; nn < 80u ; ++nn)
+		{
+			tau += tauDelta;
+			edge.accumulateXform(xOld, tau);
+		}
+		for (std::size_t nn{0u} ; nn < 40u ; ++nn)
+		{
+			tau += tauDelta;
+			edge.accumulateXform(xNew, tau);
+		}
+
+		// only recent observations should remain
+		std::size_t const maxSize
+			{ static_cast<std::size_t>(forgetting.maxAge() / tauDelta) + 1u };
+		std::size_t const gotSize{ edge.theXformTracker.size() };
+		if (! ((gotSize <= maxSize) && (gotSize == edge.theTimedXforms.size())))
+		{
+			oss << "Failure of forgetting tracker size test\n";
+			oss << "exp: (at most) " << maxSize << '\n';
+			oss << "got: " << gotSize << '\n';
+		}
+
+		// and the estimate should follow the changed relationship
+		Transform const & expXform = xNew;
+		Transform const gotXform{ edge.xform() };
+		if (! nearlyEquals(gotXform, expXform))
+		{
+			oss << "Failure of forgetting median test\n";
+			oss << "exp: " << expXform << '\n';
+			oss << "got: " << gotXform << '\n';
+		}
+
+		// size limit applies independent of age
+		orinet::stat::track::Forgetting const keepFew{ .theMaxSize = 5u };
+		EdgeRobust edgeFew(EdgeDir{ 7u, 9u }, xOld, 0., 8u, keepFew);
+		for (std::size_t nn{1u} ; nn < 20u ; ++nn)
+		{
+			edgeFew.accumulateXform(xNew, static_cast<double>(nn));
+		}
+		if (! (5u == edgeFew.theXformTracker.size()))
+		{
+			oss << "Failure of forgetting maxSize test\n";
+			oss << "exp: " << 5u << '\n';
+			oss << "got: " << edgeFew.theXformTracker.size() << '\n';
+		}
+	}
+
+	//! Check level by level (batch) propagation with traversal one
+	void
+	test4
+		( std::ostream & oss
+		)
+	{
+		using namespace orinet::network;
+		using namespace rigibra;
+		using namespace engabra::g3;
+
+		// random tree: each station attached to an earlier one
+		constexpr std::size_t numSta{ 3000u };
+		orinet::random::Context ctx(73205161u);
+		std::vector<Transform> expStas;
+		expStas.reserve(numSta);
+		Geometry treeGeo;
+		for (std::size_t intoKey{0u} ; intoKey < numSta ; ++intoKey)
+		{
+			expStas.emplace_back
+				(orinet::random::uniformTransform(ctx, { -50., 100. }));
+			if (0u < intoKey)
+			{
+				using orinet::random::distinctIndices;
+				StaKey const fromKey
+					{ distinctIndices(ctx, intoKey, 1u).front() };
+				// alternate edge directions (to include reversed edges)
+				EdgeDir edgeDir{ fromKey, intoKey };
+				Transform xform
+					{ expStas[intoKey] * inverse(expStas[fromKey]) };
+				if (1u == (intoKey % 2u))
+				{
+					edgeDir = EdgeDir{ intoKey, fromKey };
+					xform = inverse(xform);
+				}
+				treeGeo.insertEdge
+					(std::make_shared<EdgeOri>(edgeDir, xform, .001));
+			}
+		}
+
+		constexpr StaKey staKey0{ 17u };
+		std::map<StaKey, Transform> const expXforms
+			{ treeGeo.propagateTransforms(staKey0, expStas[staKey0]) };
+		std::map<StaKey, Transform> const gotXforms1
+			{ treeGeo.propagateTransformsByLevel
+				(staKey0, expStas[staKey0], 1u)
+			};
+		std::map<StaKey, Transform> const gotXforms4
+			{ treeGeo.propagateTransformsByLevel
+				(staKey0, expStas[staKey0], 4u)
+			};
+
+		bool okay
+			{  (numSta == expXforms.size())
+			&& (numSta == gotXforms1.size())
+			&& (numSta == gotXforms4.size())
+			};
+		double maxMag{ 0. };
+		// rounding differs (matrix vs spinor) and accumulates with depth
+		constexpr double tol{ 8192. * std::numeric_limits<double>::epsilon() };
+		for (std::size_t key{0u} ; okay && (key < numSta) ; ++key)
+		{
+			Transform const & expXform = expXforms.at(key);
+			Transform const & gotXform1 = gotXforms1.at(key);
+			Transform const & gotXform4 = gotXforms4.at(key);
+			okay = orinet::compare::similarResult
+					(gotXform1, expXform, true, tol, &maxMag)
+				&& nearlyEquals(gotXform1, gotXform4);
+		}
+		if (! okay)
+		{
+			oss << "Failure of propagateTransformsByLevel test\n";
+			oss << "exp size: " << expXforms.size() << '\n';
+			oss << "got size: " << gotXforms1.size() << '\n';
+			oss << "maxMag: " << maxMag << '\n';
+		}
+	}
+
+	//! Check path information produced during propagation
+	void
+	test5
+		( std::ostream & oss
+		)
+	{
+		using namespace orinet::network;
+		using namespace rigibra;
+		using namespace engabra::g3;
+
+		// small tree: 10 -> 11 -> 12, 10 -> 13, (14 -> 13 reversed)
+		Transform const xform{ Vector{ 1., 0., 0. }, identity<Attitude>() };
+		Geometry treeGeo;
+		treeGeo.insertEdge
+			(std::make_shared<EdgeOri>(EdgeDir{ 10u, 11u }, xform, .5));
+		treeGeo.insertEdge
+			(std::make_shared<EdgeOri>(EdgeDir{ 11u, 12u }, xform, .25));
+		treeGeo.insertEdge
+			(std::make_shared<EdgeOri>(EdgeDir{ 10u, 13u }, xform, 1.));
+		treeGeo.insertEdge
+			(std::make_shared<EdgeOri>(EdgeDir{ 14u, 13u }, xform, .125));
+
+		// expected: parent, depth, cumulative weight
+		struct Expect
+		{
+			StaKey theParentKey;
+			std::size_t theDepth;
+			double theCumWeight;
+		};
+		std::map<StaKey, Expect> const expMetrics
+			{ { 10u, Expect{ sNullKey, 0u, 0. } }
+			, { 11u, Expect{ 10u, 1u, .5 } }
+			, { 12u, Expect{ 11u, 2u, .75 } }
+			, { 13u, Expect{ 10u, 1u, 1. } }
+			, { 14u, Expect{ 13u, 2u, 1.125 } }
+			};
+
+		PathMetrics gotMetricsA;
+		PathMetrics gotMetricsB;
+		(void)treeGeo.propagateTransforms(10u, xform, &gotMetricsA);
+		(void)treeGeo.propagateTransformsByLevel(10u, xform, 1u, &gotMetricsB);
+
+		for (PathMetrics const & gotMetrics : { gotMetricsA, gotMetricsB })
+		{
+			bool okay{ expMetrics.size() == gotMetrics.size() };
+			for (std::size_t nn{0u} ; okay && (nn < gotMetrics.size()) ; ++nn)
+			{
+				Expect const & exp = expMetrics.at(gotMetrics.theStaKeys[nn]);
+				std::size_t const & parentNdx = gotMetrics.theParentNdxs[nn];
+				double const & gotCumWeight = gotMetrics.theCumWeights[nn];
+				okay = (exp.theParentKey == gotMetrics.parentKey(nn))
+					&& (exp.theDepth == gotMetrics.theDepths[nn])
+					&& nearlyEquals(exp.theCumWeight, gotCumWeight)
+					// parents precede children
+					&& (  (PathMetrics::sNullNdx == parentNdx)
+					   || (parentNdx < nn)
+					   );
+			}
+			if (! okay)
+			{
+				oss << "Failure of propagation path metrics test\n";
+				oss << "exp size: " << expMetrics.size() << '\n';
+				oss << "got size: " << gotMetrics.size() << '\n';
+			}
+		}
+	}
+
+
+	//! Check station orders and renumbered networks
+	void
+	test6
+		( std::ostream & oss
+		)
+	{
+		using namespace orinet::network;
+		using namespace rigibra;
+		using namespace engabra::g3;
+
+		// chain of stations with (scrambled) keys inserted in random order
+		constexpr std::size_t numSta{ 200u };
+		orinet::random::Context ctx(36019475u);
+		std::vector<StaKey> chainKeys;
+		for (std::size_t nn{0u} ; nn < numSta ; ++nn)
+		{
+			chainKeys.emplace_back((nn * 73u) % numSta + 1000u);
+		}
+		std::vector<Transform> expStas;
+		for (std::size_t nn{0u} ; nn < numSta ; ++nn)
+		{
+			Vector const loc{ 10. * static_cast<double>(nn), 0., 0. };
+			Transform const noise
+				{ orinet::random::uniformTransform(ctx, { -1., 1. }) };
+			expStas.emplace_back(Transform{ loc, noise.theAtt });
+		}
+		std::vector<std::size_t> const edgeNdxs
+			{ orinet::random::distinctIndices(ctx, numSta - 1u, numSta - 1u) };
+		Geometry geo;
+		for (std::size_t const & nn : edgeNdxs)
+		{
+			Transform const xform{ expStas[nn + 1u] * inverse(expStas[nn]) };
+			geo.insertEdge
+				( std::make_shared<EdgeOri>
+					(EdgeDir{ chainKeys[nn], chainKeys[nn + 1u] }, xform, .1)
+				);
+		}
+
+		// [DoxyExampleRenumber]
+
+		// station order following network connectivity (or positions)
+		StaKey const staKey0{ chainKeys.front() };
+		std::vector<StaKey> const bfsOrder{ geo.breadthFirstOrder(staKey0) };
+		std::vector<StaKey> const rcmOrder{ geo.cuthillMcKeeOrder() };
+		std::map<StaKey, Transform> const staXforms
+			{ geo.propagateTransforms(staKey0, expStas.front()) };
+		std::vector<StaKey> const sfcOrder{ spaceFillingOrder(staXforms) };
+
+		// same network content with graph storage in that order
+		Geometry const bfsGeo{ geo.renumbered(bfsOrder) };
+
+		// [DoxyExampleRenumber]
+
+		// all orders are permutations of station keys (here along chain)
+		std::set<StaKey> const allKeys(chainKeys.cbegin(), chainKeys.cend());
+		for (std::vector<StaKey> const & order
+			: { bfsOrder, rcmOrder, sfcOrder })
+		{
+			bool okay
+				{  (numSta == order.size())
+				&& (allKeys == std::set<StaKey>(order.cbegin(), order.cend()))
+				};
+			for (std::size_t nn{1u} ; okay && (nn < order.size()) ; ++nn)
+			{
+				EdgeDir const edgeDir{ order[nn - 1u], order[nn] };
+				okay = (nullptr != geo.edge(edgeDir));
+			}
+			if (! okay)
+			{
+				oss << "Failure of station order test\n";
+				oss << "exp size: " << numSta << '\n';
+				oss << "got size: " << order.size() << '\n';
+			}
+		}
+		if (! (staKey0 == bfsOrder.front()))
+		{
+			oss << "Failure of breadthFirstOrder start test\n";
+		}
+
+		// renumbered network has vertices in order and same results
+		std::map<StaKey, Transform> const gotXforms
+			{ bfsGeo.propagateTransforms(staKey0, expStas.front()) };
+		bool okay
+			{  (bfsOrder == bfsGeo.allContents().theStaKeys)
+			&& (geo.sizeEdges() == bfsGeo.sizeEdges())
+			&& (staXforms.size() == gotXforms.size())
+			};
+		for (std::map<StaKey, Transform>::value_type const & staXform
+			: staXforms)
+		{
+			okay = okay && gotXforms.contains(staXform.first)
+				&& nearlyEquals(gotXforms.at(staXform.first), staXform.second);
+		}
+		if (! okay)
+		{
+			oss << "Failure of renumbered network test\n";
+			oss << "exp size: " << staXforms.size() << '\n';
+			oss << "got size: " << gotXforms.size() << '\n';
+		}
+	}
+
 }
 
 //! Check behavior of NS
@@ -342,6 +661,10 @@ main
 	test0(oss);
 	test1(oss);
 	test2(oss);
+	test3(oss);
+	test4(oss);
+	test5(oss);
+	test6(oss);
 
 	if (oss.str().empty()) // Only pass if no errors were encountered
 	{
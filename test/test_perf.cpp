@@ -0,0 +1,185 @@
+//
+// MIT License
+//
+// Copyright (c) 2024 Stellacore Corporation
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+
+/*! \file
+\brief Unit tests (and example) code for OriNet::perf
+*/
+
+
+#include "OriNet/perf.hpp"
+
+#include <cstdint>
+#include <iostream>
+#include <sstream>
+
+
+namespace
+{
+	//! Examples for documentation
+	void
+	test0
+		( std::ostream & oss
+		)
+	{
+		// [DoxyExample01]
+
+		// accumulate latency statistics for phases of an update
+		using orinet::perf::Phase;
+		orinet::perf::Latencies latencies;
+		for (std::size_t nFrame{0u} ; nFrame < 100u ; ++nFrame)
+		{
+			{
+				// elapsed time recorded when timer goes out of scope
+				orinet::perf::ScopedTimer const timer
+					(&latencies, Phase::Propagation);
+				// ... perform work for this phase
+			}
+			latencies.recordAllocations(nFrame); // e.g. from alloc counter
+		}
+
+		// statistics for phase of interest
+		orinet::perf::Latencies const stats{ latencies.snapshot() };
+		orinet::perf::Histogram const & hist
+			= stats.phaseNanos(Phase::Propagation);
+		std::uint64_t const p99{ hist.percentile(.99) };
+		// all phases: e.g. std::cout << stats.infoString() << '\n';
+
+		// [DoxyExample01]
+
+		std::uint64_t const expCount{ 100u };
+		std::uint64_t const gotCount{ hist.count() };
+		if (! ((gotCount == expCount) && (! (hist.max() < p99))))
+		{
+			oss << "Failure of phase latency recording test\n";
+			oss << "exp: count: " << expCount << '\n';
+			oss << "got: count: " << gotCount << '\n';
+			oss << "p99: " << p99 << "  max: " << hist.max() << '\n';
+		}
+
+		// allocation values are small enough to be recorded exactly
+		orinet::perf::Histogram const & allocs = stats.frameAllocs();
+		std::uint64_t const expP50{ 49u };
+		std::uint64_t const gotP50{ allocs.percentile(.5) };
+		if (! (gotP50 == expP50))
+		{
+			oss << "Failure of allocation percentile test\n";
+			oss << "exp: " << expP50 << '\n';
+			oss << "got: " << gotP50 << '\n';
+		}
+
+		// reset removes all values
+		latencies.reset();
+		if (! (0u == latencies.phaseNanos(Phase::Propagation).count()))
+		{
+			oss << "Failure of reset test\n";
+		}
+	}
+
+	//! Check histogram bucket relationships and resolution
+	void
+	test1
+		( std::ostream & oss
+		)
+	{
+		using orinet::perf::Histogram;
+
+		// buckets are contiguous and cover full range of values
+		std::size_t errCount{ 0u };
+		for (std::size_t ndx{1u} ; ndx < Histogram::sNumBuckets ; ++ndx)
+		{
+			std::uint64_t const prevUpper{ Histogram::bucketUpper(ndx - 1u) };
+			std::uint64_t const currLower{ Histogram::bucketLower(ndx) };
+			bool const okayGap{ (prevUpper + 1u) == currLower };
+			bool const okayLower{ ndx == Histogram::bucketIndex(currLower) };
+			bool const okayUpper
+				{ ndx == Histogram::bucketIndex(Histogram::bucketUpper(ndx)) };
+			if (! (okayGap && okayLower && okayUpper))
+			{
+				++errCount;
+			}
+		}
+		std::uint64_t const maxValue{ ~std::uint64_t{ 0u } };
+		std::size_t const lastNdx{ Histogram::sNumBuckets - 1u };
+		std::uint64_t const lastUpper{ Histogram::bucketUpper(lastNdx) };
+		if (! ((0u == errCount) && (maxValue == lastUpper)))
+		{
+			oss << "Failure of bucket contiguity test\n";
+			oss << "errCount: " << errCount << '\n';
+			oss << "lastUpper: " << lastUpper << '\n';
+		}
+
+		// percentiles are accurate to within bucket resolution
+		Histogram hist;
+		for (std::uint64_t value{1u} ; ! (1000000u < value) ; ++value)
+		{
+			hist.record(value);
+		}
+		constexpr double relTol{ 1. / double(Histogram::sNumHalf) };
+		double const expP99{ 990000. };
+		double const gotP99{ static_cast<double>(hist.percentile(.99)) };
+		double const relErr{ (gotP99 - expP99) / expP99 };
+		if (! ((0. <= relErr) && (relErr < relTol)))
+		{
+			oss << "Failure of percentile resolution test\n";
+			oss << "exp: " << expP99 << '\n';
+			oss << "got: " << gotP99 << '\n';
+			oss << "relErr: " << relErr << '\n';
+		}
+
+		// extremes are exact
+		if (! ((1u == hist.min()) && (1000000u == hist.max())
+			&& (1000000u == hist.percentile(1.))))
+		{
+			oss << "Failure of min/max test\n";
+			oss << "min: " << hist.min() << '\n';
+			oss << "max: " << hist.max() << '\n';
+		}
+	}
+
+}
+
+//! Check behavior of NS
+int
+main
+	()
+{
+	int status{ 1 };
+	std::stringstream oss;
+
+	test0(oss);
+	test1(oss);
+
+	if (oss.str().empty()) // Only pass if no errors were encountered
+	{
+		status = 0;
+	}
+	else
+	{
+		// else report error messages
+		std::cerr << "### FAILURE in test file: " << __FILE__ << std::endl;
+		std::cerr << oss.str();
+	}
+	return status;
+}
@@ -0,0 +1,275 @@
+//
+// MIT License
+//
+// Copyright (c) 2024 Stellacore Corporation
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+
+/*! \file
+\brief Unit tests (and example) code for OriNet::random::Context
+*/
+
+
+#include "OriNet/random.hpp"
+#include "OriNet/sim.hpp"
+
+#include <Engabra>
+#include <Rigibra>
+
+#include <iostream>
+#include <map>
+#include <numeric>
+#include <random>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+
+namespace
+{
+	//! True if all transforms are the same (to within roundoff)
+	inline
+	bool
+	sameXforms
+		( std::vector<rigibra::Transform> const & xforms1
+		, std::vector<rigibra::Transform> const & xforms2
+		)
+	{
+		bool same{ xforms1.size() == xforms2.size() };
+		for (std::size_t nn{0u} ; same && (nn < xforms1.size()) ; ++nn)
+		{
+			rigibra::Transform const & xfm1 = xforms1[nn];
+			rigibra::Transform const & xfm2 = xforms2[nn];
+			same = rigibra::nearlyEquals(xfm1, xfm2);
+		}
+		return same;
+	}
+
+	//! Examples for documentation
+	void
+	test0
+		( std::ostream & oss
+		)
+	{
+		using namespace rigibra;
+		Transform const expXform
+			{ engabra::g3::Vector{ 1., 2., 3. }
+			, Attitude{ PhysAngle{ engabra::g3::BiVector{ .3, .2, .1 } } }
+			};
+
+		// [DoxyExample01]
+
+		// all (pseudo)random state is held by the context
+		orinet::random::Context const ctxMain(12345u);
+
+		// generate data in parallel - one (independent) stream per item
+		constexpr std::size_t numItems{ 8u };
+		std::vector<std::vector<Transform> > itemXforms(numItems);
+		std::vector<std::thread> threads;
+		for (std::size_t nItem{0u} ; nItem < numItems ; ++nItem)
+		{
+			threads.emplace_back
+				( [&ctxMain, &itemXforms, &expXform, nItem] ()
+				{
+					orinet::random::Context ctx{ ctxMain.stream(nItem) };
+					itemXforms[nItem] = orinet::random::noisyTransforms
+						(ctx, expXform, 10u, 2u, .125, .0625);
+				}
+				);
+		}
+		for (std::thread & thread : threads)
+		{
+			thread.join();
+		}
+
+		// [DoxyExample01]
+
+		// results are same as for sequential generation
+		bool okay{ true };
+		for (std::size_t nItem{0u} ; nItem < numItems ; ++nItem)
+		{
+			orinet::random::Context ctx{ ctxMain.stream(nItem) };
+			std::vector<Transform> const expXforms
+				{ orinet::random::noisyTransforms
+					(ctx, expXform, 10u, 2u, .125, .0625)
+				};
+			okay &= sameXforms(itemXforms[nItem], expXforms);
+		}
+		if (! okay)
+		{
+			oss << "Failure of parallel stream reproducibility test\n";
+		}
+
+		// different streams provide different values
+		if (sameXforms(itemXforms[0], itemXforms[1]))
+		{
+			oss << "Failure of stream independence test\n";
+		}
+	}
+
+	//! Check context seeding and splitting properties
+	void
+	test1
+		( std::ostream & oss
+		)
+	{
+		// context seeded as a std::mt19937 is
+		{
+			std::mt19937 expGen(36742620u);
+			orinet::random::Context ctx(36742620u);
+			std::mt19937::result_type const expValue{ expGen() };
+			std::mt19937::result_type const gotValue{ ctx.generator()() };
+			if (! (gotValue == expValue))
+			{
+				oss << "Failure of Context seeding test\n";
+				oss << "exp: " << expValue << '\n';
+				oss << "got: " << gotValue << '\n';
+			}
+		}
+
+		// streams depend only on seed and stream id (not on usage)
+		{
+			orinet::random::Context ctxA(7u);
+			orinet::random::Context const ctxB(7u);
+			(void)orinet::random::directionVector(ctxA); // advance state
+			orinet::random::Context ctxA3{ ctxA.stream(3u) };
+			orinet::random::Context ctxB3{ ctxB.stream(3u) };
+			engabra::g3::Vector const gotDir
+				{ orinet::random::directionVector(ctxA3) };
+			engabra::g3::Vector const expDir
+				{ orinet::random::directionVector(ctxB3) };
+			if (! engabra::g3::nearlyEquals(gotDir, expDir))
+			{
+				oss << "Failure of stream determinism test\n";
+				oss << "exp: " << expDir << '\n';
+				oss << "got: " << gotDir << '\n';
+			}
+		}
+
+		// simulation with explicit context is reproducible
+		{
+			orinet::random::Context ctx1(99u);
+			orinet::random::Context ctx2(99u);
+			std::pair<double, double> const locMinMax{ -10., 10. };
+			std::vector<rigibra::Transform> const stas1
+				{ orinet::sim::randomStations(ctx1, 5u, locMinMax) };
+			std::vector<rigibra::Transform> const stas2
+				{ orinet::sim::randomStations(ctx2, 5u, locMinMax) };
+			if (! sameXforms(stas1, stas2))
+			{
+				oss << "Failure of randomStations reproducibility test\n";
+			}
+		}
+	}
+
+	//! Check parallel backsight simulation
+	void
+	test2
+		( std::ostream & oss
+		)
+	{
+		orinet::random::Context ctxSta(5u);
+		std::pair<double, double> const locMinMax{ -100., 100. };
+		std::vector<rigibra::Transform> const expStas
+			{ orinet::sim::randomStations(ctxSta, 200u, locMinMax) };
+
+		// same result for any number of threads
+		orinet::random::Context const ctx(31u);
+		constexpr std::size_t numBack{ 4u };
+		using orinet::sim::backsightTransformsParallel;
+		std::map<orinet::sim::NdxPair, std::vector<rigibra::Transform> >
+			const pairXforms1
+			{ backsightTransformsParallel
+				( ctx, expStas, numBack, 5u, 1u, locMinMax
+				, { -1., 1. }, .125, .005, 1u
+				)
+			};
+		std::map<orinet::sim::NdxPair, std::vector<rigibra::Transform> >
+			const pairXforms4
+			{ backsightTransformsParallel
+				( ctx, expStas, numBack, 5u, 1u, locMinMax
+				, { -1., 1. }, .125, .005, 4u
+				)
+			};
+
+		bool same{ pairXforms1.size() == pairXforms4.size() };
+		bool okayPairs{ true };
+		using Iter = std::map<orinet::sim::NdxPair
+			, std::vector<rigibra::Transform> >::const_iterator;
+		Iter it4{ pairXforms4.cbegin() };
+		for (Iter it1{pairXforms1.cbegin()} ; same
+			&& (pairXforms1.cend() != it1) ; ++it1, ++it4)
+		{
+			same = (it1->first == it4->first)
+				&& sameXforms(it1->second, it4->second);
+			okayPairs &= (it1->first.first < it1->first.second)
+				&& (6u == it1->second.size());
+		}
+
+		// (distinct) backsights to up to numBack previous stations
+		std::size_t const expSize{ 0u + 1u + 2u + 3u + (196u * numBack) };
+		if (! (same && okayPairs && (expSize == pairXforms1.size())))
+		{
+			oss << "Failure of backsightTransformsParallel test\n";
+			oss << "same: " << same << '\n';
+			oss << "okayPairs: " << okayPairs << '\n';
+			oss << "exp: " << expSize << '\n';
+			oss << "got: " << pairXforms1.size() << '\n';
+		}
+
+		// sampling without replacement
+		orinet::random::Context ctxNdx(3u);
+		std::vector<std::size_t> const ndxs
+			{ orinet::random::distinctIndices(ctxNdx, 10u, 10u) };
+		std::vector<std::size_t> expNdxs(10u);
+		std::iota(expNdxs.begin(), expNdxs.end(), 0u);
+		if (! (expNdxs == ndxs))
+		{
+			oss << "Failure of distinctIndices full range test\n";
+		}
+	}
+
+}
+
+//! Check behavior of NS
+int
+main
+	()
+{
+	int status{ 1 };
+	std::stringstream oss;
+
+	test0(oss);
+	test1(oss);
+	test2(oss);
+
+	if (oss.str().empty()) // Only pass if no errors were encountered
+	{
+		status = 0;
+	}
+	else
+	{
+		// else report error messages
+		std::cerr << "### FAILURE in test file: " << __FILE__ << std::endl;
+		std::cerr << oss.str();
+	}
+	return status;
+}
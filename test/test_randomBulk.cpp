@@ -0,0 +1,371 @@
+//
+// MIT License
+//
+// Copyright (c) 2024 Stellacore Corporation
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+
+/*! \file
+\brief Unit tests (and example) code for OriNet random bulk generation
+*/
+
+
+#include "OriNet/randomBulk.hpp"
+
+#include "OriNet/parallel.hpp"
+
+#include <Engabra>
+#include <Rigibra>
+
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+
+
+namespace
+{
+	//! Examples for documentation
+	void
+	test0
+		( std::ostream & oss
+		)
+	{
+		using namespace rigibra;
+		Transform const expXform
+			{ engabra::g3::Vector{ 1., 2., 3. }
+			, Attitude{ PhysAngle{ engabra::g3::BiVector{ .3, .2, .1 } } }
+			};
+
+		// [DoxyExample01]
+
+		// values are determined by (seed, stream, element index) only
+		orinet::random::CounterSource const source
+			{ .theSeed = 20240901u
+			, .theStream = 0u
+			, .theFirstIndex = 0u
+			};
+
+		// noise model as used with noisyTransform()
+		orinet::random::NoiseModel const noise
+			{ .theLocSigma = 1./8.
+			, .theAngSigma = 5./1024.
+			, .theProbErr = .10
+			, .theLocMinMax = { -10., 10. }
+			, .theAngMinMax = { -1., 1. }
+			};
+
+		// fill structure-of-array storage (using all hardware threads)
+		constexpr std::size_t numXforms{ 100000u };
+		orinet::random::TransformArrays xformArrays(numXforms);
+		orinet::random::fillNoisyTransforms
+			(&xformArrays, expXform, noise, source);
+
+		// individual transforms are available as needed
+		Transform const xform0{ xformArrays.transform(0u) };
+
+		// [DoxyExample01]
+
+		if (! isValid(xform0))
+		{
+			oss << "Failure of valid bulk transform test\n";
+			oss << "xform0: " << xform0 << '\n';
+		}
+
+		// same result with single thread
+		orinet::random::TransformArrays xformArrays1(numXforms);
+		orinet::random::fillNoisyTransforms
+			(&xformArrays1, expXform, noise, source, 1u);
+		bool same{ true };
+		for (std::size_t kk{0u} ; kk < 3u ; ++kk)
+		{
+			same &= (xformArrays1.theLocs[kk] == xformArrays.theLocs[kk]);
+			same &= (xformArrays1.theAngs[kk] == xformArrays.theAngs[kk]);
+		}
+		if (! same)
+		{
+			oss << "Failure of thread count independence test\n";
+		}
+	}
+
+	//! Check Philox implementation against published known answers
+	void
+	test1
+		( std::ostream & oss
+		)
+	{
+		using orinet::random::Philox4x32;
+
+		// Known answer test values from Random123 distribution
+		struct Kat
+		{
+			Philox4x32::Counter const theCtr;
+			Philox4x32::Key const theKey;
+			Philox4x32::Counter const theExp;
+		};
+		std::vector<Kat> const kats
+			{ Kat
+				{ { 0u, 0u, 0u, 0u }
+				, { 0u, 0u }
+				, { 0x6627e8d5u, 0xe169c58du, 0xbc57ac4cu, 0x9b00dbd8u }
+				}
+			, Kat
+				{ { 0xffffffffu, 0xffffffffu, 0xffffffffu, 0xffffffffu }
+				, { 0xffffffffu, 0xffffffffu }
+				, { 0x408f276du, 0x41c83b0eu, 0xa20bc7c6u, 0x6d5451fdu }
+				}
+			, Kat
+				{ { 0x243f6a88u, 0x85a308d3u, 0x13198a2eu, 0x03707344u }
+				, { 0xa4093822u, 0x299f31d0u }
+				, { 0xd16cfe09u, 0x94fdccebu, 0x5001e420u, 0x24126ea1u }
+				}
+			};
+		for (Kat const & kat : kats)
+		{
+			Philox4x32::Counter const got
+				{ Philox4x32::block(kat.theCtr, kat.theKey) };
+			if (! (got == kat.theExp))
+			{
+				oss << "Failure of Philox4x32 known answer test\n";
+				oss << std::hex;
+				oss << "exp: " << kat.theExp[0] << ' ' << kat.theExp[1]
+					<< ' ' << kat.theExp[2] << ' ' << kat.theExp[3] << '\n';
+				oss << "got: " << got[0] << ' ' << got[1]
+					<< ' ' << got[2] << ' ' << got[3] << '\n';
+				oss << std::dec;
+			}
+		}
+
+		// lane (SIMD friendly) generation same as single block
+		orinet::random::CounterSource const source
+			{ .theSeed = 0x299f31d0a4093822u
+			, .theStream = 0x13198a2eu
+			, .theFirstIndex = 0x85a308d3243f6a88u
+			};
+		std::array<double, orinet::random::sBulkLanes> u0;
+		std::array<double, orinet::random::sBulkLanes> u1;
+		orinet::random::philoxUniformLanes
+			(source, 0u, 1u, 0x03707344u, u0.data(), u1.data());
+		Philox4x32::Counter const blk
+			{ Philox4x32::block
+				( { 0x243f6a88u, 0x85a308d3u, 0x13198a2eu, 0x03707344u }
+				, { 0xa4093822u, 0x299f31d0u }
+				)
+			};
+		constexpr double scale{ 1. / 9007199254740992. }; // 2^-53
+		std::uint64_t const bits0
+			{ ((std::uint64_t{ blk[0] } << 32u) | blk[1]) >> 11u };
+		double const expU0{ (static_cast<double>(bits0) + .5) * scale };
+		if (! (expU0 == u0[0]))
+		{
+			oss << "Failure of lane uniform value test\n";
+			oss << "exp: " << expU0 << '\n';
+			oss << "got: " << u0[0] << '\n';
+		}
+	}
+
+	//! Check distribution properties and index offset consistency
+	void
+	test2
+		( std::ostream & oss
+		)
+	{
+		using namespace rigibra;
+		using engabra::g3::Vector;
+		Transform const expXform
+			{ Vector{ -1., 5., 2. }
+			, Attitude{ PhysAngle{ engabra::g3::BiVector{ -.5, .1, .7 } } }
+			};
+		constexpr double sigmaLoc{ .25 };
+		constexpr double sigmaAng{ .01 };
+
+		constexpr std::size_t numXforms{ 20000u };
+		orinet::random::CounterSource const source{ .theSeed = 17u };
+		orinet::random::TransformArrays xformArrays(numXforms);
+		orinet::random::fillPerturbedTransforms
+			(&xformArrays, expXform, sigmaLoc, sigmaAng, source, 3u);
+
+		// sample mean and deviation of location components
+		double maxMeanErr{ 0. };
+		double maxSigmaErr{ 0. };
+		for (std::size_t kk{0u} ; kk < 3u ; ++kk)
+		{
+			std::vector<double> const & locs = xformArrays.theLocs[kk];
+			double sum{ 0. };
+			double sumSq{ 0. };
+			for (double const & loc : locs)
+			{
+				double const dif{ loc - expXform.theLoc[kk] };
+				sum += dif;
+				sumSq += dif*dif;
+			}
+			double const mean{ sum / double(numXforms) };
+			double const sigma{ std::sqrt(sumSq / double(numXforms)) };
+			maxMeanErr = std::max(maxMeanErr, std::abs(mean));
+			maxSigmaErr = std::max(maxSigmaErr, std::abs(sigma - sigmaLoc));
+		}
+		// few standard errors of mean (sigma/sqrt(N) ~= .002)
+		constexpr double tolMean{ .01 };
+		constexpr double tolSigma{ .01 };
+		if (! ((maxMeanErr < tolMean) && (maxSigmaErr < tolSigma)))
+		{
+			oss << "Failure of perturbed distribution test\n";
+			oss << "maxMeanErr: " << maxMeanErr << '\n';
+			oss << "maxSigmaErr: " << maxSigmaErr << '\n';
+		}
+
+		// later portion generated separately (with index offset) matches
+		constexpr std::size_t numTail{ 1000u };
+		orinet::random::CounterSource const sourceTail
+			{ .theSeed = 17u
+			, .theStream = 0u
+			, .theFirstIndex = numXforms - numTail
+			};
+		orinet::random::TransformArrays tailArrays(numTail);
+		orinet::random::fillPerturbedTransforms
+			(&tailArrays, expXform, sigmaLoc, sigmaAng, sourceTail, 1u);
+		std::vector<double> const expTail
+			( xformArrays.theAngs[2].cend() - numTail
+			, xformArrays.theAngs[2].cend()
+			);
+		if (! (tailArrays.theAngs[2] == expTail))
+		{
+			oss << "Failure of index offset consistency test\n";
+		}
+
+		// fraction of blunders consistent with noise model
+		orinet::random::NoiseModel const noise{ .theProbErr = .25 };
+		std::vector<std::uint8_t> isBlunders;
+		orinet::random::fillNoisyTransforms
+			(&xformArrays, expXform, noise, source, 0u, &isBlunders);
+		std::size_t numBlunder{ 0u };
+		for (std::uint8_t const & isBlunder : isBlunders)
+		{
+			numBlunder += isBlunder;
+		}
+		double const gotFrac{ double(numBlunder) / double(numXforms) };
+		if (! (std::abs(gotFrac - noise.theProbErr) < .02))
+		{
+			oss << "Failure of blunder fraction test\n";
+			oss << "exp: " << noise.theProbErr << '\n';
+			oss << "got: " << gotFrac << '\n';
+		}
+	}
+
+	//! Check exceptions thrown by parallel functions (on any thread)
+	void
+	test3
+		( std::ostream & oss
+		)
+	{
+		using namespace orinet;
+		constexpr std::size_t numItems{ 8u };
+		constexpr std::size_t numThreads{ 4u };
+		constexpr std::size_t minPerRange{ 1u };
+
+		// throw from range on calling thread (last) or on another (first)
+		std::vector<std::size_t> gotThrows;
+		for (std::size_t const & badItem : { numItems - 1u, std::size_t{ 0u } })
+		{
+			try
+			{
+				parallel::forEachRange
+					( numItems
+					, [&badItem] (std::size_t const beg, std::size_t const end)
+						{
+							if ((beg <= badItem) && (badItem < end))
+							{
+								throw std::runtime_error("bad range");
+							}
+						}
+					, numThreads
+					, minPerRange
+					);
+			}
+			catch (std::runtime_error const &)
+			{
+				gotThrows.emplace_back(badItem);
+			}
+		}
+
+		// throw from some thread (unknown which) for dynamic processing
+		std::atomic<std::size_t> numCalls{ 0u };
+		bool gotIndexThrow{ false };
+		try
+		{
+			parallel::forEachIndex
+				( 1024u
+				, [&numCalls] (std::size_t const ndx)
+					{
+						++numCalls;
+						if (3u == ndx)
+						{
+							throw std::runtime_error("bad index");
+						}
+					}
+				, numThreads
+				);
+		}
+		catch (std::runtime_error const &)
+		{
+			gotIndexThrow = true;
+		}
+
+		if (! ((2u == gotThrows.size()) && gotIndexThrow))
+		{
+			oss << "Failure of parallel exception propagation test\n";
+			oss << "exp: range,index throws: 2 1\n";
+			oss << "got: range,index throws: " << gotThrows.size()
+				<< ' ' << gotIndexThrow << '\n';
+			oss << "numCalls: " << numCalls << '\n';
+		}
+	}
+
+}
+
+//! Check behavior of NS
+int
+main
+	()
+{
+	int status{ 1 };
+	std::stringstream oss;
+
+	test0(oss);
+	test1(oss);
+	test2(oss);
+	test3(oss);
+
+	if (oss.str().empty()) // Only pass if no errors were encountered
+	{
+		status = 0;
+	}
+	else
+	{
+		// else report error messages
+		std::cerr << "### FAILURE in test file: " << __FILE__ << std::endl;
+		std::cerr << oss.str();
+	}
+	return status;
+}
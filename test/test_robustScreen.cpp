@@ -0,0 +1,229 @@
+//
+// MIT License
+//
+// Copyright (c) 2024 Stellacore Corporation
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+
+/*! \file
+\brief Unit tests (and example) code for OriNet::robust screening
+*/
+
+
+#include "OriNet/robustScreen.hpp"
+
+#include "OriNet/compare.hpp"
+#include "OriNet/random.hpp" // for simulation support
+#include "OriNet/robust.hpp"
+
+#include <Engabra>
+#include <Rigibra>
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+
+namespace
+{
+	//! Examples for documentation
+	void
+	test0
+		( std::ostream & oss
+		)
+	{
+		using namespace rigibra;
+		using namespace orinet;
+		random::Context ctx(71264930u);
+
+		// simulate many noisy (and some blunderous) candidate transforms
+		Transform const expXform
+			{ random::uniformTransform(ctx, { -10., 10. }) };
+		constexpr std::size_t numMea{ 3000u };
+		constexpr std::size_t numErr{ 1000u };
+		constexpr double sigmaLoc{ 1./100. };
+		constexpr double sigmaAng{ 1./1000. };
+		std::vector<Transform> const xforms
+			{ random::noisyTransforms
+				(ctx, expXform, numMea, numErr, sigmaLoc, sigmaAng)
+			};
+
+		// [DoxyExample01]
+
+		// candidates are screened (in float) with a tolerance that is
+		// well above the measurement noise (but much less than blunders)
+		double const sigmaMag
+			{ random::sigmaMagForSigmaLocAng(sigmaLoc, sigmaAng) };
+		double const maxMagTol{ 10. * sigmaMag };
+		std::size_t numInliers{ 0u };
+		Transform const gotXform
+			{ robust::transformViaScreening
+				(xforms.cbegin(), xforms.cend(), maxMagTol, false, &numInliers)
+			};
+
+		// [DoxyExample01]
+
+		// robust estimate should be (statistically) near expected value
+		double gotMaxMag{ engabra::g3::null<double>() };
+		double const tol{ sigmaMag };
+		bool const okay
+			{ compare::similarResult(gotXform, expXform, false, tol, &gotMaxMag)
+			};
+		if (! okay)
+		{
+			oss << "Failure of transformViaScreening estimate test\n";
+			oss << "exp: " << expXform << '\n';
+			oss << "got: " << gotXform << '\n';
+			oss << "gotMaxMag: " << gotMaxMag << '\n';
+		}
+
+		// nearly all measurements (and few blunders) should be retained
+		if (! ((numMea < (numInliers + numMea/100u))
+			&& (numInliers < (numMea + numErr/100u))))
+		{
+			oss << "Failure of transformViaScreening inlier count test\n";
+			oss << "numMea: " << numMea << '\n';
+			oss << "numInliers: " << numInliers << '\n';
+		}
+	}
+
+	//! Check bulk kernels against the (double) per-transform functions
+	void
+	test1
+		( std::ostream & oss
+		)
+	{
+		using namespace rigibra;
+		using namespace orinet;
+		random::Context ctx(38560217u);
+
+		Transform const refXform
+			{ random::uniformTransform(ctx, { -10., 10. }) };
+		std::vector<Transform> const xforms
+			{ random::noisyTransforms
+				(ctx, refXform, 200u, 50u, 1./10., 1./10.)
+			};
+
+		robust::EffectArrays<double> effectDbls;
+		effectDbls.assign(xforms.cbegin(), xforms.cend());
+		robust::EffectArrays<float> effectFlts;
+		effectFlts.assign(xforms.cbegin(), xforms.cend());
+
+		// median estimate (double) same as from iterator version
+		Transform const expMedian
+			{ robust::transformViaEffect(xforms.cbegin(), xforms.cend()) };
+		Transform const gotMedianDbl{ robust::transformViaEffect(effectDbls) };
+		Transform const gotMedianFlt{ robust::transformViaEffect(effectFlts) };
+		constexpr double tolDbl{ 1.e-12 };
+		constexpr double tolFlt{ 1.e-4 };
+		if (! compare::similarResult(gotMedianDbl, expMedian, false, tolDbl))
+		{
+			oss << "Failure of EffectArrays<double> median test\n";
+		}
+		if (! compare::similarResult(gotMedianFlt, expMedian, false, tolFlt))
+		{
+			oss << "Failure of EffectArrays<float> median test\n";
+		}
+
+		// bulk differences consistent with maxMagResultDifference()
+		for (bool const & normalize : { false, true })
+		{
+			std::vector<double> magDbls;
+			compare::maxMagResultDifferences
+				(&magDbls, effectDbls, refXform, normalize);
+			std::vector<float> magFlts;
+			compare::maxMagResultDifferences
+				(&magFlts, effectFlts, refXform, normalize);
+
+			double maxErrDbl{ 0. };
+			double maxErrFlt{ 0. };
+			for (std::size_t ndx{0u} ; ndx < xforms.size() ; ++ndx)
+			{
+				double const expMag
+					{ compare::maxMagResultDifference
+						(xforms[ndx], refXform, normalize)
+					};
+				double const relScale{ std::max(1., expMag) };
+				maxErrDbl = std::max
+					(maxErrDbl, std::abs(magDbls[ndx] - expMag) / relScale);
+				maxErrFlt = std::max
+					(maxErrFlt, std::abs(magFlts[ndx] - expMag) / relScale);
+			}
+			if (! ((maxErrDbl < tolDbl) && (maxErrFlt < tolFlt)))
+			{
+				oss << "Failure of maxMagResultDifferences test\n";
+				oss << "normalize: " << normalize << '\n';
+				oss << "maxErrDbl: " << maxErrDbl << '\n';
+				oss << "maxErrFlt: " << maxErrFlt << '\n';
+			}
+		}
+
+		// invalid transforms are skipped
+		robust::EffectArrays<float> effects;
+		std::vector<Transform> const withNull
+			{ xforms[0], null<Transform>(), xforms[1] };
+		effects.assign(withNull.cbegin(), withNull.cend());
+		if (! (2u == effects.size()))
+		{
+			oss << "Failure of EffectArrays invalid skip test\n";
+			oss << "exp: " << 2u << '\n';
+			oss << "got: " << effects.size() << '\n';
+		}
+
+		// median of single precision values
+		std::vector<float> values{ 3.f, -1.f, 7.f, 1.f };
+		float const gotValue{ robust::medianOf(values) };
+		float const expValue{ 2.f };
+		if (! (expValue == gotValue))
+		{
+			oss << "Failure of medianOf<float> test\n";
+			oss << "exp: " << expValue << '\n';
+			oss << "got: " << gotValue << '\n';
+		}
+	}
+
+}
+
+//! Check behavior of single precision screening functions
+int
+main
+	()
+{
+	int status{ 1 };
+	std::stringstream oss;
+
+	test0(oss);
+	test1(oss);
+
+	if (oss.str().empty()) // Only pass if no errors were encountered
+	{
+		status = 0;
+	}
+	else
+	{
+		// else report error messages
+		std::cerr << "### FAILURE in test file: " << __FILE__ << std::endl;
+		std::cerr << oss.str();
+	}
+	return status;
+}
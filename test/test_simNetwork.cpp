@@ -0,0 +1,361 @@
+//
+// MIT License
+//
+// Copyright (c) 2024 Stellacore Corporation
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+
+/*! \file
+\brief Unit tests (and example) code for OriNet::sim::NetworkSim
+*/
+
+
+#include "OriNet/simNetwork.hpp"
+
+#include "OriNet/compare.hpp"
+#include "OriNet/networkGeometry.hpp"
+
+#include <Engabra>
+#include <Rigibra>
+
+#include <iostream>
+#include <map>
+#include <numeric>
+#include <sstream>
+#include <vector>
+
+
+namespace
+{
+	//! Number of connected components (via union-find) among stations
+	inline
+	std::size_t
+	numComponents
+		( orinet::sim::NetworkSim const & netSim
+		)
+	{
+		std::vector<std::size_t> parents(netSim.sizeStations());
+		std::iota(parents.begin(), parents.end(), 0u);
+		auto const rootOf
+			{ [&parents] (std::size_t ndx)
+				{
+					while (! (parents[ndx] == ndx))
+					{
+						parents[ndx] = parents[parents[ndx]];
+						ndx = parents[ndx];
+					}
+					return ndx;
+				}
+			};
+		std::size_t numComps{ parents.size() };
+		netSim.forEachEdge
+			( [&] (orinet::sim::NdxPair const & ndxPair)
+			{
+				std::size_t const root1{ rootOf(ndxPair.first) };
+				std::size_t const root2{ rootOf(ndxPair.second) };
+				if (! (root1 == root2))
+				{
+					parents[root1] = root2;
+					--numComps;
+				}
+			}
+			);
+		return numComps;
+	}
+
+	//! Number of edges
+	inline
+	std::size_t
+	numEdges
+		( orinet::sim::NetworkSim const & netSim
+		)
+	{
+		std::size_t count{ 0u };
+		netSim.forEachEdge
+			([&count] (orinet::sim::NdxPair const &) { ++count; });
+		return count;
+	}
+
+	//! Examples for documentation
+	void
+	test0
+		( std::ostream & oss
+		)
+	{
+		// [DoxyExample01]
+
+		// configure simulation
+		using orinet::sim::NetworkSpec;
+		orinet::sim::NetworkSim const netSim
+			( NetworkSpec
+				{ .theTopology = NetworkSpec::SlamSessions
+				, .theNumStas = 120u
+				, .theNumBack = 2u
+				, .theNumSessions = 3u
+				, .theLoopEvery = 5u
+				, .theNumMea = 5u
+				, .theSeed = 12345u
+				}
+			);
+		orinet::random::NoiseModel const noise
+			{ .theLocSigma = 1./100.
+			, .theAngSigma = 1./1000.
+			, .theProbErr = .10
+			};
+
+		// observations are streamed - e.g. directly into a network
+		orinet::network::Geometry netGeo;
+		netSim.forEachObservation
+			( noise
+			, [&netGeo] (orinet::sim::NdxPair const & ndxPair
+				, rigibra::Transform const & xIntoWrtFrom)
+			{
+				orinet::network::EdgeDir const edgeDir
+					{ ndxPair.first, ndxPair.second };
+				netGeo.accumulateEdgeXform(edgeDir, xIntoWrtFrom, 8u);
+			}
+			);
+
+		// expected station orientations are available on demand
+		rigibra::Transform const xSta0{ netSim.stationXform(0u) };
+		std::map<std::size_t, rigibra::Transform> const gotXforms
+			{ netGeo.propagateTransforms(0u, xSta0) };
+
+		// [DoxyExample01]
+
+		std::size_t const expNumEdges{ numEdges(netSim) };
+		std::size_t const gotNumEdges{ netGeo.sizeEdges() };
+		if (! ((netSim.sizeStations() == gotXforms.size())
+			&& (expNumEdges == gotNumEdges)))
+		{
+			oss << "Failure of streamed network size test\n";
+			oss << "exp: " << netSim.sizeStations() << ' ' << expNumEdges
+				<< '\n';
+			oss << "got: " << gotXforms.size() << ' ' << gotNumEdges
+				<< '\n';
+		}
+
+		// propagation through robust edges recovers station orientations
+		double maxErr{ 0. };
+		for (std::map<std::size_t, rigibra::Transform>::value_type
+			const & gotXform : gotXforms)
+		{
+			rigibra::Transform const expXform
+				{ netSim.stationXform(gotXform.first) };
+			constexpr bool useNorm{ false };
+			double const err
+				{ orinet::compare::maxMagResultDifference
+					(gotXform.second, expXform, useNorm)
+				};
+			maxErr = std::max(maxErr, err);
+		}
+		constexpr double tolErr{ 1. }; // empirical: accumulates along paths
+		if (! (maxErr < tolErr))
+		{
+			oss << "Failure of propagated station orientation test\n";
+			oss << "maxErr: " << maxErr << '\n';
+		}
+	}
+
+	//! Check edge counts and connectivity for each topology
+	void
+	test1
+		( std::ostream & oss
+		)
+	{
+		using orinet::sim::NetworkSpec;
+		using orinet::sim::NetworkSim;
+
+		// chain traverse
+		{
+			NetworkSim const netSim
+				(NetworkSpec{ .theTopology = NetworkSpec::Chain
+					, .theNumStas = 50u, .theNumBack = 2u });
+			std::size_t const expEdges{ 1u + 2u*48u };
+			std::size_t const gotEdges{ numEdges(netSim) };
+			if (! ((expEdges == gotEdges) && (1u == numComponents(netSim))))
+			{
+				oss << "Failure of Chain topology test\n";
+				oss << "exp: " << expEdges << '\n';
+				oss << "got: " << gotEdges << '\n';
+			}
+		}
+
+		// grid
+		{
+			NetworkSim const netSim
+				(NetworkSpec{ .theTopology = NetworkSpec::Grid
+					, .theNumStas = 60u, .theGridWidth = 10u });
+			std::size_t const expEdges{ (9u * 6u) + (10u * 5u) };
+			std::size_t const gotEdges{ numEdges(netSim) };
+			if (! ((expEdges == gotEdges) && (1u == numComponents(netSim))))
+			{
+				oss << "Failure of Grid topology test\n";
+				oss << "exp: " << expEdges << '\n';
+				oss << "got: " << gotEdges << '\n';
+			}
+		}
+
+		// random geometric (radius large enough to connect all cells)
+		{
+			NetworkSim const netSim
+				(NetworkSpec{ .theTopology = NetworkSpec::RandomGeometric
+					, .theNumStas = 400u, .theRadius = 2.25 });
+			std::size_t const gotEdges{ numEdges(netSim) };
+			std::size_t const minEdges{ 2u * 400u }; // > 4-neighbor grid
+			if (! ((minEdges < gotEdges) && (1u == numComponents(netSim))))
+			{
+				oss << "Failure of RandomGeometric topology test\n";
+				oss << "gotEdges: " << gotEdges << '\n';
+				oss << "numComps: " << numComponents(netSim) << '\n';
+			}
+		}
+
+		// small world: one edge per lattice edge (rewired or not)
+		{
+			NetworkSim const netSim
+				(NetworkSpec{ .theTopology = NetworkSpec::SmallWorld
+					, .theNumStas = 200u, .theNumNeighbors = 6u
+					, .theRewireProb = .25 });
+			std::size_t const expEdges{ 200u * 3u };
+			std::size_t const gotEdges{ numEdges(netSim) };
+			std::size_t numLong{ 0u };
+			netSim.forEachEdge
+				( [&numLong] (orinet::sim::NdxPair const & ndxPair)
+				{
+					std::size_t const dist{ ndxPair.second - ndxPair.first };
+					if ((3u < dist) && (dist < (200u - 3u)))
+					{
+						++numLong;
+					}
+				}
+				);
+			// about rewireProb * (fraction outside ring neighborhood)
+			bool const okayLong{ (75u < numLong) && (numLong < 225u) };
+			if (! ((expEdges == gotEdges) && okayLong
+				&& (1u == numComponents(netSim))))
+			{
+				oss << "Failure of SmallWorld topology test\n";
+				oss << "exp: " << expEdges << '\n';
+				oss << "got: " << gotEdges << '\n';
+				oss << "numLong: " << numLong << '\n';
+			}
+		}
+
+		// multiple SLAM sessions with loop closures
+		{
+			NetworkSim const netSim
+				(NetworkSpec{ .theTopology = NetworkSpec::SlamSessions
+					, .theNumStas = 90u, .theNumBack = 1u
+					, .theNumSessions = 3u, .theLoopEvery = 10u });
+			// 3 sessions of 30: 29 odometry edges each, 3 closures/session
+			std::size_t const expEdges{ 3u*29u + 2u*3u };
+			std::size_t const gotEdges{ numEdges(netSim) };
+			if (! ((expEdges == gotEdges) && (1u == numComponents(netSim))))
+			{
+				oss << "Failure of SlamSessions topology test\n";
+				oss << "exp: " << expEdges << '\n';
+				oss << "got: " << gotEdges << '\n';
+			}
+		}
+	}
+
+	//! Check that station ranges partition the streamed observations
+	void
+	test2
+		( std::ostream & oss
+		)
+	{
+		using orinet::sim::NetworkSpec;
+		orinet::sim::NetworkSim const netSim
+			( NetworkSpec
+				{ .theTopology = NetworkSpec::SmallWorld
+				, .theNumStas = 100u
+				, .theNumMea = 3u
+				, .theSeed = 7u
+				}
+			);
+		orinet::random::NoiseModel const noise
+			{ .theLocSigma = .1, .theAngSigma = .01, .theProbErr = .2 };
+
+		using ObsVec = std::vector
+			<std::pair<orinet::sim::NdxPair, rigibra::Transform> >;
+		auto const collect
+			{ [&netSim, &noise] (std::size_t beg, std::size_t end)
+				{
+					ObsVec obs;
+					netSim.forEachObservation
+						( noise
+						, [&obs] (orinet::sim::NdxPair const & ndxPair
+							, rigibra::Transform const & xform)
+							{ obs.emplace_back(ndxPair, xform); }
+						, beg, end
+						);
+					return obs;
+				}
+			};
+
+		ObsVec const allObs{ collect(0u, 100u) };
+		ObsVec partObs{ collect(0u, 37u) };
+		ObsVec const tailObs{ collect(37u, 100u) };
+		partObs.insert(partObs.end(), tailObs.cbegin(), tailObs.cend());
+
+		bool same{ allObs.size() == partObs.size() };
+		for (std::size_t nn{0u} ; same && (nn < allObs.size()) ; ++nn)
+		{
+			same = (allObs[nn].first == partObs[nn].first)
+				&& rigibra::nearlyEquals(allObs[nn].second, partObs[nn].second);
+		}
+		std::size_t const expSize{ 3u * 100u * 2u };
+		if (! (same && (expSize == allObs.size())))
+		{
+			oss << "Failure of station range partition test\n";
+			oss << "exp: " << expSize << '\n';
+			oss << "got: " << allObs.size() << ' ' << partObs.size() << '\n';
+		}
+	}
+
+}
+
+//! Check behavior of NS
+int
+main
+	()
+{
+	int status{ 1 };
+	std::stringstream oss;
+
+	test0(oss);
+	test1(oss);
+	test2(oss);
+
+	if (oss.str().empty()) // Only pass if no errors were encountered
+	{
+		status = 0;
+	}
+	else
+	{
+		// else report error messages
+		std::cerr << "### FAILURE in test file: " << __FILE__ << std::endl;
+		std::cerr << oss.str();
+	}
+	return status;
+}
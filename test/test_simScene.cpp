@@ -0,0 +1,231 @@
+//
+// MIT License
+//
+// Copyright (c) 2024 Stellacore Corporation
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+
+/*! \file
+\brief Unit tests (and example) code for OriNet::sim::Scene
+*/
+
+
+#include "OriNet/simScene.hpp"
+
+#include "OriNet/compare.hpp"
+#include "OriNet/networkGeometry.hpp"
+
+#include <Engabra>
+#include <Rigibra>
+
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <vector>
+
+
+namespace
+{
+	//! Examples for documentation
+	void
+	test0
+		( std::ostream & oss
+		)
+	{
+		using namespace orinet;
+
+		// [DoxyExample01]
+
+		// simulate object space features and several moving cameras
+		random::Context ctx(31415u);
+		constexpr std::size_t numFea{ 50u };
+		sim::Scene scene(sim::expFeaXforms(ctx, numFea));
+		scene.addCamera
+			(sim::sCamKey0, std::make_shared<sim::TrajectoryCircle>(2.));
+		scene.addCamera
+			(sim::sCamKey0 + 1u, std::make_shared<sim::TrajectoryLine>());
+
+		// generate batches of frames into reusable buffers
+		constexpr std::size_t numTimes{ 32u };
+		constexpr std::size_t numFeaPerFrame{ 6u };
+		sim::FrameBatch batch;
+		batch.reserve
+			(numTimes * scene.sizeCameras(), numFeaPerFrame, numFea);
+		constexpr double tauBeg{ 0. };
+		constexpr double tauDelta{ 1./32. };
+		random::NoiseModel const camNoise{};
+		scene.fillFrames
+			(ctx, tauBeg, tauDelta, numTimes, numFeaPerFrame, camNoise, &batch);
+
+		// e.g. register each frame as star observations (camera to features)
+		network::Geometry netGeo;
+		std::vector<std::pair<network::StaKey, rigibra::Transform> > hubObs;
+		for (sim::Frame const & frame : batch.theFrames)
+		{
+			hubObs.clear();
+			for (std::vector<sim::Observation>::const_iterator
+				itObs{batch.begin(frame)} ; batch.end(frame) != itObs ; ++itObs)
+			{
+				hubObs.emplace_back(itObs->theFeaKey, itObs->theXformCamWrtFea);
+			}
+			// NOTE: here, all frames of a camera share same hub station
+			netGeo.insertStarObservations(frame.theCamKey, hubObs, 8u);
+		}
+
+		// [DoxyExample01]
+
+		std::size_t const expNumFrames{ numTimes * scene.sizeCameras() };
+		std::size_t const gotNumFrames{ batch.theFrames.size() };
+		std::size_t const expNumObs{ expNumFrames * numFeaPerFrame };
+		std::size_t const gotNumObs{ batch.theObservations.size() };
+		if (! ((expNumFrames == gotNumFrames) && (expNumObs == gotNumObs)))
+		{
+			oss << "Failure of frame batch size test\n";
+			oss << "exp: frames,obs: " << expNumFrames << ' ' << expNumObs
+				<< '\n';
+			oss << "got: frames,obs: " << gotNumFrames << ' ' << gotNumObs
+				<< '\n';
+		}
+
+		if (! (netGeo.sizeVerts() <= (numFea + scene.sizeCameras())))
+		{
+			oss << "Failure of star registration vertex count test\n";
+			oss << "got: " << netGeo.sizeVerts() << '\n';
+		}
+	}
+
+	//! Check observation content, distinctness and reproducibility
+	void
+	test1
+		( std::ostream & oss
+		)
+	{
+		using namespace orinet;
+		using rigibra::Transform;
+
+		constexpr std::size_t numFea{ 20u };
+		random::Context ctxFea(27u);
+		sim::Scene scene(sim::expFeaXforms(ctxFea, numFea));
+		scene.addCamera
+			(sim::sCamKey0, std::make_shared<sim::TrajectoryCircle>());
+		scene.addCamera
+			(sim::sCamKey0 + 5u, std::make_shared<sim::TrajectoryCircle>(3.));
+
+		constexpr std::size_t numTimes{ 10u };
+		constexpr std::size_t numFeaPerFrame{ 7u };
+		random::NoiseModel const camNoise
+			{ .theLocSigma = 1./100.
+			, .theAngSigma = 1./1000.
+			};
+		sim::FrameBatch batch1;
+		random::Context ctx1(99u);
+		scene.fillFrames(ctx1, 0., .25, numTimes, numFeaPerFrame, camNoise
+			, &batch1);
+
+		// each observation consistent with (perturbed) camera orientation
+		// and each frame contains distinct features in increasing order
+		double maxErr{ 0. };
+		bool okayOrder{ true };
+		for (sim::Frame const & frame : batch1.theFrames)
+		{
+			sim::FeaKey prevKey{ 0u };
+			for (std::vector<sim::Observation>::const_iterator
+				itObs{batch1.begin(frame)} ; batch1.end(frame) != itObs
+				; ++itObs)
+			{
+				std::size_t const feaNdx{ itObs->theFeaKey - sim::sFeaKey0 };
+				Transform const & xFeaWrtRef = scene.featureXform(feaNdx);
+				Transform const gotCamWrtRef
+					{ itObs->theXformCamWrtFea * xFeaWrtRef };
+				using orinet::compare::maxMagResultDifference;
+				maxErr = std::max
+					( maxErr
+					, maxMagResultDifference
+						(gotCamWrtRef, frame.theXformCamWrtRef, false)
+					);
+				okayOrder &= (prevKey < itObs->theFeaKey);
+				okayOrder &= (itObs->theCamKey == frame.theCamKey);
+				prevKey = itObs->theFeaKey;
+			}
+		}
+		constexpr double tol{ 1.e-12 };
+		if (! (maxErr < tol))
+		{
+			oss << "Failure of observation consistency test\n";
+			oss << "maxErr: " << maxErr << '\n';
+		}
+		if (! okayOrder)
+		{
+			oss << "Failure of frame observation order test\n";
+		}
+
+		// same seed reproduces same frames (in reused buffer)
+		sim::FrameBatch batch2;
+		random::Context ctx2(99u);
+		scene.fillFrames(ctx2, 0., .25, numTimes, numFeaPerFrame, camNoise
+			, &batch2);
+		sim::Observation const * const ptData{ batch2.theObservations.data() };
+		random::Context ctx3(99u);
+		scene.fillFrames(ctx3, 0., .25, numTimes, numFeaPerFrame, camNoise
+			, &batch2);
+		bool same{ batch1.theObservations.size()
+			== batch2.theObservations.size() };
+		for (std::size_t nn{0u} ; same && (nn < batch2.theObservations.size())
+			; ++nn)
+		{
+			same = (batch1.theObservations[nn].theFeaKey
+				== batch2.theObservations[nn].theFeaKey);
+		}
+		if (! same)
+		{
+			oss << "Failure of reproducible frame generation test\n";
+		}
+		if (! (ptData == batch2.theObservations.data()))
+		{
+			oss << "Failure of buffer reuse test\n";
+		}
+	}
+
+}
+
+//! Check behavior of NS
+int
+main
+	()
+{
+	int status{ 1 };
+	std::stringstream oss;
+
+	test0(oss);
+	test1(oss);
+
+	if (oss.str().empty()) // Only pass if no errors were encountered
+	{
+		status = 0;
+	}
+	else
+	{
+		// else report error messages
+		std::cerr << "### FAILURE in test file: " << __FILE__ << std::endl;
+		std::cerr << oss.str();
+	}
+	return status;
+}
@@ -46,294 +46,25 @@ OriNet is providing continuously updated object space model information.
 
 
 #include "OriNet/OriNet"
+#include "OriNet/alloc.hpp"
 #include "OriNet/compare.hpp"
+#include "OriNet/perf.hpp"
 #include "OriNet/random.hpp"
+#include "OriNet/simScene.hpp"
 
 #include <Engabra>
 #include <Rigibra>
 
+#include <cstdlib>
 #include <iostream>
 #include <map>
-#include <random>
 #include <set>
 #include <sstream>
 #include <vector>
 
 
-namespace sim
-{
-	using CamKey = std::size_t;
-	using FeaKey = std::size_t;
-
-	// use offset values to make visual distinction in diganostic output
-	constexpr FeaKey sFeaKey0{  900 };
-	constexpr CamKey sCamKey0{ 1000 };
-
-	//! Uniformly distributed index into (non-empty) container.
-	inline
-	std::size_t
-	randomIndexInto
-		( std::size_t const & size
-		)
-	{
-		if (! (0u < size))
-		{
-			std::cerr << "FATAL:"
-				" calling randomIndexInto with empty container" << std::endl;
-			exit(1);
-		}
-		static std::mt19937 gen(35364653u);
-		std::uniform_int_distribution<> dist(0u, size-1u);
-		return dist(gen);
-	}
-
-	//! Simulate distribution of random object space features
-	std::map<FeaKey, rigibra::Transform>
-	expFeaXforms
-		( std::size_t const & numFea
-		, double const & pmDist = 10.
-		)
-	{
-		using rigibra::Transform;
-		std::map<FeaKey, Transform> expFeaXforms;
-
-		// simulate object feature body distribution
-		constexpr std::size_t numMea{ 0u }; // no impact here
-		constexpr double locSigma{ 0. }; // no impact here
-		constexpr double angSigma{ 0. }; // no impact here
-		std::pair<double, double> locMinMax{ -pmDist, pmDist };
-		constexpr std::pair<double, double> angMinMax{ -1., 1. };
-
-		// generate a collection of feature orientations
-		std::vector<Transform> const feaXforms
-			{ orinet::random::noisyTransforms
-				( rigibra::identity<Transform>()
-				, numMea, numFea
-				, locSigma, angSigma // unused for 0 measurements
-				, locMinMax, angMinMax
-				)
-			};
-
-		// assign key values to each (arbitrarily)
-		FeaKey feaKey{ sim::sFeaKey0 };
-		for (Transform const & feaXform : feaXforms)
-		{
-			expFeaXforms[feaKey] = feaXform;
-			++feaKey;
-		}
-
-		return expFeaXforms;
-	}
-
-	/*! \brief Produce orientations as a function of time.
-	 *
-	 * Provides orientations which are (pseudo)random perturbations of
-	 * a simple deterministic path.
-	 */
-	struct Trajectory
-	{
-		double const theSpeed{ 1./4. }; // [m/s]
-
-		inline
-		Trajectory
-			( double const & speed
-			)
-			: theSpeed(speed)
-		{ }
-
-		inline
-		virtual
-		~Trajectory
-			() = default;
-
-		//! Orientation at time tau for deterministic trajectory model.
-		inline
-		virtual
-		rigibra::Transform
-		pathOrientation
-			( double const & tau // [s]
-			) const = 0;
-
-		//! Orientation at time tau for deterministic trajectory model.
-		inline
-		rigibra::Transform
-		perturbedOrientation
-			( double const & tau // [s]
-			, orinet::random::NoiseModel const & noise
-			) const
-		{
-			rigibra::Transform xPathWrtRef{ pathOrientation(tau) };
-
-			// determine if return value should be measurement or blunder
-			static std::mt19937 gen(47686779u);
-			std::uniform_real_distribution<> dist(0., 1.);
-			bool const isBlunder{ (dist(gen) < noise.theProbErr) };
-
-			// simulate appropriate type of transform
-			rigibra::Transform xBodyWrtPath;
-			using namespace orinet::random;
-			if (isBlunder)
-			{
-				xBodyWrtPath = uniformTransform
-					(noise.theLocMinMax, noise.theAngMinMax);
-			}
-			else
-			{
-				xBodyWrtPath = perturbedTransform
-					(xPathWrtRef, noise.theLocSigma, noise.theAngSigma);
-			}
-
-			return (xBodyWrtPath * xPathWrtRef);
-		}
-
-	}; // Trajectory
-
-	/*! \brief Trajectory with an underlying linear model
-	 */
-	struct TrajectoryLine : public Trajectory
-	{
-		engabra::g3::Vector const theDir0{ engabra::g3::e1 };
-		engabra::g3::Vector const theStart
-			{ engabra::g3::zero<engabra::g3::Vector>() };
-		rigibra::Attitude const theAtt0
-			{ rigibra::identity<rigibra::Attitude>() };
-
-		inline
-		TrajectoryLine
-			( double const & speed = 1./4.
-			)
-			: Trajectory(speed)
-		{ }
-
-		//! Orientation at time tau for deterministic trajectory model.
-		inline
-		virtual
-		rigibra::Transform
-		pathOrientation
-			( double const & tau // [s]
-			) const
-		{
-			using namespace engabra::g3;
-			Vector const loc{ theStart + theSpeed*tau*theDir0 };
-			using namespace rigibra;
-			return Transform{ loc, theAtt0 };
-		} 
-
-	}; // TrajectoryLine
-
-	/*! \brief Trajectory with an underlying circular model
-	 */
-	struct TrajectoryCircle : public Trajectory
-	{
-		double const theRadius{ engabra::g3::null<double> () };
-		engabra::g3::Vector const theCenter
-			{ engabra::g3::zero<engabra::g3::Vector>() };
-		engabra::g3::Vector const thePlaneDir1{ engabra::g3::e1 };
-		engabra::g3::Vector const thePlaneDir2{ engabra::g3::e2 };
-		rigibra::Attitude const theAtt0
-			{ rigibra::identity<rigibra::Attitude>() };
-
-		engabra::g3::BiVector const thePlaneDir{ engabra::g3::e12 };
-
-		inline
-		TrajectoryCircle
-			( double const & radius
-				= 1.
-			, engabra::g3::Vector const & center
-				= engabra::g3::zero<engabra::g3::Vector>()
-			, engabra::g3::Vector const & planeDir1
-				= engabra::g3::e1
-			, engabra::g3::Vector const & planeDir2
-				= engabra::g3::e2
-			, double const & speed
-				= 1./4.
-			)
-			: Trajectory(speed)
-			, theRadius{ radius }
-			, theCenter{ center }
-			, thePlaneDir1{ planeDir1 }
-			, thePlaneDir2{ planeDir2 }
-			, thePlaneDir
-				{ engabra::g3::direction((thePlaneDir1*thePlaneDir2).theBiv) }
-		{ }
-
-		//! Period for a complete rotation (in seconds).
-		inline
-		double
-		period
-			() const
-		{
-			return ((engabra::g3::turnFull * theRadius) / theSpeed);
-		}
-
-		//! Orientation at time tau for deterministic trajectory model.
-		inline
-		virtual
-		rigibra::Transform
-		pathOrientation
-			( double const & tau // [s]
-			) const
-		{
-			using namespace engabra::g3;
-			using namespace rigibra;
-
-			// rotate starting vector through angle depending on time
-			double const angSpeed{ theSpeed / theRadius };
-			PhysAngle const ang{ tau * angSpeed * thePlaneDir };
-			Attitude const att(ang);
-			Vector const loc{ att(thePlaneDir1) };
-
-			return Transform{loc, theAtt0};
-		}
-
-	}; // TrajectoryCircle
-
-
-	//! Simulate camera observing several features.
-	inline
-	std::map<std::pair<CamKey, FeaKey>, rigibra::Transform>
-	xformCamWrtFeas
-		( TrajectoryCircle const & trajCam
-		, double const & tau
-		, std::map<FeaKey, rigibra::Transform> const & expFeaXforms
-		, std::size_t const & numFeas
-		, orinet::random::NoiseModel const & noise = {}
-		)
-	{
-		using rigibra::Transform;
-		std::map<std::pair<CamKey, FeaKey>, Transform> mapCamFeaXforms;
-
-		// get camera position
-		Transform const xCamWrtRef{ trajCam.perturbedOrientation(tau, noise) };
-
-		// get relative transformations to several targets
-		while (mapCamFeaXforms.size() < numFeas)
-		{
-			// select a pseudo-random feature to be "observed" next
-			std::size_t const randNdx
-				{ randomIndexInto(expFeaXforms.size()) };
-			std::map<FeaKey, Transform>::const_iterator
-				itFeaXform{ expFeaXforms.cbegin() };
-			std::advance(itFeaXform, randNdx);
-			FeaKey const & feaKey = itFeaXform->first;
-			Transform const & xFeaWrtRef = itFeaXform->second;
-
-			Transform const xRefWrtFea{ inverse(xFeaWrtRef) };
-			Transform const xCamWrtFea{ xCamWrtRef * xRefWrtFea };
-			//
-			sim::CamKey const & camKey = sim::sCamKey0;
-			mapCamFeaXforms.emplace_hint
-				( mapCamFeaXforms.end()
-				, std::make_pair
-					( std::make_pair(camKey, feaKey)
-					, xCamWrtFea
-					)
-				);
-		}
-		return mapCamFeaXforms;
-	}
-
-} // [sim]
+//! Scene simulation (trajectories, features, observations)
+namespace sim = orinet::sim;
 
 	//! get the maximum magnitude (hexad) error between the two collections
 	inline
@@ -471,6 +202,82 @@ namespace sim
 
 	} // func
 
+	//! Update network with one exposure's worth of star observations.
+	inline
+	void
+	updateNetworkStar
+		( orinet::network::Geometry * const & ptNetGeo
+		, std::map<std::pair<sim::CamKey, sim::FeaKey>, rigibra::Transform>
+			const & mapCamFeaXforms
+		, std::size_t const & reserveSize
+		, orinet::random::NoiseModel const & feaNoise
+		)
+	{
+		using namespace rigibra;
+		using orinet::network::StaKey;
+
+		if (! mapCamFeaXforms.empty())
+		{
+			// all observations in this exposure share the same camera
+			sim::CamKey const & camKey = mapCamFeaXforms.cbegin()->first.first;
+
+			// [DoxyExampleStar]
+
+			// one (noisy) observation per feature - linear in their number
+			std::vector<std::pair<StaKey, Transform> > xCamWrtFeas;
+			xCamWrtFeas.reserve(mapCamFeaXforms.size());
+			for (std::map<std::pair<sim::CamKey, sim::FeaKey>, Transform>
+				::value_type const & mapCamFeaXform : mapCamFeaXforms)
+			{
+				sim::FeaKey const & feaKey = mapCamFeaXform.first.second;
+				Transform const & xCamWrtFeaIdeal = mapCamFeaXform.second;
+				using orinet::random::noisyTransform;
+				xCamWrtFeas.emplace_back
+					(feaKey, noisyTransform(xCamWrtFeaIdeal, feaNoise));
+			}
+
+			// camera is hub station, features are spoke stations
+			ptNetGeo->insertStarObservations(camKey, xCamWrtFeas, reserveSize);
+
+			// [DoxyExampleStar]
+		}
+	}
+
+	/*! \brief Update robust estimates for edges observed in one exposure.
+	 *
+	 * Edge estimates are (re)computed on demand, but doing it here
+	 * confines the work to a known (and separately timed) phase.
+	 */
+	inline
+	void
+	reestimateEdges
+		( orinet::network::Geometry const & netGeo
+		, std::map<std::pair<sim::CamKey, sim::FeaKey>, rigibra::Transform>
+			const & mapCamFeaXforms
+		)
+	{
+		using Iter = std::map<std::pair<sim::CamKey, sim::FeaKey>
+			, rigibra::Transform>::const_iterator;
+		for (Iter it1{mapCamFeaXforms.cbegin()}
+			; mapCamFeaXforms.cend() != it1 ; ++it1)
+		{
+			Iter it2{ it1 };
+			++it2;
+			for ( ; mapCamFeaXforms.cend() != it2 ; ++it2)
+			{
+				using namespace orinet::network;
+				EdgeDir const edgeDir{ it1->first.second, it2->first.second };
+				std::shared_ptr<EdgeBase> const ptEdge{ netGeo.edge(edgeDir) };
+				std::shared_ptr<EdgeRobust> const ptEdgeRobust
+					{ std::dynamic_pointer_cast<EdgeRobust>(ptEdge) };
+				if (ptEdgeRobust)
+				{
+					ptEdgeRobust->reestimate();
+				}
+			}
+		}
+	}
+
 namespace
 {
 	//! Examples for documentation
@@ -518,6 +325,10 @@ namespace
 		// start test data only after one trajectory loop
 		bool checkingActive{ false };
 
+		// latency statistics for phases of each incremental update
+		using Phase = orinet::perf::Phase;
+		orinet::perf::Latencies latencies;
+
 		// update network geometry continously for a period of time
 		orinet::network::Geometry netGeo;
 		double tauVal{ 0. };
@@ -536,9 +347,31 @@ namespace
 					(trajCam, tauVal, expFeaXforms, numFea, trajNoise)
 				};
 
+			// count allocations made during update phases
+			orinet::alloc::Scope const allocScope{};
+
 			// update robust network
-			constexpr std::size_t reserveSize{ 4096u }; // for performance
-			updateNetwork(&netGeo, mapCamFeaXforms, reserveSize, feaNoise);
+			{
+				using orinet::perf::ScopedTimer;
+				ScopedTimer const timer(&latencies, Phase::ObsAccumulate);
+				constexpr std::size_t reserveSize{ 4096u }; // for performance
+				updateNetwork(&netGeo, mapCamFeaXforms, reserveSize, feaNoise);
+			}
+
+			// refresh robust estimates for edges affected by this exposure
+			{
+				using orinet::perf::ScopedTimer;
+				ScopedTimer const timer(&latencies, Phase::EdgeReestimate);
+				reestimateEdges(netGeo, mapCamFeaXforms);
+			}
+
+			// determine network of (currently) best edges
+			orinet::network::Geometry treeGeo;
+			{
+				using orinet::perf::ScopedTimer;
+				ScopedTimer const timer(&latencies, Phase::SpanningUpdate);
+				treeGeo = netGeo.networkTree(netGeo.spanningEdgeBases());
+			}
 
 			// Lock-in first iteration's first camera station as reference
 			static sim::FeaKey const feaKey0
@@ -547,8 +380,14 @@ namespace
 				{ expFeaXforms.cbegin()->second };
 
 			// propagate features through current robust network
-			std::map<sim::FeaKey, Transform> const gotFeaXforms
-				{ netGeo.propagateTransforms(feaKey0, xform0) };
+			std::map<sim::FeaKey, Transform> gotFeaXforms;
+			{
+				using orinet::perf::ScopedTimer;
+				ScopedTimer const timer(&latencies, Phase::Propagation);
+				gotFeaXforms = treeGeo.propagateTransforms(feaKey0, xform0);
+			}
+
+			latencies.recordAllocations(allocScope.numAllocs());
 
 			// asset the quality of the result
 			double const maxErr
@@ -580,6 +419,10 @@ namespace
 			std::cout << "netGeo:\n" << netGeo.infoStringContents() << '\n';
 		}
 
+		// report update latency distributions
+		std::cout << latencies.snapshot().infoString
+			("test_slam: incremental update latencies") << '\n';
+
 		if (! checkingActive)
 		{
 			oss << "Failure of checkingActive test (run for more time)\n";
@@ -606,6 +449,144 @@ namespace
 
 	}
 
+	//! Check star registration (camera hub to feature spokes)
+	void
+	test1
+		( std::ostream & oss
+		)
+	{
+		using namespace rigibra;
+
+		// simulated run time (length and acquisition interval)
+		constexpr double tauMax{ 30.125 };
+		constexpr double tauDelta{ 1./32. };
+
+		// number of object space features to simulate
+		constexpr std::size_t numFea{ 7u };
+		constexpr double tolErr{ .1 }; // same as for pairwise test
+
+		// Noise model for camera to feature observations
+		orinet::random::NoiseModel const feaNoise
+			{ .theLocSigma =  5./100.
+			, .theAngSigma =  2./1000.
+			, .theProbErr =  .20
+			, .theLocMinMax = { -.5, .5 }
+			, .theAngMinMax = { -.5, .5 }
+			};
+
+		std::map<sim::FeaKey, Transform> const expFeaXforms
+			{ sim::expFeaXforms(numFea) };
+		sim::TrajectoryCircle const trajCam{};
+
+		// each exposure is a new camera station (with its own key)
+		orinet::network::Geometry netGeo;
+		std::size_t numObs{ 0u };
+		sim::CamKey camKey{ sim::sCamKey0 };
+		for (double tauVal{ tauDelta } ; ! (tauMax < tauVal)
+			; tauVal += tauDelta)
+		{
+			std::map<std::pair<sim::CamKey, sim::FeaKey>, Transform>
+				const mapCamFeaXforms
+				{ sim::xformCamWrtFeas
+					(trajCam, tauVal, expFeaXforms, numFea, {}, camKey)
+				};
+			constexpr std::size_t reserveSize{ 1u }; // single obs per edge
+			updateNetworkStar(&netGeo, mapCamFeaXforms, reserveSize, feaNoise);
+			numObs += mapCamFeaXforms.size();
+			++camKey;
+		}
+
+		// one edge per observation (no feature pair expansion)
+		std::size_t const numCams{ camKey - sim::sCamKey0 };
+		std::size_t const expNumVerts{ numCams + numFea };
+		std::size_t const gotNumVerts{ netGeo.sizeVerts() };
+		std::size_t const expNumEdges{ numObs };
+		std::size_t const gotNumEdges{ netGeo.sizeEdges() };
+		if (! ((gotNumVerts == expNumVerts) && (gotNumEdges == expNumEdges)))
+		{
+			oss << "Failure of star registration size test\n";
+			oss << "exp: verts,edges: " << expNumVerts << ' ' << expNumEdges
+				<< '\n';
+			oss << "got: verts,edges: " << gotNumVerts << ' ' << gotNumEdges
+				<< '\n';
+		}
+
+		// feature to feature relationships derived (robustly) on demand
+		sim::FeaKey const & feaKey0 = expFeaXforms.cbegin()->first;
+		Transform const & xFea0WrtRef = expFeaXforms.cbegin()->second;
+		for (std::map<sim::FeaKey, Transform>::value_type
+			const & expFeaXform : expFeaXforms)
+		{
+			sim::FeaKey const & feaKey = expFeaXform.first;
+			if (feaKey0 < feaKey)
+			{
+				Transform const & xFeaWrtRef = expFeaXform.second;
+				Transform const expFeaWrtFea0
+					{ xFeaWrtRef * inverse(xFea0WrtRef) };
+				using orinet::network::EdgeDir;
+				Transform const gotFeaWrtFea0
+					{ netGeo.xformViaHubs(EdgeDir{ feaKey0, feaKey }) };
+
+				constexpr bool useNorm{ false };
+				using orinet::compare::maxMagResultDifference;
+				double const maxErr
+					{ maxMagResultDifference
+						(gotFeaWrtFea0, expFeaWrtFea0, useNorm)
+					};
+				if (! (maxErr < tolErr))
+				{
+					oss << "Failure of xformViaHubs test\n";
+					oss << "feaKey: " << feaKey << '\n';
+					oss << "exp: " << expFeaWrtFea0 << '\n';
+					oss << "got: " << gotFeaWrtFea0 << '\n';
+					oss << "maxErr: " << maxErr << '\n';
+				}
+			}
+		}
+	}
+
+	//! Check accumulation of observations given in either edge direction
+	void
+	test2
+		( std::ostream & oss
+		)
+	{
+		using namespace rigibra;
+		using orinet::network::EdgeDir;
+		orinet::random::Context ctx(85301u);
+		Transform const x2w1
+			{ orinet::random::uniformTransform(ctx, { -5., 5. }, { -1., 1. }) };
+
+		// first observation creates edge, others given for reverse edge
+		EdgeDir const dir12{ 1u, 2u };
+		EdgeDir const dir21{ 2u, 1u };
+		orinet::network::Geometry netGeo;
+		constexpr std::size_t reserveSize{ 3u };
+		netGeo.accumulateEdgeXform(dir12, x2w1, reserveSize);
+		netGeo.accumulateEdgeXform(dir21, inverse(x2w1), reserveSize);
+		netGeo.accumulateEdgeXform(dir21, inverse(x2w1), reserveSize);
+
+		std::shared_ptr<orinet::network::EdgeBase> const ptEdge
+			{ netGeo.edge(dir12) };
+		bool okay{ (1u == netGeo.sizeEdges()) && ptEdge };
+		if (okay)
+		{
+			EdgeDir::DirCompare const dirComp
+				{ ptEdge->edgeDir().compareTo(dir12) };
+			okay = (EdgeDir::Forward == dirComp)
+				&& nearlyEquals(ptEdge->xform(), x2w1, 1.e-12);
+		}
+		if (! okay)
+		{
+			oss << "Failure of mixed direction accumulation test\n";
+			oss << "exp: " << x2w1 << '\n';
+			if (ptEdge)
+			{
+				oss << "got: " << ptEdge->xform() << '\n';
+			}
+		}
+	}
+
 }
 
 //! Check behavior of NS
@@ -617,6 +598,8 @@ main
 	std::stringstream oss;
 
 	test0(oss);
+	test1(oss);
+	test2(oss);
 
 	if (oss.str().empty()) // Only pass if no errors were encountered
 	{
@@ -36,6 +36,7 @@
 #include <Rigibra>
 
 #include <algorithm>
+#include <cstdint>
 #include <iostream>
 #include <random>
 #include <sstream>
@@ -278,6 +279,119 @@ namespace
 
 	}
 
+	//! Test removal of values from trackers
+	void
+	test4
+		( std::ostream & oss
+		)
+	{
+		constexpr std::size_t reserveSize{ 16u };
+		orinet::stat::track::Values stats(reserveSize);
+		for (double const & value : { 5., -3., 7., 1., 1., 9. })
+		{
+			stats.insert(value);
+		}
+		// remove values to leave { -3., 1., 7. }
+		bool const okErase
+			{  stats.erase(9.)
+			&& stats.erase(1.)
+			&& stats.erase(5.)
+			&& (! stats.erase(5.)) // no longer present
+			};
+		double const expMedian{ 1. };
+		double const gotMedian{ stats.median() };
+		if (! (okErase && (3u == stats.size())
+			&& engabra::g3::nearlyEquals(gotMedian, expMedian)))
+		{
+			oss << "Failure of value tracker erase test\n";
+			oss << "okErase: " << okErase << '\n';
+			oss << "exp: " << expMedian << '\n';
+			oss << "got: " << gotMedian << '\n';
+		}
+
+		// transforms removed by value (as was inserted)
+		using namespace rigibra;
+		using namespace engabra::g3;
+		orinet::stat::track::Transforms xStats(reserveSize);
+		Transform const xA
+			{ Vector{ 1., 2., 3. }, Attitude{ PhysAngle{ .1*e12 } } };
+		Transform const xB
+			{ Vector{ 2., 3., 4. }, Attitude{ PhysAngle{ .2*e23 } } };
+		xStats.insert(xA);
+		xStats.insert(xB);
+		xStats.insert(xB);
+		bool const okXform{ xStats.erase(xA) && (2u == xStats.size()) };
+		if (! (okXform && nearlyEquals(xStats.median(), xB)))
+		{
+			oss << "Failure of transform tracker erase test\n";
+			oss << "exp: " << xB << '\n';
+			oss << "got: " << xStats.median() << '\n';
+		}
+
+		// partial match (location only) leaves collection unchanged
+		Transform const xMix{ xB.theLoc, xA.theAtt };
+		bool const okMix
+			{  (! xStats.erase(xMix))
+			&& (2u == xStats.size())
+			&& xStats.erase(xB)
+			&& xStats.erase(xB)
+			&& (0u == xStats.size())
+			};
+		orinet::stat::track::Vectors vStats(reserveSize);
+		vStats.insert(Vector{ 1., 2., 3. });
+		bool const okVec
+			{  (! vStats.erase(Vector{ 1., 2., 4. }))
+			&& vStats.erase(Vector{ 1., 2., 3. })
+			};
+		if (! (okMix && okVec))
+		{
+			oss << "Failure of partial match erase test\n";
+			oss << "okMix: " << okMix << '\n';
+			oss << "okVec: " << okVec << '\n';
+		}
+	}
+
+	//! Check readFrom() of saved and of corrupt data
+	inline
+	void
+	test5
+		( std::ostream & oss
+		)
+	{
+		orinet::stat::track::Values expStats(4u);
+		for (double const & value : { 3., 1., 2. })
+		{
+			expStats.insert(value);
+		}
+		std::stringstream saved;
+		expStats.writeTo(saved);
+		orinet::stat::track::Values gotStats(4u);
+		bool const okSaved
+			{  gotStats.readFrom(saved)
+			&& (3u == gotStats.size())
+			&& (2. == gotStats.median())
+			};
+
+		// element count far larger than (remaining) stream data
+		std::uint64_t const badNumElem{ 1ull << 60u };
+		std::stringstream corrupt;
+		corrupt.write
+			(reinterpret_cast<char const *>(&badNumElem), sizeof(badNumElem));
+		corrupt.write
+			(reinterpret_cast<char const *>(&badNumElem), sizeof(badNumElem));
+		bool const okCorrupt
+			{  (! gotStats.readFrom(corrupt))
+			&& (3u == gotStats.size()) // unchanged
+			};
+
+		if (! (okSaved && okCorrupt))
+		{
+			oss << "Failure of Values readFrom test\n";
+			oss << "okSaved: " << okSaved << '\n';
+			oss << "okCorrupt: " << okCorrupt << '\n';
+		}
+	}
+
 }
 
 //! Check behavior of NS
@@ -292,6 +406,8 @@ main
 	test1(oss);
 	test2(oss);
 	test3(oss);
+	test4(oss);
+	test5(oss);
 
 	if (oss.str().empty()) // Only pass if no errors were encountered
 	{
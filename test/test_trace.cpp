@@ -0,0 +1,360 @@
+//
+// MIT License
+//
+// Copyright (c) 2024 Stellacore Corporation
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+
+/*! \file
+\brief Unit tests (and example) code for OriNet::trace
+*/
+
+
+#include "OriNet/trace.hpp"
+
+#include "OriNet/networkEdge.hpp"
+#include "OriNet/networkGeometry.hpp"
+#include "OriNet/random.hpp"
+#include "OriNet/robust.hpp"
+
+#include <Engabra>
+#include <Rigibra>
+
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <set>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+
+// The library must be compiled with the same setting (e.g. OriNet::Trace)
+#if ! defined(OriNet_TRACE)
+#	error "test_trace requires OriNet_TRACE for test and library code"
+#endif
+
+
+namespace
+{
+	//! Events (from all threads) with given name
+	inline
+	std::vector<orinet::trace::Event>
+	eventsNamed
+		( std::string const & name
+		)
+	{
+		std::vector<orinet::trace::Event> events;
+		using orinet::trace::ThreadBuffer;
+		for (std::shared_ptr<ThreadBuffer> const & ptBuffer
+			: orinet::trace::Registry::instance().buffers())
+		{
+			for (orinet::trace::Event const & event : ptBuffer->theEvents)
+			{
+				if (name == event.theName)
+				{
+					events.emplace_back(event);
+				}
+			}
+		}
+		return events;
+	}
+
+	//! Examples for documentation
+	void
+	test0
+		( std::ostream & oss
+		)
+	{
+		orinet::trace::clear();
+
+		// [DoxyExample01]
+
+		// stages of processing
+		for (std::size_t nn{0u} ; nn < 3u ; ++nn)
+		{
+			// spans are recorded (only) if OriNet_TRACE is defined
+			OriNet_TRACE_SPAN("example::outerStage");
+			{
+				// span with associated value (e.g. problem size)
+				OriNet_TRACE_SPAN_ARG("example::innerStage", 17u);
+				// ... do work
+			}
+		}
+
+		// timeline for all threads (e.g. view with chrome://tracing)
+		std::ostringstream json;
+		orinet::trace::writeChromeJson(json);
+
+		// [DoxyExample01]
+
+		std::size_t const gotNum{ orinet::trace::numEvents() };
+		std::size_t const expNum{ 6u };
+		if (! (expNum == gotNum))
+		{
+			oss << "Failure of numEvents test\n";
+			oss << "exp: " << expNum << '\n';
+			oss << "got: " << gotNum << '\n';
+		}
+
+		std::string const jsonStr{ json.str() };
+		bool const hasOuter
+			{ std::string::npos != jsonStr.find("\"example::outerStage\"") };
+		bool const hasArg
+			{ std::string::npos != jsonStr.find("\"args\": {\"n\": 17}") };
+		bool const hasComplete
+			{ std::string::npos != jsonStr.find("\"ph\": \"X\"") };
+		if (! (hasOuter && hasArg && hasComplete))
+		{
+			oss << "Failure of Chrome JSON content test\n";
+			oss << jsonStr << '\n';
+		}
+
+		// inner spans are nested within outer spans
+		std::vector<orinet::trace::Event> const outers
+			{ eventsNamed("example::outerStage") };
+		std::vector<orinet::trace::Event> const inners
+			{ eventsNamed("example::innerStage") };
+		if (! ((3u == outers.size()) && (3u == inners.size())))
+		{
+			oss << "Failure of event names test\n";
+		}
+		else
+		{
+			for (std::size_t nn{0u} ; nn < outers.size() ; ++nn)
+			{
+				orinet::trace::Event const & outer = outers[nn];
+				orinet::trace::Event const & inner = inners[nn];
+				bool const okayNest
+					{  (! (inner.theBegNs < outer.theBegNs))
+					&& (! ( (outer.theBegNs + outer.theDurNs)
+						  < (inner.theBegNs + inner.theDurNs)))
+					};
+				if (! okayNest)
+				{
+					oss << "Failure of span nesting test\n";
+				}
+			}
+		}
+	}
+
+	//! Check spans from instrumented (header) code
+	void
+	test1
+		( std::ostream & oss
+		)
+	{
+		orinet::trace::clear();
+
+		using namespace rigibra;
+		orinet::random::Context ctx(987u);
+		std::pair<double, double> const locMinMax{ -1., 1. };
+		std::pair<double, double> const angMinMax{ -.5, .5 };
+		std::vector<Transform> xforms;
+		for (std::size_t nn{0u} ; nn < 25u ; ++nn)
+		{
+			xforms.emplace_back
+				(orinet::random::uniformTransform(ctx, locMinMax, angMinMax));
+		}
+		(void)orinet::robust::transformViaEffect
+			(xforms.cbegin(), xforms.cend());
+		(void)orinet::robust::transformViaParameters
+			(xforms.cbegin(), xforms.cend());
+
+		using namespace orinet::network;
+		EdgeRobust const edge(EdgeDir{ 1u, 2u }, xforms.front(), 4u);
+		edge.reestimate();
+
+		std::vector<orinet::trace::Event> const viaEffects
+			{ eventsNamed("robust::transformViaEffect") };
+		std::vector<orinet::trace::Event> const viaParms
+			{ eventsNamed("robust::transformViaParameters") };
+		std::vector<orinet::trace::Event> const reests
+			{ eventsNamed("EdgeRobust::reestimate") };
+		if (! ( (1u == viaEffects.size()) && (1u == viaParms.size())
+			 && (! reests.empty())
+			  ))
+		{
+			oss << "Failure of instrumented function event test\n";
+			oss << "viaEffects.size: " << viaEffects.size() << '\n';
+			oss << "viaParms.size: " << viaParms.size() << '\n';
+			oss << "reests.size: " << reests.size() << '\n';
+		}
+		else
+		if (! ( viaEffects.front().theHasArg
+			 && (xforms.size() == viaEffects.front().theArg)
+			  ))
+		{
+			oss << "Failure of event arg test\n";
+			oss << "exp: " << xforms.size() << '\n';
+			oss << "got: " << viaEffects.front().theArg << '\n';
+		}
+	}
+
+	//! Check recording from several threads
+	void
+	test2
+		( std::ostream & oss
+		)
+	{
+		orinet::trace::clear();
+
+		constexpr std::size_t numThreads{ 4u };
+		constexpr std::size_t numPerThread{ 100u };
+		std::vector<std::thread> threads;
+		for (std::size_t nThread{0u} ; nThread < numThreads ; ++nThread)
+		{
+			threads.emplace_back
+				( [] ()
+					{
+						for (std::size_t nn{0u} ; nn < numPerThread ; ++nn)
+						{
+							OriNet_TRACE_SPAN("test::threadWork");
+						}
+					}
+				);
+		}
+		for (std::thread & thread : threads)
+		{
+			thread.join();
+		}
+
+		// buffers are retained after threads exit
+		std::set<std::size_t> tids;
+		std::size_t numWork{ 0u };
+		using orinet::trace::ThreadBuffer;
+		for (std::shared_ptr<ThreadBuffer> const & ptBuffer
+			: orinet::trace::Registry::instance().buffers())
+		{
+			for (orinet::trace::Event const & event : ptBuffer->theEvents)
+			{
+				if (0 == std::strcmp("test::threadWork", event.theName))
+				{
+					tids.insert(ptBuffer->theTid);
+					++numWork;
+				}
+			}
+		}
+
+		if (! (numThreads == tids.size()))
+		{
+			oss << "Failure of distinct thread id test\n";
+			oss << "exp: " << numThreads << '\n';
+			oss << "got: " << tids.size() << '\n';
+		}
+		if (! ((numThreads * numPerThread) == numWork))
+		{
+			oss << "Failure of multithread event count test\n";
+			oss << "exp: " << (numThreads * numPerThread) << '\n';
+			oss << "got: " << numWork << '\n';
+		}
+	}
+
+
+	//! Check spans from instrumented (library source) network code
+	void
+	test3
+		( std::ostream & oss
+		)
+	{
+		orinet::trace::clear();
+
+		using namespace orinet::network;
+		orinet::random::Context ctx(4321u);
+		Geometry geo;
+		constexpr std::size_t numSta{ 5u };
+		for (std::size_t nn{1u} ; nn < numSta ; ++nn)
+		{
+			geo.insertEdge
+				( std::make_shared<EdgeOri>
+					( EdgeDir{ nn - 1u, nn }
+					, orinet::random::uniformTransform(ctx, { -1., 1. })
+					, 1.
+					)
+				);
+		}
+		Geometry const treeGeo{ geo.networkTree(geo.spanningEdgeBases()) };
+		rigibra::Transform const xform0
+			{ rigibra::identity<rigibra::Transform>() };
+		(void)treeGeo.propagateTransforms(0u, xform0);
+
+		// inserts into geo and (again) into treeGeo
+		std::size_t const numInserts
+			{ eventsNamed("Geometry::insertEdge").size() };
+		std::vector<orinet::trace::Event> const spans
+			{ eventsNamed("Geometry::spanningEdgeBases") };
+		std::vector<orinet::trace::Event> const trees
+			{ eventsNamed("Geometry::networkTree") };
+		std::vector<orinet::trace::Event> const props
+			{ eventsNamed("Geometry::propagateTransforms") };
+		if (! ( ((2u * (numSta - 1u)) == numInserts)
+			 && (1u == spans.size())
+			 && (1u == trees.size())
+			 && (1u == props.size())
+			  ))
+		{
+			oss << "Failure of network span event test\n";
+			oss << "numInserts: " << numInserts << '\n';
+			oss << "spans.size: " << spans.size() << '\n';
+			oss << "trees.size: " << trees.size() << '\n';
+			oss << "props.size: " << props.size() << '\n';
+		}
+		else
+		if (! ( spans.front().theHasArg
+			 && ((numSta - 1u) == spans.front().theArg)
+			 && props.front().theHasArg
+			 && (numSta == props.front().theArg)
+			  ))
+		{
+			oss << "Failure of network span arg test\n";
+			oss << "spans.arg: " << spans.front().theArg << '\n';
+			oss << "props.arg: " << props.front().theArg << '\n';
+		}
+	}
+
+}
+
+//! Check behavior of trace recording
+int
+main
+	()
+{
+	int status{ 1 };
+	std::stringstream oss;
+
+	test0(oss);
+	test1(oss);
+	test2(oss);
+	test3(oss);
+
+	if (oss.str().empty()) // Only pass if no errors were encountered
+	{
+		status = 0;
+	}
+	else
+	{
+		// else report error messages
+		std::cerr << "### FAILURE in test file: " << __FILE__ << std::endl;
+		std::cerr << oss.str();
+	}
+	return status;
+}
@@ -40,6 +40,7 @@
 #include <deque>
 #include <iostream>
 #include <map>
+#include <memory>
 #include <numeric>
 #include <set>
 #include <vector>
@@ -136,14 +137,7 @@ main
 	constexpr std::size_t numMea{ 7u };
 	constexpr std::size_t numErr{ 3u };
 	constexpr std::pair<double, double> locMinMax{ 0., 100. };
-	/*
-	// large size data
-	constexpr std::size_t numStations{ 1000u };
-	constexpr std::size_t numBacksight{ 5u };
-	constexpr std::size_t numMea{ 400u };
-	constexpr std::size_t numErr{  50u };
-	constexpr std::pair<double, double> locMinMax{ 0., 100. };
-	*/
+	// NOTE: for large networks, ref OriNet bench/bench_network.cpp
 #	endif // EasyCase
 
 	// [DoxyExample02]
@@ -172,12 +166,27 @@ main
 	for (std::map<NdxPair, std::vector<rigibra::Transform> >::value_type
 		const & pairXform : pairXforms)
 	{
-		// compute robustly fit transformation for this edge
-		orinet::network::EdgeOri const edgeOri
-			{ orinet::network::edgeOriMedianFit(pairXform.second) };
+		NdxPair const & ndxPair = pairXform.first;
+		std::vector<rigibra::Transform> const & obsXforms = pairXform.second;
+		if (obsXforms.empty())
+		{
+			continue;
+		}
+
+		// robustly fit transformation for this edge (from all observations)
+		using namespace orinet::network;
+		EdgeDir const edgeDir{ ndxPair.first, ndxPair.second };
+		std::shared_ptr<EdgeRobust> const ptEdge
+			{ std::make_shared<EdgeRobust>
+				(edgeDir, obsXforms.front(), obsXforms.size())
+			};
+		for (std::size_t nn{1u} ; nn < obsXforms.size() ; ++nn)
+		{
+			ptEdge->accumulateXform(obsXforms[nn]);
+		}
 
 		// insert robust transform into network
-		geoNet.addEdge(pairXform.first, edgeOri);
+		geoNet.insertEdge(ptEdge);
 	}
 
 
@@ -189,7 +198,7 @@ main
 	//
 
 	std::vector<graaf::edge_id_t> const mstEdgeIds
-		{ geoNet.spanningEdgeOris() };
+		{ geoNet.spanningEdgeBases() };
 
 	orinet::network::Geometry const mstNet{ geoNet.networkTree(mstEdgeIds) };
 
@@ -200,10 +209,10 @@ main
 	//
 
 	// traverse mst from node 0 (since 0 always present in non-empty graph)
-	orinet::network::StaNdx const staNdx0{ 0u };
-	rigibra::Transform const & staXform0 = expStas[staNdx0];
-	std::vector<rigibra::Transform> const gotStas
-		{ mstNet.propagateTransforms(staNdx0, staXform0) };
+	orinet::network::StaKey const staKey0{ 0u };
+	rigibra::Transform const & staXform0 = expStas[staKey0];
+	std::map<orinet::network::StaKey, rigibra::Transform> const gotStas
+		{ mstNet.propagateTransforms(staKey0, staXform0) };
 
 	//
 	// Display computed/propagated station locations
@@ -211,12 +220,13 @@ main
 
 	if (showResult)
 	{
-		std::size_t const numSta{ expStas.size() };
 		std::cout << "\n==============";
-		for (std::size_t nn{0u} ; nn < numSta ; ++nn)
+		for (std::map<orinet::network::StaKey, rigibra::Transform>::value_type
+			const & gotKeySta : gotStas)
 		{
+			std::size_t const & nn = gotKeySta.first;
 			rigibra::Transform const & expSta = expStas[nn];
-			rigibra::Transform const & gotSta = gotStas[nn];
+			rigibra::Transform const & gotSta = gotKeySta.second;
 			std::cout
 				<< '\n'
 				<< "exp[" << nn << "] " << expSta << '\n'